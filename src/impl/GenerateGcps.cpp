@@ -21,6 +21,8 @@
 #include <ul_ImageLoader.h>
 #include <ul_Proj4Projection.h>
 #include <ul_SmartVector.h>
+#include <ul_Profiler.h>
+#include <ul_SubPixelCorrelator.h>
 
 static int LoadLocations(const std::string &fixedChipLocationFile, ultra::CTiledGaussianPyramidTiePointGenerator::SContext &context)
 {
@@ -47,6 +49,7 @@ static int LoadLocations(const std::string &fixedChipLocationFile, ultra::CTiled
 
 int GenerateGcps(SArgs &args, ultra::CVector<ultra::SChipCorrelationResult> &result, bool &overlapExists)
 {
+    ULTRA_SCOPED_TIMER("GenerateGcps");
     ultra::CTiledGaussianPyramidTiePointGenerator::SContext context;
 
     ultra::SImageMetadata meta;
@@ -75,6 +78,7 @@ int GenerateGcps(SArgs &args, ultra::CVector<ultra::SChipCorrelationResult> &res
     context.mayContainNullValues = args.mayContainNullValues;
     context.chipSize = args.chipSize;
     context.chipGenerationGridSize = args.chipGenerationGridSize;
+    context.maxFeaturesPerCell = args.maxFeaturesPerCell;
     if (args.usePhaseCorrelation)
         context.typeOfChipCorrelationTechnique = ultra::ECorrelationType::PHASE;
     else
@@ -82,6 +86,8 @@ int GenerateGcps(SArgs &args, ultra::CVector<ultra::SChipCorrelationResult> &res
     context.chipGeneratorMethods.clear();
     context.chipGeneratorMethods.pushBack(args.chipGenType);
     context.correlationThreshold = args.correlationThreshold;
+    context.duplicateGcpTolerance = args.duplicateGcpTolerance;
+    context.localShiftPriors = args.localShiftPriors;
 
     if (args.chipGenType == ultra::EChips::CHIP_GEN_FIXED_LOCATION)
     {
@@ -99,5 +105,7 @@ int GenerateGcps(SArgs &args, ultra::CVector<ultra::SChipCorrelationResult> &res
         ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned from CTiledGaussianPyramidTiePointGenerator::Calculate()");
         return 1;
     }
+    if (args.validatePrecision && (args.correlationPrecision != ultra::ECorrelationPrecision::HIGH || args.coarseToFineStride > 1))
+        ultra::CCorrelationPrecisionValidation::getInstance()->LogSummary();
     return 0;
 }
@@ -22,6 +22,8 @@
 #include <ul_Pair.h>
 #include <ul_Proj4Projection.h>
 #include <ul_File.h>
+#include <ul_GcpResultSink.h>
+#include <ul_Profiler.h>
 
 static std::string changeExt(const ultra::CFile &filePath, std::string ext)
 {
@@ -39,102 +41,72 @@ static int SaveResidualFile(SArgs &args,
                             const ultra::CVector<ultra::SChipCorrelationResult> &result)
 {
     ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_INFO, "Residual X = " + ultra::toString(totalXY.x) + " Y = " + ultra::toString(totalXY.y));
-    char msg[4096];
-    sprintf(msg, "Residual histogram\n");
-    for (int x = 0; x < residualHistogram.size(); x++)
+    std::string msg = "Residual histogram\n";
+    for (unsigned long x = 0; x < residualHistogram.size(); x++)
     {
-        switch (x)
-        {
-        case 0:
-            sprintf(msg, "%s\tGreen %d\n", msg, residualHistogram[x]);
-            break;
-        case 1:
-            sprintf(msg, "%s\tTeal %d\n", msg, residualHistogram[x]);
-            break;
-        case 2:
-            sprintf(msg, "%s\tBlue %d\n", msg, residualHistogram[x]);
-            break;
-        case 3:
-            sprintf(msg, "%s\tYellow %d\n", msg, residualHistogram[x]);
-            break;
-        case 4:
-            sprintf(msg, "%s\tRed %d\n", msg, residualHistogram[x]);
-            break;
-        }
+        std::string name = ultra::SGcpResultHeader::getHistogramBinName(x);
+        if (name != "")
+            msg += "\t" + name + " " + ultra::toString(residualHistogram[x]) + "\n";
     }
     ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_INFO, msg);
 
-    std::string outputPath = args.outputPath + "/image-gverify.res";
-    FILE *fm = fopen(outputPath.c_str(), "w");
-    if (fm == NULL)
-    {
-        ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_WARN, "Failed to create residual file");
-        return 1;
-    }
-
-    fprintf(fm, "IMAGE_GVERIFY\n\n");
-    fprintf(fm, "Total residuals\n");
-    fprintf(fm, "\tResidual x = %lf\n", totalXY.x);
-    fprintf(fm, "\tResidual y = %lf\n", totalXY.y);
+    ultra::SGcpResultHeader header;
+    header.totalResidual = totalXY;
+    header.residualHistogram = residualHistogram;
+    header.geoTransform = metaRef.getAffineGeoTransform();
+    header.proj4Str = refProj4Str;
+    ultra::EProjectionEnum::EProjectionUnits projUnits = subSetMetaRef.projectionUnits;
+    header.units = ultra::toLower(ultra::EProjectionEnum::projectionUnitsToStr(projUnits));
+    if (header.units == "")
+        header.units = "meters";
 
-    fprintf(fm, "Residual histogram\n");
-    for (int x = 0; x < residualHistogram.size(); x++)
+    std::vector<std::unique_ptr<ultra::IGcpResultSink> > sinks;
+    for (unsigned long t = 0; t < args.resultFormats.size(); t++)
     {
-        switch (x)
+        std::string outputPath = args.outputPath + "/image-gverify." + ultra::EGcpResultFormat::getFileExtension(args.resultFormats[t]);
+        sinks.push_back(ultra::IGcpResultSink::Create(args.resultFormats[t], outputPath));
+        if (sinks.back() == nullptr || sinks.back()->Begin(header) != 0)
         {
-        case 0:
-            fprintf(fm, "\tGreen %d\n", residualHistogram[x]);
-            break;
-        case 1:
-            fprintf(fm, "\tTeal %d\n", residualHistogram[x]);
-            break;
-        case 2:
-            fprintf(fm, "\tBlue %d\n", residualHistogram[x]);
-            break;
-        case 3:
-            fprintf(fm, "\tYellow %d\n", residualHistogram[x]);
-            break;
-        case 4:
-            fprintf(fm, "\tRed %d\n", residualHistogram[x]);
-            break;
+            ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_WARN, "Failed to create residual file '" + outputPath + "'");
+            return 1;
         }
     }
-    ultra::CVector<double> afx = metaRef.getAffineGeoTransform();
-    const double* dp = afx.getDataPointer();
-    fprintf(fm, "\n");
-    fprintf(fm, "Geo-Affine-Transform [%4.4lf, %4.4lf, %4.4lf, %4.4lf, %4.4lf, %4.4lf]\n", dp[0], dp[1], dp[2], dp[3], dp[4], dp[5]);
-    fprintf(fm, "Proj4-Str [%s]\n", refProj4Str.c_str());
 
-    ultra::EProjectionEnum::EProjectionUnits projUnits = subSetMetaRef.projectionUnits;
-    std::string resType = ultra::toLower(ultra::EProjectionEnum::projectionUnitsToStr(projUnits));
-    if (resType == "")
-        resType = "meters";
-    fprintf(fm, "-----------------------------\n");
-    fprintf(fm, "-------------GCPs------------\n");
-    fprintf(fm, "-----------------------------\n");
-    fprintf(fm, "Point_ID    Line      Sample         Map-X      Map-Y     Corelation  Residual Residual Outlier \n");
-    fprintf(fm, "         (Ref image) (Ref image) (Ref image) (Ref image)  Coefficient  In y     In x     Flag   \n");
-    fprintf(fm, "                                                                                        (0=bad  \n");
-    fprintf(fm, "                                                                    (%s) (%s)   1=OK)  \n", resType.c_str(), resType.c_str());
-    fprintf(fm, "BEGIN\n");
-
-    for (long t = 0; t < result.size(); t++)
+    ultra::SGcpRecord record;
+    for (unsigned long t = 0; t < result.size(); t++)
     {
-        long id = t;
-        double mapx = result[t].chip.midCoordinate.x;
-        double mapy = result[t].chip.midCoordinate.y;
+        if (!result[t].correlationResultIsGood)
+            continue;
+
         ultra::SPair<long> sl = metaRef.getSampleLine(result[t].chip.midCoordinate).roundValues().convertType<long>();
-        long line = sl.y;
-        long sample = sl.x;
-        double corcoef = result[t].corrCoefficient;
-        double resx = (mapx - result[t].newMidCoordinate.x);
-        double resy = (mapy - result[t].newMidCoordinate.y);
-        int good = (result[t].isGoodResult() ? (1) : (0));
-        if (result[t].correlationResultIsGood)
-            fprintf(fm, "%04d %s\t%05d\t\t%05d\t\t%4.4lf\t\t%4.4lf\t\t%4.4lf\t\t%4.4lf\t\t%4.4lf\t\t%d\n", id, result[t].chip.chipType.c_str(), line, sample, mapx, mapy, corcoef, resy, resx, good);
+        record.id = t;
+        record.chipType = result[t].chip.chipType;
+        record.line = sl.y;
+        record.sample = sl.x;
+        record.mapX = result[t].chip.midCoordinate.x;
+        record.mapY = result[t].chip.midCoordinate.y;
+        record.corrCoefficient = result[t].corrCoefficient;
+        record.residualX = record.mapX - result[t].newMidCoordinate.x;
+        record.residualY = record.mapY - result[t].newMidCoordinate.y;
+        record.isGood = result[t].isGoodResult();
+        for (unsigned long i = 0; i < sinks.size(); i++)
+        {
+            if (sinks[i]->Write(record) != 0)
+            {
+                ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned from IGcpResultSink::Write()");
+                return 1;
+            }
+        }
     }
 
-    fclose(fm);
+    for (unsigned long i = 0; i < sinks.size(); i++)
+    {
+        if (sinks[i]->End() != 0)
+        {
+            ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned from IGcpResultSink::End()");
+            return 1;
+        }
+    }
     return 0;
 }
 
@@ -146,7 +118,7 @@ static int SaveImage(SArgs &args,
 {
     std::string outputPath = args.outputPath + "/image-gverify_result.jpeg";
     if (ultra::CImageSaver::getInstance()->SaveImage(outputPath, imgInput, ultra::EImage::IMAGE_TYPE_JPEG) != 0 ||
-        args.saveTiff && ultra::CImageSaver::getInstance()->SaveImage(changeExt(outputPath, "tif"), imgInput, ultra::EImage::IMAGE_TYPE_GEOTIFF, &subSetMetaIn) != 0)
+        args.saveTiff && ultra::CImageSaver::getInstance()->SaveImage(changeExt(outputPath, "tif"), imgInput, ultra::EImage::IMAGE_TYPE_GEOTIFF, &subSetMetaIn, &args.outputSaveOptions) != 0)
     {
         ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned form SaveImage()");
         return 1;
@@ -160,7 +132,7 @@ static int SaveImage(SArgs &args,
 
     outputPath = args.outputPath + "/image-gverify_base.jpeg";
     if (ultra::CImageSaver::getInstance()->SaveImage(outputPath, imgRef, ultra::EImage::IMAGE_TYPE_JPEG) != 0 ||
-        args.saveTiff && ultra::CImageSaver::getInstance()->SaveImage(changeExt(outputPath, "tif"), imgRef, ultra::EImage::IMAGE_TYPE_GEOTIFF, &subSetMetaRef) != 0)
+        args.saveTiff && ultra::CImageSaver::getInstance()->SaveImage(changeExt(outputPath, "tif"), imgRef, ultra::EImage::IMAGE_TYPE_GEOTIFF, &subSetMetaRef, &args.outputSaveOptions) != 0)
     {
         ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned form SaveImage()");
         return 1;
@@ -420,6 +392,7 @@ static int SaveResults(SArgs &args, const ultra::CVector<ultra::SChipCorrelation
 
 int GenerateResults(SArgs &args, const ultra::CVector<ultra::SChipCorrelationResult> &result, bool overlapExists)
 {
+    ULTRA_SCOPED_TIMER("GenerateResults");
     ultra::CImage imgRef, imgIn;
     ultra::SImageMetadata metaRef, metaIn;
     ultra::SImageMetadata subSetMetaRef2, subSetMetaIn2;
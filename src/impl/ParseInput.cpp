@@ -19,6 +19,7 @@
 #include "ul_Logger.h"
 #include "ul_Utility.h"
 #include "ul_File.h"
+#include "ul_ImageSaver.h"
 
 SArgs::SArgs()
 {
@@ -30,6 +31,13 @@ SArgs::SArgs()
     resampleType = ultra::EResamplerEnum::RESAMPLE_TYPE_BI;
     saveTiff = false;
     saveUnion = true;
+    duplicateGcpTolerance = 0;
+    correlationPrecision = ultra::ECorrelationPrecision::HIGH;
+    validatePrecision = false;
+    coarseToFineStride = 1;
+    maxFeaturesPerCell = 0;
+    localShiftPriors = true;
+    resultFormats.push_back(ultra::EGcpResultFormat::RESULT_FORMAT_TEXT);
 }
 
 SArgs::~SArgs()
@@ -60,23 +68,37 @@ std::ostream &operator<<(std::ostream &stream, const SArgs::SImageItem &o)
 std::ostream &operator<<(std::ostream &stream, const SArgs &o)
 {
     stream << "gridSize = '" << o.chipGenerationGridSize << "'" << std::endl;
+    stream << "featuresPerCell = '" << o.maxFeaturesPerCell << "'" << std::endl;
     stream << "resampleType  = '" << ultra::EResamplerEnum::resamplingTypeToStr(o.resampleType) << "'" << std::endl;
     stream << "nullValue = '" << o.nullValue << "'" << std::endl;
     stream << "mayContainNullValues = '" + ultra::boolToStr(o.mayContainNullValues) << "'" << std::endl;
     stream << "chipGenType = '" << ultra::EChips::chipGenTypeToStr(o.chipGenType) << "'" << std::endl;
     stream << "fixedChipLocationFile = '" << o.fixedChipLocationFile << std::endl;
     stream << "correlationThreshold = '" << o.correlationThreshold << "'" << std::endl;
+    stream << "duplicateGcpTolerance = '" << o.duplicateGcpTolerance << "'" << std::endl;
     stream << "referenceImage = \n'" << o.referenceImage << "'" << std::endl;
     stream << "inputImage = \n'" << o.inputImage << "'" << std::endl;
     stream << "logPath = '" << o.logPath << "'" << std::endl;
     stream << "outputPath = '" << o.outputPath << "'" << std::endl;
     stream << "threadCount = '" << o.threadCount << "'" << std::endl;
     stream << "usePhaseCorrelation = '" << ultra::boolToStr(o.usePhaseCorrelation) << "'" << std::endl;
+    stream << "correlationPrecision = '" << ultra::CCorrelationHelper::typeToStr(o.correlationPrecision) << "'" << std::endl;
+    stream << "validatePrecision = '" << ultra::boolToStr(o.validatePrecision) << "'" << std::endl;
+    stream << "coarseToFineStride = '" << o.coarseToFineStride << "'" << std::endl;
+    stream << "localShiftPriors = '" << ultra::boolToStr(o.localShiftPriors) << "'" << std::endl;
     stream << "workingDirectory = '" << o.workingDirectory << "'" << std::endl;
     stream << "chipSize = '" << o.chipSize << "'" << std::endl;
     stream << "amountOfPyramids = '" << o.amountOfPyramids << "'" << std::endl;
     stream << "saveTiff = '" << ultra::boolToStr(o.saveTiff) << "'" << std::endl;
     stream << "saveUnion = '" << ultra::boolToStr(o.saveUnion) << "'" << std::endl;
+    stream << "timingReportPath = '" << o.timingReportPath << "'" << std::endl;
+    stream << "traceReportPath = '" << o.traceReportPath << "'" << std::endl;
+    stream << "resultFormats = '";
+    for (unsigned long t = 0; t < o.resultFormats.size(); t++)
+        stream << ((t == 0) ? ("") : (",")) << ultra::EGcpResultFormat::formatTypeToStr(o.resultFormats[t]);
+    stream << "'" << std::endl;
+    stream << "workingSaveOptions = '" << o.workingSaveOptions << "'" << std::endl;
+    stream << "outputSaveOptions = '" << o.outputSaveOptions << "'" << std::endl;
     return stream;
 }
 
@@ -133,6 +155,12 @@ static int ValidateInputs(SArgs &args)
         ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_INFO, "Chip Size must be odd adding 1 to make Chip Size odd");
     }
 
+    if (args.duplicateGcpTolerance < 0)
+    {
+        std::cout << "Duplicate GCP tolerance cannot be negative" << std::endl;
+        return 1;
+    }
+
     if (args.amountOfPyramids < 1)
     {
         std::cout << "Pyramid levels must be an integer larger than 0" << std::endl;
@@ -151,6 +179,26 @@ static int ValidateInputs(SArgs &args)
     return 0;
 }
 
+static int ParseResultFormats(std::vector<ultra::EGcpResultFormat::EFormatType> &formats, const std::string &second)
+{
+    std::vector<std::string> items = ultra::split(second, ',');
+    formats.clear();
+    for (unsigned long t = 0; t < items.size(); t++)
+    {
+        ultra::EGcpResultFormat::EFormatType type = ultra::EGcpResultFormat::strToFormatType(items[t]);
+        if (type == ultra::EGcpResultFormat::RESULT_FORMAT_TYPE_COUNT)
+        {
+            return 1;
+        }
+        bool duplicate = false;
+        for (unsigned long i = 0; i < formats.size(); i++)
+            duplicate |= formats[i] == type;
+        if (!duplicate)
+            formats.push_back(type);
+    }
+    return formats.empty() ? 1 : 0;
+}
+
 static int ParseChipType(ultra::EChips::EChipType &type, const std::string &second)
 {
     ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_INFO, "Chip gen type is '" + second + "'");
@@ -229,6 +277,10 @@ int ParseInput(int argc, char **argv, SArgs &args)
         {
             args.correlationThreshold = atof(second.c_str());
         }
+        else if (first == "-dt")
+        {
+            args.duplicateGcpTolerance = atof(second.c_str());
+        }
         else if (first == "-r")
         {
             second = ultra::toUpper(second);
@@ -288,6 +340,22 @@ int ParseInput(int argc, char **argv, SArgs &args)
                 return 1;
             }
         }
+        else if (first == "-of")
+        {
+            if (ParseResultFormats(args.resultFormats, second) != 0)
+            {
+                std::cout << "Invalid result formats '" << second << "'" << std::endl;
+                return 1;
+            }
+        }
+        else if (first == "-timing")
+        {
+            args.timingReportPath = second;
+        }
+        else if (first == "-trace")
+        {
+            args.traceReportPath = second;
+        }
         else if (first == "-st")
         {
             args.saveTiff = ultra::strToBool(second);
@@ -296,6 +364,22 @@ int ParseInput(int argc, char **argv, SArgs &args)
         {
             args.saveUnion = ultra::strToBool(second);
         }
+        else if (first == "-co_w")
+        {
+            if (ultra::SImageSaveOptions::Parse(second, args.workingSaveOptions) != 0)
+            {
+                std::cout << "Invalid working directory save options '" << second << "'" << std::endl;
+                return 1;
+            }
+        }
+        else if (first == "-co_o")
+        {
+            if (ultra::SImageSaveOptions::Parse(second, args.outputSaveOptions) != 0)
+            {
+                std::cout << "Invalid output save options '" << second << "'" << std::endl;
+                return 1;
+            }
+        }
         else if (first == "-g")
         {
             gotGridSize = true;
@@ -309,6 +393,18 @@ int ParseInput(int argc, char **argv, SArgs &args)
                 return 1;
             }
         }
+        else if (first == "-featuresPerCell")
+        {
+            if (ultra::isInt(second) && atol(second.c_str()) >= 0)
+            {
+                args.maxFeaturesPerCell = atol(second.c_str());
+            }
+            else
+            {
+                std::cout << "Features per cell must be a non negative integer" << std::endl;
+                return 1;
+            }
+        }
         else if (first == "-usePhaseCorrelation")
         {
             if (ultra::toUpper(second) == "TRUE")
@@ -318,6 +414,44 @@ int ParseInput(int argc, char **argv, SArgs &args)
             else
                 return 1;
         }
+        else if (first == "-precision")
+        {
+            if (ultra::CCorrelationHelper::strToType(second, args.correlationPrecision) != 0)
+            {
+                std::cout << "Invalid correlation precision '" << second << "'" << std::endl;
+                return 1;
+            }
+        }
+        else if (first == "-validatePrecision")
+        {
+            if (ultra::toUpper(second) == "TRUE")
+                args.validatePrecision = true;
+            else if (ultra::toUpper(second) == "FALSE")
+                args.validatePrecision = false;
+            else
+                return 1;
+        }
+        else if (first == "-coarseToFine")
+        {
+            if (ultra::isInt(second) && atol(second.c_str()) >= 1)
+            {
+                args.coarseToFineStride = atol(second.c_str());
+            }
+            else
+            {
+                std::cout << "Coarse to fine stride must be an integer of at least 1" << std::endl;
+                return 1;
+            }
+        }
+        else if (first == "-localShiftPriors")
+        {
+            if (ultra::toUpper(second) == "TRUE")
+                args.localShiftPriors = true;
+            else if (ultra::toUpper(second) == "FALSE")
+                args.localShiftPriors = false;
+            else
+                return 1;
+        }
         else
         {
             std::cout << "Invalid argument '" << first << "'" << std::endl;
@@ -345,6 +479,10 @@ int ParseInput(int argc, char **argv, SArgs &args)
     }
 
     ultra::AUltraThreadPool::setDefaultPoolSize(args.threadCount);
+    ultra::CDigitalImageCorrelatorFactory::setDefaultPrecision(args.correlationPrecision);
+    ultra::CDigitalImageCorrelatorFactory::setValidatePrecision(args.validatePrecision);
+    ultra::CDigitalImageCorrelatorFactory::setDefaultCoarseToFineStride(args.coarseToFineStride);
+    ultra::CImageSaver::getInstance()->setDefaultSaveOptions(args.workingSaveOptions);
 
     return ((fail) ? (1) : (0));
 }
@@ -365,19 +503,42 @@ void showHelp(int argc, char **argv)
     std::cout << "\t" << "-n [thread count(1)]" << std::endl;
     std::cout << "\t" << "-l [log folder]" << std::endl;
     std::cout << "\t" << "-c [correlation coefficient(0.75)]" << std::endl;
+    std::cout << "\t" << "-dt [duplicate GCP tolerance in map units (0)]" << std::endl;
     std::cout << "\t" << "-r [resample technique (NN/BI/CI)]" << std::endl;
     std::cout << "\t" << "-cs [chip size (33)]" << std::endl;
     std::cout << "\t" << "-st [save geotiff (false)]" << std::endl;
+    std::cout << "\t" << "-of [comma separated GCP result formats TEXT / BINARY / CSV (TEXT)]" << std::endl;
     std::cout << "\t" << "-su [save union images between reference and input (true)]" << std::endl;
     std::cout << "\t" << "-g [grid size (chip size * 2)]" << std::endl;
+    std::cout << "\t" << "-featuresPerCell [HARRIS / SOBEL keep at most this many of the strongest features per grid cell, 0 keeps all of them (0)]" << std::endl;
     std::cout << "\t" << "-b_p [reference image proj4 string (example \"+proj=utm +ellps=WGS84 +units=m +no_defs +zone=36\"')]" << std::endl;
     std::cout << "\t" << "-m_p [input image proj4 string (example \"+proj=eqc +ellps=sphere +R=5729577.951308 +units=m +no_defs\"')]" << std::endl;
     std::cout << "\t" << "-usePhaseCorrelation [true/false (false)]" << std::endl;
+    std::cout << "\t" << "-precision [correlation arithmetic precision HIGH / DOUBLE / FLOAT, FLOAT only speeds up phase correlation (HIGH)]" << std::endl;
+    std::cout << "\t" << "-validatePrecision [repeat every correlation exhaustively at HIGH precision and log the differences true/false (false)]" << std::endl;
+    std::cout << "\t" << "-coarseToFine [CCOEFF_NORM search stride, above 1 the best offsets of the strided grid are refined and offsets below the threshold are abandoned early (1)]" << std::endl;
+    std::cout << "\t" << "-localShiftPriors [search the chips of a finer pyramid level around the shifts of the nearby coarser GCPs, with a search window sized to their spread true/false (true)]" << std::endl;
+    std::cout << "\t" << "-timing [path to a JSON report of the stage timings and counters, written at exit]" << std::endl;
+    std::cout << "\t" << "-trace [path to a Chrome trace JSON timeline of the thread activity, written at exit]" << std::endl;
+    std::cout << "\t" << "-co_w [GeoTIFF save options for working directory images (COMPRESS=NONE)]" << std::endl;
+    std::cout << "\t" << "-co_o [GeoTIFF save options for output images (COMPRESS=NONE)]" << std::endl;
     std::cout << std::endl;
     std::cout << "Note:" << std::endl;
     std::cout << "\t'-b_p' and '-m_p' do not need to be specified, these are only used if you wish to override" << std::endl;
     std::cout << "\tthe detected Proj4 projection strings" << std::endl;
     std::cout << std::endl;
+    std::cout << "GeoTIFF save options:" << std::endl;
+    std::cout << "  Comma separated KEY=VALUE list, valid keys are" << std::endl;
+    std::cout << "  COMPRESS=NONE/DEFLATE/ZSTD/LZW" << std::endl;
+    std::cout << "  PREDICTOR=NONE/HORIZONTAL/FLOATING_POINT/AUTO" << std::endl;
+    std::cout << "  LEVEL=<compression level>" << std::endl;
+    std::cout << "  TILED=YES/NO" << std::endl;
+    std::cout << "  BLOCKSIZE=<tile size, multiple of 16>" << std::endl;
+    std::cout << "  BIGTIFF=NO/YES/IF_NEEDED/IF_SAFER" << std::endl;
+    std::cout << "  NUM_THREADS=<compression thread count>/ALL_CPUS" << std::endl;
+    std::cout << "  Example:" << std::endl;
+    std::cout << "  -co_w COMPRESS=ZSTD,PREDICTOR=AUTO,TILED=YES,BLOCKSIZE=512,BIGTIFF=IF_SAFER,NUM_THREADS=4" << std::endl;
+    std::cout << std::endl;
     std::cout << "fixed-chip-location structure:" << std::endl;
     std::cout << "  Is a plain text file on which each line must contain a latitude,longitude decimal degrees pair in WGS84" << std::endl;
     std::cout << "  Example:" << std::endl;
@@ -17,10 +17,14 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 
 #include <ul_Vector.h>
 #include <ul_ChipsGen.h>
 #include <ul_Resampler.h>
+#include <ul_ImageSaveOptions.h>
+#include <ul_GcpResultSink.h>
+#include <ul_DigitalImageCorrelator.h>
 
 struct SArgs
 {
@@ -48,8 +52,14 @@ public:
 
     unsigned int threadCount;
     unsigned long chipGenerationGridSize;
+    unsigned long maxFeaturesPerCell;
     double correlationThreshold;
+    double duplicateGcpTolerance;
     bool usePhaseCorrelation;
+    ultra::ECorrelationPrecision correlationPrecision;
+    bool validatePrecision;
+    unsigned long coarseToFineStride;
+    bool localShiftPriors;
     std::string logPath;
     std::string outputPath;
     unsigned long chipSize;
@@ -60,6 +70,11 @@ public:
     bool mayContainNullValues;
     bool saveTiff;
     bool saveUnion;
+    std::vector<ultra::EGcpResultFormat::EFormatType> resultFormats;
+    std::string timingReportPath;
+    std::string traceReportPath;
+    ultra::SImageSaveOptions workingSaveOptions;
+    ultra::SImageSaveOptions outputSaveOptions;
 
     friend std::ostream &operator<<(std::ostream &stream, const SArgs & o);
 
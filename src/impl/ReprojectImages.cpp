@@ -20,9 +20,11 @@
 #include <ul_ImageLoader.h>
 #include <ul_ImageSaver.h>
 #include <ul_Reproject.h>
+#include <ul_Profiler.h>
 
 int ReprojectImages(SArgs &args)
 {
+    ULTRA_SCOPED_TIMER("ReprojectImages");
     ultra::SImageMetadata refMeta, inMeta, inBackMeta;
 
     if (ultra::CImageLoader::getInstance()->LoadImageMetadata(args.referenceImage.pathToImage, refMeta) != 0 ||
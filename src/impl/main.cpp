@@ -19,23 +19,14 @@
 #include "GenerateResults.h"
 #include "ReprojectImages.h"
 
+#include <ul_Profiler.h>
+
 static std::string VERSION = "0.25e";
 
-int main(int argc, char **argv)
+static int Run(SArgs &args)
 {
-    ultra::CLogger::getInstance()->setLogLevel(ultra::CLogger::LOG_INFO);
-    ultra::CLogger::getInstance()->LogLogLevels();
-    SArgs args;
     ultra::CVector<ultra::SChipCorrelationResult> result;
 
-    if (ParseInput(argc, argv, args) != 0)
-    {
-        showHelp(argc, argv);
-        return 1;
-    }
-    ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_INFO, "Version " + VERSION);
-    ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_INFO, "Arguments\n" + ultra::toString(args) + "\n\n");
-
     if (ReprojectImages(args) != 0)
     {
         ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned from ReprojectImages()");
@@ -56,3 +47,47 @@ int main(int argc, char **argv)
 
     return 0;
 }
+
+int main(int argc, char **argv)
+{
+    ultra::CLogger::getInstance()->setLogLevel(ultra::CLogger::LOG_INFO);
+    ultra::CLogger::getInstance()->LogLogLevels();
+    SArgs args;
+
+    if (ParseInput(argc, argv, args) != 0)
+    {
+        showHelp(argc, argv);
+        return 1;
+    }
+    ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_INFO, "Version " + VERSION);
+    ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_INFO, "Arguments\n" + ultra::toString(args) + "\n\n");
+
+    if (args.traceReportPath != "")
+    {
+        ultra::CTracer::getInstance()->Enable();
+        ultra::CTracer::getInstance()->SetThreadName("main");
+    }
+
+    int ret = Run(args);
+
+    // written on failures too, the stages that did run are often what is of interest
+    if (args.timingReportPath != "")
+    {
+        if (ultra::CProfiler::getInstance()->SaveJson(args.timingReportPath) != 0)
+        {
+            ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned from CProfiler::SaveJson()");
+            ret = 1;
+        }
+    }
+    if (args.traceReportPath != "")
+    {
+        ultra::CTracer::getInstance()->Disable();
+        if (ultra::CTracer::getInstance()->SaveJson(args.traceReportPath) != 0)
+        {
+            ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned from CTracer::SaveJson()");
+            ret = 1;
+        }
+    }
+
+    return ret;
+}
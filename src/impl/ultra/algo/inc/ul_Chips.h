@@ -59,10 +59,16 @@ public:
     SPair<double> midCoordinate;
     CMatrix<T> chipData;
     CMatrix<SPair<double> > worldMatrix;
+    // expected shift (in input pixels) of the GCP found for the chip, the search window is centred on it
+    SPair<double> searchShiftPrior;
+    // extra search range (in input pixels) around the chip, 0 uses that of the correlator
+    unsigned long searchWindowSize;
 
     CChip()
     {
         chipType = "BASE_CHIP_TYPE";
+        searchShiftPrior = 0;
+        searchWindowSize = 0;
     }
 
     CChip(const CChip<T> &r)
@@ -74,6 +80,8 @@ public:
         midCoordinate = r.midCoordinate;
         chipData = r.chipData;
         worldMatrix = r.worldMatrix;
+        searchShiftPrior = r.searchShiftPrior;
+        searchWindowSize = r.searchWindowSize;
     }
 
     virtual ~CChip()
@@ -91,6 +99,8 @@ public:
         midCoordinate = r.midCoordinate;
         chipData = r.chipData;
         worldMatrix = r.worldMatrix;
+        searchShiftPrior = r.searchShiftPrior;
+        searchWindowSize = r.searchWindowSize;
 
         return *this;
     }
@@ -102,7 +112,8 @@ public:
         return chipType == r.chipType && chipId == r.chipId &&
                 boundingCoordinate[0] == r.boundingCoordinate[0] && boundingCoordinate[1] == r.boundingCoordinate[1]
                 && boundingCoordinate[2] == r.boundingCoordinate[2] && boundingCoordinate[3] == r.boundingCoordinate[3] &&
-                midCoordinate == r.midCoordinate && chipData == r.chipData && worldMatrix == r.worldMatrix;
+                midCoordinate == r.midCoordinate && chipData == r.chipData && worldMatrix == r.worldMatrix &&
+                searchShiftPrior == r.searchShiftPrior && searchWindowSize == r.searchWindowSize;
     }
 };
 
@@ -19,6 +19,8 @@
 #include "ul_Chips.h"
 #include "ul_UltraThread.h"
 
+#include <functional>
+
 namespace ultra
 {
 
@@ -26,6 +28,10 @@ template<class T>
 class CChipsGen : public IRunnable
 {
 public:
+    /**
+     * Receives every chip the moment it is generated, a non zero return stops the generator
+     */
+    typedef std::function<int(const CChip<T> &chip) > ChipSink;
 
     class CChipsGenContext
     {
@@ -47,12 +53,19 @@ public:
         unsigned int threadCount;
         int errorCode;
         unsigned long gridSize;
+        /**
+         * Feature driven generators (Harris, Sobel) keep at most this many of the strongest
+         * features per <code>gridSize</code> cell, zero (or a zero grid size) keeps all of them
+         */
+        unsigned long maxFeaturesPerCell;
 
         CChipsGenContext() :
         m_ultraSChipsGenContextLock(new CThreadLock())
         {
             threadCount = 1;
             errorCode = 0;
+            gridSize = 0;
+            maxFeaturesPerCell = 0;
         }
 
         virtual ~CChipsGenContext()
@@ -62,6 +75,7 @@ public:
 
 private:
     std::string m_chipGenName;
+    ChipSink m_chipSink;
 
     int CheckContext()
     {
@@ -104,6 +118,28 @@ protected:
     virtual int SplitImagesForThreads() = 0;
     virtual int innerGenerate(CChipsGen<T>::CChipsGenContext *context = nullptr) = 0;
 
+    /**
+     * Hands a generated chip to the sink, or appends it to the output chips if no sink is set
+     * @param chip
+     * @return 0 on success
+     */
+    int EmitChip(const CChip<T> &chip)
+    {
+        if (!m_chipSink)
+        {
+            this->m_outputChips->pushBack(chip);
+            return 0;
+        }
+
+        if (m_chipSink(chip) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from the chip sink");
+            return 1;
+        }
+
+        return 0;
+    }
+
 public:
 
     CChipsGen(std::string chipsGenName = "Base_ChipsGen") :
@@ -126,6 +162,15 @@ public:
         return m_chipGenName;
     }
 
+    /**
+     * Chips are handed to the sink as they are generated instead of being collected in the output chips
+     * @param sink
+     */
+    void setChipSink(const ChipSink &sink)
+    {
+        m_chipSink = sink;
+    }
+
     int LoadData(const CMatrix<T> *inputImage, CVector< CChip<T> > *chips)
     {
         if (inputImage == nullptr)
@@ -16,14 +16,31 @@
 
 #pragma once
 
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include <ul_UltraThreadFixedPool.h>
 #include "ul_CreateConvKernel.h"
 
 namespace ultra
 {
 
+/**
+ * Convolves images with a kernel. Separable floating point kernels (Gaussian, Sobel, box)
+ * are applied as a horizontal and a vertical 1-D pass over zero padded scratch rows, so
+ * the inner loops carry no bounds or no-data checks, large images are split into row
+ * bands that are convolved in parallel. Other kernels use the direct 2-D convolution.
+ */
 class CConvKernelToImage
 {
 private:
+    /**
+     * Images smaller than this are convolved on the calling thread
+     */
+    static const unsigned long PARALLEL_MIN_PIXELS = 512 * 512;
+    static const unsigned long MIN_BAND_ROWS = 64;
 
     template<class T>
     static int Init(const CMatrix<T> &input, const CConvKernel<T> &kernel, CMatrix<T> &output)
@@ -54,6 +71,260 @@ private:
         return 0;
     }
 
+    /**
+     * Splits the kernel into kernel[r][c] = colTaps[r] * rowTaps[c]
+     * @return false if the kernel is not separable (or not a floating point kernel)
+     */
+    template<class T>
+    static bool SplitSeparable(const CConvKernel<T> &kernel, std::vector<T> &colTaps, std::vector<T> &rowTaps)
+    {
+        if (!std::is_floating_point<T>::value)
+            return false;
+
+        long kr_Size = (long) kernel.getSize().row;
+        long kc_Size = (long) kernel.getSize().col;
+        long pivotRow = 0;
+        long pivotCol = 0;
+        T maxTap = 0;
+        for (long kr = 0; kr < kr_Size; kr++)
+        {
+            for (long kc = 0; kc < kc_Size; kc++)
+            {
+                if (getAbs(kernel[kr][kc]) > maxTap)
+                {
+                    maxTap = getAbs(kernel[kr][kc]);
+                    pivotRow = kr;
+                    pivotCol = kc;
+                }
+            }
+        }
+        if (maxTap == 0)
+            return false;
+
+        colTaps.resize(kr_Size);
+        rowTaps.resize(kc_Size);
+        for (long kr = 0; kr < kr_Size; kr++)
+            colTaps[kr] = kernel[kr][pivotCol];
+        for (long kc = 0; kc < kc_Size; kc++)
+            rowTaps[kc] = kernel[pivotRow][kc] / kernel[pivotRow][pivotCol];
+
+        T tolerance = maxTap * std::numeric_limits<T>::epsilon() * 64;
+        for (long kr = 0; kr < kr_Size; kr++)
+        {
+            for (long kc = 0; kc < kc_Size; kc++)
+            {
+                if (getAbs(kernel[kr][kc] - colTaps[kr] * rowTaps[kc]) > tolerance)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Convolves output rows [rowStart, rowEnd) with a separable kernel, follows the same rules
+     * as the direct convolution: taps outside the image or on no-data are skipped and the
+     * normalization uses the sum of the taps that were used.
+     * @return true if a zero kernel sum prevented normalization
+     */
+    template<class T>
+    static bool ConvolveSeparableRows(const CMatrix<T> &input, const std::vector<T> &colTaps, const std::vector<T> &rowTaps, SSize anchor,
+                                      CMatrix<T> &output, bool normalizeKernel, const T *nodata, bool onlyOverValidData, long rowStart, long rowEnd)
+    {
+        long kr_Size = (long) colTaps.size();
+        long kc_Size = (long) rowTaps.size();
+        long r_Size = (long) input.getSize().row;
+        long c_Size = (long) input.getSize().col;
+        long padTop = kr_Size - 1 - (long) anchor.row;
+        long padLeft = kc_Size - 1 - (long) anchor.col;
+        long lineSize = c_Size + kc_Size - 1;
+        long hRows = rowEnd - rowStart + kr_Size - 1;
+        bool masked = nodata != nullptr;
+        T fullCount = T(kr_Size * kc_Size);
+
+        // flipped so that both passes are plain correlations over the padded rows
+        std::vector<T> hTaps(kc_Size);
+        std::vector<T> vTaps(kr_Size);
+        for (long j = 0; j < kc_Size; j++)
+            hTaps[j] = rowTaps[kc_Size - 1 - j];
+        for (long i = 0; i < kr_Size; i++)
+            vTaps[i] = colTaps[kr_Size - 1 - i];
+
+        std::vector<T> line(lineSize, T(0));
+        std::vector<T> maskLine(masked ? lineSize : 0, T(0));
+        std::vector<T> hData(hRows * c_Size, T(0));
+        std::vector<T> hWeight(masked ? hRows * c_Size : 0, T(0));
+        std::vector<T> hCount(masked ? hRows * c_Size : 0, T(0));
+
+        // horizontal pass, rows outside the image stay zero
+        for (long h = 0; h < hRows; h++)
+        {
+            long rr = rowStart + h - padTop;
+            if (rr < 0 || rr >= r_Size)
+                continue;
+
+            const T *in = input[rr].getDataPointer();
+            if (!masked)
+            {
+                std::copy(in, in + c_Size, line.begin() + padLeft);
+            }
+            else
+            {
+                for (long c = 0; c < c_Size; c++)
+                {
+                    bool valid = in[c] != *nodata;
+                    line[padLeft + c] = valid ? in[c] : T(0);
+                    maskLine[padLeft + c] = valid ? T(1) : T(0);
+                }
+            }
+
+            T *hd = &hData[h * c_Size];
+            for (long j = 0; j < kc_Size; j++)
+            {
+                T tap = hTaps[j];
+                const T *src = &line[j];
+                for (long c = 0; c < c_Size; c++)
+                    hd[c] += src[c] * tap;
+            }
+
+            if (masked)
+            {
+                T *hw = &hWeight[h * c_Size];
+                T *hc = &hCount[h * c_Size];
+                for (long j = 0; j < kc_Size; j++)
+                {
+                    T tap = hTaps[j];
+                    const T *src = &maskLine[j];
+                    for (long c = 0; c < c_Size; c++)
+                    {
+                        hw[c] += src[c] * tap;
+                        hc[c] += src[c];
+                    }
+                }
+            }
+        }
+
+        // without no-data the used taps only depend on the image borders
+        std::vector<T> colWeight(c_Size, T(0));
+        std::vector<T> colCount(c_Size, T(0));
+        if (!masked)
+        {
+            for (long c = 0; c < c_Size; c++)
+            {
+                for (long j = 0; j < kc_Size; j++)
+                {
+                    long cc = c + j - padLeft;
+                    if (cc >= 0 && cc < c_Size)
+                    {
+                        colWeight[c] += hTaps[j];
+                        colCount[c] += T(1);
+                    }
+                }
+            }
+        }
+
+        bool zeroKernelSum = false;
+        std::vector<T> acc(c_Size);
+        std::vector<T> accWeight(masked ? c_Size : 0);
+        std::vector<T> accCount(masked ? c_Size : 0);
+        for (long r = rowStart; r < rowEnd; r++)
+        {
+            std::fill(acc.begin(), acc.end(), T(0));
+            std::fill(accWeight.begin(), accWeight.end(), T(0));
+            std::fill(accCount.begin(), accCount.end(), T(0));
+            T rowWeight = 0;
+            T rowCount = 0;
+            for (long i = 0; i < kr_Size; i++)
+            {
+                long h = r - rowStart + i;
+                T tap = vTaps[i];
+                const T *src = &hData[h * c_Size];
+                for (long c = 0; c < c_Size; c++)
+                    acc[c] += src[c] * tap;
+
+                if (masked)
+                {
+                    const T *srcWeight = &hWeight[h * c_Size];
+                    const T *srcCount = &hCount[h * c_Size];
+                    for (long c = 0; c < c_Size; c++)
+                    {
+                        accWeight[c] += srcWeight[c] * tap;
+                        accCount[c] += srcCount[c];
+                    }
+                }
+                else
+                {
+                    long rr = h + rowStart - padTop;
+                    if (rr >= 0 && rr < r_Size)
+                    {
+                        rowWeight += tap;
+                        rowCount += T(1);
+                    }
+                }
+            }
+
+            T *out = output[r].getDataPointer();
+            for (long c = 0; c < c_Size; c++)
+            {
+                T count = masked ? accCount[c] : rowCount * colCount[c];
+                if (count < T(0.5) || (onlyOverValidData && count < fullCount - T(0.5)))
+                {
+                    if (nodata != nullptr)
+                        out[c] = *nodata;
+                    continue;
+                }
+
+                if (!normalizeKernel)
+                {
+                    out[c] = acc[c];
+                    continue;
+                }
+
+                T kernelSum = masked ? accWeight[c] : rowWeight * colWeight[c];
+                if (getAbs(kernelSum) < std::numeric_limits<T>::epsilon())
+                {
+                    zeroKernelSum = true;
+                    out[c] = acc[c];
+                }
+                else
+                {
+                    out[c] = acc[c] / kernelSum;
+                }
+            }
+        }
+
+        return zeroKernelSum;
+    }
+
+    template<class T>
+    static int executeSeparable(const CMatrix<T> &input, const std::vector<T> &colTaps, const std::vector<T> &rowTaps, SSize anchor,
+                                CMatrix<T> &output, bool normalizeKernel, const T *nodata, bool onlyOverValidData, bool useLogger)
+    {
+        long r_Size = (long) input.getSize().row;
+        unsigned long bandCount = 1;
+        if (input.getSize().getProduct() >= PARALLEL_MIN_PIXELS)
+            bandCount = getMAX(1UL, getMIN(AUltraThreadPool::getDefaultPoolSize(), (unsigned long) r_Size / MIN_BAND_ROWS));
+
+        std::atomic<bool> zeroKernelSum(false);
+        std::function<void(unsigned long, unsigned long) > band = [&](unsigned long rowStart, unsigned long rowEnd)
+        {
+            if (ConvolveSeparableRows(input, colTaps, rowTaps, anchor, output, normalizeKernel, nodata, onlyOverValidData, (long) rowStart, (long) rowEnd))
+                zeroKernelSum = true;
+        };
+        if (CUltraThreadFixedPool::RunBands((unsigned long) r_Size, bandCount, band) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunBands()");
+            return 1;
+        }
+
+        if (useLogger)
+        {
+            if (zeroKernelSum)
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "Kernel sum is less than epsilon");
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "100%   ");
+        }
+        return 0;
+    }
+
     template<class T>
     static int execute(const CMatrix<T> &input, const CConvKernel<T> &kernel, CMatrix<T> &output, bool normalizeKernel, const T *nodata, bool onlyOverValidData, bool useLogger)
     {
@@ -70,6 +341,22 @@ private:
             return 1;
         }
 
+        std::vector<T> colTaps;
+        std::vector<T> rowTaps;
+        if (SplitSeparable(kernel, colTaps, rowTaps))
+        {
+            if (executeSeparable(input, colTaps, rowTaps, kernel.getAnchor(), *outputPtr, normalizeKernel, nodata, onlyOverValidData, useLogger) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from executeSeparable()");
+                return 1;
+            }
+            if (&input == &output)
+            {
+                output = temp;
+            }
+            return 0;
+        }
+
         long ar_Size = (long) kernel.getAnchor().row;
         long ac_Size = (long) kernel.getAnchor().col;
         long kr_Size = (long) kernel.getSize().row;
@@ -173,7 +460,7 @@ endLoop:
                 if (per != (int) ((r * 100) / input.getSize().row + 1))
                 {
                     per = (int) ((r * 100) / input.getSize().row + 1);
-                    CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, toString(per) + "%     \r");
+                    ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, toString(per) + "%     \r");
                 }
             }
         }
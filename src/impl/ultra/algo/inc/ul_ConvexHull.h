@@ -19,6 +19,7 @@
 #include <ul_Vector.h>
 #include <ul_Size.h>
 #include <ul_KeyValue.h>
+#include <vector>
 
 namespace ultra
 {
@@ -27,19 +28,18 @@ class CConvexHull
 {
 private:
     static bool sortFunction(const SKeyValue<unsigned long, SSize> &l, const SKeyValue<unsigned long, SSize> &r);
-    static int sortFunctionVoid(const void *ll, const void *rr);
-    static bool hullFuncCompFuncTop(float a1, float a2);
-    static bool hullFuncCompFuncBot(float a1, float a2);
-
-    void hullFunc(
-                  const CVector<SKeyValue<unsigned long, SSize> > &pts,
-                  std::vector<SKeyValue<unsigned long, SSize> > &topBot,
-                  bool (*func)(float, float)
-                  ) const;
+    static long cross(const SSize &o, const SSize &a, const SSize &b);
 public:
     CConvexHull();
     virtual ~CConvexHull();
 
+    /**
+     * Andrew's monotone chain, O(n log n)
+     * @param points
+     * @param hullSequence indexes into points of the hull vertices, collinear points are dropped
+     * and the first index is repeated at the end to close the hull
+     * @return 0 on success
+     */
     int GenerateHullPoint(const CVector<SSize> &points, CVector<unsigned long> &hullSequence) const;
 };
 
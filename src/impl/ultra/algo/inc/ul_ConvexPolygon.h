@@ -0,0 +1,71 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include <vector>
+#include <ul_Vector.h>
+#include <ul_Size.h>
+#include <ul_Pair.h>
+
+namespace ultra
+{
+
+/**
+ * A convex polygon in (row, col) coordinates, built as the convex hull of a point set.
+ * <br>
+ * The vertices are kept counter-clockwise (col to the right, row up), the inside
+ * of every edge is on its left.
+ */
+class CConvexPolygon
+{
+private:
+    std::vector<SPair<double> > m_vertices;
+
+    static double cross(const SPair<double> &o, const SPair<double> &a, const SPair<double> &b);
+    static void ClipHalfPlane(
+                              const std::vector<SPair<double> > &polygon,
+                              const SPair<double> &a, const SPair<double> &b,
+                              double distance,
+                              std::vector<SPair<double> > &clipped
+                              );
+public:
+    CConvexPolygon();
+    virtual ~CConvexPolygon();
+
+    /**
+     * Replaces the polygon with the convex hull of the points, fewer than three
+     * non collinear points give an empty polygon
+     * @param points
+     * @return 0 on success
+     */
+    int Generate(const CVector<SSize> &points);
+    /**
+     * Moves every edge inwards by distance, the polygon becomes empty if nothing is left
+     * @param distance
+     */
+    void Erode(double distance);
+    /**
+     * @param point
+     * @return true if the point is inside or on the boundary
+     */
+    bool contains(const SPair<double> &point) const;
+    bool isEmpty() const;
+    void clear();
+    const std::vector<SPair<double> > &getVertices() const;
+};
+
+} // namespace ultra
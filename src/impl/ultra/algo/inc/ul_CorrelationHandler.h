@@ -20,7 +20,8 @@
 #include "ul_DigitalImageCorrelator.h"
 #include <ul_Pair.h>
 #include <ul_UltraThread.h>
-#include <ul_AtomicLong.h>
+#include <ul_CountDownLatch.h>
+#include <ul_BoundedQueue.h>
 
 namespace ultra
 {
@@ -37,15 +38,25 @@ private:
     ECorrelationType m_correlationMethod;
 
     CVector<CVector<CChip<float> > > m_inputChips;
+    CBoundedQueue<CChip<float> > *m_chipQueue;
     CVector<CVector<SChipCorrelationResult> > m_results;
     unsigned int m_maxThreads;
     bool m_canStart;
     float m_correlationThreshold;
-    CAtomicLong m_atLong;
+    CCountDownLatch m_completedLatch;
 
     int Init(const CVector<CChip<float> > &inputChips);
+    int InitQueued();
+    int innerLoadData(
+                      const CMatrix<float> &inputImage,
+                      const CMatrix<SPair<double> > &worldMatrix,
+                      const SPair<double> &pixelGroundSamplingDistance,
+                      unsigned long searchWindowSize,
+                      const SPair<double> &originChipToInputDiv,
+                      ECorrelationType correlationMethod
+                      );
     int cleanup();
-    int StartThreads(std::shared_ptr<CThreadLock> lock);
+    int StartThreads();
 
     bool m_useNullValue;
     float m_nullValue;
@@ -64,8 +75,29 @@ public:
                  const SPair<double> &originChipToInputDiv,
                  ECorrelationType correlationMethod = ECorrelationType::CCOEFF_NORM
                  );
-    int Correlate(std::shared_ptr<CThreadLock> lock);
+    /**
+     * The correlation threads pop chips from the queue as they are produced, the queue
+     * must be closed once the last chip was pushed and must outlive this object.
+     * The results are not in the order the chips were pushed, use the chip IDs
+     * to match them up
+     * @return 0 on success
+     */
+    int LoadData(
+                 const CMatrix<float> &inputImage,
+                 CBoundedQueue<CChip<float> > *chipQueue,
+                 const CMatrix<SPair<double> > &worldMatrix,
+                 const SPair<double> &pixelGroundSamplingDistance,
+                 unsigned long searchWindowSize,
+                 const SPair<double> &originChipToInputDiv,
+                 ECorrelationType correlationMethod = ECorrelationType::CCOEFF_NORM
+                 );
+    int Correlate();
     bool isBusy();
+    /**
+     * Blocks until all the correlation threads completed
+     * @return 0 on success
+     */
+    int WaitForCompletion();
     int GetResults(CVector<SChipCorrelationResult> &results);
 };
 
@@ -18,6 +18,7 @@
 
 
 #include <ul_Matrix.h>
+#include <ul_ScratchMatrix.h>
 #include <ul_Complex.h>
 #include <ul_UltraThread.h>
 
@@ -46,12 +47,38 @@ protected:
 
     virtual void forwardImpl(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMatrix<SComplex<MY_WORKING_TYPE> > &output) const = 0;
     virtual void inverseImpl(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMatrix<SComplex<MY_WORKING_TYPE> > &output) const = 0;
+    virtual void forwardImpl(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const = 0;
+    virtual void inverseImpl(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const = 0;
+    virtual void forwardImpl(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const = 0;
+    virtual void inverseImpl(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const = 0;
     
     void forwardWt(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMatrix<SComplex<MY_WORKING_TYPE> > &output) const;
     void inverseWt(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMatrix<SComplex<MY_WORKING_TYPE> > &output) const;
 public:
+    /**
+     * Largest row or column count transformed in single precision, the round-off of a
+     * float FFT grows with log2 of the size and stays well below the phase correlation
+     * peak up to this size
+     */
+    static const unsigned long SINGLE_PRECISION_MAX_SIZE;
+
     virtual ~ADftBase2d();
 
+    /**
+     * @param size
+     * @return true if a transform of this size may be done in single precision
+     */
+    static bool isSinglePrecisionSafe(const SSize &size);
+
+    /**
+     * Transforms matrices in the scratch arena of the calling thread, no heap allocations are made.
+     * The output must already be allocated to the transform size.
+     */
+    void forward(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const;
+    void inverse(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const;
+    void forward(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const;
+    void inverse(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const;
+
     template<class T>
     void forward(const CMatrix<SComplex<T> > &input, CMatrix<SComplex<T> > &output) const
     {
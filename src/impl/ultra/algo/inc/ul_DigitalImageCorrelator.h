@@ -35,6 +35,44 @@ enum class ESubPixelCorrelationType
     SUB_PIXEL_CORRELATION_TYPE_COUNT
 };
 
+/**
+ * Arithmetic precision of the correlation kernels, the reduced precisions are validated against HIGH.
+ * FLOAT speeds up phase correlation through the float FFTs, the coef-norm accumulation loops are
+ * serial sums that do not vectorize without reassociation so coef-norm runs at about the speed of HIGH.
+ */
+enum class ECorrelationPrecision
+{
+    HIGH = 0, // long double integral images, double accumulators and FFTs
+    DOUBLE, // double integral images, double accumulators and FFTs
+    FLOAT, // compensated float integral images, float accumulators, float FFTs where ADftBase2d::isSinglePrecisionSafe()
+    CORRELATION_PRECISION_COUNT
+};
+
+/**
+ * Coarse to fine search of a CCOEFF_NORM correlation surface. Every stride-th offset is
+ * evaluated first and the neighbourhoods of the best ones are refined, the remaining offsets
+ * are then abandoned as soon as an upper bound of their coefficient falls below threshold or
+ * below the best coefficient found so far, so the peak is the one of the exhaustive search.
+ * Only the peak of such a surface and its eight neighbours are guaranteed to hold exact
+ * coefficients, abandoned offsets hold their upper bound.
+ */
+struct SCoarseToFineSearch
+{
+    unsigned long stride; // 0 or 1 evaluates every offset
+    double threshold;
+
+    SCoarseToFineSearch(unsigned long stride = 1, double threshold = -1) :
+    stride(stride),
+    threshold(threshold)
+    {
+    }
+
+    bool isExhaustive() const
+    {
+        return stride <= 1;
+    }
+};
+
 class CCorrelationHelper
 {
 public:
@@ -42,6 +80,13 @@ public:
     ~CCorrelationHelper() = delete;
     static std::string typeToStr(ECorrelationType type);
     static std::string typeToStr(ESubPixelCorrelationType type);
+    static std::string typeToStr(ECorrelationPrecision precision);
+    /**
+     * @param str HIGH, DOUBLE or FLOAT, case insensitive
+     * @param precision
+     * @return 0 on success
+     */
+    static int strToType(const std::string &str, ECorrelationPrecision &precision);
 };
 
 template<class T>
@@ -49,10 +94,17 @@ class ADigitalImageCorrelator
 {
 protected:
     const SSize m_inputSize;
+    const CMatrix<T> *m_region;
+    bool m_regionHasNoData;
+    T m_regionNoData;
+    CMatrix<T> m_regionWindow;
 public:
 
     ADigitalImageCorrelator(const SSize &inputSize) :
-    m_inputSize(inputSize)
+    m_inputSize(inputSize),
+    m_region(nullptr),
+    m_regionHasNoData(false),
+    m_regionNoData()
     {
     }
 
@@ -64,6 +116,58 @@ public:
                            const T *refNoData = nullptr, const T *inputNoData = nullptr) const = 0;
     virtual void correlate(const CMatrix<SComplex<T> > &reference, const CMatrix<SComplex<T> > &input, CMatrix<double> &output,
                            const SComplex<T> *refNoData = nullptr, const SComplex<T> *inputNoData = nullptr) const = 0;
+
+    /**
+     * Sets a reference region that several inputs are correlated in with correlateInRegion(),
+     * correlators that can share work between the inputs (coef-norm) prepare it once here.
+     * The region must stay valid until the next call.
+     * @param region
+     * @param regionNoData
+     * @param inputSize the size of the inputs that will be correlated in the region
+     */
+    virtual void setSearchRegion(const CMatrix<T> &region, const T *regionNoData, const SSize &)
+    {
+        m_region = &region;
+        m_regionHasNoData = regionNoData != nullptr;
+        if (m_regionHasNoData)
+            m_regionNoData = *regionNoData;
+    }
+
+    /**
+     * Correlates with the window of referenceSize at ul of the search region as the reference
+     * @param ul
+     * @param referenceSize
+     * @param input
+     * @param output
+     * @param inputNoData
+     * @param search
+     */
+    virtual void correlateInRegion(const SSize &ul, const SSize &referenceSize, const CMatrix<T> &input, CMatrix<double> &output,
+                                   const T *inputNoData = nullptr, const SCoarseToFineSearch &search = SCoarseToFineSearch())
+    {
+        if (m_region == nullptr)
+            throw CException(__FILE__, __LINE__, "No search region has been set");
+        if (m_region->getSubMatrix(ul, referenceSize, m_regionWindow) != 0)
+            throw CException(__FILE__, __LINE__, "Window of size " + toString(referenceSize) + " at " + toString(ul) + " is outside of the search region");
+        correlateCoarseToFine(m_regionWindow, input, output, search, m_regionHasNoData ? &m_regionNoData : nullptr, inputNoData);
+    }
+
+    /**
+     * Same as correlate() but searches the surface coarse to fine, see SCoarseToFineSearch.
+     * Correlators that do not support it evaluate every offset.
+     */
+    virtual void correlateCoarseToFine(const CMatrix<T> &reference, const CMatrix<T> &input, CMatrix<double> &output,
+                                       const SCoarseToFineSearch &, const T *refNoData = nullptr, const T *inputNoData = nullptr) const
+    {
+        correlate(reference, input, output, refNoData, inputNoData);
+    }
+
+    virtual void correlateCoarseToFine(const CMatrix<SComplex<T> > &reference, const CMatrix<SComplex<T> > &input, CMatrix<double> &output,
+                                       const SCoarseToFineSearch &,
+                                       const SComplex<T> *refNoData = nullptr, const SComplex<T> *inputNoData = nullptr) const
+    {
+        correlate(reference, input, output, refNoData, inputNoData);
+    }
 };
 
 namespace __ultra_internal
@@ -75,65 +179,81 @@ namespace correlate_phase
 class CPhaseCorrelatorImpl
 {
 private:
-    void correlateComplexWt(CDft2d *fftOp, const CMatrix<SComplex<ADftBase2d::MY_WORKING_TYPE> > &reference,
-                            const CMatrix<SComplex<ADftBase2d::MY_WORKING_TYPE> > &input, CMatrix<double> &output,
-                            const SComplex<ADftBase2d::MY_WORKING_TYPE> *refNoData, const SComplex<ADftBase2d::MY_WORKING_TYPE> *inputNoData) const;
-public:
-    CPhaseCorrelatorImpl();
-    virtual ~CPhaseCorrelatorImpl();
+    ECorrelationPrecision m_precision;
 
-    template<class T>
-    void correlateNormal(CDft2d *fftOp, const CMatrix<T> &reference, const CMatrix<T> &input, CMatrix<double> &output,
-                         const T *refNoData, const T *inputNoData) const
+    template<class W, class N>
+    static SComplex<W> toWorkingType(const N &v)
     {
-        auto fp = [](const T & v)->SComplex<ADftBase2d::MY_WORKING_TYPE>
+        return SComplex<W>(v, 0);
+    }
+
+    template<class W, class N>
+    static SComplex<W> toWorkingType(const SComplex<N> &v)
+    {
+        return v.template convertType<W>();
+    }
+
+    template<class W>
+    void correlateComplexWt(CScratchArena *arena, CDft2d *fftOp, const CScratchMatrix<SComplex<W> > &reference,
+                            const CScratchMatrix<SComplex<W> > &input, CMatrix<double> &output,
+                            const SComplex<W> *refNoData, const SComplex<W> *inputNoData) const;
+
+    template<class W, class N>
+    void convertAndCorrelate(CDft2d *fftOp, const CMatrix<N> &reference, const CMatrix<N> &input, CMatrix<double> &output,
+                             const N *refNoData, const N *inputNoData) const
+    {
+        auto fp = [](const N & v)->SComplex<W>
         {
-            return SComplex<ADftBase2d::MY_WORKING_TYPE>(v, 0);
+            return toWorkingType<W>(v);
         };
-        auto nRef = reference.template map<SComplex<ADftBase2d::MY_WORKING_TYPE> > (fp);
-        auto nIn = input.template map<SComplex<ADftBase2d::MY_WORKING_TYPE> > (fp);
-        SComplex<ADftBase2d::MY_WORKING_TYPE> nRefNd;
-        SComplex<ADftBase2d::MY_WORKING_TYPE> *nRefNdPtr = nullptr;
+        CScratchArenaScope scope;
+        CScratchMatrix<SComplex<W> > nRef(scope.getArena(), reference.getSize());
+        CScratchMatrix<SComplex<W> > nIn(scope.getArena(), input.getSize());
+        nRef.assign(reference, fp);
+        nIn.assign(input, fp);
+        SComplex<W> nRefNd;
+        SComplex<W> *nRefNdPtr = nullptr;
         if (refNoData != nullptr)
         {
             nRefNd = fp(*refNoData);
             nRefNdPtr = &nRefNd;
         }
-        SComplex<ADftBase2d::MY_WORKING_TYPE> nInNd;
-        SComplex<ADftBase2d::MY_WORKING_TYPE> *nInNdPtr = nullptr;
+        SComplex<W> nInNd;
+        SComplex<W> *nInNdPtr = nullptr;
         if (inputNoData != nullptr)
         {
             nInNd = fp(*inputNoData);
             nInNdPtr = &nInNd;
         }
-        correlateComplexWt(fftOp, nRef, nIn, output, nRefNdPtr, nInNdPtr);
+        correlateComplexWt<W>(scope.getArena(), fftOp, nRef, nIn, output, nRefNdPtr, nInNdPtr);
+    }
+
+    bool useSinglePrecision(const SSize &size) const
+    {
+        return m_precision == ECorrelationPrecision::FLOAT && ADftBase2d::isSinglePrecisionSafe(size);
+    }
+public:
+    CPhaseCorrelatorImpl(ECorrelationPrecision precision = ECorrelationPrecision::HIGH);
+    virtual ~CPhaseCorrelatorImpl();
+
+    template<class T>
+    void correlateNormal(CDft2d *fftOp, const CMatrix<T> &reference, const CMatrix<T> &input, CMatrix<double> &output,
+                         const T *refNoData, const T *inputNoData) const
+    {
+        if (useSinglePrecision(input.getSize()))
+            convertAndCorrelate<float, T>(fftOp, reference, input, output, refNoData, inputNoData);
+        else
+            convertAndCorrelate<ADftBase2d::MY_WORKING_TYPE, T>(fftOp, reference, input, output, refNoData, inputNoData);
     }
 
     template<class T>
     void correlateComplex(CDft2d *fftOp, const CMatrix<SComplex<T> > &reference, const CMatrix<SComplex<T> > &input,
                           CMatrix<double> &output, const SComplex<T> *refNoData, const SComplex<T> *inputNoData) const
     {
-        auto fp = [](const SComplex<T> & v)->SComplex<ADftBase2d::MY_WORKING_TYPE>
-        {
-            return v.template convertType<ADftBase2d::MY_WORKING_TYPE>();
-        };
-        auto nRef = reference.template map<SComplex<ADftBase2d::MY_WORKING_TYPE> > (fp);
-        auto nIn = input.template map<SComplex<ADftBase2d::MY_WORKING_TYPE> > (fp);
-        SComplex<ADftBase2d::MY_WORKING_TYPE> nRefNd;
-        SComplex<ADftBase2d::MY_WORKING_TYPE> *nRefNdPtr = nullptr;
-        if (refNoData != nullptr)
-        {
-            nRefNd = fp(*refNoData);
-            nRefNdPtr = &nRefNd;
-        }
-        SComplex<ADftBase2d::MY_WORKING_TYPE> nInNd;
-        SComplex<ADftBase2d::MY_WORKING_TYPE> *nInNdPtr = nullptr;
-        if (inputNoData != nullptr)
-        {
-            nInNd = fp(*inputNoData);
-            nInNdPtr = &nInNd;
-        }
-        correlateComplexWt(fftOp, nRef, nIn, output, nRefNdPtr, nInNdPtr);
+        if (useSinglePrecision(input.getSize()))
+            convertAndCorrelate<float, SComplex<T> >(fftOp, reference, input, output, refNoData, inputNoData);
+        else
+            convertAndCorrelate<ADftBase2d::MY_WORKING_TYPE, SComplex<T> >(fftOp, reference, input, output, refNoData, inputNoData);
     }
 };
 
@@ -146,10 +266,11 @@ private:
     CPhaseCorrelatorImpl m_corImpl;
 public:
 
-    CPhaseDigitalImageCorrelator(const SSize &inputSize) :
+    CPhaseDigitalImageCorrelator(const SSize &inputSize, ECorrelationPrecision precision) :
     ADigitalImageCorrelator<T>(inputSize),
     m_fft2d(std::make_shared<CDft2d>(inputSize)),
-    m_fft2dPtr(m_fft2d.get())
+    m_fft2dPtr(m_fft2d.get()),
+    m_corImpl(precision)
     {
         if (inputSize.row % 2 != 0 || inputSize.col % 2 != 0)
             throw CException(__FILE__, __LINE__, "Phase correlation requires that the matrix sizes be of even size");
@@ -182,43 +303,169 @@ class CCoefNormCorrelatorImpl
 private:
     using MY_WORKING_TYPE = double;
 
-    void correlateNormalWt(const CMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &reference,
-                           const CMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &input,
+    // the search image and its integral image shared by the templates correlated in it, see setSearchRegion()
+    struct SSearchRegion;
+
+    ECorrelationPrecision m_precision;
+    std::unique_ptr<SSearchRegion> m_region;
+
+    void correlateNormalWt(CScratchArena *arena,
+                           const CScratchMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &reference,
+                           const CScratchMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &input,
                            CMatrix<double> &output,
                            const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *refNoData,
-                           const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *inputNoData) const;
-    void correlateComplexWt(const CMatrix<SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> > &reference,
-                            const CMatrix<SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> > &input,
+                           const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *inputNoData,
+                           const SCoarseToFineSearch &search) const;
+    void correlateNormalFloat(CScratchArena *arena,
+                              const CScratchMatrix<float> &reference,
+                              const CScratchMatrix<float> &input,
+                              CMatrix<double> &output,
+                              const float *refNoData,
+                              const float *inputNoData,
+                              const SCoarseToFineSearch &search) const;
+    void correlateComplexWt(CScratchArena *arena,
+                            const CScratchMatrix<SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> > &reference,
+                            const CScratchMatrix<SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> > &input,
                             CMatrix<double> &output,
                             const SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> *refNoData,
                             const SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> *inputNoData) const;
-public:
-    CCoefNormCorrelatorImpl();
-    virtual ~CCoefNormCorrelatorImpl();
 
-    template<class T>
-    void correlateNormal(const CMatrix<T> &reference, const CMatrix<T> &input, CMatrix<double> &output,
-                         const T *refNoData, const T *inputNoData) const
+    template<class W, class T>
+    void convertAndCorrelate(const CMatrix<T> &reference, const CMatrix<T> &input, CMatrix<double> &output,
+                             const T *refNoData, const T *inputNoData, const SCoarseToFineSearch &search) const
     {
-        auto nRef = reference.template convertType<MY_WORKING_TYPE>();
-        auto nIn = input.template convertType<MY_WORKING_TYPE>();
-        MY_WORKING_TYPE nRefNd;
-        MY_WORKING_TYPE *nRefNdPtr = nullptr;
+        auto fp = [](const T & v)->W
+        {
+            return (W) v;
+        };
+        CScratchArenaScope scope;
+        CScratchMatrix<W> nRef(scope.getArena(), reference.getSize());
+        CScratchMatrix<W> nIn(scope.getArena(), input.getSize());
+        nRef.assign(reference, fp);
+        nIn.assign(input, fp);
+        W nRefNd;
+        W *nRefNdPtr = nullptr;
         if (refNoData != nullptr)
         {
-            nRefNd = (MY_WORKING_TYPE) (*refNoData);
+            nRefNd = (W) (*refNoData);
             nRefNdPtr = &nRefNd;
         }
-        MY_WORKING_TYPE nInNd;
-        MY_WORKING_TYPE *nInNdPtr = nullptr;
+        W nInNd;
+        W *nInNdPtr = nullptr;
         if (inputNoData != nullptr)
         {
-            nInNd = (MY_WORKING_TYPE) (*inputNoData);
+            nInNd = (W) (*inputNoData);
             nInNdPtr = &nInNd;
         }
-        correlateNormalWt(nRef, nIn, output, nRefNdPtr, nInNdPtr);
+        correlateWt(scope.getArena(), nRef, nIn, output, nRefNdPtr, nInNdPtr, search);
+    }
+
+    void correlateWt(CScratchArena *arena, const CScratchMatrix<MY_WORKING_TYPE> &reference, const CScratchMatrix<MY_WORKING_TYPE> &input,
+                     CMatrix<double> &output, const MY_WORKING_TYPE *refNoData, const MY_WORKING_TYPE *inputNoData,
+                     const SCoarseToFineSearch &search) const
+    {
+        correlateNormalWt(arena, reference, input, output, refNoData, inputNoData, search);
+    }
+
+    void correlateWt(CScratchArena *arena, const CScratchMatrix<float> &reference, const CScratchMatrix<float> &input,
+                     CMatrix<double> &output, const float *refNoData, const float *inputNoData,
+                     const SCoarseToFineSearch &search) const
+    {
+        correlateNormalFloat(arena, reference, input, output, refNoData, inputNoData, search);
+    }
+
+    CScratchArena *resetSearchRegion(const SSize &templateSize);
+    const SSearchRegion &getSearchRegion(const SSize &templateSize) const;
+    void prepareSearchRegion(const CScratchMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &region,
+                             const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *noData);
+    void prepareSearchRegion(const CScratchMatrix<float> &region, const float *noData);
+    void correlateRegionWt(CScratchArena *arena, const SSize &ul, const SSize &searchSize,
+                           const CScratchMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &input,
+                           CMatrix<double> &output,
+                           const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *inputNoData,
+                           const SCoarseToFineSearch &search) const;
+    void correlateRegionWt(CScratchArena *arena, const SSize &ul, const SSize &searchSize,
+                           const CScratchMatrix<float> &input,
+                           CMatrix<double> &output,
+                           const float *inputNoData,
+                           const SCoarseToFineSearch &search) const;
+
+    template<class W, class T>
+    void setSearchRegionWt(const CMatrix<T> &region, const T *noData, const SSize &templateSize)
+    {
+        CScratchArena *arena = resetSearchRegion(templateSize);
+        CScratchMatrix<W> nRegion(arena, region.getSize());
+        nRegion.assign(region, [](const T & v)->W
+        {
+            return (W) v;
+        });
+        W nNoData = noData != nullptr ? (W) (*noData) : W(0);
+        prepareSearchRegion(nRegion, noData != nullptr ? &nNoData : nullptr);
+    }
+
+    template<class W, class T>
+    void correlateInRegionWt(const SSize &ul, const SSize &searchSize, const CMatrix<T> &input, CMatrix<double> &output,
+                             const T *inputNoData, const SCoarseToFineSearch &search) const
+    {
+        CScratchArenaScope scope;
+        CScratchMatrix<W> nIn(scope.getArena(), input.getSize());
+        nIn.assign(input, [](const T & v)->W
+        {
+            return (W) v;
+        });
+        W nInNd = inputNoData != nullptr ? (W) (*inputNoData) : W(0);
+        correlateRegionWt(scope.getArena(), ul, searchSize, nIn, output, inputNoData != nullptr ? &nInNd : nullptr, search);
+    }
+public:
+    CCoefNormCorrelatorImpl(ECorrelationPrecision precision = ECorrelationPrecision::HIGH);
+    virtual ~CCoefNormCorrelatorImpl();
+
+    /**
+     * Chips that contain no data are always correlated exhaustively
+     */
+    template<class T>
+    void correlateNormal(const CMatrix<T> &reference, const CMatrix<T> &input, CMatrix<double> &output,
+                         const T *refNoData, const T *inputNoData, const SCoarseToFineSearch &search = SCoarseToFineSearch()) const
+    {
+        if (m_precision == ECorrelationPrecision::FLOAT)
+            convertAndCorrelate<float, T>(reference, input, output, refNoData, inputNoData, search);
+        else
+            convertAndCorrelate<MY_WORKING_TYPE, T>(reference, input, output, refNoData, inputNoData, search);
+    }
+
+    /**
+     * Converts a search region that templates of templateSize will be correlated in, and
+     * builds its integral image once for all of them
+     * @param region
+     * @param noData
+     * @param templateSize
+     */
+    template<class T>
+    void setSearchRegion(const CMatrix<T> &region, const T *noData, const SSize &templateSize)
+    {
+        if (m_precision == ECorrelationPrecision::FLOAT)
+            setSearchRegionWt<float, T>(region, noData, templateSize);
+        else
+            setSearchRegionWt<MY_WORKING_TYPE, T>(region, noData, templateSize);
+    }
+
+    /**
+     * Same as correlateNormal() on the window of searchSize at ul of the search region, apart
+     * from the rounding of the integral image that is shared by the windows
+     */
+    template<class T>
+    void correlateInRegion(const SSize &ul, const SSize &searchSize, const CMatrix<T> &input, CMatrix<double> &output,
+                           const T *inputNoData, const SCoarseToFineSearch &search = SCoarseToFineSearch()) const
+    {
+        if (m_precision == ECorrelationPrecision::FLOAT)
+            correlateInRegionWt<float, T>(ul, searchSize, input, output, inputNoData, search);
+        else
+            correlateInRegionWt<MY_WORKING_TYPE, T>(ul, searchSize, input, output, inputNoData, search);
     }
 
+    /**
+     * Complex chips are always correlated in double, FLOAT uses double integral images
+     */
     template<class T>
     void correlateComplex(const CMatrix<SComplex<T> > &reference, const CMatrix<SComplex<T> > &input,
                           CMatrix<double> &output, const SComplex<T> *refNoData, const SComplex<T> *inputNoData) const
@@ -227,8 +474,11 @@ public:
         {
             return v.template convertType<MY_WORKING_TYPE>();
         };
-        auto nRef = reference.template map<SComplex<MY_WORKING_TYPE> >(fp);
-        auto nIn = input.template map<SComplex<MY_WORKING_TYPE> >(fp);
+        CScratchArenaScope scope;
+        CScratchMatrix<SComplex<MY_WORKING_TYPE> > nRef(scope.getArena(), reference.getSize());
+        CScratchMatrix<SComplex<MY_WORKING_TYPE> > nIn(scope.getArena(), input.getSize());
+        nRef.assign(reference, fp);
+        nIn.assign(input, fp);
 
         SComplex<MY_WORKING_TYPE> nRefNd;
         SComplex<MY_WORKING_TYPE> *nRefNdPtr = nullptr;
@@ -244,7 +494,7 @@ public:
             nInNd = inputNoData->template convertType<MY_WORKING_TYPE>();
             nInNdPtr = &nInNd;
         }
-        correlateComplexWt(nRef, nIn, output, nRefNdPtr, nInNdPtr);
+        correlateComplexWt(scope.getArena(), nRef, nIn, output, nRefNdPtr, nInNdPtr);
     }
 };
 
@@ -255,8 +505,9 @@ private:
     CCoefNormCorrelatorImpl m_corImpl;
 public:
 
-    CCoefNormDigitalImageCorrelator(const SSize &inputSize) :
-    ADigitalImageCorrelator<T>(inputSize)
+    CCoefNormDigitalImageCorrelator(const SSize &inputSize, ECorrelationPrecision precision) :
+    ADigitalImageCorrelator<T>(inputSize),
+    m_corImpl(precision)
     {
     }
 
@@ -275,6 +526,25 @@ public:
     {
         m_corImpl.template correlateComplex<T>(reference, input, output, refNoData, inputNoData);
     }
+
+    virtual void setSearchRegion(const CMatrix<T> &region, const T *regionNoData, const SSize &inputSize) override
+    {
+        m_corImpl.template setSearchRegion<T>(region, regionNoData, inputSize);
+    }
+
+    virtual void correlateInRegion(const SSize &ul, const SSize &referenceSize, const CMatrix<T> &input, CMatrix<double> &output,
+                                   const T *inputNoData = nullptr, const SCoarseToFineSearch &search = SCoarseToFineSearch()) override
+    {
+        m_corImpl.template correlateInRegion<T>(ul, referenceSize, input, output, inputNoData, search);
+    }
+
+    using ADigitalImageCorrelator<T>::correlateCoarseToFine;
+
+    virtual void correlateCoarseToFine(const CMatrix<T> &reference, const CMatrix<T> &input, CMatrix<double> &output,
+                                       const SCoarseToFineSearch &search, const T *refNoData = nullptr, const T *inputNoData = nullptr) const override
+    {
+        m_corImpl.template correlateNormal<T>(reference, input, output, refNoData, inputNoData, search);
+    }
 };
 
 } // namespace correlate_coef_norm
@@ -283,21 +553,47 @@ public:
 
 class CDigitalImageCorrelatorFactory
 {
+private:
+    static ECorrelationPrecision DEFAULT_PRECISION;
+    static bool VALIDATE_PRECISION;
+    static unsigned long DEFAULT_COARSE_TO_FINE_STRIDE;
 public:
     CDigitalImageCorrelatorFactory() = delete;
     virtual ~CDigitalImageCorrelatorFactory() = delete;
 
+    static ECorrelationPrecision getDefaultPrecision();
+    /**
+     * Sets the precision of correlators that are not given one, HIGH by default
+     * @param precision
+     */
+    static void setDefaultPrecision(ECorrelationPrecision precision);
+    static bool getValidatePrecision();
+    /**
+     * If set, sub pixel correlators below HIGH precision repeat every correlation at HIGH
+     * precision and record the differences in CCorrelationPrecisionValidation
+     * @param validate
+     */
+    static void setValidatePrecision(bool validate);
+    static unsigned long getDefaultCoarseToFineStride();
+    /**
+     * Sets the SCoarseToFineSearch stride of sub pixel correlators that are not given one,
+     * 1 (exhaustive) by default
+     * @param stride
+     */
+    static void setDefaultCoarseToFineStride(unsigned long stride);
+
     template<class T>
-    static std::shared_ptr<ADigitalImageCorrelator<T> > create(ECorrelationType correlationMethod, const SSize &inputSize)
+    static std::shared_ptr<ADigitalImageCorrelator<T> > create(ECorrelationType correlationMethod, const SSize &inputSize,
+                                                               ECorrelationPrecision precision = CDigitalImageCorrelatorFactory::getDefaultPrecision())
     {
         std::shared_ptr<ADigitalImageCorrelator<T> > correlator;
         switch (correlationMethod)
         {
         case ECorrelationType::CCOEFF_NORM:
-            correlator = std::make_shared<__ultra_internal::correlate_coef_norm::CCoefNormDigitalImageCorrelator<T> >(inputSize);
+            correlator = std::make_shared<__ultra_internal::correlate_coef_norm::CCoefNormDigitalImageCorrelator<T> >(inputSize, precision);
             break;
         case ECorrelationType::PHASE:
-            correlator = std::make_shared<__ultra_internal::correlate_phase::CPhaseDigitalImageCorrelator<T> >(inputSize);
+            correlator = std::make_shared<__ultra_internal::correlate_phase::CPhaseDigitalImageCorrelator<T> >(inputSize, precision);
             break;
         default:
             throw CException(__FILE__, __LINE__, "No implementation found");
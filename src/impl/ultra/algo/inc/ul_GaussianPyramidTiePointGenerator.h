@@ -19,6 +19,7 @@
 #include "ul_TiePointGenerator.h"
 #include "ul_Resampler.h"
 #include "ul_Int_TiePointGenerator.h"
+#include "ul_GcpShiftPriors.h"
 
 namespace ultra
 {
@@ -34,6 +35,8 @@ public:
         unsigned long amountOfPyramids;
         CTiePointGenerator::SContext tiePointGeneratorContext;
         unsigned long minimumRequiredGcp;
+        // search the chips of a finer level around the shifts of the nearby GCPs of the coarser level, default is true
+        bool localShiftPriors;
 
         SContext();
         SContext(const SContext &r);
@@ -72,7 +75,11 @@ private:
         SInnerContext &operator=(const SInnerContext &r);
     };
 
+    // GCPs at most this many chip generation grid cells away contribute to a shift prior
+    static const double SHIFT_PRIOR_RADIUS_IN_GRID_CELLS;
+
     SInnerContext m_context;
+    CGcpShiftPriors m_shiftPriors;
 
     bool isContextOk();
     int checkImageSize(const std::string &pathToImage, unsigned long modVal);
@@ -86,6 +93,9 @@ private:
                      CVector<SChipCorrelationResult> &result,
                      const SPair<double> &avgShift1
                      );
+    int BuildShiftPriors(const CVector<SChipCorrelationResult> &result,
+                         const SPair<double> &gsd, const SPair<double> &globalShift,
+                         CTiePointGenerator::SContext &context);
 
 public:
     CGaussianPyramidTiePointGenerator(const CGaussianPyramidTiePointGenerator::SContext *context);
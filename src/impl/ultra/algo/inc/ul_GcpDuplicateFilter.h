@@ -0,0 +1,46 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include "ul_Chips.h"
+
+namespace ultra
+{
+
+/**
+ * Removes GCPs whose reference chip centre coincides with that of an earlier GCP.
+ * <br>
+ * The good results are bucketed on a hash grid of their quantized <code>chip.midCoordinate</code>,
+ * every result is only compared against the results in the neighbouring cells, keeping the
+ * removal linear in the amount of GCPs. The first result of a group of duplicates is kept.
+ */
+class CGcpDuplicateFilter
+{
+public:
+    /**
+     * Marks the duplicate results as not good
+     * @param results
+     * @param tolerance centres at most this far apart (in the units of the chip coordinates)
+     * are duplicates, 0 only removes exact duplicates, fails if it quantizes a coordinate
+     * to more than 2^52 cells
+     * @param removedCount the amount of results marked as not good
+     * @return 0 on success
+     */
+    static int RemoveDuplicates(CVector<SChipCorrelationResult> &results, double tolerance, unsigned long &removedCount);
+};
+
+} // namespace ultra
@@ -18,6 +18,7 @@
 
 #include <ul_Chips.h>
 #include <ul_UltraThread.h>
+#include "ul_ConvexPolygon.h"
 
 namespace ultra
 {
@@ -29,26 +30,18 @@ private:
     class CHullGenThread : public IRunnable
     {
     private:
-        CMatrix<float> *m_image;
-        CMatrix<float> *m_hull;
+        const CMatrix<float> *m_image;
+        CConvexPolygon *m_hull;
         float m_nullValue;
-        float m_nonNullValue;
         int m_exitCode;
         unsigned long m_trimAmount;
-        unsigned long m_paddSize;
 
-        int GenerateConvexHullImage(const CMatrix<float> *image, CMatrix<float> &hull) const;
-        int FillPixelDataArea(const CMatrix<float> *image, CMatrix<float> &hull) const;
-        int TrimHullArea(CMatrix<float> &hull) const;
-        template<class IO_TYPE, class WORKING_TYPE>
-        int GenOuterHull(const CMatrix<IO_TYPE> &inMat, CMatrix<IO_TYPE> &outMat, IO_TYPE clipVal, IO_TYPE insertVal) const;
+        int ExtractFootprintBoundary(CVector<SSize> &boundary) const;
     public:
         CHullGenThread(
-                       CMatrix<float> *image, CMatrix<float> *hull,
+                       const CMatrix<float> *image, CConvexPolygon *hull,
                        float nullValue,
-                       float nonNullValue,
-                       unsigned long trimAmount,
-                       unsigned long paddSize
+                       unsigned long trimAmount
                        );
         virtual ~CHullGenThread();
 
@@ -56,14 +49,10 @@ private:
         int GetExitCode() const;
     };
 private:
-    CMatrix<float> m_refImage;
-    CMatrix<float> m_inImage;
-    CMatrix<float> m_refHull;
-    CMatrix<float> m_inHull;
+    CConvexPolygon m_refHull;
+    CConvexPolygon m_inHull;
     float m_nullValue;
-    float m_nonNullValue;
     unsigned long m_trimAmount;
-    unsigned long m_paddSize;
     CVector<SChipCorrelationResult> *m_gcps;
     CVector<CHullGenThread *> m_threads;
 
@@ -100,6 +89,21 @@ public:
     CGcpHullRejection();
     virtual ~CGcpHullRejection();
 
+    /**
+     * Rejects the GCPs outside the trimmed outer hulls of the valid data of both images,
+     * the images are only read, they are not copied
+     * @return 0 on success
+     */
+    int Reject(
+               const CMatrix<float> &refImage,
+               const SImageMetadata &refMetadata,
+               const CMatrix<float> &inImage,
+               const SImageMetadata &inMetadata,
+               float nullValue,
+               unsigned long hullTrimAmount,
+               CVector<SChipCorrelationResult> *gcps
+               );
+
     int Reject(
                const CVector<CMatrix<float> > &refImage,
                const SImageMetadata &refMetadata,
@@ -0,0 +1,181 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <ul_Pair.h>
+#include <ul_Vector.h>
+#include <ul_BufferedWriter.h>
+
+namespace ultra
+{
+
+struct EGcpResultFormat
+{
+
+    enum EFormatType
+    {
+        RESULT_FORMAT_TEXT = 0,
+        RESULT_FORMAT_BINARY,
+        RESULT_FORMAT_CSV,
+        RESULT_FORMAT_TYPE_COUNT
+    };
+
+    static std::string formatTypeToStr(EGcpResultFormat::EFormatType type);
+    static EGcpResultFormat::EFormatType strToFormatType(const std::string &type);
+    /**
+     * @return the file extension (without the dot) used for a format
+     */
+    static std::string getFileExtension(EGcpResultFormat::EFormatType type);
+};
+
+/**
+ * Scene wide values that precede the GCP records
+ */
+struct SGcpResultHeader
+{
+    SPair<double> totalResidual;
+    CVector<unsigned int> residualHistogram;
+    CVector<double> geoTransform;
+    std::string proj4Str;
+    std::string units;
+
+    SGcpResultHeader();
+    ~SGcpResultHeader();
+
+    /**
+     * @param bin residual histogram bin
+     * @return the colour the bin is drawn with, empty past the last bin
+     */
+    static std::string getHistogramBinName(unsigned long bin);
+};
+
+/**
+ * A single finalized GCP, residuals are reference minus input in map units
+ */
+struct SGcpRecord
+{
+    long id;
+    std::string chipType;
+    long line;
+    long sample;
+    double mapX;
+    double mapY;
+    double corrCoefficient;
+    double residualY;
+    double residualX;
+    bool isGood;
+
+    SGcpRecord();
+    ~SGcpRecord();
+};
+
+/**
+ * Receives GCP records one at a time as they are finalized.
+ * <br>
+ * Calls are <code>Begin()</code> once, <code>Write()</code> per record and
+ * <code>End()</code> once, after which the output is complete on disk.
+ */
+class IGcpResultSink
+{
+public:
+    virtual ~IGcpResultSink();
+    virtual int Begin(const SGcpResultHeader &header) = 0;
+    virtual int Write(const SGcpRecord &record) = 0;
+    virtual int End() = 0;
+
+    /**
+     * @param type
+     * @param path output file, created or truncated on <code>Begin()</code>
+     * @return a sink writing the format, nullptr if the type is invalid
+     */
+    static std::unique_ptr<IGcpResultSink> Create(EGcpResultFormat::EFormatType type, const std::string &path);
+};
+
+/**
+ * The IMAGE_GVERIFY residual (.res) text format
+ */
+class CTextGcpResultSink : public IGcpResultSink
+{
+private:
+    std::string m_path;
+    CBufferedWriter m_writer;
+
+public:
+    CTextGcpResultSink(const std::string &path);
+    virtual ~CTextGcpResultSink();
+    virtual int Begin(const SGcpResultHeader &header) override;
+    virtual int Write(const SGcpRecord &record) override;
+    virtual int End() override;
+};
+
+/**
+ * Compact binary format, all values in host byte order:
+ * <br>
+ * header: char[4] "UGCP", uint32 version, uint64 record count,
+ * double total residual x, double total residual y,
+ * uint32 histogram size, uint32[histogram size],
+ * uint32 transform size, double[transform size],
+ * uint32 length + proj4 string, uint32 length + units string
+ * <br>
+ * record: int64 id, int64 line, int64 sample, double map x, double map y,
+ * double correlation coefficient, double residual y, double residual x,
+ * uint8 good flag, uint8 length + chip type string
+ */
+class CBinaryGcpResultSink : public IGcpResultSink
+{
+public:
+    static const char MAGIC[4];
+    static const unsigned int VERSION;
+
+private:
+    std::string m_path;
+    CBufferedWriter m_writer;
+    unsigned long long m_countOffset;
+    unsigned long long m_count;
+
+    int WriteString(const std::string &str);
+
+public:
+    CBinaryGcpResultSink(const std::string &path);
+    virtual ~CBinaryGcpResultSink();
+    virtual int Begin(const SGcpResultHeader &header) override;
+    virtual int Write(const SGcpRecord &record) override;
+    virtual int End() override;
+};
+
+/**
+ * One row per GCP under a header row of column names, doubles are written
+ * with enough digits to read back exactly. Scene wide values are not
+ * repeated here, they are in the text and binary formats.
+ */
+class CCsvGcpResultSink : public IGcpResultSink
+{
+private:
+    std::string m_path;
+    CBufferedWriter m_writer;
+
+public:
+    CCsvGcpResultSink(const std::string &path);
+    virtual ~CCsvGcpResultSink();
+    virtual int Begin(const SGcpResultHeader &header) override;
+    virtual int Write(const SGcpRecord &record) override;
+    virtual int End() override;
+};
+
+} // namespace ultra
@@ -0,0 +1,88 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include <vector>
+
+#include "ul_Chips.h"
+
+namespace ultra
+{
+
+/**
+ * Shift priors for the chips of the next (finer) pyramid level, taken from the GCPs of a coarser level.
+ * <br>
+ * The prior of a location is the median shift of the good GCPs around it, the spread of those shifts
+ * sizes the search window. The GCPs are bucketed on a grid of cells as large as the neighbourhood
+ * radius, a location is only compared against the GCPs in the neighbouring cells.
+ */
+class CGcpShiftPriors
+{
+private:
+    // fewer neighbouring GCPs than this give no prior
+    static const unsigned long MIN_NEIGHBOURS;
+    // median absolute deviations of the neighbouring shifts the search window covers
+    static const double SPREAD_DEVIATIONS;
+    // pixels added around the spread, covering the pyramid resampling and the rounding of the prior
+    static const unsigned long MARGIN_PIXELS;
+
+    std::vector<SPair<double> > m_locations;
+    std::vector<SPair<double> > m_shifts;
+    std::vector<std::vector<unsigned long> > m_cells;
+    SPair<double> m_gridOrigin;
+    SSize m_gridSize;
+    double m_radius;
+
+    bool getCell(const SPair<double> &mapCoordinate, long &row, long &col) const;
+
+public:
+    CGcpShiftPriors();
+    ~CGcpShiftPriors();
+
+    /**
+     * @param results the GCPs of the coarser level
+     * @param gsd the ground sampling distance of the coarser level
+     * @param globalShift the shift (in pixels of the coarser level) the whole next level is moved by
+     * @param radius GCPs at most this far (in map units) from a location contribute to its prior
+     * @param scale pixels of the next level per pixel of the coarser level
+     * @return 0 on success
+     */
+    int Build(const CVector<SChipCorrelationResult> &results, const SPair<double> &gsd,
+              const SPair<double> &globalShift, double radius, double scale);
+    void Clear();
+    bool isEmpty() const;
+
+    /**
+     * @param mapCoordinate
+     * @param shift the expected shift (in whole pixels of the next level) on top of the global shift
+     * @param spread the distance (in pixels of the next level) around shift the neighbouring GCPs lie within
+     * @return false if too few GCPs are near
+     */
+    bool getPrior(const SPair<double> &mapCoordinate, SPair<double> &shift, double &spread) const;
+
+    /**
+     * Centres the search window of the chip on its prior, and shrinks its search range to the
+     * spread of the prior
+     * @param chip
+     * @param maxSearchWindowSize the search range is never larger than this
+     * @return false if the chip has no prior and was left as it is
+     */
+    bool Apply(CChip<float> &chip, unsigned long maxSearchWindowSize) const;
+};
+
+} // namespace ultra
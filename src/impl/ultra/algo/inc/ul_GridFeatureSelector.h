@@ -0,0 +1,81 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "ul_Matrix.h"
+
+namespace ultra
+{
+
+/**
+ * Keeps the strongest features per grid cell while the candidates are scanned, using a
+ * bounded min-heap per cell, so chip data only has to be extracted for the survivors and
+ * the amount of chips per image is bounded by the grid.
+ */
+class CGridFeatureSelector
+{
+public:
+
+    struct SFeature
+    {
+        unsigned long row;
+        unsigned long col;
+        float score;
+
+        SFeature();
+        SFeature(unsigned long row, unsigned long col, float score);
+    };
+
+private:
+    unsigned long m_cellSize;
+    unsigned long m_maxPerCell;
+    unsigned long m_cellCols;
+    unsigned long m_cellRows;
+    unsigned long m_nextCellRow;
+    std::vector<std::vector<SFeature> > m_cells;
+
+    static bool isWeaker(const SFeature &a, const SFeature &b);
+    static void SortRasterOrder(std::vector<SFeature> &features);
+
+public:
+    /**
+     * @param imageSize
+     * @param cellSize grid cell size in pixels, zero keeps every feature
+     * @param maxPerCell the amount of features kept per cell, zero keeps every feature
+     */
+    CGridFeatureSelector(const SSize &imageSize, unsigned long cellSize, unsigned long maxPerCell);
+    virtual ~CGridFeatureSelector();
+
+    void Add(unsigned long row, unsigned long col, float score);
+
+    /**
+     * @return the surviving features in raster order
+     */
+    std::vector<SFeature> getFeatures() const;
+
+    /**
+     * Removes and returns the features of the cells that lie entirely above row, their selection
+     * can no longer change once every candidate above row was added
+     * @param row
+     * @return the removed features in raster order
+     */
+    std::vector<SFeature> TakeFeaturesAbove(unsigned long row);
+};
+
+} // namespace ultra
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "ul_ChipsGen.h"
+#include "ul_HarrisCornerTransform.h"
 
 namespace ultra
 {
@@ -45,7 +46,7 @@ private:
     SSize m_imgSize;
 
     int Init(CChipsGen<float>::CChipsGenContext *context);
-    int ProcessHarrisTransformImageVector(CVector<CMatrix<unsigned char> > &imageVecOut);
+    int ProcessHarrisTransformImageVector(CHarrisCornerTransform &harrisCornerTransform, CVector<CMatrix<unsigned char> > &imageVecOut);
     int Process();
 
 protected:
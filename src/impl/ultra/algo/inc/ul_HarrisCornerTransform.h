@@ -28,20 +28,40 @@ public:
     class CHarrisCornerContext : public CTransformContext
     {
     public:
+        /**
+         * A pixel is a corner if both eigenvalues exceed this value
+         */
         float minHarrisValue;
+        /**
+         * If non-zero the threshold starts at <code>minHarrisValue</code> and is lowered by
+         * <code>thresholdStep</code>, at most <code>maxThresholdSteps</code> times, until more
+         * than <code>minCornerCount</code> pixels pass. The response is only computed once.
+         */
+        unsigned long minCornerCount;
+        float thresholdStep;
+        unsigned long maxThresholdSteps;
+        /**
+         * Only keep corners whose response is the maximum of their 3x3 neighbourhood
+         */
+        bool nonMaximumSuppression;
+        /**
+         * Set by the transform to the threshold that was used
+         */
+        float selectedHarrisValue;
         CHarrisCornerContext();
         virtual ~CHarrisCornerContext();
     };
 private:
 
-    CTransform<float, float> *m_sobelFilter;
     CVector<CMatrix<float> > m_sobelImages;
-    CMatrix<CMatrix<float> > m_harrisMat;
+    // smallest eigenvalue of the Harris matrix, -inf where it has no real eigenvalues
+    CMatrix<float> m_response;
     CHarrisCornerContext *m_context;
     bool m_internalContext;
 
     int DoSobelTransForm();
-    int ConstructHarrisMatrix();
+    int ComputeResponse();
+    int SelectThreshold(float &threshold) const;
     int DetectHarrisCorners();
 
 protected:
@@ -52,6 +72,11 @@ public:
     CHarrisCornerTransform();
     virtual ~CHarrisCornerTransform();
 
+    /**
+     * @return the smallest eigenvalue per pixel of the last transform, the corner strength
+     */
+    const CMatrix<float> &getResponse() const;
+
 };
 
 } // namespace ultra
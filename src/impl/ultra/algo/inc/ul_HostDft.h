@@ -28,6 +28,10 @@ private:
 protected:
     virtual void forwardImpl(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMatrix<SComplex<MY_WORKING_TYPE> > &output) const override;
     virtual void inverseImpl(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMatrix<SComplex<MY_WORKING_TYPE> > &output) const override;
+    virtual void forwardImpl(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const override;
+    virtual void inverseImpl(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const override;
+    virtual void forwardImpl(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const override;
+    virtual void inverseImpl(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const override;
 public:
     CHostDft2d(const SSize &size);
     virtual ~CHostDft2d();
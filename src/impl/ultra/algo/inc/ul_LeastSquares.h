@@ -86,7 +86,7 @@ private:
             if (getAbs(C[it][it]) < getAbs(eps))
             {
                 values[it] = 0;
-                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Going do divide by zero at row'" + toString(it) + "', assume ans will be zero (as in not used)");
+                ULTRA_LOG(CLogger::LOG_DEBUG, "Going do divide by zero at row'" + toString(it) + "', assume ans will be zero (as in not used)");
                 continue;
             }
 
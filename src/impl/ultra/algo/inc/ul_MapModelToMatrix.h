@@ -82,7 +82,17 @@ public:
         m_inputMatrix = nullptr;
     }
 
-    int GetSceneTile(const SPair<double> &midCoordinate, const SSize &windowSize, CMatrix<T> &outputTile, const SPair<double> &groundSamplingDistance, bool &validTileReturned, ECorrelationType &corrMethod)
+    /**
+     * Locates the tile GetSceneTile() would return without copying it
+     * @param midCoordinate
+     * @param windowSize
+     * @param groundSamplingDistance
+     * @param validTileReturned false if the tile is not completely inside the input matrix
+     * @param corrMethod
+     * @param tileUl the upper left pixel of the tile in the input matrix
+     * @return 0 on success
+     */
+    int LocateTile(const SPair<double> &midCoordinate, const SSize &windowSize, const SPair<double> &groundSamplingDistance, bool &validTileReturned, const ECorrelationType &corrMethod, SSize &tileUl)
     {
         validTileReturned = true;
         if (!m_hasInited)
@@ -128,21 +138,6 @@ public:
             return 1;
         }
 
-        if (outputTile.getSize() != windowSize)
-        {
-            try
-            {
-                outputTile.resize(windowSize);
-            }
-            catch (CException e)
-            {
-                validTileReturned = false;
-                throw e;
-            }
-        }
-
-        outputTile.initMat(T(0));
-
         /*
          * Assuming that the world matrix values will always be square
          */
@@ -250,24 +245,49 @@ public:
             ec--;
             er--;
         }
-        unsigned long rr = 0;
-        unsigned long cc = 0;
-        for (long r = sr; r <= er; r++)
+        if (sr < 0 || sc < 0 ||
+            er >= (long) m_size.row || ec >= (long) m_size.col)
         {
-            cc = 0;
-            for (long c = sc; c <= ec; c++)
+            //out of bounds
+            validTileReturned = false;
+            return 0;
+        }
+        tileUl = SSize(sr, sc);
+        return 0;
+    }
+
+    int GetSceneTile(const SPair<double> &midCoordinate, const SSize &windowSize, CMatrix<T> &outputTile, const SPair<double> &groundSamplingDistance, bool &validTileReturned, ECorrelationType &corrMethod)
+    {
+        SSize tileUl;
+        if (LocateTile(midCoordinate, windowSize, groundSamplingDistance, validTileReturned, corrMethod, tileUl) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LocateTile()");
+            return 1;
+        }
+
+        if (outputTile.getSize() != windowSize)
+        {
+            try
+            {
+                outputTile.resize(windowSize);
+            }
+            catch (CException e)
             {
-                if (r < 0 || c < 0 ||
-                    r >= m_size.row || c >= m_size.col)
-                {
-                    //out of bounds
-                    validTileReturned = false;
-                    return 0;
-                }
-                outputTile[rr][cc] = (*m_inputMatrix)[r][c];
-                cc++;
+                validTileReturned = false;
+                throw e;
             }
-            rr++;
+        }
+
+        outputTile.initMat(T(0));
+        if (!validTileReturned)
+            return 0;
+
+        for (unsigned long r = 0; r < windowSize.row; r++)
+        {
+            const T *src = (*m_inputMatrix)[tileUl.row + r].getDataPointer() + tileUl.col;
+            T *des = outputTile[r].getDataPointer();
+            for (unsigned long c = 0; c < windowSize.col; c++)
+                des[c] = src[c];
         }
 
         return 0;
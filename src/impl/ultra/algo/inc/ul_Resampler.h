@@ -398,7 +398,7 @@ private:
                 per = (int) ((r * 100.0) / outputSize.row);
                 if (ENABLE_PERCENTAGE_LOGGER)
                 {
-                    CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Resampling " + toString(per) + "%     \r");
+                    ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Resampling " + toString(per) + "%     \r");
                 }
             }
             for (c = 0; c < outputSize.col; c++)
@@ -444,7 +444,7 @@ private:
                 per = (int) ((r * 100.0) / outputSize.row);
                 if (ENABLE_PERCENTAGE_LOGGER)
                 {
-                    CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Resampling " + toString(per) + "%     \r");
+                    ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Resampling " + toString(per) + "%     \r");
                 }
             }
             for (long c = 0, sc = (long) outputSize.col; c < sc; c++)
@@ -505,7 +505,7 @@ private:
                 per = (int) ((r * 100.0) / outputSize.r);
                 if (ENABLE_PERCENTAGE_LOGGER)
                 {
-                    CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Resampling " + toString(per) + "%     \r");
+                    ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Resampling " + toString(per) + "%     \r");
                 }
             }
             auto *outDp = output[r].getDataPointer();
@@ -577,7 +577,7 @@ private:
                 per = (int) ((r * 100.0) / rMax);
                 if (ENABLE_PERCENTAGE_LOGGER)
                 {
-                    CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Resampling " + toString(per) + "%     \r");
+                    ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Resampling " + toString(per) + "%     \r");
                 }
             }
             for (long c = 0; c < cMax; c++)
@@ -47,20 +47,20 @@ public:
 private:
     int m_chipWidth;
     int m_chipOffset;
+    unsigned long m_gridSize;
+    unsigned long m_maxFeaturesPerCell;
     CConvKernel<float> m_gaussianKernel;
-    CTransform<float, float> *m_transformer;
     CTransform<float, float> *m_smoother;
     CTransformContext *m_smootherCtx;
-    CMatrix<float> m_tempPhase;
 
     int Init(CChipsGen<float>::CChipsGenContext *context);
     int ApplySobel(const CMatrix<float> &im, CMatrix<float> &sobel_grad, CMatrix<float> &sobel_phase);
     int getThreshold(const CMatrix<float>& im, float& th);
     int PostSmoothing(const CMatrix<float> &threshed, CMatrix<float> &smoothed);
-    int isHighestInCenter(const CMatrix<float> &sample, bool &res, unsigned long i, unsigned long j, const SSize &tileSize);
-    int isPhaseErratic(const CMatrix<float> &sample, bool &res, unsigned long i, unsigned long j, const SSize &tileSize);
-    int isPointUsable(const CMatrix<float> &magSubset, CMatrix<float> &phaseSubset, bool &res, unsigned long i, unsigned long j, const SSize &tileSize);
-    int ProcessChips(const CMatrix<float> &im, const CMatrix<float> &smoothed, CMatrix<float> &sobel_phase, CVector<CChip<float> >& output);
+    int isHighestInCenter(const CMatrix<float> &sample, bool &res, unsigned long i, unsigned long j, const SSize &tileSize) const;
+    int isPhaseErratic(const CMatrix<float> &sample, bool &res, unsigned long i, unsigned long j, const SSize &tileSize, CMatrix<float> &tempPhase) const;
+    int isPointUsable(const CMatrix<float> &magSubset, const CMatrix<float> &phaseSubset, bool &res, unsigned long i, unsigned long j, const SSize &tileSize, CMatrix<float> &tempPhase) const;
+    int ProcessChips(const CMatrix<float> &im, const CMatrix<float> &smoothed, CMatrix<float> &sobel_phase);
 protected:
     virtual int innerGenerate(CChipsGen<float>::CChipsGenContext *context) override;
     virtual int SplitImagesForThreads() override;
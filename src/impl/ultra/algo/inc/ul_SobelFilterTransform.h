@@ -16,10 +16,12 @@
 
 #pragma once
 
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include <ul_UltraThreadFixedPool.h>
 #include "ul_Transform.h"
-#include "ul_ConvKernel.h"
-#include "ul_ConvKernelToImage.h"
-#include "ul_CreateConvKernel.h"
 
 namespace ultra
 {
@@ -81,77 +83,182 @@ public:
 
     };
 private:
-    CVector<CMatrix<T> > m_smoothedImage;
-    CConvKernel<T> m_gaussianKernel;
-    CConvKernel<T> m_sobelX;
-    CConvKernel<T> m_sobelY;
+    /**
+     * Images smaller than this are processed on the calling thread
+     */
+    static const unsigned long PARALLEL_MIN_PIXELS = 512 * 512;
+    static const unsigned long MIN_BAND_ROWS = 64;
+
     CContext *m_ctx;
     unsigned long m_outBandSize;
 
-    int GaussInput(unsigned long it)
+    /**
+     * Taps of the 1-D Gaussian (5 wide, stdDev 1.6) the input is smoothed with, the
+     * smoothing renormalizes by the sum of the taps used so the scale is irrelevant
+     */
+    static void getSmoothingTaps(T taps[5])
     {
-        const CVector<CMatrix<T> > *inputImages = CTransform<T, T>::getInputImages();
+        double div = 2.0 * 1.6 * 1.6;
+        for (long i = 0; i < 5; i++)
+        {
+            double x = (double) (i - 2);
+            taps[i] = (T) std::exp(-(x * x) / div);
+        }
+    }
 
-        if (m_ctx->getSmoothInput())
+    /**
+     * Horizontally smooths an input row, <code>line</code> is scratch space of <code>cols + 4</code>
+     * whose first and last two entries are zero
+     */
+    static void SmoothRow(const T *in, long cols, const T taps[5], T *line, T *out)
+    {
+        std::copy(in, in + cols, line + 2);
+        for (long c = 0; c < cols; c++)
+            out[c] = line[c] * taps[0] + line[c + 1] * taps[1] + line[c + 2] * taps[2] + line[c + 3] * taps[3] + line[c + 4] * taps[4];
+    }
+
+    /**
+     * Computes the gradient rows [rowStart, rowEnd) of <code>ComputeGradients()</code>, the outputs must be sized
+     */
+    static void ComputeGradientRows(const CMatrix<T> &input, bool smoothInput, CMatrix<T> *gradX, CMatrix<T> *gradY, CMatrix<T> *mod, CMatrix<T> *phase,
+                                    long rowStart, long rowEnd)
+    {
+        long rows = (long) input.getSize().row;
+        long cols = (long) input.getSize().col;
+        T taps[5];
+        getSmoothingTaps(taps);
+        std::vector<T> line(cols + 4, T(0));
+        std::vector<T> colWeight(cols, T(0));
+        for (long c = 0; c < cols; c++)
         {
-            if (CConvKernelToImage::Convolve<T>((*inputImages)[it], m_gaussianKernel, m_smoothedImage[it], true) != 0)
+            for (long j = 0; j < 5; j++)
             {
-                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Convolve()");
-                return 1;
+                if (c + j - 2 >= 0 && c + j - 2 < cols)
+                    colWeight[c] += taps[j];
             }
         }
-        else
+
+        // rolling buffers: horizontally smoothed input rows and fully smoothed rows
+        std::vector<T> hRows(smoothInput ? 5 * cols : 0);
+        std::vector<T> sRows(smoothInput ? 3 * cols : 0);
+        long nextS = getMAX(0L, rowStart - 1);
+        long nextH = getMAX(0L, nextS - 2);
+
+        for (long r = rowStart; r < rowEnd; r++)
         {
-            m_smoothedImage[it] = (*inputImages)[it];
+            const T *s[3] = {nullptr, nullptr, nullptr};
+            if (smoothInput)
+            {
+                long needS = getMIN(r + 1, rows - 1);
+                for (; nextS <= needS; nextS++)
+                {
+                    long needH = getMIN(nextS + 2, rows - 1);
+                    for (; nextH <= needH; nextH++)
+                        SmoothRow(input[nextH].getDataPointer(), cols, taps, &line[0], &hRows[(nextH % 5) * cols]);
+
+                    T *out = &sRows[(nextS % 3) * cols];
+                    std::fill(out, out + cols, T(0));
+                    T rowWeight = 0;
+                    for (long i = 0; i < 5; i++)
+                    {
+                        long rr = nextS + i - 2;
+                        if (rr < 0 || rr >= rows)
+                            continue;
+                        rowWeight += taps[i];
+                        const T *h = &hRows[(rr % 5) * cols];
+                        for (long c = 0; c < cols; c++)
+                            out[c] += h[c] * taps[i];
+                    }
+                    for (long c = 0; c < cols; c++)
+                        out[c] /= rowWeight * colWeight[c];
+                }
+                for (long i = 0; i < 3; i++)
+                {
+                    long rr = r + i - 1;
+                    if (rr >= 0 && rr < rows)
+                        s[i] = &sRows[(rr % 3) * cols];
+                }
+            }
+            else
+            {
+                for (long i = 0; i < 3; i++)
+                {
+                    long rr = r + i - 1;
+                    if (rr >= 0 && rr < rows)
+                        s[i] = input[rr].getDataPointer();
+                }
+            }
+
+            // the convolution skips taps outside the image and normalizes by the remaining
+            // kernel sum, only non-zero on the first/last column (X) and row (Y)
+            T xRowSum = (T) (s[0] != nullptr ? 1 : 0) + T(2) + (T) (s[2] != nullptr ? 1 : 0);
+            T *gx = gradX != nullptr ? (*gradX)[r].getDataPointer() : nullptr;
+            T *gy = gradY != nullptr ? (*gradY)[r].getDataPointer() : nullptr;
+            T *md = mod != nullptr ? (*mod)[r].getDataPointer() : nullptr;
+            T *ph = phase != nullptr ? (*phase)[r].getDataPointer() : nullptr;
+            for (long c = 0; c < cols; c++)
+            {
+                T x = 0;
+                T y = 0;
+                T weights[3] = {T(1), T(2), T(1)};
+                for (long i = 0; i < 3; i++)
+                {
+                    if (s[i] == nullptr)
+                        continue;
+                    T left = c > 0 ? s[i][c - 1] : T(0);
+                    T right = c < cols - 1 ? s[i][c + 1] : T(0);
+                    x += weights[i] * (left - right);
+                }
+                T colSum = (c > 0 ? T(1) : T(0)) + T(2) + (c < cols - 1 ? T(1) : T(0));
+                for (long j = -1; j <= 1; j++)
+                {
+                    if (c + j < 0 || c + j >= cols)
+                        continue;
+                    T below = s[2] != nullptr ? s[2][c + j] : T(0);
+                    T above = s[0] != nullptr ? s[0][c + j] : T(0);
+                    y += weights[j + 1] * (below - above);
+                }
+
+                if (c == 0)
+                    x /= -xRowSum;
+                else if (c == cols - 1)
+                    x /= xRowSum;
+                if (r == 0)
+                    y /= colSum;
+                else if (r == rows - 1)
+                    y /= -colSum;
+
+                if (gx != nullptr)
+                    gx[c] = x;
+                if (gy != nullptr)
+                    gy[c] = y;
+                if (md != nullptr)
+                    md[c] = std::sqrt(x * x + y * y);
+                if (ph != nullptr)
+                    ph[c] = atan2((double) y, (double) x);
+            }
         }
 
-        return 0;
     }
 
     int ApplySobel(unsigned long it)
     {
+        const CVector<CMatrix<T> > *inputImages = CTransform<T, T>::getInputImages();
         CVector<CMatrix<T> > *outputImages = CTransform<T, T>::getOutputImages();
 
-        if (CConvKernelToImage::Convolve<T>(m_smoothedImage[it], m_sobelX, (*outputImages)[0 + m_outBandSize * it], true) != 0)
-        {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Convolve()");
-            return 1;
-        }
+        unsigned long modIndex = 2;
+        unsigned long phaseIndex = 3;
+        if (!m_ctx->getGenMod())
+            phaseIndex = modIndex; // as we are not generating the mod we need to adjust the phase index
 
-        if (CConvKernelToImage::Convolve<T>(m_smoothedImage[it], m_sobelY, (*outputImages)[1 + m_outBandSize * it], true) != 0)
+        CMatrix<T> *mod = m_ctx->getGenMod() ? &(*outputImages)[modIndex + m_outBandSize * it] : nullptr;
+        CMatrix<T> *phase = m_ctx->getGenPhase() ? &(*outputImages)[phaseIndex + m_outBandSize * it] : nullptr;
+        if (ComputeGradients((*inputImages)[it], m_ctx->getSmoothInput(),
+                             &(*outputImages)[0 + m_outBandSize * it], &(*outputImages)[1 + m_outBandSize * it], mod, phase) != 0)
         {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Convolve()");
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ComputeGradients()");
             return 1;
         }
-        SSize size = (*outputImages)[0 + m_outBandSize * it].getSize();
-
-        int modIndex = 2;
-        int phaseIndex = 3;
-        bool genMod = m_ctx->getGenMod();
-        bool genPhase = m_ctx->getGenPhase();
-        if (genMod)
-            (*outputImages)[modIndex + m_outBandSize * it].resize(size);
-        else
-            phaseIndex = modIndex; // as we are generating the mod we need to make adjust the phase index
-        if (genPhase)
-            (*outputImages)[phaseIndex + m_outBandSize * it].resize(size);
-
-        if (genMod || genPhase)
-        {
-            unsigned long r, c;
-            for (r = 0; r < size.row; r++)
-            {
-                T *xDp = (*outputImages)[0 + m_outBandSize * it][r].getDataPointer();
-                T *yDp = (*outputImages)[1 + m_outBandSize * it][r].getDataPointer();
-                for (c = 0; c < size.col; c++)
-                {
-                    if (genMod)
-                        (*outputImages)[modIndex + m_outBandSize * it][r][c] = std::sqrt(xDp[c] * xDp[c] + yDp[c] * yDp[c]);
-                    if (genPhase)
-                        (*outputImages)[phaseIndex + m_outBandSize * it][r][c] = atan2((double) yDp[c], (double) xDp[c]);
-                }
-            }
-        }
 
         return 0;
     }
@@ -189,36 +296,8 @@ protected:
             }
         }
 
-        m_smoothedImage.resize(size);
-
-        for (unsigned long t = 0; t < size; t++)
-        {
-            if (m_smoothedImage[t].getSize() != (*inputImages)[t].getSize())
-            {
-                m_smoothedImage[t].resize((*inputImages)[t].getSize());
-            }
-        }
-
         outputImages->resize(m_outBandSize * size);
 
-        if (CCreateConvKernel::GetKernel<T>(EKernelTypes::GAUSSIAN, SSize(5, 5), m_gaussianKernel, 1.6) != 0)
-        {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to create getKernel()");
-            return 1;
-        }
-
-        if (CCreateConvKernel::GetKernel<T>(EKernelTypes::SOBEL_X, SSize(3, 3), m_sobelX, 1.6) != 0)
-        {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to create getKernel()");
-            return 1;
-        }
-
-        if (CCreateConvKernel::GetKernel<T>(EKernelTypes::SOBEL_Y, SSize(3, 3), m_sobelY, 1.6) != 0)
-        {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to create getKernel()");
-            return 1;
-        }
-
         return 0;
     }
 
@@ -229,19 +308,11 @@ protected:
         unsigned long size = inputImages->size();
         for (unsigned long it = 0; it < size; it++)
         {
-            if (GaussInput(it) != 0)
-            {
-                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GaussInput()");
-                return 1;
-            }
-
             if (ApplySobel(it) != 0)
             {
                 CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ApplySobel()");
                 return 1;
             }
-
-            m_smoothedImage[it].clear();
         }
 
         return 0;
@@ -257,6 +328,52 @@ public:
     virtual ~CSobelFilterTransform()
     {
     }
+
+    /**
+     * Computes the Gaussian smoothed (5x5, stdDev 1.6) Sobel gradients, their magnitude and
+     * phase in a single sweep over the input, keeping only a few rows of intermediate
+     * results. Gives the same results as convolving with the Gaussian and the
+     * SOBEL_X/SOBEL_Y kernels through <code>CConvKernelToImage</code>, borders included.
+     * @param input image of at least 5x5
+     * @param smoothInput
+     * @param gradX may be nullptr if not needed
+     * @param gradY may be nullptr if not needed
+     * @param mod gradient magnitude, may be nullptr if not needed
+     * @param phase gradient phase, may be nullptr if not needed
+     * @return 0 on success
+     */
+    static int ComputeGradients(const CMatrix<T> &input, bool smoothInput, CMatrix<T> *gradX, CMatrix<T> *gradY, CMatrix<T> *mod, CMatrix<T> *phase)
+    {
+        SSize size = input.getSize();
+        if (size.row < 5 || size.col < 5)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Input image must be at least 5x5");
+            return 1;
+        }
+
+        CMatrix<T> * outputs[4] = {gradX, gradY, mod, phase};
+        for (unsigned long t = 0; t < 4; t++)
+        {
+            if (outputs[t] != nullptr && outputs[t]->getSize() != size)
+                outputs[t]->resize(size);
+        }
+
+        // row bands only share input rows, each band streams its own halo
+        unsigned long bandCount = 1;
+        if (size.getProduct() >= PARALLEL_MIN_PIXELS)
+            bandCount = getMIN(AUltraThreadPool::getDefaultPoolSize(), size.row / MIN_BAND_ROWS);
+        std::function<void(unsigned long, unsigned long) > band = [&](unsigned long rowStart, unsigned long rowEnd)
+        {
+            ComputeGradientRows(input, smoothInput, gradX, gradY, mod, phase, (long) rowStart, (long) rowEnd);
+        };
+        if (CUltraThreadFixedPool::RunBands(size.row, bandCount, band) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunBands()");
+            return 1;
+        }
+
+        return 0;
+    }
 };
 
 } // namespace ultra
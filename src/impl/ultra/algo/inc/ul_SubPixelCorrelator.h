@@ -24,6 +24,47 @@
 namespace ultra
 {
 
+/**
+ * Process wide record of how far reduced precision or coarse to fine correlations deviate
+ * from exhaustive HIGH precision ones, filled by sub pixel correlators in validation mode
+ */
+class CCorrelationPrecisionValidation
+{
+public:
+    /**
+     * Offset difference in pixels above which a chip is logged
+     */
+    static const double OFFSET_DIFFERENCE_LOG_THRESHOLD;
+private:
+    std::shared_ptr<CThreadLock> m_lock;
+    unsigned long long m_compared;
+    unsigned long long m_successMismatches;
+    unsigned long long m_offsetCompared;
+    double m_offsetDifferenceSum;
+    double m_maxOffsetDifference;
+    double m_maxCoefficientDifference;
+
+    CCorrelationPrecisionValidation();
+public:
+    virtual ~CCorrelationPrecisionValidation();
+    static CCorrelationPrecisionValidation *getInstance();
+
+    /**
+     * @param correlation describes the validated correlation, e.g. its precision
+     * @param highSuccess
+     * @param highOffset
+     * @param highCoefficient
+     * @param success
+     * @param offset
+     * @param coefficient
+     */
+    void Add(const std::string &correlation,
+             bool highSuccess, const SPair<double> &highOffset, double highCoefficient,
+             bool success, const SPair<double> &offset, double coefficient);
+    void LogSummary() const;
+    void Clear();
+};
+
 namespace __ultra_internal
 {
 
@@ -50,9 +91,7 @@ public:
 class CCorrelatePhaseImpl : public ICorrelateInterface
 {
 private:
-    CMatrix<double> m_neighbors;
     SPair<double> m_templateImageSizeHalf;
-    SSize m_size3x3;
 public:
 
     CCorrelatePhaseImpl(const SPair<double> &templateImageSizeHalf);
@@ -66,12 +105,11 @@ public:
 class CCorrelateSpacePolyImpl : public ICorrelateInterface
 {
 private:
-    SSize m_size3x3;
-    SSize m_size3x1;
-    SSize m_size1x3;
-    CVector<double> m_vec3;
-    CMatrix<double> m_A, m_B;
-    CVector<double> m_leastSquareAns;
+    CMatrix<double> m_A;
+    // the least squares solution of m_A for each of the 9 neighbours, the fit is their weighted sum
+    CMatrix<double> m_solution;
+    double m_B[9];
+    double m_leastSquareAns[6];
 private:
 
     static CVector<double> genVec(double r, double c);
@@ -101,6 +139,15 @@ private:
     std::unique_ptr<__ultra_internal::ICorrelateInterface> m_subCorrelator;
     int (CSubPixelCorrelator<T>::*m_fp_calcCorrCoef)(double &);
 
+    ECorrelationPrecision m_precision;
+    SCoarseToFineSearch m_search;
+    // exhaustive HIGH precision correlator every correlation is repeated with in validation mode
+    std::unique_ptr<CSubPixelCorrelator<T> > m_reference;
+    std::string m_validationName;
+
+    const CMatrix<T> *m_region;
+    CMatrix<T> m_regionWindow;
+
     int CalcCorrCoefPhase(double &corrCoefficient)
     {
         unsigned long peakCount = 4;
@@ -159,7 +206,7 @@ private:
     }
 
     template<class N>
-    int CorrelateImpl(const CMatrix<N> &inputImage,
+    int CorrelateOnce(const CMatrix<N> &inputImage,
                       const CMatrix<N> &templateImage,
                       const double &corrThreshold,
                       bool &success,
@@ -181,9 +228,20 @@ private:
 
         if (m_isPhase)
             m_correlator->correlate(inputImage, templateImage, m_scratchImage);
+        else if (!m_search.isExhaustive())
+            m_correlator->correlateCoarseToFine(inputImage, templateImage, m_scratchImage, SCoarseToFineSearch(m_search.stride, corrThreshold),
+                                                inputNullValue, templateNullValue);
         else
             m_correlator->correlate(inputImage, templateImage, m_scratchImage, inputNullValue, templateNullValue);
 
+        return LocatePeak(corrThreshold, success, templateToInputOffset, corrCoefficient);
+    }
+
+    /**
+     * Finds the correlation peak in m_scratchImage and refines it to sub pixel accuracy
+     */
+    int LocatePeak(const double &corrThreshold, bool &success, SPair<double> &templateToInputOffset, double &corrCoefficient)
+    {
         if ((this->*m_fp_calcCorrCoef)(corrCoefficient) != 0)
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ::m_fp_calcCorrCoef()");
@@ -205,15 +263,111 @@ private:
         return 0;
     }
 
+    template<class N>
+    int CorrelateImpl(const CMatrix<N> &inputImage,
+                      const CMatrix<N> &templateImage,
+                      const double &corrThreshold,
+                      bool &success,
+                      SPair<double> &templateToInputOffset,
+                      double &corrCoefficient,
+                      const N* inputNullValue,
+                      const N* templateNullValue,
+                      bool mayInputContainNullValues,
+                      bool mayTemplateContainNullValues)
+    {
+        corrCoefficient = 0;
+        if (CorrelateOnce<N>(inputImage, templateImage, corrThreshold, success, templateToInputOffset, corrCoefficient,
+                             inputNullValue, templateNullValue, mayInputContainNullValues, mayTemplateContainNullValues) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CorrelateOnce()");
+            return 1;
+        }
+        if (!m_reference)
+            return 0;
+        if (Validate<N>(inputImage, templateImage, corrThreshold, success, templateToInputOffset, corrCoefficient,
+                        inputNullValue, templateNullValue, mayInputContainNullValues, mayTemplateContainNullValues) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Validate()");
+            return 1;
+        }
+        return 0;
+    }
+
+    /**
+     * Repeats a correlation with the HIGH precision reference correlator and records the differences
+     */
+    template<class N>
+    int Validate(const CMatrix<N> &inputImage,
+                 const CMatrix<N> &templateImage,
+                 const double &corrThreshold,
+                 bool success,
+                 const SPair<double> &templateToInputOffset,
+                 double corrCoefficient,
+                 const N* inputNullValue,
+                 const N* templateNullValue,
+                 bool mayInputContainNullValues,
+                 bool mayTemplateContainNullValues)
+    {
+        bool highSuccess = false;
+        SPair<double> highOffset;
+        double highCoefficient = 0;
+        if (m_reference->template CorrelateOnce<N>(inputImage, templateImage, corrThreshold, highSuccess, highOffset, highCoefficient,
+                                                   inputNullValue, templateNullValue, mayInputContainNullValues, mayTemplateContainNullValues) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CorrelateOnce()");
+            return 1;
+        }
+        CCorrelationPrecisionValidation::getInstance()->Add(m_validationName, highSuccess, highOffset, highCoefficient,
+                                                            success, templateToInputOffset, corrCoefficient);
+        return 0;
+    }
+
+    bool regionWindowContains(const SSize &ul, const SSize &size, const T &val) const
+    {
+        for (unsigned long r = ul.row; r < ul.row + size.row; r++)
+        {
+            const T *dp = (*m_region)[r].getDataPointer();
+            for (unsigned long c = ul.col; c < ul.col + size.col; c++)
+            {
+                if (dp[c] == val)
+                    return true;
+            }
+        }
+        return false;
+    }
+
 public:
 
+    /**
+     * @param templateImageSize
+     * @param corrType
+     * @param subPixelCorrType
+     * @param precision
+     * @param validatePrecision if set and precision is below HIGH or the search is coarse to fine, every
+     * correlation is repeated exhaustively at HIGH precision and the differences are added to CCorrelationPrecisionValidation
+     * @param coarseToFineStride CCOEFF_NORM surfaces are searched coarse to fine above 1 with
+     * the correlation threshold as the bound, see SCoarseToFineSearch
+     */
     CSubPixelCorrelator(const SSize &templateImageSize,
                         ECorrelationType corrType,
-                        ESubPixelCorrelationType subPixelCorrType)
+                        ESubPixelCorrelationType subPixelCorrType,
+                        ECorrelationPrecision precision = CDigitalImageCorrelatorFactory::getDefaultPrecision(),
+                        bool validatePrecision = CDigitalImageCorrelatorFactory::getValidatePrecision(),
+                        unsigned long coarseToFineStride = CDigitalImageCorrelatorFactory::getDefaultCoarseToFineStride()) :
+    m_precision(precision),
+    m_search(corrType == ECorrelationType::PHASE ? 1 : coarseToFineStride),
+    m_region(nullptr)
     {
         SPair<double> templateImageSizeD = templateImageSize;
         SPair<double> templateImageSizeHalf = templateImageSizeD / 2.0;
-        m_correlator = CDigitalImageCorrelatorFactory::create<T>(corrType, templateImageSize);
+        m_correlator = CDigitalImageCorrelatorFactory::create<T>(corrType, templateImageSize, precision);
+        if (validatePrecision && (precision != ECorrelationPrecision::HIGH || !m_search.isExhaustive()))
+        {
+            m_reference.reset(new CSubPixelCorrelator<T>(templateImageSize, corrType, subPixelCorrType, ECorrelationPrecision::HIGH, false, 1));
+            m_validationName = CCorrelationHelper::typeToStr(precision);
+            if (!m_search.isExhaustive())
+                m_validationName += " coarse to fine (stride '" + toString(m_search.stride) + "')";
+        }
 
         m_fp_calcCorrCoef = nullptr;
         m_isPhase = false;
@@ -274,6 +428,74 @@ public:
             mayTemplateContainNullValues);
     }
 
+    /**
+     * Sets the input region that CorrelateInRegion() correlates templates of templateImageSize in,
+     * a CCOEFF_NORM correlator builds the integral image of the region once for all of them.
+     * The region must stay valid until the next call.
+     * @param region
+     * @param templateImageSize
+     * @param inputNullValue
+     */
+    void SetSearchRegion(const CMatrix<T> &region, const SSize &templateImageSize, const T* inputNullValue = nullptr)
+    {
+        m_region = &region;
+        m_correlator->setSearchRegion(region, m_isPhase ? nullptr : inputNullValue, templateImageSize);
+    }
+
+    /**
+     * Same as Correlate() with the window of windowSize at windowUl of the search region as the input image
+     */
+    int CorrelateInRegion(const SSize &windowUl,
+                          const SSize &windowSize,
+                          const CMatrix<T> &templateImage,
+                          const double &corrThreshold,
+                          bool &success,
+                          SPair<double> &templateToInputOffset,
+                          double &corrCoefficient,
+                          const T* inputNullValue = nullptr,
+                          const T* templateNullValue = nullptr,
+                          bool mayInputContainNullValues = true,
+                          bool mayTemplateContainNullValues = true)
+    {
+        if (m_region == nullptr)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "No search region has been set");
+            return 1;
+        }
+
+        success = false;
+        corrCoefficient = 0;
+        if (m_isPhase)
+            mayInputContainNullValues = mayTemplateContainNullValues = false;
+        bool skip = !mayTemplateContainNullValues && templateNullValue != nullptr && templateImage.contains(*templateNullValue);
+        skip |= !mayInputContainNullValues && inputNullValue != nullptr && regionWindowContains(windowUl, windowSize, *inputNullValue);
+        if (!skip)
+        {
+            m_correlator->correlateInRegion(windowUl, windowSize, templateImage, m_scratchImage, m_isPhase ? nullptr : templateNullValue,
+                                            SCoarseToFineSearch(m_search.stride, corrThreshold));
+            if (LocatePeak(corrThreshold, success, templateToInputOffset, corrCoefficient) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LocatePeak()");
+                return 1;
+            }
+        }
+        if (!m_reference)
+            return 0;
+
+        if (m_region->getSubMatrix(windowUl, windowSize, m_regionWindow) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from getSubMatrix()");
+            return 1;
+        }
+        if (Validate<T>(m_regionWindow, templateImage, corrThreshold, success, templateToInputOffset, corrCoefficient,
+                        inputNullValue, templateNullValue, mayInputContainNullValues, mayTemplateContainNullValues) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Validate()");
+            return 1;
+        }
+        return 0;
+    }
+
     int Correlate(const CMatrix<SComplex<T> > &inputImage,
                   const CMatrix<SComplex<T> > &templateImage,
                   const double &corrThreshold,
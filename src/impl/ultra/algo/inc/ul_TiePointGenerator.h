@@ -20,6 +20,10 @@
 #include "ul_ChipsGen.h"
 #include "ul_DigitalImageCorrelator.h"
 #include "ul_Int_TiePointGenerator.h"
+#include "ul_ImagePrefetcher.h"
+#include "ul_CorrelationHandler.h"
+#include "ul_BoundedQueue.h"
+#include "ul_GcpShiftPriors.h"
 
 namespace ultra
 {
@@ -62,6 +66,8 @@ public:
         ECorrelationType typeOfChipCorrelationTechnique;
         // this must usually be twice the 'chipSizeMinimum' value
         unsigned long chipGenerationGridSize;
+        // Harris and Sobel keep at most this many of the strongest features per grid cell, 0 keeps all of them
+        unsigned long maxFeaturesPerCell;
         CVector<EChips::EChipType> chipGeneratorMethods;
         CVector<SPair<double> > fixedLocationChips;
         std::string fixedLocationChipProj4Str;
@@ -71,11 +77,20 @@ public:
 
         bool outerHullRejectGcps;
 
+        // GCPs whose reference chip centres are at most this far apart (map units) are duplicates, default is 0
+        double duplicateGcpTolerance;
+
         SPair<double> inputOffsetShiftInPixels;
 
         SScene inputScene;
         SScene referenceScene;
 
+        // optional, when set images are read through the prefetcher, it is not owned by the context
+        CImagePrefetcher *imagePrefetcher;
+
+        // optional, when set the chips are searched around their local shift prior, it is not owned by the context
+        const CGcpShiftPriors *shiftPriors;
+
         //methods
         SContext();
         SContext(const CTiePointGenerator::SContext & r);
@@ -129,6 +144,8 @@ private:
 private:
     static const int REF_IMG_INDEX;
     static const int INPUT_IMG_INDEX;
+    // queued chips per correlation thread between the chip generators and the correlators
+    static const unsigned long CHIP_QUEUE_DEPTH_PER_THREAD;
     SInnerContext m_context;
 
     bool isContextSceneOK(const CTiePointGenerator::SContext::SScene &context);
@@ -139,21 +156,22 @@ private:
                              );
     int LoadImgMetadata();
     int LoadTwoImages();
-    int LoadCompleteImages(CMatrixArray<float> &refImages, SImageMetadata &refMetadata,
-                           CMatrixArray<float> &inputImages, SImageMetadata &inputMetadata);
+    int LoadTwoImagesPrefetched();
+    int LoadSceneMetadata(SImageMetadata &refMetadata, SImageMetadata &inputMetadata);
     int LoadOneImageFull(int bandNumber);
     int GenerateChips(const std::string pathToImageWhereChipsAreLoadedFrom,
-                      CMatrix<float> &image, CVector<CChip<float> > &chipVector,
+                      CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink,
                       EChips::EChipType chipType);
     //chip generation systems START
-    int (CTiePointGenerator::*m_fp_generateChips)(CMatrix<float> &, CVector<CChip<float> > &);
-    int GenerateSobelChips(CMatrix<float> &image, CVector<CChip<float> > &chipVector);
-    int GenerateEvenChips(CMatrix<float> &image, CVector<CChip<float> > &chipVector);
-    int GenerateHarrisChips(CMatrix<float> &image, CVector<CChip<float> > &chipVector);
-    int GenerateFixedLocationChips(CMatrix<float> &image, CVector<CChip<float> > &chipVector);
+    int GenerateSobelChips(CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink);
+    int GenerateEvenChips(CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink);
+    int GenerateHarrisChips(CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink);
+    int GenerateFixedLocationChips(CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink);
     int GenerateChips(CChipsGen<float> *chipGenner, CChipsGen<float>::CChipsGenContext *context,
-                      CMatrix<float> &image, CVector<CChip<float> > &chipVector);
-    int TranslateChipCoordinatesToMap(CVector<CChip<float> > &chipVector);
+                      CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink);
+    void TranslateChipCoordinatesToMap(CChip<float> &chip);
+    int ProduceChips(CBoundedQueue<CChip<float> > &chipQueue,
+                     std::vector<unsigned long> &chipCounts);
     //chip generation systems END
 
     //correlation START
@@ -164,16 +182,18 @@ private:
                             const SPair<double> &origin,
                             const SPair<double> &subImageShift
                             );
-    int Correlate(
-                  CMatrix<SPair<double> > &worldMatrix,
-                  CVector<CChip<float> > &chipVector,
-                  CVector<SChipCorrelationResult> &result
-                  );
-    int StartCorrelation(CVector<CChip<float> > &chipVector, CVector<SChipCorrelationResult> &result);
+    int StartCorrelationThreads(
+                                std::unique_ptr<CCorrelationHandler> &corr,
+                                CMatrix<SPair<double> > &worldMatrix,
+                                CBoundedQueue<CChip<float> > &chipQueue
+                                );
+    int ReorderResults(CVector<SChipCorrelationResult> &result,
+                       const std::vector<unsigned long> &chipCounts);
+    int StartCorrelation(CVector<SChipCorrelationResult> &result);
     //correlation END
 
     int MainLoop(CVector<SChipCorrelationResult> &finalResult);
-    void RemoveDuplicateGcps(CVector<SChipCorrelationResult> &finalResult);
+    int RemoveDuplicateGcps(CVector<SChipCorrelationResult> &finalResult);
     int HullRejectGcps(CVector<SChipCorrelationResult> &result);
 public:
 
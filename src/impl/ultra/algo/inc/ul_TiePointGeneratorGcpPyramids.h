@@ -21,6 +21,7 @@
 #include "ul_ChipsGen.h"
 #include "ul_SubPixelCorrelator.h"
 #include "ul_AtomicLong.h"
+#include "ul_CountDownLatch.h"
 #include "ul_AtomicBool.h"
 
 namespace ultra
@@ -103,8 +104,7 @@ private:
         CAtomicLong *m_sharedCounter;
         CAtomicLong *m_sharedProcessingPercentage;
         CAtomicBool *m_runningVar;
-        CAtomicLong *m_threadDoneCount;
-        unsigned long m_totalRunningThreads;
+        CCountDownLatch *m_doneLatch;
         unsigned long m_gcpTotalCount;
 
         int ResampleData(const CMatrix<float> &originalData,
@@ -140,8 +140,7 @@ private:
                  CThreadLock *sharedLock,
                  CAtomicLong *sharedCounter,
                  CAtomicLong *sharedProcessingPercentage,
-                 CAtomicLong *threadDoneCount,
-                 unsigned long totalRunningThreads,
+                 CCountDownLatch *doneLatch,
                  CAtomicBool *runningVar);
         int getExitCode() const;
         virtual void run(void *context = nullptr);
@@ -40,11 +40,18 @@ public:
         bool mayContainNullValues;
         unsigned long chipSize;
         unsigned long chipGenerationGridSize;
+        // Harris and Sobel keep at most this many of the strongest features per grid cell, 0 keeps all of them
+        unsigned long maxFeaturesPerCell;
         ECorrelationType typeOfChipCorrelationTechnique;
         CVector<EChips::EChipType> chipGeneratorMethods;
         CVector<SPair<double> > fixedLocationChips;
         std::string fixedLocationChipProj4Str;
         double correlationThreshold;
+        // GCPs whose reference chip centres are at most this far apart (map units) are duplicates,
+        // neighbouring tiles overlap so their GCPs may not coincide exactly, default is 0
+        double duplicateGcpTolerance;
+        // search the chips of a finer pyramid level around the shifts of the nearby coarser GCPs, default is true
+        bool localShiftPriors;
 
         SContext();
         ~SContext();
@@ -74,6 +81,7 @@ private:
     int CleanSubItems(const std::string &path);
     int ProcessTile(const CVector<std::string> &scenePaths,
                     const std::string &workingFolder,
+                    CImagePrefetcher *prefetcher,
                     CVector<SChipCorrelationResult> &result);
     int MergeAndCleanOutput(const CVector<CVector<SChipCorrelationResult> > &gcps,
                             CVector<SChipCorrelationResult> &result);
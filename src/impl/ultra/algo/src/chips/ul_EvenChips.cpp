@@ -87,7 +87,6 @@ int CEvenChips::Init(CChipsGen<float>::CChipsGenContext *context)
 
 int CEvenChips::Process()
 {
-    std::vector<CChip<float> > tempChipVector;
     CChip<float> chip;
 
     unsigned long start;
@@ -143,20 +142,22 @@ int CEvenChips::Process()
             chip.boundingCoordinate[2] = chip.midCoordinate + SPair<double>(cornerOffset, cornerOffset);
             chip.boundingCoordinate[3] = chip.midCoordinate + SPair<double>(-cornerOffset, cornerOffset);
 
-            tempChipVector.push_back(chip);
+            if (EmitChip(chip) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from EmitChip()");
+                return 1;
+            }
         }
 
         if (per != (int) ((r * 100) / stopR))
         {
             per = (int) ((r * 100) / stopR);
-            CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing " + toString(per) + "%      \r");
+            ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Processing " + toString(per) + "%      \r");
         }
     }
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing 100%      ");
 
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Generated '" + toString(tempChipVector.size()) + "' chips");
-
-    (*(this->m_outputChips)) = tempChipVector;
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Generated '" + toString(id) + "' chips");
 
     return 0;
 }
@@ -126,7 +126,6 @@ int CFixedLocationChips::Process()
     long cornerOffset = m_context->chipSize / 2;
     SSize ul;
     SSize chipSize = m_context->chipSize;
-    CSmartVector<CChip<float> > q;
     int per = 0;
     unsigned long size = m_context->locations.size();
     for (unsigned long t = 0; t < size; t++)
@@ -164,19 +163,22 @@ int CFixedLocationChips::Process()
             chip.boundingCoordinate[2] = sl + SPair<double>(cornerOffset, cornerOffset);
             chip.boundingCoordinate[3] = sl + SPair<double>(-cornerOffset, cornerOffset);
 
-            q.pushBack(chip);
+            if (EmitChip(chip) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from EmitChip()");
+                return 1;
+            }
 
             if (per != (int) ((t * 100) / size))
             {
                 per = (int) ((t * 100) / size);
-                CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing " + toString(per) + "%      \r");
+                ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Processing " + toString(per) + "%      \r");
             }
         }
     }
 
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing 100%      ");
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Generated '" + toString(q.size()) + "' chips");
-    (*this->m_outputChips) = q.toVector();
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Generated '" + toString(chipId) + "' chips");
     return 0;
 }
 
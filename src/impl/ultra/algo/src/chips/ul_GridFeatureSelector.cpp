@@ -0,0 +1,154 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ul_GridFeatureSelector.h"
+
+#include <algorithm>
+
+namespace ultra
+{
+
+CGridFeatureSelector::SFeature::SFeature()
+{
+    row = 0;
+    col = 0;
+    score = 0;
+}
+
+CGridFeatureSelector::SFeature::SFeature(unsigned long row, unsigned long col, float score)
+{
+    this->row = row;
+    this->col = col;
+    this->score = score;
+}
+
+CGridFeatureSelector::CGridFeatureSelector(const SSize &imageSize, unsigned long cellSize, unsigned long maxPerCell)
+{
+    if (cellSize == 0 || maxPerCell == 0)
+    {
+        m_cellSize = 0;
+        m_maxPerCell = 0;
+        m_cellCols = 1;
+        m_cellRows = 1;
+        m_nextCellRow = 0;
+        m_cells.resize(1);
+        return;
+    }
+
+    m_cellSize = cellSize;
+    m_maxPerCell = maxPerCell;
+    m_cellCols = (imageSize.col + cellSize - 1) / cellSize;
+    m_cellRows = (imageSize.row + cellSize - 1) / cellSize;
+    m_nextCellRow = 0;
+    m_cells.resize(getMAX(1UL, m_cellCols * m_cellRows));
+}
+
+CGridFeatureSelector::~CGridFeatureSelector()
+{
+}
+
+/**
+ * Orders by score, ties go to the feature that comes first in raster order so the selection is deterministic
+ */
+bool CGridFeatureSelector::isWeaker(const SFeature &a, const SFeature &b)
+{
+    if (a.score != b.score)
+        return a.score < b.score;
+    if (a.row != b.row)
+        return a.row > b.row;
+    return a.col > b.col;
+}
+
+void CGridFeatureSelector::Add(unsigned long row, unsigned long col, float score)
+{
+    if (m_cellSize == 0)
+    {
+        m_cells[0].push_back(SFeature(row, col, score));
+        return;
+    }
+
+    std::vector<SFeature> &cell = m_cells[(row / m_cellSize) * m_cellCols + col / m_cellSize];
+    SFeature feature(row, col, score);
+    // min-heap on strength, the weakest kept feature is at the front
+    auto stronger = [](const SFeature &a, const SFeature & b)->bool
+    {
+        return isWeaker(b, a);
+    };
+    if (cell.size() < m_maxPerCell)
+    {
+        cell.push_back(feature);
+        std::push_heap(cell.begin(), cell.end(), stronger);
+    }
+    else if (isWeaker(cell.front(), feature))
+    {
+        std::pop_heap(cell.begin(), cell.end(), stronger);
+        cell.back() = feature;
+        std::push_heap(cell.begin(), cell.end(), stronger);
+    }
+}
+
+void CGridFeatureSelector::SortRasterOrder(std::vector<SFeature> &features)
+{
+    std::sort(features.begin(), features.end(), [](const SFeature &a, const SFeature & b)->bool
+    {
+        if (a.row != b.row)
+            return a.row < b.row;
+        return a.col < b.col;
+    });
+}
+
+std::vector<CGridFeatureSelector::SFeature> CGridFeatureSelector::getFeatures() const
+{
+    std::vector<SFeature> features;
+    for (const auto &cell : m_cells)
+        features.insert(features.end(), cell.begin(), cell.end());
+
+    SortRasterOrder(features);
+    return features;
+}
+
+std::vector<CGridFeatureSelector::SFeature> CGridFeatureSelector::TakeFeaturesAbove(unsigned long row)
+{
+    std::vector<SFeature> features;
+    if (m_cellSize == 0)
+    {
+        std::vector<SFeature> &cell = m_cells[0];
+        auto above = std::stable_partition(cell.begin(), cell.end(), [row](const SFeature & feature)->bool
+        {
+            return feature.row < row;
+        });
+        features.assign(cell.begin(), above);
+        cell.erase(cell.begin(), above);
+    }
+    else
+    {
+        unsigned long endCellRow = getMIN(row / m_cellSize, m_cellRows);
+        for (; m_nextCellRow < endCellRow; m_nextCellRow++)
+        {
+            for (unsigned long c = 0; c < m_cellCols; c++)
+            {
+                std::vector<SFeature> &cell = m_cells[m_nextCellRow * m_cellCols + c];
+                features.insert(features.end(), cell.begin(), cell.end());
+                std::vector<SFeature>().swap(cell);
+            }
+        }
+    }
+
+    SortRasterOrder(features);
+    return features;
+}
+
+} // namespace ultra
@@ -16,7 +16,7 @@
 
 #include "ul_HarrisChips.h"
 
-#include "ul_HarrisCornerTransform.h"
+#include "ul_GridFeatureSelector.h"
 
 namespace ultra
 {
@@ -58,7 +58,7 @@ int CHarrisChips::Init(CChipsGen<float>::CChipsGenContext *context)
     return 0;
 }
 
-int CHarrisChips::ProcessHarrisTransformImageVector(CVector<CMatrix<unsigned char> > &imageVecOut)
+int CHarrisChips::ProcessHarrisTransformImageVector(CHarrisCornerTransform &harrisCornerTransform, CVector<CMatrix<unsigned char> > &imageVecOut)
 {
     CVector<CMatrix<float> > imageVecIn;
 
@@ -73,17 +73,8 @@ int CHarrisChips::ProcessHarrisTransformImageVector(CVector<CMatrix<unsigned cha
 
     CHarrisCornerTransform::CHarrisCornerContext harrisTransformContext;
 
-    CTransform<float, unsigned char> *harrisCornerTransform = new CHarrisCornerTransform();
-    if (harrisCornerTransform == nullptr)
+    if (harrisCornerTransform.LoadData(&imageVecIn, &imageVecOut) != 0)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to create CHarrisCornerTransform object");
-        return 1;
-    }
-
-    if (harrisCornerTransform->LoadData(&imageVecIn, &imageVecOut) != 0)
-    {
-        delete harrisCornerTransform;
-        harrisCornerTransform = nullptr;
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadData()");
         return 1;
     }
@@ -91,42 +82,28 @@ int CHarrisChips::ProcessHarrisTransformImageVector(CVector<CMatrix<unsigned cha
     unsigned long gcpCount = imageVecIn[0].getSize().col * imageVecIn[0].getSize().row;
     gcpCount /= (m_context->chipSize * m_context->chipSize);
     gcpCount /= 4;
-    unsigned long pointsFound;
-    int loop = 0;
+
+    // same threshold ladder as before (1.0 down to 0.5), but the response is only computed once
     harrisTransformContext.minHarrisValue = 1.0;
-    while (true)
+    harrisTransformContext.thresholdStep = 0.1f;
+    harrisTransformContext.maxThresholdSteps = 5;
+    harrisTransformContext.minCornerCount = gcpCount;
+    harrisTransformContext.nonMaximumSuppression = true;
+    if (harrisCornerTransform.Transform(&harrisTransformContext) != 0)
     {
-        if (harrisCornerTransform->Transform(&harrisTransformContext) != 0)
-        {
-            delete harrisCornerTransform;
-            harrisCornerTransform = nullptr;
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Transform()");
-            return 1;
-        }
-
-        pointsFound = imageVecOut[0].countIfGreaterThan(0);
-        if (pointsFound > gcpCount)
-        {
-            break;
-        }
-        loop++;
-        harrisTransformContext.minHarrisValue -= 0.1;
-        if (loop > 5)
-        {
-            break;
-        }
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Transform()");
+        return 1;
     }
-
-    delete harrisCornerTransform;
-    harrisCornerTransform = nullptr;
+    ULTRA_LOG(CLogger::LOG_DEBUG, "Harris threshold '" + toString(harrisTransformContext.selectedHarrisValue) + "'");
 
     return 0;
 }
 
 int CHarrisChips::Process()
 {
+    CHarrisCornerTransform harrisCornerTransform;
     CVector<CMatrix<unsigned char> > imageVecOut;
-    if (ProcessHarrisTransformImageVector(imageVecOut) != 0)
+    if (ProcessHarrisTransformImageVector(harrisCornerTransform, imageVecOut) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ProcessHarrisTransformImageVector()");
         return 1;
@@ -137,50 +114,72 @@ int CHarrisChips::Process()
     long chipHalf = m_context->chipSize / 2;
     SSize chipSize = SSize(m_context->chipSize, m_context->chipSize);
     long rMax = size.row - chipHalf, cMax = size.col - chipHalf;
-    std::vector<CChip<float> > tempChipVector;
-    CChip<float> chip;
-    unsigned long id = 0;
+    const CMatrix<float> &response = harrisCornerTransform.getResponse();
+    CGridFeatureSelector selector(size, m_context->gridSize, m_context->maxFeaturesPerCell);
+    unsigned long chipCount = 0;
     int per = 0;
-    unsigned long ulR, ulC;
-    chip.chipType = EChips::chipGenTypeToStr(EChips::CHIP_GEN_HARRIS);
-    chip.worldMatrix.clear();
 
-    for (r = chipHalf; r < rMax; r++)
+    // chip data is only extracted for the selected corners, a grid cell row is handed on the
+    // moment the scan passed it so its chips are correlated while the rest is scanned
+    std::function<int(const std::vector<CGridFeatureSelector::SFeature> &) > emitFeatures = [&](const std::vector<CGridFeatureSelector::SFeature> &features)->int
     {
-        for (c = chipHalf; c < cMax; c++)
+        for (const auto &feature : features)
         {
-            if (imageVecOut[0][r][c] != 0)
+            CChip<float> chip;
+            chip.chipType = EChips::chipGenTypeToStr(EChips::CHIP_GEN_HARRIS);
+            chip.worldMatrix.clear();
+            chip.chipData = this->m_inputImage->getSubMatrix(SSize(feature.row - chipHalf, feature.col - chipHalf), chipSize);
+            chip.chipId = chipCount++;
+            chip.midCoordinate = SPair<double>((double) (feature.row), (double) (feature.col));
+
+            /**
+             * 0 = UL
+             * 1 = LL
+             * 2 = LR
+             * 3 = UR
+             */
+            chip.boundingCoordinate[0] = chip.midCoordinate + SPair<double>(-chipHalf, -chipHalf);
+            chip.boundingCoordinate[1] = chip.midCoordinate + SPair<double>(chipHalf, -chipHalf);
+            chip.boundingCoordinate[2] = chip.midCoordinate + SPair<double>(chipHalf, chipHalf);
+            chip.boundingCoordinate[3] = chip.midCoordinate + SPair<double>(-chipHalf, chipHalf);
+
+            if (EmitChip(chip) != 0)
             {
-                ulR = r - chipHalf;
-                ulC = c - chipHalf;
-                chip.chipData = this->m_inputImage->getSubMatrix(SSize(ulR, ulC), chipSize);
-                chip.chipId = id++;
-                chip.midCoordinate = SPair<double>((double) (r), (double) (c));
-
-                /**
-                 * 0 = UL
-                 * 1 = LL
-                 * 2 = LR
-                 * 3 = UR
-                 */
-                chip.boundingCoordinate[0] = chip.midCoordinate + SPair<double>(-chipHalf, -chipHalf);
-                chip.boundingCoordinate[1] = chip.midCoordinate + SPair<double>(chipHalf, -chipHalf);
-                chip.boundingCoordinate[2] = chip.midCoordinate + SPair<double>(chipHalf, chipHalf);
-                chip.boundingCoordinate[3] = chip.midCoordinate + SPair<double>(-chipHalf, chipHalf);
-                tempChipVector.push_back(chip);
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from EmitChip()");
+                return 1;
             }
         }
+        return 0;
+    };
+
+    for (r = chipHalf; r < rMax; r++)
+    {
+        const unsigned char *corners = imageVecOut[0][r].getDataPointer();
+        const float *strength = response[r].getDataPointer();
+        for (c = chipHalf; c < cMax; c++)
+        {
+            if (corners[c] != 0)
+                selector.Add(r, c, strength[c]);
+        }
+        if (emitFeatures(selector.TakeFeaturesAbove(r + 1)) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from emitFeatures()");
+            return 1;
+        }
         if (per != (int) ((r * 100) / rMax))
         {
             per = (int) ((r * 100) / rMax);
-            CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing " + toString(per) + "%      \r");
+            ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Processing " + toString(per) + "%      \r");
         }
     }
+    if (emitFeatures(selector.getFeatures()) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from emitFeatures()");
+        return 1;
+    }
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing 100%      ");
 
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Generated '" + toString(tempChipVector.size()) + "' chips");
-
-    (*(this->m_outputChips)) = tempChipVector;
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Generated '" + toString(chipCount) + "' chips");
 
     return 0;
 }
@@ -17,6 +17,8 @@
 #include "ul_SobelChips.h"
 
 #include "ul_Logger.h"
+#include "ul_UltraThreadFixedPool.h"
+#include "ul_GridFeatureSelector.h"
 
 namespace ultra
 {
@@ -24,19 +26,12 @@ namespace ultra
 CSobelChips::CSobelChips() :
 CChipsGen<float>("Sobel_ChipsGen")
 {
-    m_transformer = nullptr;
     m_smoother = nullptr;
     m_smootherCtx = nullptr;
 }
 
 CSobelChips::~CSobelChips()
 {
-    if (m_transformer != nullptr)
-    {
-        delete m_transformer;
-        m_transformer = nullptr;
-    }
-
     if (m_smoother != nullptr)
     {
         delete m_smoother;
@@ -60,6 +55,8 @@ int CSobelChips::Init(CChipsGen<float>::CChipsGenContext *context)
     }
 
     m_chipWidth = thisContext->chipWidth;
+    m_gridSize = thisContext->gridSize;
+    m_maxFeaturesPerCell = thisContext->maxFeaturesPerCell;
 
     if (m_chipWidth % 2 != 0 && m_chipWidth <= 0)
     {
@@ -68,11 +65,6 @@ int CSobelChips::Init(CChipsGen<float>::CChipsGenContext *context)
     }
     m_chipOffset = (m_chipWidth - 1) / 2;
 
-    if (m_transformer == nullptr)
-    {
-        m_transformer = new CSobelFilterTransform<float>();
-    }
-
     if (m_smoother == nullptr)
     {
         m_smoother = new CGaussianFilterTransform<float>();
@@ -88,41 +80,12 @@ int CSobelChips::Init(CChipsGen<float>::CChipsGenContext *context)
 
 int CSobelChips::ApplySobel(const CMatrix<float> &im, CMatrix<float> &sobel_grad, CMatrix<float> &sobel_phase)
 {
-    CVector<CMatrix<float> > imVec;
-    CVector<CMatrix<float> > sobelOut;
-
-    imVec.resize(1);
-    imVec[0] = im;
-    if (imVec[0].getSize() != im.getSize())
+    if (CSobelFilterTransform<float>::ComputeGradients(im, true, nullptr, nullptr, &sobel_grad, &sobel_phase) != 0)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed make a copy of the input image");
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CSobelFilterTransform::ComputeGradients()");
         return 1;
     }
 
-    if (m_transformer->LoadData(&imVec, &sobelOut) != 0)
-    {
-        delete m_transformer;
-        m_transformer = nullptr;
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadData()");
-        return 1;
-    }
-    if (m_transformer->Transform() != 0)
-    {
-        delete m_transformer;
-        m_transformer = nullptr;
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Transform()");
-        return 1;
-    }
-
-    if (sobelOut.size() < 4)
-    {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Too few images is returned from the Sobel transform");
-        return 1;
-    }
-
-    sobel_grad = sobelOut[2];
-    sobel_phase = sobelOut[3];
-
     return 0;
 }
 
@@ -198,7 +161,7 @@ int CSobelChips::PostSmoothing(const CMatrix<float> &threshed, CMatrix<float> &s
     return 0;
 }
 
-int CSobelChips::isHighestInCenter(const CMatrix<float> &sample, bool &res, unsigned long i, unsigned long j, const SSize &tileSize)
+int CSobelChips::isHighestInCenter(const CMatrix<float> &sample, bool &res, unsigned long i, unsigned long j, const SSize &tileSize) const
 {
     res = false;
     int centerCol = j + (tileSize.col / 2);
@@ -228,28 +191,28 @@ int CSobelChips::isHighestInCenter(const CMatrix<float> &sample, bool &res, unsi
     return 0;
 }
 
-int CSobelChips::isPhaseErratic(const CMatrix<float> &sample, bool &res, unsigned long i, unsigned long j, const SSize &tileSize)
+int CSobelChips::isPhaseErratic(const CMatrix<float> &sample, bool &res, unsigned long i, unsigned long j, const SSize &tileSize, CMatrix<float> &tempPhase) const
 {
     //check the phase and make sure that NOT all points in the same directions
     for (unsigned long r = 0; r < tileSize.row; r++)
     {
         const float *sampleP = &sample[r + i][0];
-        float *gaussian = &m_gaussianKernel[r][0];
-        float *phase = &m_tempPhase[r][0];
+        const float *gaussian = &m_gaussianKernel[r][0];
+        float *phase = &tempPhase[r][0];
         for (unsigned long c = 0; c < tileSize.col; c++)
         {
             phase[c] = sampleP[c + j] * gaussian[c];
         }
     }
 
-    double stdDev = m_tempPhase.stdDev();
+    double stdDev = tempPhase.stdDev();
     if (stdDev < 0.01)
         res = false;
 
     return 0;
 }
 
-int CSobelChips::isPointUsable(const CMatrix<float> &magSubset, CMatrix<float> &phaseSubset, bool &res, unsigned long i, unsigned long j, const SSize &tileSize)
+int CSobelChips::isPointUsable(const CMatrix<float> &magSubset, const CMatrix<float> &phaseSubset, bool &res, unsigned long i, unsigned long j, const SSize &tileSize, CMatrix<float> &tempPhase) const
 {
     if (isHighestInCenter(magSubset, res, i, j, tileSize) != 0)
     {
@@ -259,7 +222,7 @@ int CSobelChips::isPointUsable(const CMatrix<float> &magSubset, CMatrix<float> &
 
     if (res)
     {
-        if (isPhaseErratic(phaseSubset, res, i, j, tileSize) != 0)
+        if (isPhaseErratic(phaseSubset, res, i, j, tileSize, tempPhase) != 0)
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from isPhaseErratic()");
             return 1;
@@ -268,35 +231,47 @@ int CSobelChips::isPointUsable(const CMatrix<float> &magSubset, CMatrix<float> &
     return 0;
 }
 
-int CSobelChips::ProcessChips(const CMatrix<float> &im, const CMatrix<float> &smoothed, CMatrix<float> &sobel_phase, CVector<CChip<float> >& output)
+int CSobelChips::ProcessChips(const CMatrix<float> &im, const CMatrix<float> &smoothed, CMatrix<float> &sobel_phase)
 {
     // Process for chips    
     unsigned long sizeY = smoothed.getSize().row;
     unsigned long sizeX = smoothed.getSize().col;
-    std::vector<CChip<float> > chipList;
-    CChip<float> chip;
-    chip.chipType = EChips::chipGenTypeToStr(EChips::CHIP_GEN_SOBEL);
-    unsigned long currentId = 0;
-    bool test;
-    long per = -1;
-    long tempPer = 0;
-
     long difY = sizeY - m_chipWidth;
     long difX = sizeX - m_chipWidth;
     SSize tileSize = SSize(m_chipWidth, m_chipWidth);
-    m_tempPhase.resize(tileSize);
-    for (unsigned long i = 0; i < difY; i++)
+    if (difY <= 0 || difX <= 0)
+        return 0;
+
+    // the bands are split on whole grid cell rows, so every band selects the final strongest
+    // points of its cells on its own and its chips can be handed on as soon as the bands above
+    // it handed on theirs, in the same order regardless of the band layout
+    unsigned long unitRows = (m_gridSize > 0 && m_maxFeaturesPerCell > 0) ? m_gridSize : 1;
+    unsigned long unitCount = (difY + unitRows - 1) / unitRows;
+    unsigned long bandCount = smoothed.getSize().getProduct() >= 512 * 512 ? AUltraThreadPool::getDefaultPoolSize() : 1;
+    bandCount = getMAX(1UL, getMIN(bandCount, unitCount));
+    // the same split as CUltraThreadFixedPool::RunBands()
+    unsigned long bandUnits = (unitCount + bandCount - 1) / bandCount;
+    bandCount = (unitCount + bandUnits - 1) / bandUnits;
+
+    std::vector<std::vector<CGridFeatureSelector::SFeature> > bandFeatures(bandCount);
+    std::vector<bool> bandDone(bandCount, false);
+    std::vector<int> bandErrors(bandCount, 0);
+    std::shared_ptr<CThreadLock> emitLock = std::make_shared<CThreadLock>();
+    unsigned long nextBand = 0;
+    unsigned long chipCount = 0;
+    int emitError = 0;
+
+    // called with emitLock held, hands on the features of the bands in band order
+    std::function<void() > emitBands = [&]()
     {
-        for (unsigned long j = 0; j < difX; j++)
+        while (emitError == 0 && nextBand < bandCount)
         {
-            if (isPointUsable(smoothed, sobel_phase, test, i, j, tileSize) != 0)
-            {
-                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from isPointUsable()");
-                return 1;
-            }
-
-            if (test)
+            for (const auto &feature : bandFeatures[nextBand])
             {
+                unsigned long i = feature.row;
+                unsigned long j = feature.col;
+                CChip<float> chip;
+                chip.chipType = EChips::chipGenTypeToStr(EChips::CHIP_GEN_SOBEL);
                 chip.chipData = im.getSubMatrix(SSize(i, j), tileSize);
                 chip.midCoordinate = SPair<double>(i + m_chipOffset, j + m_chipOffset);
                 /**
@@ -309,22 +284,78 @@ int CSobelChips::ProcessChips(const CMatrix<float> &im, const CMatrix<float> &sm
                 chip.boundingCoordinate[1] = SPair<double>(i, j + m_chipWidth);
                 chip.boundingCoordinate[2] = SPair<double>(i + m_chipWidth, j + m_chipWidth);
                 chip.boundingCoordinate[3] = SPair<double>(i + m_chipWidth, j);
-                chip.chipId = currentId++;
-                chipList.push_back(chip);
+                chip.chipId = chipCount++;
+                if (EmitChip(chip) != 0)
+                {
+                    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from EmitChip()");
+                    emitError = 1;
+                    return;
+                }
             }
+            bandFeatures[nextBand].clear();
+            if (!bandDone[nextBand])
+                return;
+            nextBand++;
+        }
+    };
 
+    std::function<void(unsigned long, unsigned long) > band = [&](unsigned long unitStart, unsigned long unitEnd)
+    {
+        unsigned long bandIndex = unitStart / bandUnits;
+        unsigned long rowEnd = getMIN((unsigned long) difY, unitEnd * unitRows);
+        CMatrix<float> tempPhase(tileSize);
+        CGridFeatureSelector selector(smoothed.getSize(), m_gridSize, m_maxFeaturesPerCell);
+        bool test;
+        for (unsigned long i = unitStart * unitRows; i < rowEnd; i++)
+        {
+            for (long j = 0; j < difX; j++)
+            {
+                if (isPointUsable(smoothed, sobel_phase, test, i, j, tileSize, tempPhase) != 0)
+                {
+                    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from isPointUsable()");
+                    bandErrors[bandIndex] = 1;
+                    return;
+                }
+
+                if (test)
+                    selector.Add(i, j, smoothed[i + tileSize.row / 2][j + tileSize.col / 2]);
+            }
 
+            bool lastRow = i + 1 == rowEnd;
+            if (!lastRow && (i + 1) % unitRows != 0)
+                continue;
+
+            std::vector<CGridFeatureSelector::SFeature> features = lastRow ? selector.getFeatures() : selector.TakeFeaturesAbove(i + 1);
+            AUTO_LOCK(emitLock);
+            bandFeatures[bandIndex].insert(bandFeatures[bandIndex].end(), features.begin(), features.end());
+            bandDone[bandIndex] = lastRow;
+            emitBands();
+            if (lastRow || emitError != 0)
+                return;
         }
-        tempPer = (i * 100) / difY;
-        if (per != tempPer)
+    };
+    if (CUltraThreadFixedPool::RunBands(unitCount, bandCount, band) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunBands()");
+        return 1;
+    }
+
+    for (unsigned long b = 0; b < bandCount; b++)
+    {
+        if (bandErrors[b] != 0)
         {
-            per = tempPer;
-            CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Sobel-chips generation: " + toString(per) + "%                   \r");
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to process a band of the image");
+            return 1;
         }
     }
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Sobel-chips generation: 100%   ");
 
-    output = chipList;
+    if (emitError != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from emitBands()");
+        return 1;
+    }
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Sobel-chips generation: 100%   ");
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Generated '" + toString(chipCount) + "' chips");
 
     return 0;
 }
@@ -377,7 +408,8 @@ int CSobelChips::innerGenerate(CChipsGen<float>::CChipsGenContext *context)
         return 1;
     }
 
-    if (ProcessChips(*(this->m_inputImage), smoothed.fit(), sobel_phase, *(this->m_outputChips)) != 0)
+    this->m_outputChips->clear();
+    if (ProcessChips(*(this->m_inputImage), smoothed.fit(), sobel_phase) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ProcessChips()");
         return 1;
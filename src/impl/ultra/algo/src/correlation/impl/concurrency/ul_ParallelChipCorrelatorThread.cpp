@@ -15,6 +15,7 @@
 */
 
 #include "ul_ParallelChipCorrelatorThread.h"
+#include <ul_Profiler.h>
 
 
 namespace ultra
@@ -22,21 +23,23 @@ namespace ultra
 namespace __ultra_internal
 {
 
-CParallelChipCorrelatorThread::CParallelChipCorrelatorThread(CAtomicLong *threadCompletedCount, unsigned long threadsSpawned, std::shared_ptr<CThreadLock> lock) :
-m_lock(lock)
+const unsigned long CParallelChipCorrelatorThread::MAX_CHIPS_PER_REGION = 8;
+
+CParallelChipCorrelatorThread::CParallelChipCorrelatorThread(CCountDownLatch *completedLatch)
 {
     m_mapper = nullptr;
 
     m_inputImage = nullptr;
     m_inputChips = nullptr;
+    m_chipQueue = nullptr;
     m_results = nullptr;
     m_worldMatrix = nullptr;
 
     m_useNullValue = false;
     m_mayContainNullValues = true;
 
-    m_threadCompletedCount = threadCompletedCount;
-    m_threadsSpawned = threadsSpawned;
+    m_completedLatch = completedLatch;
+    m_failed = false;
 }
 
 CParallelChipCorrelatorThread::~CParallelChipCorrelatorThread()
@@ -48,14 +51,50 @@ CParallelChipCorrelatorThread::~CParallelChipCorrelatorThread()
     }
 }
 
+int CParallelChipCorrelatorThread::InitSubCorrelator(const SSize &chipSize)
+{
+    m_phaseImageSize = chipSize;
+    if (m_phaseImageSize.row <= 1 ||
+        m_phaseImageSize.col <= 1)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Phase correlation image size is too small");
+        return 1;
+    }
+
+    if (m_phaseImageSize.col % 2 != 0)
+        m_phaseImageSize.col--;
+    if (m_phaseImageSize.row % 2 != 0)
+        m_phaseImageSize.row--;
+
+    if (!m_subCorrelator)
+    {
+        ESubPixelCorrelationType subType = ESubPixelCorrelationType::SUB_PIXEL_CORRELATION_TYPE_COUNT;
+        if (m_correlationMethod == ECorrelationType::PHASE)
+            subType = ESubPixelCorrelationType::PHASE_SUB_PIXEL;
+        else
+            subType = ESubPixelCorrelationType::LEAST_SQUARE_SUB_PIXEL;
+
+        m_subCorrelator.reset(new CSubPixelCorrelator<float>(m_phaseImageSize, m_correlationMethod, subType));
+    }
+
+    return 0;
+}
+
 int CParallelChipCorrelatorThread::innerInit()
 {
-    if (m_inputImage == nullptr || m_inputChips == nullptr || m_results == nullptr || m_worldMatrix == nullptr)
+    if (m_inputImage == nullptr || (m_inputChips == nullptr && m_chipQueue == nullptr) || m_results == nullptr || m_worldMatrix == nullptr)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Input image, world-matrix and or chip are not loaded, or results set is not loaded, please call LoadData");
         return 1;
     }
 
+    if (m_chipQueue != nullptr)
+    {
+        // the sub pixel correlator is created once the first chip is popped
+        m_results->clear();
+        return 0;
+    }
+
     unsigned long size = m_inputChips->size();
     if (size == 0)
     {
@@ -79,35 +118,39 @@ int CParallelChipCorrelatorThread::innerInit()
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "No valid chips found skipping,");
         return 0;
     }
-    m_phaseImageSize = (*m_inputChips)[sizeIndex].chipData.getSize();
-    if (m_phaseImageSize.row <= 1 ||
-        m_phaseImageSize.col <= 1)
+    if (InitSubCorrelator((*m_inputChips)[sizeIndex].chipData.getSize()) != 0)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Phase correlation image size is too small");
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from InitSubCorrelator()");
         return 1;
     }
 
-    if (m_phaseImageSize.col % 2 != 0)
-        m_phaseImageSize.col--;
-    if (m_phaseImageSize.row % 2 != 0)
-        m_phaseImageSize.row--;
+    return 0;
+}
 
-    if (!m_subCorrelator)
+int CParallelChipCorrelatorThread::LoadData(const CMatrix<float> *inputImage,
+                                            const CVector<CChip<float> > *inputChips,
+                                            CVector<SChipCorrelationResult> *results,
+                                            const CMatrix<SPair<double> > *worldMatrix,
+                                            const SPair<double> &pixelGroundSamplingDistance,
+                                            unsigned long spatialCorrelationSearchWindowSize,
+                                            float correlationThreshold,
+                                            ECorrelationType correlationMethod,
+                                            bool useNullValue, float nullValue, bool mayContainNullValues)
+{
+    if (inputChips == nullptr)
     {
-        ESubPixelCorrelationType subType = ESubPixelCorrelationType::SUB_PIXEL_CORRELATION_TYPE_COUNT;
-        if (m_correlationMethod == ECorrelationType::PHASE)
-            subType = ESubPixelCorrelationType::PHASE_SUB_PIXEL;
-        else
-            subType = ESubPixelCorrelationType::LEAST_SQUARE_SUB_PIXEL;
-
-        m_subCorrelator.reset(new CSubPixelCorrelator<float>(m_phaseImageSize, m_correlationMethod, subType));
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid conversion for input float chips");
+        return 1;
     }
 
-    return 0;
+    m_inputChips = inputChips;
+    m_chipQueue = nullptr;
+    return innerLoadData(inputImage, results, worldMatrix, pixelGroundSamplingDistance, spatialCorrelationSearchWindowSize,
+                         correlationThreshold, correlationMethod, useNullValue, nullValue, mayContainNullValues);
 }
 
 int CParallelChipCorrelatorThread::LoadData(const CMatrix<float> *inputImage,
-                                            const CVector<CChip<float> > *inputChips,
+                                            CBoundedQueue<CChip<float> > *chipQueue,
                                             CVector<SChipCorrelationResult> *results,
                                             const CMatrix<SPair<double> > *worldMatrix,
                                             const SPair<double> &pixelGroundSamplingDistance,
@@ -115,9 +158,29 @@ int CParallelChipCorrelatorThread::LoadData(const CMatrix<float> *inputImage,
                                             float correlationThreshold,
                                             ECorrelationType correlationMethod,
                                             bool useNullValue, float nullValue, bool mayContainNullValues)
+{
+    if (chipQueue == nullptr)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid chip queue");
+        return 1;
+    }
+
+    m_inputChips = nullptr;
+    m_chipQueue = chipQueue;
+    return innerLoadData(inputImage, results, worldMatrix, pixelGroundSamplingDistance, spatialCorrelationSearchWindowSize,
+                         correlationThreshold, correlationMethod, useNullValue, nullValue, mayContainNullValues);
+}
+
+int CParallelChipCorrelatorThread::innerLoadData(const CMatrix<float> *inputImage,
+                                                 CVector<SChipCorrelationResult> *results,
+                                                 const CMatrix<SPair<double> > *worldMatrix,
+                                                 const SPair<double> &pixelGroundSamplingDistance,
+                                                 unsigned long spatialCorrelationSearchWindowSize,
+                                                 float correlationThreshold,
+                                                 ECorrelationType correlationMethod,
+                                                 bool useNullValue, float nullValue, bool mayContainNullValues)
 {
     m_inputImage = inputImage;
-    m_inputChips = inputChips;
     m_results = results;
     m_worldMatrix = worldMatrix;
     m_pixelGSD = pixelGroundSamplingDistance;
@@ -140,12 +203,6 @@ int CParallelChipCorrelatorThread::LoadData(const CMatrix<float> *inputImage,
         return 1;
     }
 
-    if (m_inputChips == nullptr)
-    {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid conversion for input float chips");
-        return 1;
-    }
-
     if (m_results == nullptr)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid conversion for output results");
@@ -182,17 +239,28 @@ int CParallelChipCorrelatorThread::LoadData(const CMatrix<float> *inputImage,
     return 0;
 }
 
+SSize CParallelChipCorrelatorThread::getSearchWindowSize(const CChip<float> &chip) const
+{
+    unsigned long searchWindowSize = chip.searchWindowSize > 0 ? chip.searchWindowSize : m_spatialCorrelationSearchWindowSize;
+    SSize windowSize = chip.chipData.getSize() + searchWindowSize;
+    if (windowSize.col % 2 != 1)
+        windowSize.col++;
+    if (windowSize.row % 2 != 1)
+        windowSize.row++;
+    return windowSize;
+}
+
+SPair<double> CParallelChipCorrelatorThread::getSearchCoordinate(const CChip<float> &chip) const
+{
+    // the world matrix is shifted the same way by the pyramid's global shift
+    return chip.midCoordinate - chip.searchShiftPrior * m_pixelGSD;
+}
+
 int CParallelChipCorrelatorThread::populateSubImage(const CChip<float> &chip, bool &validTileReturned)
 {
     if (m_correlationMethod != ECorrelationType::PHASE)
     {
-        SSize windowSize = chip.chipData.getSize() + m_spatialCorrelationSearchWindowSize;
-        if (windowSize.col % 2 != 1)
-            windowSize.col++;
-        if (windowSize.row % 2 != 1)
-            windowSize.row++;
-
-        if (m_mapper->GetSceneTile(chip.midCoordinate, windowSize, m_corrSubImage, m_pixelGSD, validTileReturned, m_correlationMethod) != 0)
+        if (m_mapper->GetSceneTile(getSearchCoordinate(chip), getSearchWindowSize(chip), m_corrSubImage, m_pixelGSD, validTileReturned, m_correlationMethod) != 0)
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GetSceneTile()");
             return 1;
@@ -200,7 +268,7 @@ int CParallelChipCorrelatorThread::populateSubImage(const CChip<float> &chip, bo
     }
     else
     {
-        if (m_mapper->GetSceneTile(chip.midCoordinate, m_phaseImageSize, m_corrSubImage, m_pixelGSD, validTileReturned, m_correlationMethod) != 0)
+        if (m_mapper->GetSceneTile(getSearchCoordinate(chip), m_phaseImageSize, m_corrSubImage, m_pixelGSD, validTileReturned, m_correlationMethod) != 0)
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GetSceneTile()");
             return 1;
@@ -210,13 +278,33 @@ int CParallelChipCorrelatorThread::populateSubImage(const CChip<float> &chip, bo
     return 0;
 }
 
-int CParallelChipCorrelatorThread::RunCorrelation(const CChip<float> &chip, SChipCorrelationResult &result)
+void CParallelChipCorrelatorThread::setCorrelationResult(bool successful, const SPair<double> &templateToInputOffset,
+                                                         const SSize &inputSize, const SSize &templateSize, SChipCorrelationResult &result) const
 {
+    result.correlationResultIsGood = successful;
+    if (result.correlationResultIsGood)
+    {
+        SPair<double> inputToTemplateImageSizeHalf = (SPair<double> (inputSize) - SPair<double> (templateSize)) / 2;
+        // the search window was centred on the shift prior
+        SPair<double> relativeOffset = inputToTemplateImageSizeHalf - templateToInputOffset + result.chip.searchShiftPrior;
+        result.newMidCoordinate = result.chip.midCoordinate;
+        result.newMidCoordinate += relativeOffset * m_pixelGSD;
+        for (int x = 0; x < 4; x++)
+        {
+            result.newBoundingCoordinate[x] = result.chip.boundingCoordinate[x];
+            result.newBoundingCoordinate[x] += relativeOffset * (m_pixelGSD);
+        }
+    }
+}
+
+int CParallelChipCorrelatorThread::RunCorrelation(SChipCorrelationResult &result)
+{
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_CORRELATION, "CorrelateChip");
     bool successful = false;
     bool validTileReturned;
+    const CChip<float> &chip = result.chip;
 
     result.correlationResultIsGood = false; //set as failed, we might skip this chip so default to failed
-    result.chip = chip;
 
     if (populateSubImage(chip, validTileReturned) != 0)
     {
@@ -226,14 +314,18 @@ int CParallelChipCorrelatorThread::RunCorrelation(const CChip<float> &chip, SChi
 
     if (!validTileReturned)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "An invalid sub image tile was returned");
+        ULTRA_LOG(CLogger::LOG_DEBUG, "An invalid sub image tile was returned");
         return 0;
     }
     SPair<double> templateToInputOffset;
 
     if (m_correlationMethod == ECorrelationType::PHASE)
     {
-        m_chipData = chip.chipData.getSubMatrix(0, m_phaseImageSize);
+        if (chip.chipData.getSubMatrix(0, m_phaseImageSize, m_chipData) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from getSubMatrix()");
+            return 1;
+        }
     }
     else
     {
@@ -257,54 +349,238 @@ int CParallelChipCorrelatorThread::RunCorrelation(const CChip<float> &chip, SChi
         return 1;
     }
 
-    result.correlationResultIsGood = successful;
-    if (result.correlationResultIsGood)
+    setCorrelationResult(successful, templateToInputOffset, m_corrSubImage.getSize(), m_chipData.getSize(), result);
+    return 0;
+}
+
+int CParallelChipCorrelatorThread::RunRegionCorrelation(const std::vector<SChipCorrelationResult*> &results, const std::vector<SSize> &windowUls,
+                                                        const SSize &regionUl, const SSize &regionLr)
+{
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_CORRELATION, "CorrelateChipRegion");
+    if (m_inputImage->getSubMatrix(regionUl, regionLr - regionUl, m_searchRegion) != 0)
     {
-        SPair<double> inputToTemplateImageSizeHalf = (SPair<double> (m_corrSubImage.getSize()) - SPair<double> (m_chipData.getSize())) / 2;
-        SPair<double> relativeOffset = inputToTemplateImageSizeHalf - templateToInputOffset;
-        result.newMidCoordinate = result.chip.midCoordinate;
-        result.newMidCoordinate += relativeOffset * m_pixelGSD;
-        for (int x = 0; x < 4; x++)
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from getSubMatrix()");
+        return 1;
+    }
+
+    // the chips of a region all have the same size, their search windows may differ
+    const SSize templateSize = results[0]->chip.chipData.getSize();
+    float *inputNullValuePtr = m_useNullValue ? &m_nullValue : nullptr;
+    float *templateNullValuePtr = m_useNullValue ? &m_nullValue : nullptr;
+    m_subCorrelator->SetSearchRegion(m_searchRegion, templateSize, inputNullValuePtr);
+
+    for (unsigned long t = 0; t < results.size(); t++)
+    {
+        ULTRA_TRACE_SCOPE(CTracer::CATEGORY_CORRELATION, "CorrelateChip");
+        SChipCorrelationResult &result = *results[t];
+        const SSize windowSize = getSearchWindowSize(result.chip);
+        bool successful = false;
+        SPair<double> templateToInputOffset;
+        if (m_subCorrelator->CorrelateInRegion(windowUls[t] - regionUl,
+                                               windowSize,
+                                               result.chip.chipData,
+                                               m_correlationThreshold,
+                                               successful,
+                                               templateToInputOffset,
+                                               result.corrCoefficient,
+                                               inputNullValuePtr,
+                                               templateNullValuePtr,
+                                               m_mayContainNullValues,
+                                               m_mayContainNullValues) != 0)
         {
-            result.newBoundingCoordinate[x] = result.chip.boundingCoordinate[x];
-            result.newBoundingCoordinate[x] += relativeOffset * (m_pixelGSD);
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CorrelateInRegion()");
+            return 1;
         }
+        setCorrelationResult(successful, templateToInputOffset, windowSize, templateSize, result);
     }
 
     return 0;
 }
 
-void CParallelChipCorrelatorThread::run(void* context)
+int CParallelChipCorrelatorThread::RunCorrelations(const std::vector<SChipCorrelationResult*> &results)
 {
-    unsigned long size = m_inputChips->size();
-    for (unsigned long it = 0; it < size; it++)
+    std::vector<SChipCorrelationResult*> group;
+    std::vector<SSize> groupUls;
+    SSize groupChipSize;
+    SSize regionUl;
+    SSize regionLr;
+    unsigned long windowArea = 0;
+
+    // chips join the current group while the bounding box of their search windows is no
+    // larger than the windows themselves, i.e. while the windows overlap enough that a
+    // shared integral image costs less than one per chip
+    for (unsigned long t = 0; t <= results.size(); t++)
     {
-        if (RunCorrelation(m_inputChips->operator[](it), m_results->operator[](it)) != 0)
+        bool located = false;
+        bool joined = false;
+        SSize windowUl;
+        SSize windowSize;
+        if (t < results.size() && m_correlationMethod != ECorrelationType::PHASE &&
+            !results[t]->chip.chipData.getSize().containsZero())
         {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunCorrelation()");
-            break;
+            const CChip<float> &chip = results[t]->chip;
+            windowSize = getSearchWindowSize(chip);
+            bool validTile = false;
+            located = m_mapper->LocateTile(getSearchCoordinate(chip), windowSize, m_pixelGSD, validTile, m_correlationMethod, windowUl) == 0 && validTile;
+
+            if (located && !group.empty() && chip.chipData.getSize() == groupChipSize)
+            {
+                SSize ul(getMIN(regionUl.row, windowUl.row), getMIN(regionUl.col, windowUl.col));
+                SSize lr(getMAX(regionLr.row, windowUl.row + windowSize.row), getMAX(regionLr.col, windowUl.col + windowSize.col));
+                if ((lr - ul).getProduct() <= windowArea + windowSize.getProduct())
+                {
+                    joined = true;
+                    regionUl = ul;
+                    regionLr = lr;
+                    windowArea += windowSize.getProduct();
+                    group.push_back(results[t]);
+                    groupUls.push_back(windowUl);
+                }
+            }
+        }
+
+        if (joined)
+            continue;
+
+        if (group.size() == 1)
+        {
+            if (RunCorrelation(*group[0]) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunCorrelation()");
+                return 1;
+            }
+        }
+        else if (group.size() > 1)
+        {
+            if (RunRegionCorrelation(group, groupUls, regionUl, regionLr) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunRegionCorrelation()");
+                return 1;
+            }
+        }
+        group.clear();
+        groupUls.clear();
+
+        if (located)
+        {
+            group.push_back(results[t]);
+            groupUls.push_back(windowUl);
+            groupChipSize = results[t]->chip.chipData.getSize();
+            regionUl = windowUl;
+            regionLr = windowUl + windowSize;
+            windowArea = windowSize.getProduct();
+        }
+        else if (t < results.size())
+        {
+            if (RunCorrelation(*results[t]) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunCorrelation()");
+                return 1;
+            }
         }
     }
 
-    //reset these back to nullptr, detach pointers
-    m_inputImage = nullptr;
-    m_inputChips = nullptr;
-    m_results = nullptr;
-    m_worldMatrix = nullptr;
+    return 0;
+}
+
+void CParallelChipCorrelatorThread::RunQueued()
+{
+    std::vector<SChipCorrelationResult> results;
+    SSize firstChipSize;
+    std::vector<CChip<float> > chips;
+    // keeps popping after a failure, the producers must never block on a full queue
+    while (m_chipQueue->PopBatch(chips, MAX_CHIPS_PER_REGION))
+    {
+        unsigned long first = results.size();
+        results.resize(first + chips.size());
+        std::vector<SChipCorrelationResult*> correlate;
+        for (unsigned long t = 0; t < chips.size(); t++)
+        {
+            SSize chipSize = chips[t].chipData.getSize();
+            if (!m_failed && !m_subCorrelator && chipSize != SSize(0, 0))
+            {
+                firstChipSize = chipSize;
+                if (InitSubCorrelator(chipSize) != 0)
+                {
+                    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from InitSubCorrelator()");
+                    m_failed = true;
+                }
+            }
+
+            if (!m_failed && m_correlationMethod == ECorrelationType::PHASE &&
+                chipSize != SSize(0, 0) && chipSize != firstChipSize)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Chips must be of the same size if a PHASE correlation is used");
+                m_failed = true;
+            }
+
+            SChipCorrelationResult &result = results[first + t];
+            result.correlationResultIsGood = false;
+            result.chip = std::move(chips[t]);
+            if (!m_failed && m_subCorrelator)
+                correlate.push_back(&result);
+        }
+
+        if (!correlate.empty() && RunCorrelations(correlate) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunCorrelations()");
+            m_failed = true;
+        }
+    }
+
+    m_results->resize(results.size());
+    for (unsigned long t = 0; t < results.size(); t++)
+    {
+        (*m_results)[t] = std::move(results[t]);
+    }
+}
 
-    m_threadCompletedCount->inc();
-    if (m_threadCompletedCount->get() == m_threadsSpawned)
+bool CParallelChipCorrelatorThread::hasFailed() const
+{
+    return m_failed;
+}
+
+void CParallelChipCorrelatorThread::run(void* context)
+{
+    CTracer::getInstance()->SetThreadName("ChipCorrelator");
+    if (m_chipQueue != nullptr)
     {
-        if (m_lock.get() != nullptr)
+        ULTRA_TRACE_SCOPE(CTracer::CATEGORY_CORRELATION, "CorrelationBatch");
+        RunQueued();
+    }
+    else
+    {
+        ULTRA_TRACE_SCOPE(CTracer::CATEGORY_CORRELATION, "CorrelationBatch");
+        unsigned long size = m_inputChips->size();
+        std::vector<SChipCorrelationResult*> correlate;
+        for (unsigned long it = 0; it < size; it += MAX_CHIPS_PER_REGION)
         {
-            AUTO_LOCK(m_lock);
-            if (m_lock->broadcast(__FILE__, __LINE__) != 0)
+            correlate.clear();
+            for (unsigned long t = it; t < size && t < it + MAX_CHIPS_PER_REGION; t++)
+            {
+                SChipCorrelationResult &result = m_results->operator[](t);
+                result.correlationResultIsGood = false;
+                result.chip = m_inputChips->operator[](t);
+                correlate.push_back(&result);
+            }
+            if (RunCorrelations(correlate) != 0)
             {
-                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to broadcast on a mutex");
-                return;
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunCorrelations()");
+                m_failed = true;
+                break;
             }
         }
     }
+
+    //reset these back to nullptr, detach pointers
+    m_inputImage = nullptr;
+    m_inputChips = nullptr;
+    m_chipQueue = nullptr;
+    m_results = nullptr;
+    m_worldMatrix = nullptr;
+
+    if (m_completedLatch != nullptr)
+        m_completedLatch->countDown();
 }
 
 } // namespace __ultra_internal
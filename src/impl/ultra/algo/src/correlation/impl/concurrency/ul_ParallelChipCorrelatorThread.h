@@ -19,8 +19,9 @@
 #include "ul_Chips.h"
 #include "ul_UltraThread.h"
 #include "ul_MapModelToMatrix.h"
-#include "ul_AtomicLong.h"
+#include "ul_CountDownLatch.h"
 #include "ul_SubPixelCorrelator.h"
+#include "ul_BoundedQueue.h"
 
 namespace ultra
 {
@@ -30,10 +31,17 @@ namespace __ultra_internal
 class CParallelChipCorrelatorThread : public IRunnable
 {
 private:
+    /**
+     * Chips taken from the queue at once, neighbouring CCOEFF_NORM chips among them are
+     * correlated against one shared search region
+     */
+    static const unsigned long MAX_CHIPS_PER_REGION;
+
     double m_correlationThreshold;
     std::unique_ptr<CSubPixelCorrelator<float> > m_subCorrelator;
     const CMatrix<float> *m_inputImage;
     const CVector<CChip<float> > *m_inputChips;
+    CBoundedQueue<CChip<float> > *m_chipQueue;
     const CMatrix<SPair<double> > *m_worldMatrix;
     CVector<SChipCorrelationResult> *m_results;
     CMapModelToMatrix<float> *m_mapper;
@@ -42,21 +50,38 @@ private:
     unsigned long m_spatialCorrelationSearchWindowSize;
     CMatrix<float> m_corrSubImage;
     CMatrix<float> m_chipData;
+    CMatrix<float> m_searchRegion;
     SPair<double> m_origin;
     SSize m_phaseImageSize;
     bool m_mayContainNullValues;
     bool m_useNullValue;
     float m_nullValue;
-    CAtomicLong *m_threadCompletedCount;
-    unsigned long m_threadsSpawned;
-    std::shared_ptr<CThreadLock> m_lock;
+    CCountDownLatch *m_completedLatch;
+    bool m_failed;
 
     int innerInit();
+    int innerLoadData(const CMatrix<float> *inputImage,
+                      CVector<SChipCorrelationResult> *results,
+                      const CMatrix<SPair<double> > *worldMatrix,
+                      const SPair<double> &pixelGroundSamplingDistance,
+                      unsigned long spatialCorrelationSearchWindowSize,
+                      float correlationThreshold,
+                      ECorrelationType correlationMethod,
+                      bool useNullValue, float nullValue, bool mayContainNullValues);
+    int InitSubCorrelator(const SSize &chipSize);
+    void RunQueued();
     int populateSubImage(const CChip<float> &chip, bool &validTileReturned);
-    int RunCorrelation(const CChip<float> &chip, SChipCorrelationResult &result);
+    SSize getSearchWindowSize(const CChip<float> &chip) const;
+    SPair<double> getSearchCoordinate(const CChip<float> &chip) const;
+    void setCorrelationResult(bool successful, const SPair<double> &templateToInputOffset,
+                              const SSize &inputSize, const SSize &templateSize, SChipCorrelationResult &result) const;
+    int RunCorrelation(SChipCorrelationResult &result);
+    int RunRegionCorrelation(const std::vector<SChipCorrelationResult*> &results, const std::vector<SSize> &windowUls,
+                             const SSize &regionUl, const SSize &regionLr);
+    int RunCorrelations(const std::vector<SChipCorrelationResult*> &results);
 
 public:
-    CParallelChipCorrelatorThread(CAtomicLong *threadCompletedCount, unsigned long threadsSpawned, std::shared_ptr<CThreadLock> lock);
+    CParallelChipCorrelatorThread(CCountDownLatch *completedLatch);
     virtual ~CParallelChipCorrelatorThread();
 
     int LoadData(const CMatrix<float> *inputImage,
@@ -68,6 +93,20 @@ public:
                  float correlationThreshold,
                  ECorrelationType correlationMethod,
                  bool useNullValue, float nullValue, bool mayContainNullValues);
+    /**
+     * Correlates the chips popped from the queue until it is closed and drained,
+     * the results are in the order the chips were popped
+     */
+    int LoadData(const CMatrix<float> *inputImage,
+                 CBoundedQueue<CChip<float> > *chipQueue,
+                 CVector<SChipCorrelationResult> *results,
+                 const CMatrix<SPair<double> > *worldMatrix,
+                 const SPair<double> &pixelGroundSamplingDistance,
+                 unsigned long spatialCorrelationSearchWindowSize,
+                 float correlationThreshold,
+                 ECorrelationType correlationMethod,
+                 bool useNullValue, float nullValue, bool mayContainNullValues);
+    bool hasFailed() const;
     virtual void run(void *context = nullptr);
 };
 
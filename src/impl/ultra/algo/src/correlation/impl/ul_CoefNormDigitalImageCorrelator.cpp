@@ -16,7 +16,8 @@
 
 #include "ul_DigitalImageCorrelator.h"
 
-#include <ul_IntegralMatrix.h>
+#include <algorithm>
+#include <vector>
 
 namespace ultra
 {
@@ -27,9 +28,136 @@ namespace correlate_coef_norm
 namespace
 {
 
+/**
+ * Integral image of image / windowSize with a leading row and column of zeros, at
+ * long double the values match those of CIntegralMatrix::createMeanIntegralMatrix()
+ */
+template<class I>
+class CMeanIntegral
+{
+private:
+    CScratchMatrix<I> m_table;
+public:
+
+    CMeanIntegral()
+    {
+    }
+
+    template<class T>
+    CMeanIntegral(CScratchArena *arena, const CScratchMatrix<T> &image, double windowSize) :
+    m_table(arena, image.getSize() + 1)
+    {
+        SSize size = image.getSize();
+        I *top = m_table[0];
+        for (unsigned long c = 0; c <= size.col; c++)
+            top[c] = 0;
+        for (unsigned long r = 0; r < size.row; r++)
+        {
+            const T *dp = image[r];
+            const I *prev = m_table[r];
+            I *cur = m_table[r + 1];
+            cur[0] = 0;
+            for (unsigned long c = 0; c < size.col; c++)
+                cur[c + 1] = (static_cast<I> (dp[c])) / windowSize + cur[c] + prev[c + 1] - prev[c];
+        }
+    }
+
+    /**
+     * @param ul
+     * @param size
+     * @return the integral image of the window of size at ul
+     */
+    CMeanIntegral<I> getView(const SSize &ul, const SSize &size) const
+    {
+        CMeanIntegral<I> ret;
+        ret.m_table = m_table.getView(ul, size + 1);
+        return ret;
+    }
+
+    I getSum(const SSize &ul, const SSize &size) const
+    {
+        SSize lr = ul + size;
+        return m_table[lr.row][lr.col] - m_table[lr.row][ul.col] - m_table[ul.row][lr.col] + m_table[ul.row][ul.col];
+    }
+};
+
+/**
+ * Float integral image that carries the rounding error of every addition in a second
+ * table (TwoSum), the window sums are close to those of a double integral image
+ */
+class CCompensatedFloatMeanIntegral
+{
+private:
+    CScratchMatrix<float> m_hi;
+    CScratchMatrix<float> m_lo;
+
+    static void twoSum(float a, float b, float &sum, float &err)
+    {
+        sum = a + b;
+        float bb = sum - a;
+        err = (a - (sum - bb)) + (b - bb);
+    }
+public:
+
+    CCompensatedFloatMeanIntegral()
+    {
+    }
+
+    CCompensatedFloatMeanIntegral(CScratchArena *arena, const CScratchMatrix<float> &image, double windowSize) :
+    m_hi(arena, image.getSize() + 1),
+    m_lo(arena, image.getSize() + 1)
+    {
+        SSize size = image.getSize();
+        float invWindowSize = (float) (1.0 / windowSize);
+        for (unsigned long c = 0; c <= size.col; c++)
+        {
+            m_hi[0][c] = 0;
+            m_lo[0][c] = 0;
+        }
+        for (unsigned long r = 0; r < size.row; r++)
+        {
+            const float *dp = image[r];
+            const float *prevHi = m_hi[r];
+            const float *prevLo = m_lo[r];
+            float *curHi = m_hi[r + 1];
+            float *curLo = m_lo[r + 1];
+            curHi[0] = 0;
+            curLo[0] = 0;
+            float rowHi = 0;
+            float rowLo = 0;
+            float err;
+            for (unsigned long c = 0; c < size.col; c++)
+            {
+                twoSum(rowHi, dp[c] * invWindowSize, rowHi, err);
+                rowLo += err;
+                twoSum(prevHi[c + 1], rowHi, curHi[c + 1], err);
+                curLo[c + 1] = prevLo[c + 1] + rowLo + err;
+            }
+        }
+    }
+
+    CCompensatedFloatMeanIntegral getView(const SSize &ul, const SSize &size) const
+    {
+        CCompensatedFloatMeanIntegral ret;
+        ret.m_hi = m_hi.getView(ul, size + 1);
+        ret.m_lo = m_lo.getView(ul, size + 1);
+        return ret;
+    }
+
+    double getSum(const SSize &ul, const SSize &size) const
+    {
+        SSize lr = ul + size;
+        double hi = (double) m_hi[lr.row][lr.col] - m_hi[lr.row][ul.col] - m_hi[ul.row][lr.col] + m_hi[ul.row][ul.col];
+        double lo = (double) m_lo[lr.row][lr.col] - m_lo[lr.row][ul.col] - m_lo[ul.row][lr.col] + m_lo[ul.row][ul.col];
+        return hi + lo;
+    }
+};
+
 class CCoefNormTemplateMatching
 {
 private:
+    // coarse offsets whose neighbourhoods are refined
+    static const unsigned long COARSE_TO_FINE_CANDIDATES = 4;
 
     template<class T>
     static std::function<void(double &outputVal, const T &top, const T &bot) > createFp()
@@ -70,7 +198,7 @@ private:
 private:
 
     template<class T>
-    static T getMean(const CMatrix<T> &image, const SSize &ul, const SSize &size, const T *noDataVal)
+    static T getMean(const CScratchMatrix<T> &image, const SSize &ul, const SSize &size, const T *noDataVal)
     {
         T divCounter = 0;
         T sum = 0;
@@ -78,7 +206,7 @@ private:
         unsigned long stopCol = ul.col + size.col;
         for (unsigned long r = ul.row; r < stopRow; r++)
         {
-            auto *dp = image[r].getDataPointer();
+            auto *dp = image[r];
             for (unsigned long c = ul.col; c < stopCol; c++)
             {
                 T tempVal = dp[c];
@@ -92,8 +220,276 @@ private:
         return divCounter > 0 ? sum / divCounter : sum;
     }
 
+    /**
+     * Same summation order as CMatrix::mean()
+     */
+    template<class T>
+    static T getMean(const CScratchMatrix<T> &image)
+    {
+        SSize s = image.getSize();
+        T ret = 0;
+        for (unsigned long r = 0; r < s.row; r++)
+        {
+            const T *dp = image[r];
+            T rowSum = 0;
+            for (unsigned long c = 0; c < s.col; c++)
+                rowSum += dp[c];
+            ret += rowSum / ((T) s.col);
+        }
+        return ret / ((T) s.row);
+    }
+
+    /**
+     * Same summation order as CMatrix::mean(noData)
+     */
     template<class T>
-    static void coefNormalizedImpl(const CMatrix<T> &searchImage, const CMatrix<T> &tempImage, CMatrix<double> &output,
+    static T getMean(const CScratchMatrix<T> &image, const T &noData)
+    {
+        SSize s = image.getSize();
+        T ret = 0;
+        double count = 0;
+        for (unsigned long r = 0; r < s.row; r++)
+        {
+            const T *dp = image[r];
+            for (unsigned long c = 0; c < s.col; c++)
+            {
+                if (dp[c] != noData)
+                {
+                    ret += dp[c];
+                    count++;
+                }
+            }
+        }
+        return count != 0 ? ret / count : noData;
+    }
+
+    /**
+     * Evaluates single offsets with the arithmetic of coefNormalizedImpl(). An offset is abandoned
+     * once the Cauchy-Schwarz bound over the template rows it has left shows that its coefficient
+     * stays below a limit.
+     */
+    template<class T, class I>
+    class COffsetEvaluator
+    {
+    private:
+        const CScratchMatrix<T> &m_searchImage;
+        const I &m_searchIntegralImage;
+        SSize m_tempSize;
+        CScratchMatrix<T> m_tempImageNormRemoved;
+        // squared template deviations summed over row r and the rows below it
+        double *m_remainingBotT;
+        // below it the coefficient is clamped by createFp()
+        double m_minBotProduct;
+        // covers the rounding of the accumulators the bound is computed from
+        double m_margin;
+        std::function<void(double &outputVal, const T &top, const T &bot)> m_fp;
+    public:
+
+        COffsetEvaluator(CScratchArena *arena, const CScratchMatrix<T> &searchImage, const I &searchIntegralImage, const CScratchMatrix<T> &tempImage) :
+        m_searchImage(searchImage),
+        m_searchIntegralImage(searchIntegralImage),
+        m_tempSize(tempImage.getSize()),
+        m_tempImageNormRemoved(arena, tempImage.getSize()),
+        m_fp(createFp<T>())
+        {
+            T tMean = getMean<T>(tempImage);
+            for (unsigned long r = 0; r < m_tempSize.row; r++)
+            {
+                const T *src = tempImage[r];
+                T *des = m_tempImageNormRemoved[r];
+                for (unsigned long c = 0; c < m_tempSize.col; c++)
+                    des[c] = src[c] - tMean;
+            }
+
+            m_remainingBotT = arena->allocate<double>(m_tempSize.row + 1);
+            m_remainingBotT[m_tempSize.row] = 0;
+            for (unsigned long r = m_tempSize.row; r > 0; r--)
+            {
+                const T *dp = m_tempImageNormRemoved[r - 1];
+                double rowSum = 0;
+                for (unsigned long c = 0; c < m_tempSize.col; c++)
+                    rowSum += (double) dp[c] * dp[c];
+                m_remainingBotT[r - 1] = m_remainingBotT[r] + rowSum;
+            }
+
+            double eps = std::numeric_limits<T>::epsilon();
+            m_minBotProduct = 4 * eps * eps;
+            m_margin = 4 * eps * m_tempSize.getProduct();
+        }
+
+        /**
+         * @param offset
+         * @param limit
+         * @param exact false if the offset was abandoned, the returned upper bound is then below limit
+         * @return the coefficient at offset
+         */
+        double evaluate(const SSize &offset, double limit, bool &exact) const
+        {
+            exact = true;
+            T SMean = static_cast<T> (m_searchIntegralImage.getSum(offset, m_tempSize));
+            T Tval = 0;
+            T Sval = 0;
+            T top = 0;
+            T botT = 0;
+            T botS = 0;
+            for (unsigned long inR = 0; inR < m_tempSize.row; inR++)
+            {
+                auto TvalDp = m_tempImageNormRemoved[inR];
+                auto SvalDp = m_searchImage[offset.row + inR];
+                for (unsigned long inC = 0; inC < m_tempSize.col; inC++)
+                {
+                    Tval = TvalDp[inC];
+                    Sval = SvalDp[offset.col + inC] - SMean;
+                    top += Tval * Sval;
+                    botT += Tval * Tval;
+                    botS += Sval * Sval;
+                }
+
+                // the rows left add at most sqrt(remainingBotT * remainingBotS) to top and
+                // remainingBotS to botS, maximised over remainingBotS this bounds the coefficient
+                if (inR + 1 < m_tempSize.row && botS > 0 && m_remainingBotT[0] * botS >= m_minBotProduct)
+                {
+                    double partTop = top > 0 ? (double) top : 0;
+                    double bound = sqrt((partTop * partTop / botS + m_remainingBotT[inR + 1]) / m_remainingBotT[0]);
+                    if (bound + m_margin < limit)
+                    {
+                        exact = false;
+                        return bound;
+                    }
+                }
+            }
+            T bot = sqrt(botT * botS);
+            double outputVal;
+            m_fp(outputVal, top, bot);
+            return outputVal;
+        }
+    };
+
+    /**
+     * @param size
+     * @param stride
+     * @return every stride-th index below size, the last index included
+     */
+    static std::vector<unsigned long> getGridIndices(unsigned long size, unsigned long stride)
+    {
+        std::vector<unsigned long> ret;
+        for (unsigned long t = 0; t < size; t += stride)
+            ret.push_back(t);
+        if (ret.back() != size - 1)
+            ret.push_back(size - 1);
+        return ret;
+    }
+
+    template<class T, class I>
+    static void coefNormalizedCoarseToFine(CScratchArena *arena, const CScratchMatrix<T> &searchImage, const I &searchIntegralImage,
+                                           const CScratchMatrix<T> &tempImage, CMatrix<double> &output, const SCoarseToFineSearch &search)
+    {
+        auto searchSize = searchImage.getSize();
+        auto tempSize = tempImage.getSize();
+        if (tempSize.row > searchSize.row ||
+                tempSize.col > searchSize.col)
+            throw CException(__FILE__, __LINE__, "Template image is larger than the search image");
+        auto outSize = searchSize + 1 - tempSize;
+        output.resize(outSize);
+        output.initMat(-1);
+
+        COffsetEvaluator<T, I> evaluator(arena, searchImage, searchIntegralImage, tempImage);
+        CScratchMatrix<unsigned char> isExact(arena, outSize);
+        for (unsigned long r = 0; r < outSize.row; r++)
+        {
+            unsigned char *dp = isExact[r];
+            for (unsigned long c = 0; c < outSize.col; c++)
+                dp[c] = 0;
+        }
+
+        bool found = false;
+        double best = -1;
+        SSize bestLoc;
+        auto evaluate = [&](const SSize &loc, double limit)->void
+        {
+            if (isExact[loc.row][loc.col] != 0)
+                return;
+            bool exact;
+            double val = evaluator.evaluate(loc, limit, exact);
+            output[loc.row][loc.col] = val;
+            if (!exact)
+                return;
+            isExact[loc.row][loc.col] = 1;
+            if (!found || val > best)
+            {
+                found = true;
+                best = val;
+                bestLoc = loc;
+            }
+        };
+
+        // the coarse grid is only pruned against the threshold, the pruned bounds then all lie below it
+        // and every coarse offset that passes the threshold is ranked on its exact coefficient
+        std::vector<SSize> coarse;
+        std::vector<unsigned long> rows = getGridIndices(outSize.row, search.stride);
+        std::vector<unsigned long> cols = getGridIndices(outSize.col, search.stride);
+        for (unsigned long r = 0; r < rows.size(); r++)
+        {
+            for (unsigned long c = 0; c < cols.size(); c++)
+            {
+                coarse.push_back(SSize(rows[r], cols[c]));
+                evaluate(coarse.back(), search.threshold);
+            }
+        }
+
+        // refine the offsets between the best coarse ones and their coarse neighbours
+        unsigned long candidates = coarse.size() < COARSE_TO_FINE_CANDIDATES ? coarse.size() : COARSE_TO_FINE_CANDIDATES;
+        std::partial_sort(coarse.begin(), coarse.begin() + candidates, coarse.end(), [&output](const SSize &a, const SSize &b)->bool
+        {
+            return output[a.row][a.col] > output[b.row][b.col];
+        });
+        long radius = (long) search.stride - 1;
+        for (unsigned long t = 0; t < candidates; t++)
+        {
+            long sr = getMAX((long) coarse[t].row - radius, 0L);
+            long er = getMIN((long) coarse[t].row + radius, (long) outSize.row - 1);
+            long sc = getMAX((long) coarse[t].col - radius, 0L);
+            long ec = getMIN((long) coarse[t].col + radius, (long) outSize.col - 1);
+            for (long r = sr; r <= er; r++)
+            {
+                for (long c = sc; c <= ec; c++)
+                    evaluate(SSize(r, c), found ? getMAX(search.threshold, best) : search.threshold);
+            }
+        }
+
+        // a peak narrower than the stride can fall between the coarse offsets, the rest of the surface
+        // is scanned against the best coefficient so far and only abandons the offsets that cannot beat it
+        for (unsigned long r = 0; r < outSize.row; r++)
+        {
+            for (unsigned long c = 0; c < outSize.col; c++)
+                evaluate(SSize(r, c), found ? getMAX(search.threshold, best) : search.threshold);
+        }
+
+        // no peak reaches the threshold, the correlation fails either way
+        if (!found || best < search.threshold)
+            return;
+
+        // climb to a local maximum, its neighbours are evaluated exactly for the sub pixel fit
+        SSize center;
+        do
+        {
+            center = bestLoc;
+            long sr = getMAX((long) center.row - 1, 0L);
+            long er = getMIN((long) center.row + 1, (long) outSize.row - 1);
+            long sc = getMAX((long) center.col - 1, 0L);
+            long ec = getMIN((long) center.col + 1, (long) outSize.col - 1);
+            for (long r = sr; r <= er; r++)
+            {
+                for (long c = sc; c <= ec; c++)
+                    evaluate(SSize(r, c), -std::numeric_limits<double>::max());
+            }
+        }
+        while (bestLoc != center);
+    }
+
+    template<class T, class I>
+    static void coefNormalizedImpl(CScratchArena *arena, const CScratchMatrix<T> &searchImage, const I &searchIntegralImage,
+                                   const CScratchMatrix<T> &tempImage, CMatrix<double> &output,
                                    const std::function<void(double &outputVal, const T &top, const T &bot)> &fp)
     {
         auto searchSize = searchImage.getSize();
@@ -104,13 +500,24 @@ private:
         auto outSize = searchSize + 1 - tempSize;
         output.resize(outSize);
 
-        auto tempImageNormRemoved = tempImage - tempImage.mean();
-        CIntegralMatrix searchIntegralImage = CIntegralMatrix::createMeanIntegralMatrix<T>(searchImage, tempSize.getProduct());
+        T tMean = getMean<T>(tempImage);
+        CScratchMatrix<T> tempImageNormRemoved(arena, tempSize);
+        // the template term is the same at every offset, summed in the same order it is bit identical
+        T botT = 0;
+        for (unsigned long r = 0; r < tempSize.row; r++)
+        {
+            const T *src = tempImage[r];
+            T *des = tempImageNormRemoved[r];
+            for (unsigned long c = 0; c < tempSize.col; c++)
+            {
+                des[c] = src[c] - tMean;
+                botT += des[c] * des[c];
+            }
+        }
 
         T Tval = 0;
         T Sval = 0;
         T top = 0;
-        T botT = 0;
         T botS = 0;
         T bot = 0;
         T SMean;
@@ -124,19 +531,17 @@ private:
                 Tval = 0;
                 Sval = 0;
                 top = 0;
-                botT = 0;
                 botS = 0;
                 bot = 0;
                 for (unsigned long inR = 0; inR < tempSize.row; inR++)
                 {
-                    auto TvalDp = tempImageNormRemoved[inR].getDataPointer();
-                    auto SvalDp = searchImage[loop.row + inR].getDataPointer();
+                    auto TvalDp = tempImageNormRemoved[inR];
+                    auto SvalDp = searchImage[loop.row + inR];
                     for (unsigned long inC = 0; inC < tempSize.col; inC++)
                     {
                         Tval = TvalDp[inC];
                         Sval = SvalDp[loop.col + inC] - SMean;
                         top += Tval * Sval;
-                        botT += Tval * Tval;
                         botS += Sval * Sval;
                     }
                 }
@@ -148,7 +553,7 @@ private:
     }
 
     template<class T>
-    static void coefNormalizedNullValuedImpl(const CMatrix<T> &searchImage, const CMatrix<T> &tempImage, CMatrix<double> &output,
+    static void coefNormalizedNullValuedImpl(CScratchArena *arena, const CScratchMatrix<T> &searchImage, const CScratchMatrix<T> &tempImage, CMatrix<double> &output,
                                              const T *searchNoData, const T *tempNoData,
                                              const std::function<void(double &outputVal, const T &top, const T &bot)> &fp)
     {
@@ -160,17 +565,14 @@ private:
         auto outSize = searchSize + 1 - tempSize;
         output.resize(outSize);
 
-        CMatrix<T> tempImageNormRemoved;
-        if (tempNoData == nullptr)
-            tempImageNormRemoved = tempImage - tempImage.mean();
-        else
+        CScratchMatrix<T> tempImageNormRemoved(arena, tempSize);
+        T m = tempNoData == nullptr ? getMean<T>(tempImage) : getMean<T>(tempImage, *tempNoData);
+        for (unsigned long r = 0; r < tempSize.row; r++)
         {
-            T tNoData = *tempNoData;
-            T m = tempImage.mean(tNoData);
-            tempImageNormRemoved = tempImage.template map<T>([m, tNoData](const T & v)->T
-            {
-                return v == tNoData ? v : v - m;
-            });
+            const T *src = tempImage[r];
+            T *des = tempImageNormRemoved[r];
+            for (unsigned long c = 0; c < tempSize.col; c++)
+                des[c] = (tempNoData != nullptr && src[c] == *tempNoData) ? src[c] : src[c] - m;
         }
 
         T Tval = 0;
@@ -195,9 +597,9 @@ private:
                 bot = 0;
                 for (unsigned long inR = 0; inR < tempSize.row; inR++)
                 {
-                    auto TvalDpOriginal = tempImage[inR].getDataPointer();
-                    auto TvalDp = tempImageNormRemoved[inR].getDataPointer();
-                    auto SvalDp = searchImage[loop.row + inR].getDataPointer();
+                    auto TvalDpOriginal = tempImage[inR];
+                    auto TvalDp = tempImageNormRemoved[inR];
+                    auto SvalDp = searchImage[loop.row + inR];
                     for (unsigned long inC = 0; inC < tempSize.col; inC++)
                     {
                         if (tempNoData != nullptr && *tempNoData == TvalDpOriginal[inC])
@@ -222,30 +624,46 @@ private:
     }
 public:
 
-    template<class T>
-    static void coefNormalizedComplex(const CMatrix<SComplex<T> > &searchImage, const CMatrix<SComplex<T> > &tempImage, CMatrix<double> &output)
+    template<class T, class I>
+    static void coefNormalizedComplex(CScratchArena *arena, const CScratchMatrix<SComplex<T> > &searchImage, const CScratchMatrix<SComplex<T> > &tempImage, CMatrix<double> &output)
     {
-        coefNormalizedImpl<SComplex<T> > (searchImage, tempImage, output, createFpComplex<T>());
+        I searchIntegralImage(arena, searchImage, tempImage.getSize().getProduct());
+        coefNormalizedImpl<SComplex<T>, I> (arena, searchImage, searchIntegralImage, tempImage, output, createFpComplex<T>());
     }
 
-    template<class T>
-    static void coefNormalized(const CMatrix<T> &searchImage, const CMatrix<T> &tempImage, CMatrix<double> &output)
+    template<class T, class I>
+    static void coefNormalized(CScratchArena *arena, const CScratchMatrix<T> &searchImage, const CScratchMatrix<T> &tempImage, CMatrix<double> &output,
+                               const SCoarseToFineSearch &search)
     {
-        coefNormalizedImpl<T>(searchImage, tempImage, output, createFp<T>());
+        I searchIntegralImage(arena, searchImage, tempImage.getSize().getProduct());
+        coefNormalized<T, I>(arena, searchImage, searchIntegralImage, tempImage, output, search);
+    }
+
+    /**
+     * @param searchIntegralImage the integral image of searchImage over windows of the template size
+     */
+    template<class T, class I>
+    static void coefNormalized(CScratchArena *arena, const CScratchMatrix<T> &searchImage, const I &searchIntegralImage,
+                               const CScratchMatrix<T> &tempImage, CMatrix<double> &output, const SCoarseToFineSearch &search)
+    {
+        if (search.isExhaustive())
+            coefNormalizedImpl<T, I>(arena, searchImage, searchIntegralImage, tempImage, output, createFp<T>());
+        else
+            coefNormalizedCoarseToFine<T, I>(arena, searchImage, searchIntegralImage, tempImage, output, search);
     }
 
     template<class T>
-    static void coefNormalizedNullValuedComplex(const CMatrix<SComplex<T> > &searchImage, const CMatrix<SComplex<T> > &tempImage, CMatrix<double> &output,
+    static void coefNormalizedNullValuedComplex(CScratchArena *arena, const CScratchMatrix<SComplex<T> > &searchImage, const CScratchMatrix<SComplex<T> > &tempImage, CMatrix<double> &output,
                                                 const SComplex<T> *searchNoData, const SComplex<T> *tempNoData)
     {
-        coefNormalizedNullValuedImpl<SComplex<T> >(searchImage, tempImage, output, searchNoData, tempNoData, createFpComplex<T>());
+        coefNormalizedNullValuedImpl<SComplex<T> >(arena, searchImage, tempImage, output, searchNoData, tempNoData, createFpComplex<T>());
     }
 
     template<class T>
-    static void coefNormalizedNullValued(const CMatrix<T> &searchImage, const CMatrix<T> &tempImage, CMatrix<double> &output,
+    static void coefNormalizedNullValued(CScratchArena *arena, const CScratchMatrix<T> &searchImage, const CScratchMatrix<T> &tempImage, CMatrix<double> &output,
                                          const T *searchNoData, const T *tempNoData)
     {
-        coefNormalizedNullValuedImpl<T>(searchImage, tempImage, output, searchNoData, tempNoData, createFp<T>());
+        coefNormalizedNullValuedImpl<T>(arena, searchImage, tempImage, output, searchNoData, tempNoData, createFp<T>());
     }
 
 
@@ -253,7 +671,29 @@ public:
 
 } // namespace
 
-CCoefNormCorrelatorImpl::CCoefNormCorrelatorImpl()
+struct CCoefNormCorrelatorImpl::SSearchRegion
+{
+    CScratchArena arena;
+    SSize templateSize;
+    bool hasNoData;
+    CScratchMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> image;
+    CCoefNormCorrelatorImpl::MY_WORKING_TYPE noData;
+    CMeanIntegral<long double> highIntegral;
+    CMeanIntegral<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> integral;
+    CScratchMatrix<float> floatImage;
+    float floatNoData;
+    CCompensatedFloatMeanIntegral floatIntegral;
+
+    SSearchRegion() :
+    hasNoData(false),
+    noData(0),
+    floatNoData(0)
+    {
+    }
+};
+
+CCoefNormCorrelatorImpl::CCoefNormCorrelatorImpl(ECorrelationPrecision precision) :
+m_precision(precision)
 {
 }
 
@@ -261,23 +701,123 @@ CCoefNormCorrelatorImpl::~CCoefNormCorrelatorImpl()
 {
 }
 
-void CCoefNormCorrelatorImpl::correlateNormalWt(const CMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &reference,
-                                                const CMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &input,
+CScratchArena *CCoefNormCorrelatorImpl::resetSearchRegion(const SSize &templateSize)
+{
+    if (!m_region)
+        m_region.reset(new SSearchRegion());
+    m_region->arena.reset();
+    m_region->templateSize = templateSize;
+    return &m_region->arena;
+}
+
+const CCoefNormCorrelatorImpl::SSearchRegion &CCoefNormCorrelatorImpl::getSearchRegion(const SSize &templateSize) const
+{
+    if (!m_region)
+        throw CException(__FILE__, __LINE__, "No search region has been set");
+    if (m_region->templateSize != templateSize)
+        throw CException(__FILE__, __LINE__, "The search region was set for templates of size " + toString(m_region->templateSize) + " not " + toString(templateSize));
+    return *m_region;
+}
+
+void CCoefNormCorrelatorImpl::prepareSearchRegion(const CScratchMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &region,
+                                                  const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *noData)
+{
+    m_region->image = region;
+    m_region->hasNoData = noData != nullptr;
+    m_region->noData = noData != nullptr ? *noData : 0;
+    double windowSize = m_region->templateSize.getProduct();
+    if (m_precision == ECorrelationPrecision::HIGH)
+        m_region->highIntegral = CMeanIntegral<long double>(&m_region->arena, region, windowSize);
+    else
+        m_region->integral = CMeanIntegral<CCoefNormCorrelatorImpl::MY_WORKING_TYPE>(&m_region->arena, region, windowSize);
+}
+
+void CCoefNormCorrelatorImpl::prepareSearchRegion(const CScratchMatrix<float> &region, const float *noData)
+{
+    m_region->floatImage = region;
+    m_region->hasNoData = noData != nullptr;
+    m_region->floatNoData = noData != nullptr ? *noData : 0;
+    m_region->floatIntegral = CCompensatedFloatMeanIntegral(&m_region->arena, region, m_region->templateSize.getProduct());
+}
+
+void CCoefNormCorrelatorImpl::correlateRegionWt(CScratchArena *arena, const SSize &ul, const SSize &searchSize,
+                                                const CScratchMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &input,
+                                                CMatrix<double> &output,
+                                                const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *inputNoData,
+                                                const SCoarseToFineSearch &search) const
+{
+    const SSearchRegion &region = getSearchRegion(input.getSize());
+    CScratchMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> reference = region.image.getView(ul, searchSize);
+    const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *refNoData = region.hasNoData ? &region.noData : nullptr;
+    bool refHasNoData = refNoData == nullptr ? false : reference.contains(*refNoData);
+    bool inHasNoData = inputNoData == nullptr ? false : input.contains(*inputNoData);
+    if (refHasNoData || inHasNoData)
+        CCoefNormTemplateMatching::coefNormalizedNullValued<CCoefNormCorrelatorImpl::MY_WORKING_TYPE>(arena, reference, input, output, refNoData, inputNoData);
+    else if (m_precision == ECorrelationPrecision::HIGH)
+        CCoefNormTemplateMatching::coefNormalized<CCoefNormCorrelatorImpl::MY_WORKING_TYPE, CMeanIntegral<long double> >(arena, reference, region.highIntegral.getView(ul, searchSize), input, output, search);
+    else
+        CCoefNormTemplateMatching::coefNormalized<CCoefNormCorrelatorImpl::MY_WORKING_TYPE, CMeanIntegral<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> >(arena, reference, region.integral.getView(ul, searchSize), input, output, search);
+}
+
+void CCoefNormCorrelatorImpl::correlateRegionWt(CScratchArena *arena, const SSize &ul, const SSize &searchSize,
+                                                const CScratchMatrix<float> &input,
+                                                CMatrix<double> &output,
+                                                const float *inputNoData,
+                                                const SCoarseToFineSearch &search) const
+{
+    const SSearchRegion &region = getSearchRegion(input.getSize());
+    CScratchMatrix<float> reference = region.floatImage.getView(ul, searchSize);
+    const float *refNoData = region.hasNoData ? &region.floatNoData : nullptr;
+    bool refHasNoData = refNoData == nullptr ? false : reference.contains(*refNoData);
+    bool inHasNoData = inputNoData == nullptr ? false : input.contains(*inputNoData);
+    if (refHasNoData || inHasNoData)
+        CCoefNormTemplateMatching::coefNormalizedNullValued<float>(arena, reference, input, output, refNoData, inputNoData);
+    else
+        CCoefNormTemplateMatching::coefNormalized<float, CCompensatedFloatMeanIntegral>(arena, reference, region.floatIntegral.getView(ul, searchSize), input, output, search);
+}
+
+void CCoefNormCorrelatorImpl::correlateNormalWt(CScratchArena *arena,
+                                                const CScratchMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &reference,
+                                                const CScratchMatrix<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> &input,
                                                 CMatrix<double> &output,
                                                 const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *refNoData,
-                                                const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *inputNoData) const
+                                                const CCoefNormCorrelatorImpl::MY_WORKING_TYPE *inputNoData,
+                                                const SCoarseToFineSearch &search) const
 {
     bool refHasNoData = refNoData == nullptr ? false : reference.contains(*refNoData);
     bool inHasNoData = inputNoData == nullptr ? false : input.contains(*inputNoData);
     bool canUseNormalMethod = !refHasNoData && !inHasNoData;
     if (canUseNormalMethod)
-        CCoefNormTemplateMatching::coefNormalized<CCoefNormCorrelatorImpl::MY_WORKING_TYPE>(reference, input, output);
+    {
+        if (m_precision == ECorrelationPrecision::HIGH)
+            CCoefNormTemplateMatching::coefNormalized<CCoefNormCorrelatorImpl::MY_WORKING_TYPE, CMeanIntegral<long double> >(arena, reference, input, output, search);
+        else
+            CCoefNormTemplateMatching::coefNormalized<CCoefNormCorrelatorImpl::MY_WORKING_TYPE, CMeanIntegral<double> >(arena, reference, input, output, search);
+    }
     else
-        CCoefNormTemplateMatching::coefNormalizedNullValued<CCoefNormCorrelatorImpl::MY_WORKING_TYPE>(reference, input, output, refNoData, inputNoData);
+        CCoefNormTemplateMatching::coefNormalizedNullValued<CCoefNormCorrelatorImpl::MY_WORKING_TYPE>(arena, reference, input, output, refNoData, inputNoData);
 }
 
-void CCoefNormCorrelatorImpl::correlateComplexWt(const CMatrix<SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> > &reference,
-                                                 const CMatrix<SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> > &input,
+void CCoefNormCorrelatorImpl::correlateNormalFloat(CScratchArena *arena,
+                                                   const CScratchMatrix<float> &reference,
+                                                   const CScratchMatrix<float> &input,
+                                                   CMatrix<double> &output,
+                                                   const float *refNoData,
+                                                   const float *inputNoData,
+                                                   const SCoarseToFineSearch &search) const
+{
+    bool refHasNoData = refNoData == nullptr ? false : reference.contains(*refNoData);
+    bool inHasNoData = inputNoData == nullptr ? false : input.contains(*inputNoData);
+    bool canUseNormalMethod = !refHasNoData && !inHasNoData;
+    if (canUseNormalMethod)
+        CCoefNormTemplateMatching::coefNormalized<float, CCompensatedFloatMeanIntegral>(arena, reference, input, output, search);
+    else
+        CCoefNormTemplateMatching::coefNormalizedNullValued<float>(arena, reference, input, output, refNoData, inputNoData);
+}
+
+void CCoefNormCorrelatorImpl::correlateComplexWt(CScratchArena *arena,
+                                                 const CScratchMatrix<SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> > &reference,
+                                                 const CScratchMatrix<SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> > &input,
                                                  CMatrix<double> &output,
                                                  const SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> *refNoData,
                                                  const SComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE> *inputNoData) const
@@ -286,9 +826,14 @@ void CCoefNormCorrelatorImpl::correlateComplexWt(const CMatrix<SComplex<CCoefNor
     bool inHasNoData = inputNoData == nullptr ? false : input.contains(*inputNoData);
     bool canUseNormalMethod = !refHasNoData && !inHasNoData;
     if (canUseNormalMethod)
-        CCoefNormTemplateMatching::coefNormalizedComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE>(reference, input, output);
+    {
+        if (m_precision == ECorrelationPrecision::HIGH)
+            CCoefNormTemplateMatching::coefNormalizedComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE, CMeanIntegral<long double> >(arena, reference, input, output);
+        else
+            CCoefNormTemplateMatching::coefNormalizedComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE, CMeanIntegral<double> >(arena, reference, input, output);
+    }
     else
-        CCoefNormTemplateMatching::coefNormalizedNullValuedComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE>(reference, input, output, refNoData, inputNoData);
+        CCoefNormTemplateMatching::coefNormalizedNullValuedComplex<CCoefNormCorrelatorImpl::MY_WORKING_TYPE>(arena, reference, input, output, refNoData, inputNoData);
 }
 
 } // namespace correlate_coef_norm
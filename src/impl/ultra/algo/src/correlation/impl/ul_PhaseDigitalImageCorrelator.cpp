@@ -23,7 +23,8 @@ namespace __ultra_internal
 namespace correlate_phase
 {
 
-CPhaseCorrelatorImpl::CPhaseCorrelatorImpl()
+CPhaseCorrelatorImpl::CPhaseCorrelatorImpl(ECorrelationPrecision precision) :
+m_precision(precision)
 {
 }
 
@@ -31,25 +32,26 @@ CPhaseCorrelatorImpl::~CPhaseCorrelatorImpl()
 {
 }
 
-void CPhaseCorrelatorImpl::correlateComplexWt(CDft2d *fftOp, const CMatrix<SComplex<ADftBase2d::MY_WORKING_TYPE> > &reference,
-                                              const CMatrix<SComplex<ADftBase2d::MY_WORKING_TYPE> > &input, CMatrix<double> &output,
-                                              const SComplex<ADftBase2d::MY_WORKING_TYPE> *refNoData, const SComplex<ADftBase2d::MY_WORKING_TYPE> *inputNoData) const
+template<class W>
+void CPhaseCorrelatorImpl::correlateComplexWt(CScratchArena *arena, CDft2d *fftOp, const CScratchMatrix<SComplex<W> > &reference,
+                                              const CScratchMatrix<SComplex<W> > &input, CMatrix<double> &output,
+                                              const SComplex<W> *refNoData, const SComplex<W> *inputNoData) const
 {
     if (refNoData != nullptr || inputNoData != nullptr)
         throw CException(__FILE__, __LINE__, "Phase correlator cannot handle no-data");
 
-    CMatrix<SComplex<ADftBase2d::MY_WORKING_TYPE> > referenceSpec;
-    CMatrix<SComplex<ADftBase2d::MY_WORKING_TYPE> > inputSpec;
+    auto size = input.getSize();
+    CScratchMatrix<SComplex<W> > referenceSpec(arena, size);
+    CScratchMatrix<SComplex<W> > inputSpec(arena, size);
     fftOp->forward(reference, referenceSpec);
     fftOp->forward(input, inputSpec);
 
-    auto size = inputSpec.getSize();
-    CMatrix<SComplex<ADftBase2d::MY_WORKING_TYPE> > ans(size);
+    CScratchMatrix<SComplex<W> > ans(arena, size);
     for (unsigned long r = 0; r < size.row; r++)
     {
-        auto rDp = referenceSpec[r].getDataPointer();
-        auto iDp = inputSpec[r].getDataPointer();
-        auto aDp = ans[r].getDataPointer();
+        auto rDp = referenceSpec[r];
+        auto iDp = inputSpec[r];
+        auto aDp = ans[r];
         for (unsigned long c = 0; c < size.col; c++)
         {
             auto &v = aDp[c] = rDp[c] * iDp[c].conjugate();
@@ -60,16 +62,37 @@ void CPhaseCorrelatorImpl::correlateComplexWt(CDft2d *fftOp, const CMatrix<SComp
                 v.im = v.re = 0;
         }
     }
-    CMatrix<SComplex<ADftBase2d::MY_WORKING_TYPE> > result;
+    CScratchMatrix<SComplex<W> > result(arena, size);
     double normValue = size.getProduct();
     fftOp->inverse(ans, result);
-    output = result.map<double>([normValue](const SComplex<ADftBase2d::MY_WORKING_TYPE> &v)->double
+
+    // writes the magnitudes with the quadrants swapped, as CDft2d::inverseFftMatrixSwapQuadrants() would
+    output.resize(size);
+    SSize shift(size.row - size.row / 2, size.col - size.col / 2);
+    for (unsigned long r = 0; r < size.row; r++)
     {
-        return v.mod() / normValue;
-    });
-    CDft2d::inverseFftMatrixSwapQuadrants(output);
+        auto resDp = result[r];
+        auto outDp = output[(r + shift.row) % size.row].getDataPointer();
+        for (unsigned long c = 0; c < size.col; c++)
+        {
+            outDp[(c + shift.col) % size.col] = resDp[c].mod() / normValue;
+        }
+    }
 }
 
+template void CPhaseCorrelatorImpl::correlateComplexWt<ADftBase2d::MY_WORKING_TYPE>(CScratchArena *arena, CDft2d *fftOp,
+                                                                                   const CScratchMatrix<SComplex<ADftBase2d::MY_WORKING_TYPE> > &reference,
+                                                                                   const CScratchMatrix<SComplex<ADftBase2d::MY_WORKING_TYPE> > &input,
+                                                                                   CMatrix<double> &output,
+                                                                                   const SComplex<ADftBase2d::MY_WORKING_TYPE> *refNoData,
+                                                                                   const SComplex<ADftBase2d::MY_WORKING_TYPE> *inputNoData) const;
+template void CPhaseCorrelatorImpl::correlateComplexWt<float>(CScratchArena *arena, CDft2d *fftOp,
+                                                              const CScratchMatrix<SComplex<float> > &reference,
+                                                              const CScratchMatrix<SComplex<float> > &input,
+                                                              CMatrix<double> &output,
+                                                              const SComplex<float> *refNoData,
+                                                              const SComplex<float> *inputNoData) const;
+
 } // namespace correlate_phase
 } // namespace __ultra_internal
 } // namespace ultra
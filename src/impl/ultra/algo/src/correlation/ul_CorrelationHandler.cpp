@@ -27,6 +27,7 @@ CCorrelationHandler::CCorrelationHandler(unsigned int threadCount, float correla
     m_maxThreads = threadCount;
     m_correlationThreshold = correlationThreshold;
     m_CCorrelationHandler_corrVecThreads = nullptr;
+    m_chipQueue = nullptr;
     m_useNullValue = useNullValue;
     m_nullValue = nullValue;
     m_mayContainNullValues = mayContainNullValues;
@@ -113,6 +114,19 @@ int CCorrelationHandler::Init(const CVector<CChip<float> > &inputChips)
     return 0;
 }
 
+int CCorrelationHandler::InitQueued()
+{
+    if (m_maxThreads < 1)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Thread count must at least be 1");
+        return 1;
+    }
+
+    m_inputChips.resize(m_maxThreads);
+    m_results.resize(m_maxThreads);
+    return 0;
+}
+
 int CCorrelationHandler::LoadData(
                                   const CMatrix<float> &inputImage,
                                   const CVector<CChip<float> > &inputChips,
@@ -124,12 +138,54 @@ int CCorrelationHandler::LoadData(
                                   )
 {
     m_canStart = false;
+    m_chipQueue = nullptr;
+    // Init() checks the chip sizes against the correlation method
+    m_correlationMethod = correlationMethod;
     if (Init(inputChips) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Init()");
         return 1;
     }
 
+    return innerLoadData(inputImage, worldMatrix, pixelGroundSamplingDistance, searchWindowSize, originChipToInputDiv, correlationMethod);
+}
+
+int CCorrelationHandler::LoadData(
+                                  const CMatrix<float> &inputImage,
+                                  CBoundedQueue<CChip<float> > *chipQueue,
+                                  const CMatrix<SPair<double> > &worldMatrix,
+                                  const SPair<double> &pixelGroundSamplingDistance,
+                                  unsigned long searchWindowSize,
+                                  const SPair<double> &originChipToInputDiv,
+                                  ECorrelationType correlationMethod
+                                  )
+{
+    m_canStart = false;
+    if (chipQueue == nullptr)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid chip queue");
+        return 1;
+    }
+    m_chipQueue = chipQueue;
+
+    if (InitQueued() != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from InitQueued()");
+        return 1;
+    }
+
+    return innerLoadData(inputImage, worldMatrix, pixelGroundSamplingDistance, searchWindowSize, originChipToInputDiv, correlationMethod);
+}
+
+int CCorrelationHandler::innerLoadData(
+                                       const CMatrix<float> &inputImage,
+                                       const CMatrix<SPair<double> > &worldMatrix,
+                                       const SPair<double> &pixelGroundSamplingDistance,
+                                       unsigned long searchWindowSize,
+                                       const SPair<double> &originChipToInputDiv,
+                                       ECorrelationType correlationMethod
+                                       )
+{
     m_inputImage = &inputImage;
     m_worldMatrix = &worldMatrix;
     m_pixelGroundSamplingDistance = pixelGroundSamplingDistance;
@@ -140,16 +196,16 @@ int CCorrelationHandler::LoadData(
     return 0;
 }
 
-int CCorrelationHandler::StartThreads(std::shared_ptr<CThreadLock> lock)
+int CCorrelationHandler::StartThreads()
 {
     CVector<__ultra_internal::CParallelChipCorrelatorThread *> * vec = new CVector<__ultra_internal::CParallelChipCorrelatorThread *>();
     m_CCorrelationHandler_corrVecThreads = vec;
     vec->resize(m_maxThreads);
     vec->initVec(nullptr);
-    m_atLong.set(0);
+    m_completedLatch.reset(vec->size());
     for (unsigned long t = 0; t < vec->size(); t++)
     {
-        vec->operator[](t) = new __ultra_internal::CParallelChipCorrelatorThread(&m_atLong, vec->size(), lock);
+        vec->operator[](t) = new __ultra_internal::CParallelChipCorrelatorThread(&m_completedLatch);
 
         if (vec->operator[](t) == nullptr)
         {
@@ -164,9 +220,20 @@ int CCorrelationHandler::StartThreads(std::shared_ptr<CThreadLock> lock)
             return 1;
         }
 
-        if ((*vec)[t]->LoadData(m_inputImage, &m_inputChips[t], &m_results[t], m_worldMatrix,
-                                m_pixelGroundSamplingDistance, m_searchWindowSize, m_correlationThreshold,
-                                m_correlationMethod, m_useNullValue, m_nullValue, m_mayContainNullValues) != 0)
+        int loadResult = 0;
+        if (m_chipQueue != nullptr)
+        {
+            loadResult = (*vec)[t]->LoadData(m_inputImage, m_chipQueue, &m_results[t], m_worldMatrix,
+                                             m_pixelGroundSamplingDistance, m_searchWindowSize, m_correlationThreshold,
+                                             m_correlationMethod, m_useNullValue, m_nullValue, m_mayContainNullValues);
+        }
+        else
+        {
+            loadResult = (*vec)[t]->LoadData(m_inputImage, &m_inputChips[t], &m_results[t], m_worldMatrix,
+                                             m_pixelGroundSamplingDistance, m_searchWindowSize, m_correlationThreshold,
+                                             m_correlationMethod, m_useNullValue, m_nullValue, m_mayContainNullValues);
+        }
+        if (loadResult != 0)
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadData()");
             for (unsigned long tt = 0; tt <= t; tt++)
@@ -185,6 +252,9 @@ int CCorrelationHandler::StartThreads(std::shared_ptr<CThreadLock> lock)
     {
         if (CUltraThread::getInstance()->start(vec->operator[](t), nullptr) != 0)
         {
+            // release anyone waiting on the threads that will never run
+            for (unsigned long tt = t; tt < vec->size(); tt++)
+                m_completedLatch.countDown();
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to start thread, oops here comes a memleak");
             return 1;
         }
@@ -193,7 +263,7 @@ int CCorrelationHandler::StartThreads(std::shared_ptr<CThreadLock> lock)
     return 0;
 }
 
-int CCorrelationHandler::Correlate(std::shared_ptr<CThreadLock> lock)
+int CCorrelationHandler::Correlate()
 {
     if (!m_canStart)
     {
@@ -202,7 +272,7 @@ int CCorrelationHandler::Correlate(std::shared_ptr<CThreadLock> lock)
     }
     m_canStart = false;
 
-    if (StartThreads(lock) != 0)
+    if (StartThreads() != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from StartThreads()");
         return 1;
@@ -213,16 +283,17 @@ int CCorrelationHandler::Correlate(std::shared_ptr<CThreadLock> lock)
 
 bool CCorrelationHandler::isBusy()
 {
-    CVector<__ultra_internal::CParallelChipCorrelatorThread *> * vec = (CVector<__ultra_internal::CParallelChipCorrelatorThread *> *)m_CCorrelationHandler_corrVecThreads;
-    for (unsigned long t = 0; t < vec->size(); t++)
+    return m_completedLatch.getCount() > 0;
+}
+
+int CCorrelationHandler::WaitForCompletion()
+{
+    if (m_completedLatch.await() != 0)
     {
-        if (CUltraThread::getInstance()->isBusy(vec->operator[](t)))
-        {
-            return true;
-        }
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CCountDownLatch::await()");
+        return 1;
     }
-
-    return false;
+    return 0;
 }
 
 int CCorrelationHandler::cleanup()
@@ -249,15 +320,21 @@ int CCorrelationHandler::cleanup()
 
 int CCorrelationHandler::GetResults(CVector<SChipCorrelationResult> &results)
 {
-    int tempLoop = 0;
-    while (isBusy())
+    if (WaitForCompletion() != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from WaitForCompletion()");
+        return 1;
+    }
+
+    bool threadFailed = false;
+    if (m_chipQueue != nullptr)
     {
-        usleep(100);
-        tempLoop++;
-        if (tempLoop == 50)
+        // a failing queued thread keeps draining the queue, report it here instead
+        CVector<__ultra_internal::CParallelChipCorrelatorThread *> * vec = (CVector<__ultra_internal::CParallelChipCorrelatorThread *> *)m_CCorrelationHandler_corrVecThreads;
+        for (unsigned long t = 0; t < vec->size(); t++)
         {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "Processing is still busy will try and get results");
-            break;
+            if (vec->operator[](t) != nullptr && vec->operator[](t)->hasFailed())
+                threadFailed = true;
         }
     }
 
@@ -293,6 +370,12 @@ int CCorrelationHandler::GetResults(CVector<SChipCorrelationResult> &results)
         return 1;
     }
 
+    if (threadFailed)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "A correlation thread failed");
+        return 1;
+    }
+
     return 0;
 }
 
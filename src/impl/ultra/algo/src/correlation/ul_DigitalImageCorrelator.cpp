@@ -16,9 +16,16 @@
 
 #include "ul_DigitalImageCorrelator.h"
 
+#include <algorithm>
+#include <cctype>
+
 namespace ultra
 {
 
+ECorrelationPrecision CDigitalImageCorrelatorFactory::DEFAULT_PRECISION = ECorrelationPrecision::HIGH;
+bool CDigitalImageCorrelatorFactory::VALIDATE_PRECISION = false;
+unsigned long CDigitalImageCorrelatorFactory::DEFAULT_COARSE_TO_FINE_STRIDE = 1;
+
 std::string CCorrelationHelper::typeToStr(ECorrelationType type)
 {
     switch (type)
@@ -39,4 +46,64 @@ std::string CCorrelationHelper::typeToStr(ESubPixelCorrelationType type)
     return "UNKOWN";
 }
 
+std::string CCorrelationHelper::typeToStr(ECorrelationPrecision precision)
+{
+    switch (precision)
+    {
+    case ECorrelationPrecision::HIGH:return "HIGH";
+    case ECorrelationPrecision::DOUBLE:return "DOUBLE";
+    case ECorrelationPrecision::FLOAT:return "FLOAT";
+    case ECorrelationPrecision::CORRELATION_PRECISION_COUNT:break;
+    }
+    return "UNKOWN";
+}
+
+int CCorrelationHelper::strToType(const std::string &str, ECorrelationPrecision &precision)
+{
+    std::string upper = str;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c)->char
+    {
+        return (char) std::toupper(c);
+    });
+    for (int t = 0; t < (int) ECorrelationPrecision::CORRELATION_PRECISION_COUNT; t++)
+    {
+        if (typeToStr((ECorrelationPrecision) t) == upper)
+        {
+            precision = (ECorrelationPrecision) t;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+ECorrelationPrecision CDigitalImageCorrelatorFactory::getDefaultPrecision()
+{
+    return DEFAULT_PRECISION;
+}
+
+void CDigitalImageCorrelatorFactory::setDefaultPrecision(ECorrelationPrecision precision)
+{
+    DEFAULT_PRECISION = precision;
+}
+
+bool CDigitalImageCorrelatorFactory::getValidatePrecision()
+{
+    return VALIDATE_PRECISION;
+}
+
+void CDigitalImageCorrelatorFactory::setValidatePrecision(bool validate)
+{
+    VALIDATE_PRECISION = validate;
+}
+
+unsigned long CDigitalImageCorrelatorFactory::getDefaultCoarseToFineStride()
+{
+    return DEFAULT_COARSE_TO_FINE_STRIDE;
+}
+
+void CDigitalImageCorrelatorFactory::setDefaultCoarseToFineStride(unsigned long stride)
+{
+    DEFAULT_COARSE_TO_FINE_STRIDE = stride;
+}
+
 } // namespace ultra
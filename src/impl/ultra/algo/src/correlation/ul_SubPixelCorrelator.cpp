@@ -16,9 +16,83 @@
 
 #include "ul_SubPixelCorrelator.h"
 
+#include <ul_Profiler.h>
+
 namespace ultra
 {
 
+const double CCorrelationPrecisionValidation::OFFSET_DIFFERENCE_LOG_THRESHOLD = 0.05;
+
+CCorrelationPrecisionValidation::CCorrelationPrecisionValidation() :
+m_lock(std::make_shared<CThreadLock>())
+{
+    Clear();
+}
+
+CCorrelationPrecisionValidation::~CCorrelationPrecisionValidation()
+{
+}
+
+CCorrelationPrecisionValidation *CCorrelationPrecisionValidation::getInstance()
+{
+    static CCorrelationPrecisionValidation instance;
+    return &instance;
+}
+
+void CCorrelationPrecisionValidation::Add(const std::string &correlation,
+                                          bool highSuccess, const SPair<double> &highOffset, double highCoefficient,
+                                          bool success, const SPair<double> &offset, double coefficient)
+{
+    double offsetDifference = 0;
+    bool compareOffset = highSuccess && success;
+    if (compareOffset)
+        offsetDifference = (offset - highOffset).modSize();
+    {
+        AUTO_LOCK(m_lock);
+        m_compared++;
+        if (highSuccess != success)
+            m_successMismatches++;
+        if (compareOffset)
+        {
+            m_offsetCompared++;
+            m_offsetDifferenceSum += offsetDifference;
+            m_maxOffsetDifference = getMAX(m_maxOffsetDifference, offsetDifference);
+            // a coarse to fine search that fails reports an upper bound as its coefficient
+            m_maxCoefficientDifference = getMAX(m_maxCoefficientDifference, getAbs(coefficient - highCoefficient));
+        }
+    }
+    CProfiler::getInstance()->AddCounter("precisionValidated", 1);
+    if (highSuccess != success)
+        CProfiler::getInstance()->AddCounter("precisionSuccessMismatches", 1);
+
+    if (highSuccess != success || offsetDifference > OFFSET_DIFFERENCE_LOG_THRESHOLD)
+    {
+        ULTRA_LOG(CLogger::LOG_DEBUG, correlation + " correlation differs from exhaustive HIGH: success '" +
+                  toString(success) + "' vs '" + toString(highSuccess) + "', offset " + toString(offset) + " vs " + toString(highOffset) +
+                  ", coefficient '" + toString(coefficient) + "' vs '" + toString(highCoefficient) + "'");
+    }
+}
+
+void CCorrelationPrecisionValidation::LogSummary() const
+{
+    AUTO_LOCK(m_lock);
+    double meanOffsetDifference = m_offsetCompared > 0 ? m_offsetDifferenceSum / m_offsetCompared : 0;
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Correlation precision validation: '" + toString(m_compared) + "' chips compared, "
+                                "'" + toString(m_successMismatches) + "' success mismatches, offset difference mean '" + toString(meanOffsetDifference) + "' "
+                                "max '" + toString(m_maxOffsetDifference) + "' pixels, max coefficient difference of successful chips '" + toString(m_maxCoefficientDifference) + "'");
+}
+
+void CCorrelationPrecisionValidation::Clear()
+{
+    AUTO_LOCK(m_lock);
+    m_compared = 0;
+    m_successMismatches = 0;
+    m_offsetCompared = 0;
+    m_offsetDifferenceSum = 0;
+    m_maxOffsetDifference = 0;
+    m_maxCoefficientDifference = 0;
+}
+
 namespace __ultra_internal
 {
 
@@ -32,8 +106,7 @@ ICorrelateInterface::~ICorrelateInterface()
 
 CCorrelatePhaseImpl::CCorrelatePhaseImpl(const SPair<double> &templateImageSizeHalf) :
 ICorrelateInterface(),
-m_templateImageSizeHalf(templateImageSizeHalf),
-m_size3x3(3)
+m_templateImageSizeHalf(templateImageSizeHalf)
 {
 }
 
@@ -48,24 +121,27 @@ int CCorrelatePhaseImpl::correlate(const CMatrix<double> &scratchImage,
 {
     templateToInputOffset = SPair<double>(maxPeakLoc) - m_templateImageSizeHalf;
 
-    m_neighbors = scratchImage.getSubMatrix(maxPeakLoc - 1, m_size3x3);
+    double top = scratchImage[maxPeakLoc.row - 1][maxPeakLoc.col];
+    double bottom = scratchImage[maxPeakLoc.row + 1][maxPeakLoc.col];
+    double left = scratchImage[maxPeakLoc.row][maxPeakLoc.col - 1];
+    double right = scratchImage[maxPeakLoc.row][maxPeakLoc.col + 1];
 
-    if (m_neighbors[0][1] > m_neighbors[2][1])
+    if (top > bottom)
     {
-        templateToInputOffset.r -= m_neighbors[0][1] / (m_neighbors[0][1] + maxPeakVal);
+        templateToInputOffset.r -= top / (top + maxPeakVal);
     }
     else
     {
-        templateToInputOffset.r += m_neighbors[2][1] / (m_neighbors[2][1] + maxPeakVal);
+        templateToInputOffset.r += bottom / (bottom + maxPeakVal);
     }
 
-    if (m_neighbors[1][0] > m_neighbors[1][2])
+    if (left > right)
     {
-        templateToInputOffset.c -= m_neighbors[1][0] / (m_neighbors[1][0] + maxPeakVal);
+        templateToInputOffset.c -= left / (left + maxPeakVal);
     }
     else
     {
-        templateToInputOffset.c += m_neighbors[1][2] / (m_neighbors[1][2] + maxPeakVal);
+        templateToInputOffset.c += right / (right + maxPeakVal);
     }
 
     success = true;
@@ -88,16 +164,9 @@ CVector<double> CCorrelateSpacePolyImpl::genVec(double r, double c)
 }
 
 CCorrelateSpacePolyImpl::CCorrelateSpacePolyImpl() :
-ICorrelateInterface(),
-m_size3x3(3),
-m_size3x1(3, 1),
-m_size1x3(1, 3),
-m_vec3(3)
+ICorrelateInterface()
 {
-    m_vec3.initVec(0);
     m_A.resize(SSize(9, 6));
-    m_B.resize(SSize(9, 1));
-    m_leastSquareAns.resize(6);
     int t = 0;
     for (int r = -1; r <= 1; r++)
     {
@@ -106,6 +175,18 @@ m_vec3(3)
             m_A[t] = genVec(r, c);
         }
     }
+
+    // the least squares fit is linear in B, solve it once per neighbour instead of once per chip
+    m_solution.resize(SSize(6, 9));
+    CMatrix<double> unitB(SSize(9, 1));
+    for (unsigned long n = 0; n < 9; n++)
+    {
+        unitB.initMat(0);
+        unitB[n][0] = 1;
+        CVector<double> ans = CLeastSquares::calc<double>(&m_A, &unitB);
+        for (unsigned long k = 0; k < 6; k++)
+            m_solution[k][n] = ans[k];
+    }
 }
 
 CCorrelateSpacePolyImpl::~CCorrelateSpacePolyImpl()
@@ -123,40 +204,26 @@ int CCorrelateSpacePolyImpl::correlate(const CMatrix<double> &scratchImage,
         success = true;
         return 0;
     }
-    const SSize &loadSize = edgeType == EdgeType::FULL ? m_size3x3 :
-        edgeType == EdgeType::X ? m_size1x3 : m_size3x1;
-    const SSize delta = edgeType == EdgeType::FULL ? SSize(1, 1) :
-        edgeType == EdgeType::X ? SSize(0, 1) : SSize(1, 0);
-    CMatrix<double> scratchSubImage = scratchImage.getSubMatrixEqualsCopy(maxPeakLoc - delta, loadSize);
-    if (edgeType == EdgeType::X)
-    {
-        scratchSubImage = scratchSubImage.pushFrontRow(m_vec3).pushBackRow(m_vec3);
-    }
-    else if (edgeType == EdgeType::Y)
+    // an edge along one axis only fits the neighbours on the other axis, the rest are zero
+    bool useRows = edgeType != EdgeType::X;
+    bool useCols = edgeType != EdgeType::Y;
+    int t = 0;
+    for (int r = -1; r <= 1; r++)
     {
-        scratchSubImage = scratchSubImage.pushFrontCol(m_vec3).pushBackCol(m_vec3);
+        for (int c = -1; c <= 1; c++, t++)
+        {
+            bool inWindow = (useRows || r == 0) && (useCols || c == 0);
+            m_B[t] = inWindow ? scratchImage[maxPeakLoc.row + r][maxPeakLoc.col + c] : 0.0;
+        }
     }
-    m_B[0][0] = (double) scratchSubImage[0][0];
-    m_B[1][0] = (double) scratchSubImage[0][1];
-    m_B[2][0] = (double) scratchSubImage[0][2];
 
-    m_B[3][0] = (double) scratchSubImage[1][0];
-    m_B[4][0] = (double) scratchSubImage[1][1];
-    m_B[5][0] = (double) scratchSubImage[1][2];
-
-    m_B[6][0] = (double) scratchSubImage[2][0];
-    m_B[7][0] = (double) scratchSubImage[2][1];
-    m_B[8][0] = (double) scratchSubImage[2][2];
-
-    try
+    for (unsigned long k = 0; k < 6; k++)
     {
-        m_leastSquareAns = CLeastSquares::calc<double>(&m_A, &m_B);
-    }
-    catch (const std::exception &e)
-    {
-        //skipping
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, e);
-        return 0;
+        const double *dp = m_solution[k].getDataPointer();
+        double sum = 0;
+        for (unsigned long n = 0; n < 9; n++)
+            sum += dp[n] * m_B[n];
+        m_leastSquareAns[k] = sum;
     }
 
     //   poly = a0 + a1x + a2y + a3xy + a4xx + a5yy
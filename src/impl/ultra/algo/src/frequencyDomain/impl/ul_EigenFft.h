@@ -28,8 +28,14 @@ class CEigenFft2d : public ADftBase2d
 private:
     std::shared_ptr<void> m_fftOpRows;
     std::shared_ptr<void> m_fftOpCols;
+    std::shared_ptr<void> m_fftOpRowsFloat;
+    std::shared_ptr<void> m_fftOpColsFloat;
     virtual void forwardImpl(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMatrix<SComplex<MY_WORKING_TYPE> > &output) const override;
     virtual void inverseImpl(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMatrix<SComplex<MY_WORKING_TYPE> > &output) const override;
+    virtual void forwardImpl(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const override;
+    virtual void inverseImpl(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const override;
+    virtual void forwardImpl(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const override;
+    virtual void inverseImpl(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const override;
 public:
     CEigenFft2d(const SSize &size);
     virtual ~CEigenFft2d();
@@ -22,6 +22,70 @@ namespace ultra
 {
 namespace __ultra_internal_fft
 {
+namespace
+{
+
+template<class W>
+std::shared_ptr<void> createFftOp()
+{
+    std::shared_ptr<void> op(new Eigen::FFT<W>(), [](void *p)->void
+    {
+        if (p != nullptr)
+        {
+            Eigen::FFT<W> *ptr = (Eigen::FFT<W>*)p;
+            delete ptr;
+        }
+    });
+    ((Eigen::FFT<W>*)op.get())->SetFlag(Eigen::FFT<W>::Speedy);
+    return op;
+}
+
+/**
+ * Row transforms straight into the output, column transforms through two gathered columns in the scratch arena
+ */
+template<class W>
+void transformScratch(void *fftOpRows, void *fftOpCols, const SSize &size, bool forward,
+                      const CScratchMatrix<SComplex<W> > &input, CScratchMatrix<SComplex<W> > &output)
+{
+    typedef typename Eigen::FFT<W>::Complex EIGEN_COMPLEX;
+    Eigen::FFT<W> *opRow = (Eigen::FFT<W>*)fftOpRows;
+    for (unsigned long r = 0; r < size.row; r++)
+    {
+        const auto *src = (const EIGEN_COMPLEX*)input[r];
+        auto *des = (EIGEN_COMPLEX*)output[r];
+        if (forward)
+            opRow->fwd(des, src, size.col);
+        else
+            opRow->inv(des, src, size.col);
+    }
+
+    CScratchArenaScope scope;
+    SComplex<W> *col = scope.getArena()->allocate<SComplex<W> >(size.row);
+    SComplex<W> *tempCol = scope.getArena()->allocate<SComplex<W> >(size.row);
+    Eigen::FFT<W> *opCol = (Eigen::FFT<W>*)fftOpCols;
+    const SComplex<W> scale(size.getProduct());
+    for (unsigned long c = 0; c < size.col; c++)
+    {
+        for (unsigned long r = 0; r < size.row; r++)
+            col[r] = output[r][c];
+        if (forward)
+        {
+            opCol->fwd((EIGEN_COMPLEX*)tempCol, (const EIGEN_COMPLEX*)col, size.row);
+            for (unsigned long r = 0; r < size.row; r++)
+            {
+                output[r][c] = tempCol[r];
+                output[r][c] /= scale;
+            }
+        }
+        else
+        {
+            opCol->inv((EIGEN_COMPLEX*)tempCol, (const EIGEN_COMPLEX*)col, size.row);
+            for (unsigned long r = 0; r < size.row; r++)
+                output[r][c] = tempCol[r];
+        }
+    }
+}
+} // namespace
 
 CEigenFft2d::CEigenFft2d(const SSize &size) :
 ADftBase2d(size, "Eigen"),
@@ -44,6 +108,8 @@ m_fftOpCols(new Eigen::FFT<MY_WORKING_TYPE>(), [](void *p)->void
 {
     ((Eigen::FFT<MY_WORKING_TYPE>*)m_fftOpRows.get())->SetFlag(Eigen::FFT<MY_WORKING_TYPE>::Speedy);
     ((Eigen::FFT<MY_WORKING_TYPE>*)m_fftOpCols.get())->SetFlag(Eigen::FFT<MY_WORKING_TYPE>::Speedy);
+    m_fftOpRowsFloat = createFftOp<float>();
+    m_fftOpColsFloat = createFftOp<float>();
 }
 
 CEigenFft2d::~CEigenFft2d()
@@ -99,5 +165,25 @@ void CEigenFft2d::inverseImpl(const CMatrix<SComplex<MY_WORKING_TYPE> > &input,
     }
 }
 
+void CEigenFft2d::forwardImpl(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const
+{
+    transformScratch<MY_WORKING_TYPE>(m_fftOpRows.get(), m_fftOpCols.get(), m_size, true, input, output);
+}
+
+void CEigenFft2d::inverseImpl(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const
+{
+    transformScratch<MY_WORKING_TYPE>(m_fftOpRows.get(), m_fftOpCols.get(), m_size, false, input, output);
+}
+
+void CEigenFft2d::forwardImpl(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const
+{
+    transformScratch<float>(m_fftOpRowsFloat.get(), m_fftOpColsFloat.get(), m_size, true, input, output);
+}
+
+void CEigenFft2d::inverseImpl(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const
+{
+    transformScratch<float>(m_fftOpRowsFloat.get(), m_fftOpColsFloat.get(), m_size, false, input, output);
+}
+
 } // namespace __ultra_internal_fft
 } // namespace ultra
@@ -61,4 +61,36 @@ void CDft2d::inverseImpl(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMatr
         throw CException(__FILE__, __LINE__, "No FFT library found");
 }
 
+void CDft2d::forwardImpl(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const
+{
+    if (m_op)
+        m_op->forward(input, output);
+    else
+        throw CException(__FILE__, __LINE__, "No FFT library found");
+}
+
+void CDft2d::inverseImpl(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const
+{
+    if (m_op)
+        m_op->inverse(input, output);
+    else
+        throw CException(__FILE__, __LINE__, "No FFT library found");
+}
+
+void CDft2d::forwardImpl(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const
+{
+    if (m_op)
+        m_op->forward(input, output);
+    else
+        throw CException(__FILE__, __LINE__, "No FFT library found");
+}
+
+void CDft2d::inverseImpl(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const
+{
+    if (m_op)
+        m_op->inverse(input, output);
+    else
+        throw CException(__FILE__, __LINE__, "No FFT library found");
+}
+
 } // namespace ultra
@@ -15,10 +15,13 @@
 */
 
 #include "ul_DftBase.h"
+#include <ul_Profiler.h>
 
 namespace ultra
 {
 
+const unsigned long ADftBase2d::SINGLE_PRECISION_MAX_SIZE = 512;
+
 ADftBase2d::ADftBase2d(const SSize &size, const std::string &fftLibName) :
 m_size(size),
 m_fftLibName(fftLibName)
@@ -40,6 +43,7 @@ void ADftBase2d::forwardWt(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMa
         throw CException(__FILE__, __LINE__, "Input and output cannot point to the same matrix");
     if (input.getSize() != m_size)
         throw CException(__FILE__, __LINE__, "Input matrix is of incorrect size");
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_FFT, "Dft2d.forward");
     forwardImpl(input, output);
 }
 
@@ -49,8 +53,54 @@ void ADftBase2d::inverseWt(const CMatrix<SComplex<MY_WORKING_TYPE> > &input, CMa
         throw CException(__FILE__, __LINE__, "Input and output cannot point to the same matrix");
     if (input.getSize() != m_size)
         throw CException(__FILE__, __LINE__, "Input matrix is of incorrect size");
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_FFT, "Dft2d.inverse");
     inverseImpl(input, output);
 }
 
+namespace
+{
+
+template<class T>
+void checkScratchArguments(const CScratchMatrix<T> &input, const CScratchMatrix<T> &output, const SSize &size)
+{
+    if (input.getDataPointer() == output.getDataPointer())
+        throw CException(__FILE__, __LINE__, "Input and output cannot point to the same matrix");
+    if (input.getSize() != size || output.getSize() != size)
+        throw CException(__FILE__, __LINE__, "Input or output matrix is of incorrect size");
+}
+} // namespace
+
+bool ADftBase2d::isSinglePrecisionSafe(const SSize &size)
+{
+    return size.row <= SINGLE_PRECISION_MAX_SIZE && size.col <= SINGLE_PRECISION_MAX_SIZE;
+}
+
+void ADftBase2d::forward(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const
+{
+    checkScratchArguments(input, output, m_size);
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_FFT, "Dft2d.forward");
+    forwardImpl(input, output);
+}
+
+void ADftBase2d::inverse(const CScratchMatrix<SComplex<MY_WORKING_TYPE> > &input, CScratchMatrix<SComplex<MY_WORKING_TYPE> > &output) const
+{
+    checkScratchArguments(input, output, m_size);
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_FFT, "Dft2d.inverse");
+    inverseImpl(input, output);
+}
+
+void ADftBase2d::forward(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const
+{
+    checkScratchArguments(input, output, m_size);
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_FFT, "Dft2d.forwardFloat");
+    forwardImpl(input, output);
+}
+
+void ADftBase2d::inverse(const CScratchMatrix<SComplex<float> > &input, CScratchMatrix<SComplex<float> > &output) const
+{
+    checkScratchArguments(input, output, m_size);
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_FFT, "Dft2d.inverseFloat");
+    inverseImpl(input, output);
+}
 
 } // namespace ultra
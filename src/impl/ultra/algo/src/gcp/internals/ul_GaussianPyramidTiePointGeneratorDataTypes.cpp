@@ -23,6 +23,7 @@ CGaussianPyramidTiePointGenerator::SContext::SContext()
 {
     amountOfPyramids = 1;
     minimumRequiredGcp = 30;
+    localShiftPriors = true;
     resampleType = EResamplerEnum::RESAMPLE_TYPE_BI;
 }
 
@@ -30,6 +31,7 @@ CGaussianPyramidTiePointGenerator::SContext::SContext(const SContext &r)
 {
     resampleType = r.resampleType;
     minimumRequiredGcp = r.minimumRequiredGcp;
+    localShiftPriors = r.localShiftPriors;
     amountOfPyramids = r.amountOfPyramids;
     tiePointGeneratorContext = r.tiePointGeneratorContext;
     workingFolder = r.workingFolder;
@@ -43,6 +45,7 @@ CGaussianPyramidTiePointGenerator::SContext &CGaussianPyramidTiePointGenerator::
 {
     resampleType = r.resampleType;
     minimumRequiredGcp = r.minimumRequiredGcp;
+    localShiftPriors = r.localShiftPriors;
     amountOfPyramids = r.amountOfPyramids;
     tiePointGeneratorContext = r.tiePointGeneratorContext;
     workingFolder = r.workingFolder;
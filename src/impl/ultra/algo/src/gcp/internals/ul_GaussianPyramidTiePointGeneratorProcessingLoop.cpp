@@ -21,6 +21,8 @@
 namespace ultra
 {
 
+const double CGaussianPyramidTiePointGenerator::SHIFT_PRIOR_RADIUS_IN_GRID_CELLS = 2.5;
+
 namespace
 {
 
@@ -122,12 +124,35 @@ int CGaussianPyramidTiePointGenerator::UpdateResult(
     return 0;
 }
 
+int CGaussianPyramidTiePointGenerator::BuildShiftPriors(const CVector<SChipCorrelationResult> &result,
+                                                        const SPair<double> &gsd, const SPair<double> &globalShift,
+                                                        CTiePointGenerator::SContext &context)
+{
+    context.shiftPriors = nullptr;
+    if (!m_context.publicContex->localShiftPriors)
+        return 0;
+
+    // the chips of every level are generated on a grid of the same size in pixels
+    double radius = SHIFT_PRIOR_RADIUS_IN_GRID_CELLS * context.chipGenerationGridSize * getMAX(getAbs(gsd.r), getAbs(gsd.c));
+    if (m_shiftPriors.Build(result, gsd, globalShift, radius, 2.0) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CGcpShiftPriors::Build()");
+        return 1;
+    }
+
+    if (!m_shiftPriors.isEmpty())
+        context.shiftPriors = &m_shiftPriors;
+    return 0;
+}
+
 int CGaussianPyramidTiePointGenerator::GenerateGcps(CVector<SChipCorrelationResult> &result)
 {
     bool skip = true;
     bool someChipsCorrelatedBefore = false;
     SPair<double> avgShift;
     CTiePointGenerator::SContext context = m_context.publicContex->tiePointGeneratorContext;
+    m_shiftPriors.Clear();
+    context.shiftPriors = nullptr;
 
     SPair<double> gsd;
     long loops = m_context.inputPyramids.size();
@@ -146,6 +171,17 @@ int CGaussianPyramidTiePointGenerator::GenerateGcps(CVector<SChipCorrelationResu
         if (t == 0)
             context.outerHullRejectGcps = baseHullReject;
 
+        // read the next (finer) pyramid level while this one correlates
+        if (context.imagePrefetcher != nullptr && t > 0)
+        {
+            if (context.imagePrefetcher->Request(m_context.referencePyramids[t - 1].filePath, context.referenceScene.bandNumber) != 0 ||
+                context.imagePrefetcher->Request(m_context.inputPyramids[t - 1].filePath, context.inputScene.bandNumber) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CImagePrefetcher::Request()");
+                return 1;
+            }
+        }
+
         std::unique_ptr<CTiePointGenerator> calculator(new CTiePointGenerator(&context));
         if (calculator.get() == nullptr)
         {
@@ -177,6 +213,8 @@ int CGaussianPyramidTiePointGenerator::GenerateGcps(CVector<SChipCorrelationResu
             {
                 context.inputOffsetShiftInPixels *= 2.0;
                 context.searchWindowSize = baseSearchWindowSize;
+                m_shiftPriors.Clear();
+                context.shiftPriors = nullptr;
                 CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "No good GCPs found skipping processing loop '" + toString(loops - t) + "'");
                 continue;
             }
@@ -193,6 +231,14 @@ int CGaussianPyramidTiePointGenerator::GenerateGcps(CVector<SChipCorrelationResu
                 context.inputOffsetShiftInPixels += avgShift.roundValues() * 2.0;
                 context.searchWindowSize = 15;
                 CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Average shift for pyramid scene '" + toString(loops - t) + "/" + toString(loops) + "' is '" + toString(avgShift) + "' pixels");
+
+                // the chips of the next level are searched around the shifts of their neighbours
+                // found here, relative to the global shift just applied
+                if (BuildShiftPriors(result, gsd, avgShift.roundValues(), context) != 0)
+                {
+                    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from BuildShiftPriors()");
+                    return 1;
+                }
             }
         }
     }
@@ -55,36 +55,24 @@ int CTiePointGenerator::GenerateWorldMatrix(
     return 0;
 }
 
-int CTiePointGenerator::Correlate(
-                                  CMatrix<SPair<double> > &worldMatrix,
-                                  CVector<CChip<float> > &chipVector,
-                                  CVector<SChipCorrelationResult> &result
-                                  )
+int CTiePointGenerator::StartCorrelationThreads(
+                                                std::unique_ptr<CCorrelationHandler> &corr,
+                                                CMatrix<SPair<double> > &worldMatrix,
+                                                CBoundedQueue<CChip<float> > &chipQueue
+                                                )
 {
-    result.clear();
-    if (chipVector.size() == 0)
-    {
-        //no chips found
-        return 0;
-    }
-    std::shared_ptr<CThreadLock> lock(new CThreadLock());
-    unsigned long numberThreadsToUse = m_context.innerContext->threadCount;
-    if (chipVector.size() < numberThreadsToUse)
-    {
-        numberThreadsToUse = chipVector.size();
-    }
-
-    std::unique_ptr<CCorrelationHandler> corr(new CCorrelationHandler(
-                                                                      numberThreadsToUse,
-                                                                      m_context.innerContext->correlationThreshold,
-                                                                      m_context.innerContext->useNullValue(),
-                                                                      m_context.innerContext->getNullValue(),
-                                                                      m_context.innerContext->getMayContainNullValues()
-                                                                      ));
+    // the chip count is not known yet, the threads wait on the queue until the generators push chips
+    corr.reset(new CCorrelationHandler(
+                                       m_context.innerContext->threadCount,
+                                       m_context.innerContext->correlationThreshold,
+                                       m_context.innerContext->useNullValue(),
+                                       m_context.innerContext->getNullValue(),
+                                       m_context.innerContext->getMayContainNullValues()
+                                       ));
 
     if (corr->LoadData(
                        m_context.images[INPUT_IMG_INDEX],
-                       chipVector,
+                       &chipQueue,
                        worldMatrix,
                        m_context.inputSceneMetadata.gsd,
                        m_context.innerContext->searchWindowSize,
@@ -96,27 +84,54 @@ int CTiePointGenerator::Correlate(
         return 1;
     }
 
+    if (corr->Correlate() != 0)
     {
-        AUTO_LOCK(lock);
-        if (corr->Correlate(lock) != 0)
-        {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Correlate()");
-            return 1;
-        }
-        if (lock->wait(__FILE__, __LINE__) != 0)
-        {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to wait on a mutex");
-            return 1;
-        }
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Correlate()");
+        return 1;
     }
 
+    return 0;
+}
+
+int CTiePointGenerator::ReorderResults(CVector<SChipCorrelationResult> &result,
+                                       const std::vector<unsigned long> &chipCounts)
+{
+    // the queued chip ID is (chip of the generator) * (generator count) + (generator), renumber
+    // the chips in generator order so the chip IDs and the result order do not depend on the
+    // thread timing
+    unsigned long generatorCount = chipCounts.size();
+    std::vector<unsigned long> chipOffsets(generatorCount, 0);
+    unsigned long totalChipsSize = 0;
+    for (unsigned long t = 0; t < generatorCount; t++)
+    {
+        chipOffsets[t] = totalChipsSize;
+        totalChipsSize += chipCounts[t];
+    }
 
-    if (corr->GetResults(result) != 0)
+    if (result.size() != totalChipsSize)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GetResults()");
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Correlated '" + toString(result.size()) + "' chips, '" + toString(totalChipsSize) + "' were generated");
         return 1;
     }
 
+    CVector<SChipCorrelationResult> ordered(totalChipsSize);
+    for (unsigned long x = 0; x < result.size(); x++)
+    {
+        unsigned long queuedId = result[x].chip.chipId;
+        unsigned long generator = queuedId % generatorCount;
+        unsigned long generatorChip = queuedId / generatorCount;
+        if (generatorChip >= chipCounts[generator])
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Unknown queued chip ID '" + toString(queuedId) + "'");
+            return 1;
+        }
+
+        unsigned long chipId = chipOffsets[generator] + generatorChip;
+        ordered[chipId] = result[x];
+        ordered[chipId].chip.chipId = chipId;
+    }
+
+    result = std::move(ordered);
     return 0;
 }
 
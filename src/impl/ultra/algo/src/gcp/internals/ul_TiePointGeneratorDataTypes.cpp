@@ -51,16 +51,21 @@ CTiePointGenerator::SContext::SContext()
     threadCount = 0;
     chipSizeMinimum = 0;
     searchWindowSize = 0;
+    maxFeaturesPerCell = 0;
     correlationThreshold = 0.75;
     m_useNullValue = false;
     m_mayContainNullValues = true;
     outerHullRejectGcps = true;
+    duplicateGcpTolerance = 0;
     typeOfChipCorrelationTechnique = ECorrelationType::CORRELATION_TYPE_COUNT;
+    imagePrefetcher = nullptr;
+    shiftPriors = nullptr;
 }
 
 CTiePointGenerator::SContext::SContext(const CTiePointGenerator::SContext &r)
 {
     chipGenerationGridSize = r.chipGenerationGridSize;
+    maxFeaturesPerCell = r.maxFeaturesPerCell;
     inputOffsetShiftInPixels = r.inputOffsetShiftInPixels;
     threadCount = r.threadCount;
     chipSizeMinimum = r.chipSizeMinimum;
@@ -68,12 +73,15 @@ CTiePointGenerator::SContext::SContext(const CTiePointGenerator::SContext &r)
     correlationThreshold = r.correlationThreshold;
     searchWindowSize = r.searchWindowSize;
     outerHullRejectGcps = r.outerHullRejectGcps;
+    duplicateGcpTolerance = r.duplicateGcpTolerance;
     chipGeneratorMethods = r.chipGeneratorMethods;
     fixedLocationChips = r.fixedLocationChips;
     fixedLocationChipProj4Str = r.fixedLocationChipProj4Str;
 
     inputScene = r.inputScene;
     referenceScene = r.referenceScene;
+    imagePrefetcher = r.imagePrefetcher;
+    shiftPriors = r.shiftPriors;
 
     m_useNullValue = r.m_useNullValue;
     m_nullValue = r.m_nullValue;
@@ -90,6 +98,7 @@ CTiePointGenerator::SContext &CTiePointGenerator::SContext::operator=(const CTie
     if (this == &r)
         return *this;
     chipGenerationGridSize = r.chipGenerationGridSize;
+    maxFeaturesPerCell = r.maxFeaturesPerCell;
     inputOffsetShiftInPixels = r.inputOffsetShiftInPixels;
     threadCount = r.threadCount;
     chipSizeMinimum = r.chipSizeMinimum;
@@ -97,12 +106,15 @@ CTiePointGenerator::SContext &CTiePointGenerator::SContext::operator=(const CTie
     correlationThreshold = r.correlationThreshold;
     searchWindowSize = r.searchWindowSize;
     outerHullRejectGcps = r.outerHullRejectGcps;
+    duplicateGcpTolerance = r.duplicateGcpTolerance;
     chipGeneratorMethods = r.chipGeneratorMethods;
     fixedLocationChips = r.fixedLocationChips;
     fixedLocationChipProj4Str = r.fixedLocationChipProj4Str;
 
     inputScene = r.inputScene;
     referenceScene = r.referenceScene;
+    imagePrefetcher = r.imagePrefetcher;
+    shiftPriors = r.shiftPriors;
 
     m_useNullValue = r.m_useNullValue;
     m_nullValue = r.m_nullValue;
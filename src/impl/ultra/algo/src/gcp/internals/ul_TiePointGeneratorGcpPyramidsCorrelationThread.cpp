@@ -39,8 +39,7 @@ int CTiePointGeneratorGcpPyramids::CCorrelationThread::Init(CTiePointGeneratorGc
                                                             CThreadLock *sharedLock,
                                                             CAtomicLong *sharedCounter,
                                                             CAtomicLong *sharedProcessingPercentage,
-                                                            CAtomicLong *threadDoneCount,
-                                                            unsigned long totalRunningThreads,
+                                                            CCountDownLatch *doneLatch,
                                                             CAtomicBool *runningVar)
 {
     m_context = context;
@@ -70,8 +69,7 @@ int CTiePointGeneratorGcpPyramids::CCorrelationThread::Init(CTiePointGeneratorGc
     m_sharedLock = sharedLock;
     m_sharedCounter = sharedCounter;
     m_sharedProcessingPercentage = sharedProcessingPercentage;
-    m_threadDoneCount = threadDoneCount;
-    m_totalRunningThreads = totalRunningThreads;
+    m_doneLatch = doneLatch;
     m_runningVar = runningVar;
     return 0;
 }
@@ -278,7 +276,7 @@ int CTiePointGeneratorGcpPyramids::CCorrelationThread::ProcessPyramidLevel(const
         {
             for (unsigned long a = 0; a < pyramids.size(); a++)
                 pyramids[a].tiePointGood[gcpItem] = false;
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Out of bounds, going to skip this chip, could not find matching reference data");
+            ULTRA_LOG(CLogger::LOG_DEBUG, "Out of bounds, going to skip this chip, could not find matching reference data");
             continue;
         }
 
@@ -317,11 +315,9 @@ int CTiePointGeneratorGcpPyramids::CCorrelationThread::ProcessPyramidLevel(const
         {
             long per = ((long) gcpItem * 100) / (long) m_gcpTotalCount;
             m_sharedProcessingPercentage->set(per);
-            CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Correlating " + toString(per) + "%    \r");
+            ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Correlating " + toString(per) + "%    \r");
         }
     }
-    if (m_threadDoneCount->incAndGet() == m_totalRunningThreads)
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Correlating 100%    ");
     return 0;
 }
 
@@ -333,6 +329,10 @@ void CTiePointGeneratorGcpPyramids::CCorrelationThread::run(void *context)
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ProcessPyramidLevel()");
         m_exitCode = 1;
     }
+
+    // always count down, even on failure, otherwise the waiting thread never wakes up
+    if (m_doneLatch->countDown() == 0 && m_exitCode == 0)
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Correlating 100%    ");
 }
 
 } // namespace ultra
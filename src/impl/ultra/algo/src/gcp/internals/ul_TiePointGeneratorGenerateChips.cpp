@@ -25,10 +25,12 @@
 namespace ultra
 {
 
-int CTiePointGenerator::GenerateSobelChips(CMatrix<float> &image, CVector<CChip<float> > &chipVector)
+int CTiePointGenerator::GenerateSobelChips(CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink)
 {
     CSobelChips::CSobelChipsContext context;
     context.chipWidth = m_context.innerContext->chipSizeMinimum;
+    context.gridSize = m_context.innerContext->chipGenerationGridSize;
+    context.maxFeaturesPerCell = m_context.innerContext->maxFeaturesPerCell;
 
     std::unique_ptr<CSobelChips> sobelChips(new CSobelChips());
     if (sobelChips.get() == nullptr)
@@ -37,7 +39,7 @@ int CTiePointGenerator::GenerateSobelChips(CMatrix<float> &image, CVector<CChip<
         return 1;
     }
 
-    if (GenerateChips(sobelChips.get(), &context, image, chipVector) != 0)
+    if (GenerateChips(sobelChips.get(), &context, image, sink) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GenerateChips()");
         return 1;
@@ -46,7 +48,7 @@ int CTiePointGenerator::GenerateSobelChips(CMatrix<float> &image, CVector<CChip<
     return 0;
 }
 
-int CTiePointGenerator::GenerateEvenChips(CMatrix<float> &image, CVector<CChip<float> > &chipVector)
+int CTiePointGenerator::GenerateEvenChips(CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink)
 {
     CEvenChips::CEvenChipsContext context;
     context.chipSize = m_context.innerContext->chipSizeMinimum;
@@ -58,7 +60,7 @@ int CTiePointGenerator::GenerateEvenChips(CMatrix<float> &image, CVector<CChip<f
         return 1;
     }
 
-    if (GenerateChips(evenChips.get(), &context, image, chipVector) != 0)
+    if (GenerateChips(evenChips.get(), &context, image, sink) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GenerateChips()");
         return 1;
@@ -68,10 +70,12 @@ int CTiePointGenerator::GenerateEvenChips(CMatrix<float> &image, CVector<CChip<f
 }
 
 
-int CTiePointGenerator::GenerateHarrisChips(CMatrix<float> &image, CVector<CChip<float> > &chipVector)
+int CTiePointGenerator::GenerateHarrisChips(CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink)
 {
     CHarrisChips::CHarrisChipsContext context;
     context.chipSize = m_context.innerContext->chipSizeMinimum;
+    context.gridSize = m_context.innerContext->chipGenerationGridSize;
+    context.maxFeaturesPerCell = m_context.innerContext->maxFeaturesPerCell;
     std::unique_ptr<CHarrisChips> harrisChips(new CHarrisChips());
 
     if (harrisChips.get() == nullptr)
@@ -80,7 +84,7 @@ int CTiePointGenerator::GenerateHarrisChips(CMatrix<float> &image, CVector<CChip
         return 1;
     }
 
-    if (GenerateChips(harrisChips.get(), &context, image, chipVector) != 0)
+    if (GenerateChips(harrisChips.get(), &context, image, sink) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GenerateChips()");
         return 1;
@@ -89,7 +93,7 @@ int CTiePointGenerator::GenerateHarrisChips(CMatrix<float> &image, CVector<CChip
     return 0;
 }
 
-int CTiePointGenerator::GenerateFixedLocationChips(CMatrix<float> &image, CVector<CChip<float> > &chipVector)
+int CTiePointGenerator::GenerateFixedLocationChips(CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink)
 {
     CFixedLocationChips::CFixedLocationChipsContext context;
     context.gridSize = m_context.innerContext->chipGenerationGridSize;
@@ -113,7 +117,7 @@ int CTiePointGenerator::GenerateFixedLocationChips(CMatrix<float> &image, CVecto
         return 1;
     }
 
-    if (GenerateChips(locationFileChips.get(), &context, image, chipVector) != 0)
+    if (GenerateChips(locationFileChips.get(), &context, image, sink) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GenerateChips()");
         return 1;
@@ -122,13 +126,16 @@ int CTiePointGenerator::GenerateFixedLocationChips(CMatrix<float> &image, CVecto
 }
 
 int CTiePointGenerator::GenerateChips(CChipsGen<float> *chipGenner, CChipsGen<float>::CChipsGenContext *context,
-                                      CMatrix<float> &image, CVector<CChip<float> > &chipVector)
+                                      CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink)
 {
+    // stays empty, the chips go to the sink
+    CVector<CChip<float> > chipVector;
     if (chipGenner->LoadData(&image, &chipVector) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadData()");
         return 1;
     }
+    chipGenner->setChipSink(sink);
 
     if (chipGenner->Generate(context) != 0)
     {
@@ -17,13 +17,14 @@
 #include "ul_TiePointGenerator.h"
 
 #include "ul_GcpHullRejection.h"
+#include "ul_Profiler.h"
 
 namespace ultra
 {
 
 int CTiePointGenerator::HullRejectGcps(CVector<SChipCorrelationResult> &result)
 {
-    CMatrixArray<float> refImage, inImage;
+    ULTRA_SCOPED_TIMER("HullRejectGcps");
     SImageMetadata refMetadata, inputMetadata;
     unsigned long hullTrimAmount = 0;
 
@@ -44,9 +45,10 @@ int CTiePointGenerator::HullRejectGcps(CVector<SChipCorrelationResult> &result)
         return 1;
     }
 
-    if (LoadCompleteImages(refImage, refMetadata, inImage, inputMetadata) != 0)
+    // the hulls are generated from the bands that were correlated, those are still loaded
+    if (LoadSceneMetadata(refMetadata, inputMetadata) != 0)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadCompleteImages()");
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadSceneMetadata()");
         return 1;
     }
 
@@ -65,7 +67,7 @@ int CTiePointGenerator::HullRejectGcps(CVector<SChipCorrelationResult> &result)
             hullTrimAmount = result[t].chip.chipData.getSize().col;
     }
 
-    if (reject->Reject(refImage, refMetadata, inImage, inputMetadata, m_context.innerContext->getNullValue(), hullTrimAmount, &result) != 0)
+    if (reject->Reject(m_context.images[REF_IMG_INDEX], refMetadata, m_context.images[INPUT_IMG_INDEX], inputMetadata, m_context.innerContext->getNullValue(), hullTrimAmount, &result) != 0)
     {
         delete reject;
         reject = nullptr;
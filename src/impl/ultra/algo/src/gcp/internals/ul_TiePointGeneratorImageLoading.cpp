@@ -36,9 +36,46 @@ int CTiePointGenerator::LoadOneImageFull(int bandNumber)
     return 0;
 }
 
+int CTiePointGenerator::LoadTwoImagesPrefetched()
+{
+    CImagePrefetcher *prefetcher = m_context.innerContext->imagePrefetcher;
+    // the input image is read on the I/O thread while the reference is read here
+    if (prefetcher->Request(m_context.innerContext->inputScene.pathToImage,
+                            m_context.innerContext->inputScene.bandNumber) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CImagePrefetcher::Request()");
+        return 1;
+    }
+
+    ULTRA_LOG(CLogger::LOG_DEBUG, "Loading reference image .... '" + m_context.innerContext->referenceScene.pathToImage + "' band number '" + toString(m_context.innerContext->referenceScene.bandNumber) + "'");
+    if (prefetcher->LoadImage(m_context.innerContext->referenceScene.pathToImage,
+                              m_context.images[REF_IMG_INDEX],
+                              m_context.innerContext->referenceScene.bandNumber) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CImagePrefetcher::LoadImage()");
+        return 1;
+    }
+    ULTRA_LOG(CLogger::LOG_DEBUG, "Loading reference image .... DONE");
+
+    ULTRA_LOG(CLogger::LOG_DEBUG, "Loading input image .... '" + m_context.innerContext->inputScene.pathToImage + "' band number '" + toString(m_context.innerContext->inputScene.bandNumber) + "'");
+    if (prefetcher->LoadImage(m_context.innerContext->inputScene.pathToImage,
+                              m_context.images[INPUT_IMG_INDEX],
+                              m_context.innerContext->inputScene.bandNumber) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CImagePrefetcher::LoadImage()");
+        return 1;
+    }
+    ULTRA_LOG(CLogger::LOG_DEBUG, "Loading input image .... DONE");
+
+    return 0;
+}
+
 int CTiePointGenerator::LoadTwoImages()
 {
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Loading reference image .... '" + m_context.innerContext->referenceScene.pathToImage + "' band number '" + toString(m_context.innerContext->inputScene.bandNumber) + "'");
+    if (m_context.innerContext->imagePrefetcher != nullptr)
+        return LoadTwoImagesPrefetched();
+
+    ULTRA_LOG(CLogger::LOG_DEBUG, "Loading reference image .... '" + m_context.innerContext->referenceScene.pathToImage + "' band number '" + toString(m_context.innerContext->inputScene.bandNumber) + "'");
     if (CImageLoader::getInstance()->LoadImage(
                                                m_context.innerContext->referenceScene.pathToImage,
                                                m_context.images[REF_IMG_INDEX],
@@ -47,9 +84,9 @@ int CTiePointGenerator::LoadTwoImages()
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadImage()");
         return 1;
     }
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Loading reference image .... DONE");
+    ULTRA_LOG(CLogger::LOG_DEBUG, "Loading reference image .... DONE");
 
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Loading input image .... '" + m_context.innerContext->inputScene.pathToImage + "' band number '" + toString(m_context.innerContext->referenceScene.bandNumber) + "'");
+    ULTRA_LOG(CLogger::LOG_DEBUG, "Loading input image .... '" + m_context.innerContext->inputScene.pathToImage + "' band number '" + toString(m_context.innerContext->referenceScene.bandNumber) + "'");
     if (CImageLoader::getInstance()->LoadImage(
                                                m_context.innerContext->inputScene.pathToImage,
                                                m_context.images[INPUT_IMG_INDEX],
@@ -58,42 +95,25 @@ int CTiePointGenerator::LoadTwoImages()
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadImage()");
         return 1;
     }
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Loading input image .... DONE");
+    ULTRA_LOG(CLogger::LOG_DEBUG, "Loading input image .... DONE");
 
     return 0;
 }
 
-int CTiePointGenerator::LoadCompleteImages(CMatrixArray<float> &refImages, SImageMetadata &refMetadata,
-                                           CMatrixArray<float> &inputImages, SImageMetadata &inputMetadata)
+int CTiePointGenerator::LoadSceneMetadata(SImageMetadata &refMetadata, SImageMetadata &inputMetadata)
 {
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Loading reference image .... '" + m_context.innerContext->referenceScene.pathToImage + "");
-    if (CImageLoader::getInstance()->LoadImage(m_context.innerContext->referenceScene.pathToImage, refImages) != 0)
-    {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadImage()");
-        return 1;
-    }
-
     if (CImageLoader::getInstance()->LoadImageMetadata(m_context.innerContext->referenceScene.pathToImage, refMetadata) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadImageMetadata()");
         return 1;
     }
 
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Loading reference image .... DONE");
-
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Loading input image .... '" + m_context.innerContext->inputScene.pathToImage + "'");
-    if (CImageLoader::getInstance()->LoadImage(m_context.innerContext->inputScene.pathToImage, inputImages) != 0)
-    {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadImage()");
-        return 1;
-    }
-
     if (CImageLoader::getInstance()->LoadImageMetadata(m_context.innerContext->inputScene.pathToImage, inputMetadata) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadImageMetadata()");
         return 1;
     }
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Loading input image .... DONE");
+
     return 0;
 }
 
@@ -33,9 +33,12 @@ CTiledGaussianPyramidTiePointGenerator::SContext::SContext()
     mayContainNullValues = true;
     chipSize = 65;
     chipGenerationGridSize = chipSize * 1.2;
+    maxFeaturesPerCell = 0;
     typeOfChipCorrelationTechnique = ECorrelationType::CCOEFF_NORM;
     chipGeneratorMethods.pushBack(EChips::CHIP_GEN_EVEN);
     correlationThreshold = 0.75;
+    duplicateGcpTolerance = 0;
+    localShiftPriors = true;
 }
 
 CTiledGaussianPyramidTiePointGenerator::SContext::~SContext()
@@ -57,9 +60,12 @@ CTiledGaussianPyramidTiePointGenerator::SContext::SContext(const CTiledGaussianP
     mayContainNullValues = r.mayContainNullValues;
     chipSize = r.chipSize;
     chipGenerationGridSize = r.chipGenerationGridSize;
+    maxFeaturesPerCell = r.maxFeaturesPerCell;
     typeOfChipCorrelationTechnique = r.typeOfChipCorrelationTechnique;
     chipGeneratorMethods = r.chipGeneratorMethods;
     correlationThreshold = r.correlationThreshold;
+    duplicateGcpTolerance = r.duplicateGcpTolerance;
+    localShiftPriors = r.localShiftPriors;
     fixedLocationChips = r.fixedLocationChips;
     fixedLocationChipProj4Str = r.fixedLocationChipProj4Str;
 }
@@ -80,9 +86,12 @@ CTiledGaussianPyramidTiePointGenerator::SContext &CTiledGaussianPyramidTiePointG
     mayContainNullValues = r.mayContainNullValues;
     chipSize = r.chipSize;
     chipGenerationGridSize = r.chipGenerationGridSize;
+    maxFeaturesPerCell = r.maxFeaturesPerCell;
     typeOfChipCorrelationTechnique = r.typeOfChipCorrelationTechnique;
     chipGeneratorMethods = r.chipGeneratorMethods;
     correlationThreshold = r.correlationThreshold;
+    duplicateGcpTolerance = r.duplicateGcpTolerance;
+    localShiftPriors = r.localShiftPriors;
     fixedLocationChips = r.fixedLocationChips;
     fixedLocationChipProj4Str = r.fixedLocationChipProj4Str;
     return *this;
@@ -20,6 +20,7 @@
 #include "ul_ImageSaver.h"
 #include "ul_File.h"
 #include "ul_Resampler.h"
+#include "ul_Profiler.h"
 
 namespace ultra
 {
@@ -78,15 +79,23 @@ int CGaussianPyramidTiePointGenerator::NextPyramid(CMatrixArray<float> &imageVec
 
 int CGaussianPyramidTiePointGenerator::GeneratePyramidImages(const std::string &imagePath, CVector<SInnerContext::SPyramid> &pyramids)
 {
+    ULTRA_SCOPED_TIMER("GeneratePyramidImages");
     CMatrixArray<float> imageVec;
     CFile file = imagePath;
 
     pyramids.resize(m_context.pyramidDivLevels.size());
     pyramids[0].filePath = imagePath;
     std::string proj4Str;
-    if (CImageLoader::getInstance()->LoadImageMetadata(pyramids[0].filePath, pyramids[0].imageMetadata) != 0 ||
-        CImageLoader::getInstance()->LoadProj4Str(pyramids[0].filePath, proj4Str) != 0 ||
-        CImageLoader::getInstance()->LoadImage(pyramids[0].filePath, imageVec) != 0)
+    CImagePrefetcher *prefetcher = m_context.publicContex->tiePointGeneratorContext.imagePrefetcher;
+    int loadResult = 0;
+    if (prefetcher != nullptr)
+        loadResult = prefetcher->LoadImage(pyramids[0].filePath, imageVec, CImagePrefetcher::ALL_BANDS);
+    else
+        loadResult = CImageLoader::getInstance()->LoadImage(pyramids[0].filePath, imageVec);
+
+    if (loadResult != 0 ||
+        CImageLoader::getInstance()->LoadImageMetadata(pyramids[0].filePath, pyramids[0].imageMetadata) != 0 ||
+        CImageLoader::getInstance()->LoadProj4Str(pyramids[0].filePath, proj4Str) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to load image data");
         return 1;
@@ -97,6 +106,7 @@ int CGaussianPyramidTiePointGenerator::GeneratePyramidImages(const std::string &
     for (long t = 1; t < m_context.pyramidDivLevels.size(); t++)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Generating pyramid level '" + toString(t + 1) + "' of '" + toString(m_context.pyramidDivLevels.size()) + "' for image '" + itemName + "'");
+        ULTRA_SCOPED_TIMER("GeneratePyramidImages.level" + toString(t + 1));
 
         pyramids[t].imageMetadata = pyramids[t - 1].imageMetadata;
         pyramids[t].filePath = CFile(m_context.publicContex->workingFolder).getPath() + CFile::separatorStr + "temp_" + toString(t + 1) + "_" + toString(m_context.pyramidDivLevels.size()) + "_" + itemName + ".TIF";
@@ -0,0 +1,164 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ul_GcpDuplicateFilter.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <ul_Map.h>
+
+namespace
+{
+
+struct SCellKey
+{
+    long long r;
+    long long c;
+
+    bool operator==(const SCellKey &o) const
+    {
+        return r == o.r && c == o.c;
+    }
+};
+
+} // namespace
+
+namespace std
+{
+
+template<>
+struct hash<SCellKey>
+{
+
+    size_t operator()(const SCellKey &k) const
+    {
+        // mixed, CMap masks the low bits and the exact keys are raw double bit patterns
+        unsigned long long h = (unsigned long long) k.r * 0x9E3779B97F4A7C15ULL + (unsigned long long) k.c;
+        h ^= h >> 31;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 29;
+        return (size_t) h;
+    }
+};
+
+} // namespace std
+
+namespace ultra
+{
+
+// cell indices are kept where a double still holds every integer, so the neighbouring cells are exact
+static const double MAX_CELL_INDEX = 4503599627370496.0; // 2^52
+
+static long long exactKey(double v)
+{
+    v += 0.0; // -0 and +0 are the same coordinate
+    long long k;
+    std::memcpy(&k, &v, sizeof (k));
+    return k;
+}
+
+int CGcpDuplicateFilter::RemoveDuplicates(CVector<SChipCorrelationResult> &results, double tolerance, unsigned long &removedCount)
+{
+    removedCount = 0;
+    if (tolerance < 0 || std::isnan(tolerance))
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Duplicate GCP tolerance must be zero or positive");
+        return 1;
+    }
+
+    bool exact = tolerance == 0;
+    double toleranceSq = tolerance * tolerance;
+    CMap<SCellKey, std::vector<unsigned long> > grid;
+    unsigned long size = results.size();
+    for (unsigned long t = 0; t < size; t++)
+    {
+        SChipCorrelationResult &result = results[t];
+        if (!result.correlationResultIsGood)
+            continue;
+
+        const SPair<double> &p = result.chip.midCoordinate;
+        if (!std::isfinite(p.r) || !std::isfinite(p.c))
+            continue;
+
+        SCellKey key;
+        if (exact)
+        {
+            key.r = exactKey(p.r);
+            key.c = exactKey(p.c);
+        }
+        else
+        {
+            double cellR = std::floor(p.r / tolerance);
+            double cellC = std::floor(p.c / tolerance);
+            if (!(std::fabs(cellR) < MAX_CELL_INDEX) || !(std::fabs(cellC) < MAX_CELL_INDEX))
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Duplicate GCP tolerance is too small for the map coordinate '" + toString(p) + "'");
+                return 1;
+            }
+            key.r = (long long) cellR;
+            key.c = (long long) cellC;
+        }
+
+        bool duplicate = false;
+        if (exact)
+        {
+            duplicate = grid.getPtr(key) != nullptr;
+        }
+        else
+        {
+            for (long long dr = -1; dr <= 1 && !duplicate; dr++)
+            {
+                for (long long dc = -1; dc <= 1 && !duplicate; dc++)
+                {
+                    SCellKey neighbour;
+                    neighbour.r = key.r + dr;
+                    neighbour.c = key.c + dc;
+                    const std::vector<unsigned long> *cell = grid.getPtr(neighbour);
+                    if (cell == nullptr)
+                        continue;
+                    for (unsigned long i = 0; i < cell->size(); i++)
+                    {
+                        const SPair<double> &q = results[(*cell)[i]].chip.midCoordinate;
+                        double distanceSq = (p.r - q.r) * (p.r - q.r) + (p.c - q.c) * (p.c - q.c);
+                        if (distanceSq <= toleranceSq)
+                        {
+                            duplicate = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (duplicate)
+        {
+            result.correlationResultIsGood = false;
+            removedCount++;
+            continue;
+        }
+
+        std::vector<unsigned long> *cell = grid.getPtr(key);
+        if (cell == nullptr)
+            grid.put(key, std::vector<unsigned long>(1, t));
+        else
+            cell->push_back(t);
+    }
+
+    return 0;
+}
+
+} // namespace ultra
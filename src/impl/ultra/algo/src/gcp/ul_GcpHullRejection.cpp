@@ -23,7 +23,6 @@ namespace ultra
 
 CGcpHullRejection::CGcpHullRejection()
 {
-    m_paddSize = 5;
     m_threads.clear();
 }
 
@@ -79,7 +78,7 @@ int CGcpHullRejection::GetSceneCoordinates(
     if (refPointPair.r < 0 || refPointPair.c < 0 ||
         refPointPair.r >= refSize.r || refPointPair.c >= refSize.c)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Calculated reference GCP coordinate is outside of scene bounds");
+        ULTRA_LOG(CLogger::LOG_DEBUG, "Calculated reference GCP coordinate is outside of scene bounds");
         canUse = false;
         return 0;
     }
@@ -87,7 +86,7 @@ int CGcpHullRejection::GetSceneCoordinates(
     if (inPointPair.r < 0 || inPointPair.c < 0 ||
         inPointPair.r >= inSize.r || inPointPair.c >= inSize.c)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Calculated input GCP coordinate is outside of scene bounds");
+        ULTRA_LOG(CLogger::LOG_DEBUG, "Calculated input GCP coordinate is outside of scene bounds");
         canUse = false;
         return 0;
     }
@@ -111,21 +110,9 @@ int CGcpHullRejection::RejectGcps(
     SPair<double> refSize = refMetadata.getDimensions();
     SPair<double> inUl = inMetadata.getOrigin();
     SPair<double> inGsd = inMetadata.getGsd();
-    SPair<double> inSize = refMetadata.getDimensions();
+    SPair<double> inSize = inMetadata.getDimensions();
     bool canUse;
 
-    if (m_refHull.getSize() != refMetadata.getDimensions())
-    {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Reference image and reference hull image have different dimensions");
-        return 1;
-    }
-
-    if (m_inHull.getSize() != inMetadata.getDimensions())
-    {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Reference image and reference hull image have different dimensions");
-        return 1;
-    }
-
     int per = 0;
     for (unsigned long t = 0; t < size; t++)
     {
@@ -143,8 +130,8 @@ int CGcpHullRejection::RejectGcps(
         }
 
         if (!(rejected) &&
-            (m_refHull[refPoint] == m_nullValue ||
-            m_inHull[inPoint] == m_nullValue))
+            (!m_refHull.contains(SPair<double>(refPoint)) ||
+            !m_inHull.contains(SPair<double>(inPoint))))
         {
             rejectionCount++;
             (*m_gcps)[t].correlationResultIsGood = false;
@@ -153,7 +140,7 @@ int CGcpHullRejection::RejectGcps(
         if (per != (int) ((t * 100) / size))
         {
             per = (int) ((t * 100) / size);
-            CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "RejectGcps " + toString(per) + "%     \r");
+            ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "RejectGcps " + toString(per) + "%     \r");
         }
     }
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "RejectGcps 100%     ");
@@ -171,20 +158,29 @@ int CGcpHullRejection::InnerReject(
                                    long &rejectionCount
                                    )
 {
-    m_refImage = refImage;
-    m_inImage = inImage;
     m_nullValue = nullValue;
     m_gcps = gcps;
     m_trimAmount = hullTrimAmount;
-    m_nonNullValue = m_nullValue + 1;
 
-    if (m_gcps == nullptr || m_refImage.getSize().containsZero() ||
-        m_inImage.getSize().containsZero())
+    if (m_gcps == nullptr || refImage.getSize().containsZero() ||
+        inImage.getSize().containsZero())
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Input parameters are nullptr or empty");
         return 1;
     }
 
+    if (refImage.getSize() != refMetadata.getDimensions())
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Reference image and reference metadata have different dimensions");
+        return 1;
+    }
+
+    if (inImage.getSize() != inMetadata.getDimensions())
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Input image and input metadata have different dimensions");
+        return 1;
+    }
+
     if (m_trimAmount == 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Nothing to trim off hull this exercise is useless");
@@ -195,8 +191,9 @@ int CGcpHullRejection::InnerReject(
 
     m_threads.resize(2);
 
-    m_threads[0] = new CHullGenThread(&m_refImage, &m_refHull, m_nullValue, m_nonNullValue, m_trimAmount, m_paddSize);
-    m_threads[1] = new CHullGenThread(&m_inImage, &m_inHull, m_nullValue, m_nonNullValue, m_trimAmount, m_paddSize);
+    // the hull threads only read the images, both outlive the threads
+    m_threads[0] = new CHullGenThread(&refImage, &m_refHull, m_nullValue, m_trimAmount);
+    m_threads[1] = new CHullGenThread(&inImage, &m_inHull, m_nullValue, m_trimAmount);
 
     if (m_threads[0] == nullptr || m_threads[1] == nullptr)
     {
@@ -241,6 +238,31 @@ int CGcpHullRejection::InnerReject(
     return 0;
 }
 
+int CGcpHullRejection::Reject(
+                              const CMatrix<float> &refImage,
+                              const SImageMetadata &refMetadata,
+                              const CMatrix<float> &inImage,
+                              const SImageMetadata &inMetadata,
+                              float nullValue,
+                              unsigned long hullTrimAmount,
+                              CVector<SChipCorrelationResult> *gcps
+                              )
+{
+    long rejectionCount = 0;
+
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Hull trim size is '" + toString(hullTrimAmount) + "'");
+
+    if (InnerReject(refImage, refMetadata, inImage, inMetadata, nullValue, hullTrimAmount, gcps, rejectionCount) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from InnerReject()");
+        return 1;
+    }
+
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Rejected a total of '" + toString(rejectionCount) + "' GCP on the outer hull edges");
+
+    return 0;
+}
+
 int CGcpHullRejection::Reject(
                               const CVector<CMatrix<float> > &refImage,
                               const SImageMetadata &refMetadata,
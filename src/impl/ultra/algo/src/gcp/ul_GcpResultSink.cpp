@@ -0,0 +1,348 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ul_GcpResultSink.h"
+
+#include <stdint.h>
+#include <ul_Logger.h>
+#include <ul_Utility.h>
+
+namespace ultra
+{
+
+std::string EGcpResultFormat::formatTypeToStr(EGcpResultFormat::EFormatType type)
+{
+    switch (type)
+    {
+    case EGcpResultFormat::RESULT_FORMAT_TEXT:return "TEXT";
+    case EGcpResultFormat::RESULT_FORMAT_BINARY:return "BINARY";
+    case EGcpResultFormat::RESULT_FORMAT_CSV:return "CSV";
+    case EGcpResultFormat::RESULT_FORMAT_TYPE_COUNT:break;
+    }
+    return "";
+}
+
+EGcpResultFormat::EFormatType EGcpResultFormat::strToFormatType(const std::string &type)
+{
+    std::string s = toUpper(type);
+
+    if (s == "TEXT")return EGcpResultFormat::RESULT_FORMAT_TEXT;
+    if (s == "BINARY")return EGcpResultFormat::RESULT_FORMAT_BINARY;
+    if (s == "CSV")return EGcpResultFormat::RESULT_FORMAT_CSV;
+
+    return EGcpResultFormat::RESULT_FORMAT_TYPE_COUNT;
+}
+
+std::string EGcpResultFormat::getFileExtension(EGcpResultFormat::EFormatType type)
+{
+    switch (type)
+    {
+    case EGcpResultFormat::RESULT_FORMAT_TEXT:return "res";
+    case EGcpResultFormat::RESULT_FORMAT_BINARY:return "gcp";
+    case EGcpResultFormat::RESULT_FORMAT_CSV:return "csv";
+    case EGcpResultFormat::RESULT_FORMAT_TYPE_COUNT:break;
+    }
+    return "";
+}
+
+SGcpResultHeader::SGcpResultHeader()
+{
+    totalResidual = SPair<double>(0, 0);
+}
+
+SGcpResultHeader::~SGcpResultHeader()
+{
+}
+
+std::string SGcpResultHeader::getHistogramBinName(unsigned long bin)
+{
+    switch (bin)
+    {
+    case 0:return "Green";
+    case 1:return "Teal";
+    case 2:return "Blue";
+    case 3:return "Yellow";
+    case 4:return "Red";
+    }
+    return "";
+}
+
+SGcpRecord::SGcpRecord()
+{
+    id = 0;
+    line = 0;
+    sample = 0;
+    mapX = 0;
+    mapY = 0;
+    corrCoefficient = 0;
+    residualY = 0;
+    residualX = 0;
+    isGood = false;
+}
+
+SGcpRecord::~SGcpRecord()
+{
+}
+
+IGcpResultSink::~IGcpResultSink()
+{
+}
+
+std::unique_ptr<IGcpResultSink> IGcpResultSink::Create(EGcpResultFormat::EFormatType type, const std::string &path)
+{
+    switch (type)
+    {
+    case EGcpResultFormat::RESULT_FORMAT_TEXT:
+        return std::unique_ptr<IGcpResultSink>(new CTextGcpResultSink(path));
+    case EGcpResultFormat::RESULT_FORMAT_BINARY:
+        return std::unique_ptr<IGcpResultSink>(new CBinaryGcpResultSink(path));
+    case EGcpResultFormat::RESULT_FORMAT_CSV:
+        return std::unique_ptr<IGcpResultSink>(new CCsvGcpResultSink(path));
+    case EGcpResultFormat::RESULT_FORMAT_TYPE_COUNT:
+        break;
+    }
+    return std::unique_ptr<IGcpResultSink>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CTextGcpResultSink::CTextGcpResultSink(const std::string &path)
+{
+    m_path = path;
+}
+
+CTextGcpResultSink::~CTextGcpResultSink()
+{
+}
+
+int CTextGcpResultSink::Begin(const SGcpResultHeader &header)
+{
+    if (header.geoTransform.size() != 6)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Geo-affine transform must have 6 values");
+        return 1;
+    }
+
+    if (m_writer.Open(m_path) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBufferedWriter::Open()");
+        return 1;
+    }
+
+    int ret = 0;
+    ret |= m_writer.Write("IMAGE_GVERIFY\n\n");
+    ret |= m_writer.Write("Total residuals\n");
+    ret |= m_writer.Printf("\tResidual x = %lf\n", header.totalResidual.x);
+    ret |= m_writer.Printf("\tResidual y = %lf\n", header.totalResidual.y);
+
+    ret |= m_writer.Write("Residual histogram\n");
+    for (unsigned long x = 0; x < header.residualHistogram.size(); x++)
+    {
+        std::string name = SGcpResultHeader::getHistogramBinName(x);
+        if (name != "")
+            ret |= m_writer.Printf("\t%s %u\n", name.c_str(), header.residualHistogram[x]);
+    }
+
+    const double *dp = header.geoTransform.getDataPointer();
+    ret |= m_writer.Write("\n");
+    ret |= m_writer.Printf("Geo-Affine-Transform [%4.4lf, %4.4lf, %4.4lf, %4.4lf, %4.4lf, %4.4lf]\n", dp[0], dp[1], dp[2], dp[3], dp[4], dp[5]);
+    ret |= m_writer.Printf("Proj4-Str [%s]\n", header.proj4Str.c_str());
+
+    ret |= m_writer.Write("-----------------------------\n");
+    ret |= m_writer.Write("-------------GCPs------------\n");
+    ret |= m_writer.Write("-----------------------------\n");
+    ret |= m_writer.Write("Point_ID    Line      Sample         Map-X      Map-Y     Corelation  Residual Residual Outlier \n");
+    ret |= m_writer.Write("         (Ref image) (Ref image) (Ref image) (Ref image)  Coefficient  In y     In x     Flag   \n");
+    ret |= m_writer.Write("                                                                                        (0=bad  \n");
+    ret |= m_writer.Printf("                                                                    (%s) (%s)   1=OK)  \n", header.units.c_str(), header.units.c_str());
+    ret |= m_writer.Write("BEGIN\n");
+    if (ret != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to write the header of '" + m_path + "'");
+        return 1;
+    }
+    return 0;
+}
+
+int CTextGcpResultSink::Write(const SGcpRecord &record)
+{
+    if (m_writer.Printf("%04ld %s\t%05ld\t\t%05ld\t\t%4.4lf\t\t%4.4lf\t\t%4.4lf\t\t%4.4lf\t\t%4.4lf\t\t%d\n",
+                        record.id, record.chipType.c_str(), record.line, record.sample,
+                        record.mapX, record.mapY, record.corrCoefficient,
+                        record.residualY, record.residualX, record.isGood ? 1 : 0) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBufferedWriter::Printf()");
+        return 1;
+    }
+    return 0;
+}
+
+int CTextGcpResultSink::End()
+{
+    if (m_writer.Close() != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBufferedWriter::Close()");
+        return 1;
+    }
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char CBinaryGcpResultSink::MAGIC[4] = {'U', 'G', 'C', 'P'};
+const unsigned int CBinaryGcpResultSink::VERSION = 1;
+
+CBinaryGcpResultSink::CBinaryGcpResultSink(const std::string &path)
+{
+    m_path = path;
+    m_countOffset = 0;
+    m_count = 0;
+}
+
+CBinaryGcpResultSink::~CBinaryGcpResultSink()
+{
+}
+
+int CBinaryGcpResultSink::WriteString(const std::string &str)
+{
+    uint32_t length = (uint32_t) str.size();
+    if (m_writer.Write(&length, sizeof (length)) != 0 ||
+        m_writer.Write(str) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBufferedWriter::Write()");
+        return 1;
+    }
+    return 0;
+}
+
+int CBinaryGcpResultSink::Begin(const SGcpResultHeader &header)
+{
+    if (m_writer.Open(m_path) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBufferedWriter::Open()");
+        return 1;
+    }
+
+    m_count = 0;
+    uint32_t version = VERSION;
+    uint64_t count = 0;
+    double totals[2] = {header.totalResidual.x, header.totalResidual.y};
+    uint32_t histogramSize = (uint32_t) header.residualHistogram.size();
+    uint32_t transformSize = (uint32_t) header.geoTransform.size();
+
+    int ret = 0;
+    ret |= m_writer.Write(MAGIC, sizeof (MAGIC));
+    ret |= m_writer.Write(&version, sizeof (version));
+    m_countOffset = m_writer.getPosition();
+    ret |= m_writer.Write(&count, sizeof (count));
+    ret |= m_writer.Write(totals, sizeof (totals));
+    ret |= m_writer.Write(&histogramSize, sizeof (histogramSize));
+    for (unsigned long x = 0; x < histogramSize; x++)
+    {
+        uint32_t bin = header.residualHistogram[x];
+        ret |= m_writer.Write(&bin, sizeof (bin));
+    }
+    ret |= m_writer.Write(&transformSize, sizeof (transformSize));
+    if (transformSize > 0)
+        ret |= m_writer.Write(header.geoTransform.getDataPointer(), transformSize * sizeof (double));
+    ret |= WriteString(header.proj4Str);
+    ret |= WriteString(header.units);
+    if (ret != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to write the header of '" + m_path + "'");
+        return 1;
+    }
+    return 0;
+}
+
+int CBinaryGcpResultSink::Write(const SGcpRecord &record)
+{
+    int64_t integers[3] = {record.id, record.line, record.sample};
+    double values[5] = {record.mapX, record.mapY, record.corrCoefficient, record.residualY, record.residualX};
+    uint8_t good = record.isGood ? 1 : 0;
+    uint8_t typeLength = (uint8_t) getMIN<unsigned long>(record.chipType.size(), 255);
+
+    if (m_writer.Write(integers, sizeof (integers)) != 0 ||
+        m_writer.Write(values, sizeof (values)) != 0 ||
+        m_writer.Write(&good, sizeof (good)) != 0 ||
+        m_writer.Write(&typeLength, sizeof (typeLength)) != 0 ||
+        m_writer.Write(record.chipType.data(), typeLength) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBufferedWriter::Write()");
+        return 1;
+    }
+    m_count++;
+    return 0;
+}
+
+int CBinaryGcpResultSink::End()
+{
+    uint64_t count = m_count;
+    if (m_writer.Patch(m_countOffset, &count, sizeof (count)) != 0 ||
+        m_writer.Close() != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to finish '" + m_path + "'");
+        return 1;
+    }
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CCsvGcpResultSink::CCsvGcpResultSink(const std::string &path)
+{
+    m_path = path;
+}
+
+CCsvGcpResultSink::~CCsvGcpResultSink()
+{
+}
+
+int CCsvGcpResultSink::Begin(const SGcpResultHeader &)
+{
+    if (m_writer.Open(m_path) != 0 ||
+        m_writer.Write("point_id,chip_type,line,sample,map_x,map_y,correlation_coefficient,residual_y,residual_x,outlier_flag\n") != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to write the header of '" + m_path + "'");
+        return 1;
+    }
+    return 0;
+}
+
+int CCsvGcpResultSink::Write(const SGcpRecord &record)
+{
+    if (m_writer.Printf("%ld,%s,%ld,%ld,%.17g,%.17g,%.17g,%.17g,%.17g,%d\n",
+                        record.id, record.chipType.c_str(), record.line, record.sample,
+                        record.mapX, record.mapY, record.corrCoefficient,
+                        record.residualY, record.residualX, record.isGood ? 1 : 0) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBufferedWriter::Printf()");
+        return 1;
+    }
+    return 0;
+}
+
+int CCsvGcpResultSink::End()
+{
+    if (m_writer.Close() != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBufferedWriter::Close()");
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace ultra
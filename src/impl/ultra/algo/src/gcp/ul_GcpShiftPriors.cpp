@@ -0,0 +1,192 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "ul_GcpShiftPriors.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ultra
+{
+
+const unsigned long CGcpShiftPriors::MIN_NEIGHBOURS = 3;
+const double CGcpShiftPriors::SPREAD_DEVIATIONS = 3;
+const unsigned long CGcpShiftPriors::MARGIN_PIXELS = 2;
+
+namespace
+{
+
+double getMedian(std::vector<double> &values)
+{
+    std::vector<double>::iterator mid = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), mid, values.end());
+    return *mid;
+}
+
+} // namespace
+
+CGcpShiftPriors::CGcpShiftPriors()
+{
+    m_radius = 0;
+}
+
+CGcpShiftPriors::~CGcpShiftPriors()
+{
+}
+
+void CGcpShiftPriors::Clear()
+{
+    m_locations.clear();
+    m_shifts.clear();
+    m_cells.clear();
+    m_gridOrigin = 0;
+    m_gridSize = SSize(0, 0);
+    m_radius = 0;
+}
+
+bool CGcpShiftPriors::isEmpty() const
+{
+    return m_locations.empty();
+}
+
+int CGcpShiftPriors::Build(const CVector<SChipCorrelationResult> &results, const SPair<double> &gsd,
+                           const SPair<double> &globalShift, double radius, double scale)
+{
+    Clear();
+    if (radius <= 0 || !std::isfinite(radius))
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Shift prior radius must be larger than zero");
+        return 1;
+    }
+    m_radius = radius;
+
+    SPair<double> minLocation;
+    SPair<double> maxLocation;
+    for (unsigned long t = 0; t < results.size(); t++)
+    {
+        if (!results[t].isGoodResult())
+            continue;
+
+        const SPair<double> &location = results[t].chip.midCoordinate;
+        if (!std::isfinite(location.r) || !std::isfinite(location.c))
+            continue;
+
+        SPair<double> residual = (results[t].newMidCoordinate - location) / gsd;
+        if (m_locations.empty())
+        {
+            minLocation = location;
+            maxLocation = location;
+        }
+        minLocation.r = getMIN(minLocation.r, location.r);
+        minLocation.c = getMIN(minLocation.c, location.c);
+        maxLocation.r = getMAX(maxLocation.r, location.r);
+        maxLocation.c = getMAX(maxLocation.c, location.c);
+        m_locations.push_back(location);
+        m_shifts.push_back((residual - globalShift) * scale);
+    }
+
+    if (m_locations.empty())
+        return 0;
+
+    m_gridOrigin = minLocation;
+    m_gridSize.row = (unsigned long) std::floor((maxLocation.r - minLocation.r) / m_radius) + 1;
+    m_gridSize.col = (unsigned long) std::floor((maxLocation.c - minLocation.c) / m_radius) + 1;
+    m_cells.resize(m_gridSize.getProduct());
+    for (unsigned long t = 0; t < m_locations.size(); t++)
+    {
+        long row = -1;
+        long col = -1;
+        if (!getCell(m_locations[t], row, col) ||
+            row < 0 || col < 0 || row >= (long) m_gridSize.row || col >= (long) m_gridSize.col)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "GCP location outside of the shift prior grid, skipping it");
+            continue;
+        }
+        m_cells[row * m_gridSize.col + col].push_back(t);
+    }
+
+    return 0;
+}
+
+bool CGcpShiftPriors::getCell(const SPair<double> &mapCoordinate, long &row, long &col) const
+{
+    if (!std::isfinite(mapCoordinate.r) || !std::isfinite(mapCoordinate.c))
+        return false;
+    row = (long) std::floor((mapCoordinate.r - m_gridOrigin.r) / m_radius);
+    col = (long) std::floor((mapCoordinate.c - m_gridOrigin.c) / m_radius);
+    // the neighbouring cells of a location further out than this are all outside of the grid
+    return row >= -1 && col >= -1 && row <= (long) m_gridSize.row && col <= (long) m_gridSize.col;
+}
+
+bool CGcpShiftPriors::getPrior(const SPair<double> &mapCoordinate, SPair<double> &shift, double &spread) const
+{
+    long row;
+    long col;
+    if (m_locations.empty() || !getCell(mapCoordinate, row, col))
+        return false;
+
+    double radiusSq = m_radius * m_radius;
+    std::vector<double> shiftsR;
+    std::vector<double> shiftsC;
+    for (long r = getMAX(row - 1, 0L); r <= getMIN(row + 1, (long) m_gridSize.row - 1); r++)
+    {
+        for (long c = getMAX(col - 1, 0L); c <= getMIN(col + 1, (long) m_gridSize.col - 1); c++)
+        {
+            const std::vector<unsigned long> &cell = m_cells[r * m_gridSize.col + c];
+            for (unsigned long t = 0; t < cell.size(); t++)
+            {
+                SPair<double> d = m_locations[cell[t]] - mapCoordinate;
+                if (d.r * d.r + d.c * d.c > radiusSq)
+                    continue;
+                shiftsR.push_back(m_shifts[cell[t]].r);
+                shiftsC.push_back(m_shifts[cell[t]].c);
+            }
+        }
+    }
+
+    if (shiftsR.size() < MIN_NEIGHBOURS)
+        return false;
+
+    SPair<double> median(getMedian(shiftsR), getMedian(shiftsC));
+    for (unsigned long t = 0; t < shiftsR.size(); t++)
+    {
+        shiftsR[t] = getAbs(shiftsR[t] - median.r);
+        shiftsC[t] = getAbs(shiftsC[t] - median.c);
+    }
+    spread = SPREAD_DEVIATIONS * getMAX(getMedian(shiftsR), getMedian(shiftsC));
+    // whole pixels, like the global shift, so the pyramid resampling error is not moved around
+    shift = median.roundValues();
+    return true;
+}
+
+bool CGcpShiftPriors::Apply(CChip<float> &chip, unsigned long maxSearchWindowSize) const
+{
+    SPair<double> shift;
+    double spread;
+    if (!getPrior(chip.midCoordinate, shift, spread))
+        return false;
+
+    // the search range is split evenly around the prior
+    unsigned long searchWindowSize = 2 * ((unsigned long) std::ceil(spread) + MARGIN_PIXELS);
+    if (searchWindowSize > maxSearchWindowSize)
+        searchWindowSize = maxSearchWindowSize;
+    chip.searchShiftPrior = shift;
+    chip.searchWindowSize = searchWindowSize;
+    return true;
+}
+
+} // namespace ultra
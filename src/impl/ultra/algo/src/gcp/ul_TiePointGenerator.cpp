@@ -19,12 +19,16 @@
 #include "ul_Utility.h"
 #include "ul_File.h"
 #include "ul_ImageLoader.h"
+#include "ul_UltraThreadFixedPool.h"
+#include "ul_GcpDuplicateFilter.h"
+#include "ul_Profiler.h"
 
 namespace ultra
 {
 
 const int CTiePointGenerator::REF_IMG_INDEX = 0;
 const int CTiePointGenerator::INPUT_IMG_INDEX = 1;
+const unsigned long CTiePointGenerator::CHIP_QUEUE_DEPTH_PER_THREAD = 16;
 
 CTiePointGenerator::CTiePointGenerator(const CTiePointGenerator::SContext *context) :
 ITiePointGenerator()
@@ -37,48 +41,44 @@ CTiePointGenerator::~CTiePointGenerator()
 
 }
 
-int CTiePointGenerator::TranslateChipCoordinatesToMap(CVector<CChip<float> > &chipVector)
+void CTiePointGenerator::TranslateChipCoordinatesToMap(CChip<float> &chip)
 {
-    unsigned long size = chipVector.size();
-    for (unsigned long x = 0; x < size; x++)
+    chip.midCoordinate *= m_context.referenceSceneMetadata.gsd;
+    chip.midCoordinate += m_context.referenceSceneMetadata.origin;
+    for (unsigned long p = 0; p < 4; p++)
     {
-        chipVector[x].midCoordinate *= m_context.referenceSceneMetadata.gsd;
-        chipVector[x].midCoordinate += m_context.referenceSceneMetadata.origin;
-        for (unsigned long p = 0; p < 4; p++)
-        {
-            chipVector[x].boundingCoordinate[p] *= m_context.referenceSceneMetadata.gsd;
-            chipVector[x].boundingCoordinate[p] += m_context.referenceSceneMetadata.origin;
-        }
+        chip.boundingCoordinate[p] *= m_context.referenceSceneMetadata.gsd;
+        chip.boundingCoordinate[p] += m_context.referenceSceneMetadata.origin;
     }
-
-    return 0;
 }
 
 int CTiePointGenerator::GenerateChips(const std::string pathToImageWhereChipsAreLoadedFrom,
-                                      CMatrix<float> &image, CVector<CChip<float> > &chipVector,
+                                      CMatrix<float> &image, const CChipsGen<float>::ChipSink &sink,
                                       EChips::EChipType chipType)
 {
-    m_fp_generateChips = nullptr;
+    ULTRA_SCOPED_TIMER("GenerateChips." + EChips::chipGenTypeToStr(chipType));
+    // local, the generators may run concurrently
+    int (CTiePointGenerator::*fp_generateChips)(CMatrix<float> &, const CChipsGen<float>::ChipSink &) = nullptr;
     switch (chipType)
     {
     case EChips::CHIP_GEN_SOBEL:
-        m_fp_generateChips = &CTiePointGenerator::GenerateSobelChips;
+        fp_generateChips = &CTiePointGenerator::GenerateSobelChips;
         break;
     case EChips::CHIP_GEN_EVEN:
-        m_fp_generateChips = &CTiePointGenerator::GenerateEvenChips;
+        fp_generateChips = &CTiePointGenerator::GenerateEvenChips;
         break;
     case EChips::CHIP_GEN_HARRIS:
-        m_fp_generateChips = &CTiePointGenerator::GenerateHarrisChips;
+        fp_generateChips = &CTiePointGenerator::GenerateHarrisChips;
         break;
     case EChips::CHIP_GEN_FIXED_LOCATION:
-        m_fp_generateChips = &CTiePointGenerator::GenerateFixedLocationChips;
+        fp_generateChips = &CTiePointGenerator::GenerateFixedLocationChips;
         break;
     default:
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid chip generations system system");
         return 1;
     }
 
-    if (m_fp_generateChips == nullptr)
+    if (fp_generateChips == nullptr)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid chip generation function pointer");
         return 1;
@@ -89,40 +89,103 @@ int CTiePointGenerator::GenerateChips(const std::string pathToImageWhereChipsAre
     if (chipSizeBuffered > imageSize.col ||
         chipSizeBuffered > imageSize.row)
     {
-        chipVector.clear();
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "Image size is too small to extract chips");
         return 0;
     }
 
-    if ((this->*m_fp_generateChips)(image, chipVector) != 0)
+    // the sink is given the chips in pixel coordinates, see TranslateChipCoordinatesToMap()
+    if ((this->*fp_generateChips)(image, sink) != 0)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from m_fp_generateChips()");
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from fp_generateChips()");
         return 1;
     }
 
-    if (TranslateChipCoordinatesToMap(chipVector) != 0)
+    return 0;
+}
+
+int CTiePointGenerator::ProduceChips(CBoundedQueue<CChip<float> > &chipQueue,
+                                     std::vector<unsigned long> &chipCounts)
+{
+    unsigned long generatorCount = m_context.innerContext->chipGeneratorMethods.size();
+    chipCounts.assign(generatorCount, 0);
+
+    // the generators run concurrently and queue every chip the moment it is generated, the queued
+    // ID interleaves the generator with its own chip count so the results can be put back in
+    // generator order afterwards, whatever the thread timing was
+    std::vector<int> generatorErrors(generatorCount, 0);
+    std::vector<unsigned long> priorCounts(generatorCount, 0);
+    std::vector<unsigned long> searchWindowSums(generatorCount, 0);
+    const CGcpShiftPriors *shiftPriors = m_context.innerContext->shiftPriors;
+    std::function<void(unsigned long, unsigned long) > generate = [&](unsigned long start, unsigned long end)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from TranslateChipCoordinatesToMap()");
+        for (unsigned long t = start; t < end; t++)
+        {
+            CChipsGen<float>::ChipSink queueSink = [&, t](const CChip<float> &chip)->int
+            {
+                CChip<float> queuedChip = chip;
+                TranslateChipCoordinatesToMap(queuedChip);
+                if (shiftPriors != nullptr && shiftPriors->Apply(queuedChip, m_context.innerContext->searchWindowSize))
+                {
+                    priorCounts[t]++;
+                    searchWindowSums[t] += queuedChip.searchWindowSize;
+                }
+
+                queuedChip.chipId = chipCounts[t]++ * generatorCount + t;
+                return chipQueue.Push(std::move(queuedChip));
+            };
+            generatorErrors[t] = GenerateChips(m_context.innerContext->referenceScene.pathToImage,
+                                               m_context.images[REF_IMG_INDEX], queueSink,
+                                               m_context.innerContext->chipGeneratorMethods[t]);
+        }
+    };
+    if (CUltraThreadFixedPool::RunBands(generatorCount, generatorCount, generate) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunBands()");
         return 1;
     }
 
+    for (unsigned long t = 0; t < generatorCount; t++)
+    {
+        if (generatorErrors[t] != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GenerateChips()");
+            return 1;
+        }
+    }
+
+    if (shiftPriors != nullptr)
+    {
+        unsigned long chipCount = 0;
+        unsigned long priorCount = 0;
+        unsigned long searchWindowSum = 0;
+        for (unsigned long t = 0; t < generatorCount; t++)
+        {
+            chipCount += chipCounts[t];
+            priorCount += priorCounts[t];
+            searchWindowSum += searchWindowSums[t];
+        }
+        double averageSearchWindowSize = priorCount > 0 ? (double) searchWindowSum / priorCount : 0;
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Searched '" + toString(priorCount) + "' of '" + toString(chipCount) + "' chips "
+                                    "around a local shift prior, with an average search range of '" + toString(averageSearchWindowSize) + "' "
+                                    "instead of '" + toString(m_context.innerContext->searchWindowSize) + "' pixels");
+    }
+
     return 0;
 }
 
-int CTiePointGenerator::StartCorrelation(
-                                         CVector<CChip<float> > &chipVector,
-                                         CVector<SChipCorrelationResult> &result
-                                         )
+int CTiePointGenerator::StartCorrelation(CVector<SChipCorrelationResult> &result)
 {
+    ULTRA_SCOPED_TIMER("Correlation");
     SSize chipSize = m_context.innerContext->chipSizeMinimum;
     SSize searchWindowSize = chipSize;
     if (m_context.innerContext->typeOfChipCorrelationTechnique != ECorrelationType::PHASE)
         searchWindowSize += m_context.innerContext->searchWindowSize;
 
-    std::string infoMessage = "Correlating '" + toString(chipVector.size()) + "' chips "
+    std::string infoMessage = "Correlating chips "
         "of size '" + toString(chipSize.row) + "x" + toString(chipSize.col) + "' "
         "on a search window of size '" + toString(searchWindowSize.row) + "x" + toString(searchWindowSize.col) + "' "
-        "using a '" + CCorrelationHelper::typeToStr(m_context.innerContext->typeOfChipCorrelationTechnique) + "' correlator";
+        "using a '" + CCorrelationHelper::typeToStr(m_context.innerContext->typeOfChipCorrelationTechnique) + "' correlator "
+        "while they are generated";
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, infoMessage);
 
     CMatrix<SPair<double> > worldMatrix;
@@ -139,94 +202,76 @@ int CTiePointGenerator::StartCorrelation(
         return 1;
     }
 
-    if (Correlate(worldMatrix, chipVector, result) != 0)
+    // the queue must outlive the correlation threads, and must be closed before they are joined
+    CBoundedQueue<CChip<float> > chipQueue(m_context.innerContext->threadCount * CHIP_QUEUE_DEPTH_PER_THREAD);
+    std::unique_ptr<CCorrelationHandler> corr;
+    if (StartCorrelationThreads(corr, worldMatrix, chipQueue) != 0)
+    {
+        chipQueue.Close();
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from StartCorrelationThreads()");
+        return 1;
+    }
+
+    std::vector<unsigned long> chipCounts;
+    int produceResult = ProduceChips(chipQueue, chipCounts);
+    chipQueue.Close();
+    if (produceResult != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ProduceChips()");
+        return 1;
+    }
+
+    unsigned long generatedCount = 0;
+    for (unsigned long t = 0; t < chipCounts.size(); t++)
+        generatedCount += chipCounts[t];
+    if (generatedCount == 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "No chips were generated, nothing to correlate");
+    }
+
+    // GetResults() blocks until the correlation threads drained the queue
+    if (corr->GetResults(result) != 0)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Correlate()");
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GetResults()");
         return 1;
     }
 
+    CProfiler::getInstance()->AddCounter(CProfiler::COUNTER_CHIPS_ATTEMPTED, result.size());
+
+    if (ReorderResults(result, chipCounts) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ReorderResults()");
+        return 1;
+    }
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Correlated '" + toString(result.size()) + "' chips");
+
     return 0;
 }
 
-void CTiePointGenerator::RemoveDuplicateGcps(CVector<SChipCorrelationResult> &finalResult)
+int CTiePointGenerator::RemoveDuplicateGcps(CVector<SChipCorrelationResult> &finalResult)
 {
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Removing duplicate GCPs");
-    unsigned long resultSize = finalResult.size();
-    long counter = 0;
-    if (resultSize > 0)
+    unsigned long counter = 0;
+    if (CGcpDuplicateFilter::RemoveDuplicates(finalResult, m_context.innerContext->duplicateGcpTolerance, counter) != 0)
     {
-        SChipCorrelationResult *dp = finalResult.getDataPointer();
-        for (unsigned long t = 0; t < resultSize - 1; t++)
-        {
-            if (dp[t].correlationResultIsGood)
-            {
-                unsigned long start = t + 1;
-                for (unsigned long i = start; i < resultSize; i++)
-                {
-                    if (dp[i].correlationResultIsGood &&
-                        dp[t].chip.midCoordinate == dp[i].chip.midCoordinate)
-                    {
-                        dp[i].correlationResultIsGood = false;
-                        counter++;
-                    }
-                }
-            }
-        }
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CGcpDuplicateFilter::RemoveDuplicates()");
+        return 1;
     }
 
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Removed '" + toString(counter) + "' duplicate GCPs");
+    return 0;
 }
 
 int CTiePointGenerator::MainLoop(CVector<SChipCorrelationResult> &finalResult)
 {
-    CVector<CVector<CChip<float> > > chipVectorTemp;
-    CVector<CChip<float> > chipVector;
-
-    unsigned long chipLoop;
-    unsigned long copyLoop;
-    unsigned long totalChipsSize;
-
-    chipVectorTemp.resize(m_context.innerContext->chipGeneratorMethods.size());
-
     if (LoadTwoImages() != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadTwoImages()");
         return 1;
     }
 
-    totalChipsSize = 0;
-    for (chipLoop = 0; chipLoop < chipVectorTemp.size(); chipLoop++)
-    {
-        if (GenerateChips(m_context.innerContext->referenceScene.pathToImage,
-                          m_context.images[REF_IMG_INDEX], chipVectorTemp[chipLoop],
-                          m_context.innerContext->chipGeneratorMethods[chipLoop]) != 0)
-        {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GenerateChips()");
-            return 1;
-        }
-        totalChipsSize += chipVectorTemp[chipLoop].size();
-    }
-
-    // no chips found so we can just skip the rest
-    if (totalChipsSize == 0)
-    {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "No chips found, skipping correlation");
-    }
-
-    chipVector.resize(totalChipsSize);
-
-    totalChipsSize = 0;
-    for (chipLoop = 0; chipLoop < chipVectorTemp.size(); chipLoop++)
-    {
-        for (copyLoop = 0; copyLoop < chipVectorTemp[chipLoop].size(); copyLoop++)
-        {
-            chipVector[totalChipsSize] = chipVectorTemp[chipLoop][copyLoop];
-            chipVector[totalChipsSize].chipId = totalChipsSize;
-            totalChipsSize++;
-        }
-    }
-
-    if (StartCorrelation(chipVector, finalResult) != 0)
+    // the chips are correlated while the generators are still running
+    if (StartCorrelation(finalResult) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from StartCorrelation()");
         return 1;
@@ -238,7 +283,11 @@ int CTiePointGenerator::MainLoop(CVector<SChipCorrelationResult> &finalResult)
         return 0;
     }
 
-    RemoveDuplicateGcps(finalResult);
+    if (RemoveDuplicateGcps(finalResult) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RemoveDuplicateGcps()");
+        return 1;
+    }
 
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Obtained '" + toString(finalResult.size()) + "' chips");
 
@@ -265,7 +314,7 @@ int CTiePointGenerator::Calculate(CVector<SChipCorrelationResult> &result, bool
         return 1;
     }
 
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "All input data and parameters seem OK");
+    ULTRA_LOG(CLogger::LOG_DEBUG, "All input data and parameters seem OK");
 
     if (MainLoop(result) != 0)
     {
@@ -279,6 +328,14 @@ int CTiePointGenerator::Calculate(CVector<SChipCorrelationResult> &result, bool
         return 1;
     }
 
+    long long accepted = 0;
+    for (unsigned long t = 0; t < result.size(); t++)
+    {
+        if (result[t].isGoodResult())
+            accepted++;
+    }
+    CProfiler::getInstance()->AddCounter(CProfiler::COUNTER_CHIPS_ACCEPTED, accepted);
+
     return 0;
 }
 
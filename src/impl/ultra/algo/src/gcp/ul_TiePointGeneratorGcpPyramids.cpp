@@ -264,7 +264,7 @@ int CTiePointGeneratorGcpPyramids::PyramidLoop(const std::string &imagePath,
             {
                 for (unsigned long a = 0; a < pyramids.size(); a++)
                     pyramids[a].tiePointGood[i] = false;
-                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Out of bounds, going to skip this chip");
+                ULTRA_LOG(CLogger::LOG_DEBUG, "Out of bounds, going to skip this chip");
                 continue;
             }
         }
@@ -281,16 +281,12 @@ int CTiePointGeneratorGcpPyramids::PyramidLoop(const std::string &imagePath,
 
 void CTiePointGeneratorGcpPyramids::cleanUp(CVector<CCorrelationThread *> &correlationThreads, CAtomicBool &runningVar)
 {
+    // the threads are either not started yet or their pool has been joined, so no polling is needed
     runningVar.set(false);
     for (unsigned long t = 0; t < correlationThreads.size(); t++)
     {
         if (correlationThreads[t] != nullptr)
         {
-            while (CUltraThread::getInstance()->isBusy(correlationThreads[t]))
-            {
-                sleep(1);
-            }
-
             delete correlationThreads[t];
             correlationThreads[t] = nullptr;
         }
@@ -306,14 +302,14 @@ int CTiePointGeneratorGcpPyramids::StartThreads(CVector<SPyramid> &pyramids,
     CThreadLock sharedLock;
     CAtomicLong sharedCounter;
     CAtomicLong sharedProcessingPercentage;
-    CAtomicLong threadDoneCount;
+    CCountDownLatch doneLatch;
     CAtomicBool runningVar;
     CVector<CCorrelationThread *> correlationThreads;
     for (long t = ((long) pyramids.size()) - 1; t >= 0; t--)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Starting pyramid correlation level (" + toString(pyramids.size() - t) + "/" + toString(pyramids.size()) + ")");
         sharedCounter.set(0);
-        threadDoneCount.set(0);
+        doneLatch.reset(m_context->m_threadCount);
         sharedProcessingPercentage.set(-1);
         runningVar.set(true);
         correlationThreads.resize(m_context->m_threadCount);
@@ -331,7 +327,7 @@ int CTiePointGeneratorGcpPyramids::StartThreads(CVector<SPyramid> &pyramids,
                                             &pyramids, &offsets, t,
                                             &m_overallGcpShift, &sharedLock,
                                             &sharedCounter, &sharedProcessingPercentage,
-                                            &threadDoneCount, m_context->m_threadCount,
+                                            &doneLatch,
                                             &runningVar) != 0)
             {
                 cleanUp(correlationThreads, runningVar);
@@ -353,11 +349,11 @@ int CTiePointGeneratorGcpPyramids::StartThreads(CVector<SPyramid> &pyramids,
             pool->start(correlationThreads[a], nullptr);
         }
 
-        if (pool->JoinAllThreads() != 0)
+        if (doneLatch.await() != 0 || pool->JoinAllThreads() != 0)
         {
-            cleanUp(correlationThreads, runningVar);
             delete pool;
             pool = nullptr;
+            cleanUp(correlationThreads, runningVar);
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CUltraThreadPool::JoinAllThreads()");
             return 1;
         }
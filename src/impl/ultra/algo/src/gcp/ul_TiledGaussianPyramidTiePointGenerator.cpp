@@ -20,6 +20,9 @@
 #include "ul_ImageSaver.h"
 #include "ul_ImageOverlap.h"
 #include <ul_PaddImage.h>
+#include <ul_ImagePrefetcher.h>
+#include "ul_GcpDuplicateFilter.h"
+#include <ul_Profiler.h>
 
 namespace ultra
 {
@@ -86,6 +89,7 @@ int CTiledGaussianPyramidTiePointGenerator::ContextOk()
 
 int CTiledGaussianPyramidTiePointGenerator::MinMaxBoxImages(bool &overlapExists)
 {
+    ULTRA_SCOPED_TIMER("MinMaxBoxImages");
     CFile minMaxBox = CFile(m_context->workingFolder, "MinMaxBox");
     if (!minMaxBox.exists())
     {
@@ -134,6 +138,7 @@ int CTiledGaussianPyramidTiePointGenerator::MinMaxBoxImages(bool &overlapExists)
 
 int CTiledGaussianPyramidTiePointGenerator::PaddImagesToSameSize()
 {
+    ULTRA_SCOPED_TIMER("PaddImagesToSameSize");
     int div = 1;
     for (int t = 1; t < m_context->amountOfPyramids; t++)
     {
@@ -336,6 +341,7 @@ int CTiledGaussianPyramidTiePointGenerator::LoadAndSaveTile(const std::string &b
 
 int CTiledGaussianPyramidTiePointGenerator::GenerateTiles()
 {
+    ULTRA_SCOPED_TIMER("GenerateTiles");
     CFile tilesInput = CFile(m_context->workingFolder, "Tiles");
     CFile refTiles = CFile(tilesInput, "Reference");
     CFile inputTiles = CFile(tilesInput, "Input");
@@ -415,29 +421,35 @@ int CTiledGaussianPyramidTiePointGenerator::CleanSubItems(const std::string &pat
 
 int CTiledGaussianPyramidTiePointGenerator::ProcessTile(const CVector<std::string> &scenePaths,
                                                         const std::string &workingFolder,
+                                                        CImagePrefetcher *prefetcher,
                                                         CVector<SChipCorrelationResult> &result)
 {
+    ULTRA_SCOPED_TIMER("ProcessTile");
     CGaussianPyramidTiePointGenerator::SContext gContext;
     gContext.amountOfPyramids = m_context->amountOfPyramids;
     gContext.resampleType = m_context->resampleType;
     gContext.workingFolder = workingFolder;
     gContext.minimumRequiredGcp = 3; //becomes stupid if it is less than 3
+    gContext.localShiftPriors = m_context->localShiftPriors;
 
 
     gContext.tiePointGeneratorContext.setNullValue(m_context->nullValue);
     gContext.tiePointGeneratorContext.setMayContainNullValues(m_context->mayContainNullValues);
     gContext.tiePointGeneratorContext.chipGenerationGridSize = m_context->chipGenerationGridSize;
+    gContext.tiePointGeneratorContext.maxFeaturesPerCell = m_context->maxFeaturesPerCell;
     gContext.tiePointGeneratorContext.chipGeneratorMethods = m_context->chipGeneratorMethods;
     gContext.tiePointGeneratorContext.fixedLocationChips = m_context->fixedLocationChips;
     gContext.tiePointGeneratorContext.fixedLocationChipProj4Str = m_context->fixedLocationChipProj4Str;
 
     gContext.tiePointGeneratorContext.chipSizeMinimum = m_context->chipSize;
     gContext.tiePointGeneratorContext.correlationThreshold = m_context->correlationThreshold;
+    gContext.tiePointGeneratorContext.duplicateGcpTolerance = m_context->duplicateGcpTolerance;
     gContext.tiePointGeneratorContext.inputOffsetShiftInPixels = 0;
     gContext.tiePointGeneratorContext.searchWindowSize = m_context->chipSize / 1.5 + 1;
     gContext.tiePointGeneratorContext.threadCount = m_context->threadCount;
     gContext.tiePointGeneratorContext.typeOfChipCorrelationTechnique = m_context->typeOfChipCorrelationTechnique;
     gContext.tiePointGeneratorContext.outerHullRejectGcps = true;
+    gContext.tiePointGeneratorContext.imagePrefetcher = prefetcher;
 
     gContext.tiePointGeneratorContext.inputScene.pathToImage = scenePaths[INPUT_INDEX];
     gContext.tiePointGeneratorContext.inputScene.bandNumber = m_context->bandNumberToUse;
@@ -463,27 +475,11 @@ int CTiledGaussianPyramidTiePointGenerator::ProcessTile(const CVector<std::strin
 int CTiledGaussianPyramidTiePointGenerator::RemoveDuplicateGcps(CVector<SChipCorrelationResult> &result)
 {
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Removing duplicate GCPs");
-    unsigned long resultSize = result.size();
-    long counter = 0;
-    if (resultSize > 0)
+    unsigned long counter = 0;
+    if (CGcpDuplicateFilter::RemoveDuplicates(result, m_context->duplicateGcpTolerance, counter) != 0)
     {
-        SChipCorrelationResult *dp = result.getDataPointer();
-        for (unsigned long t = 0; t < resultSize - 1; t++)
-        {
-            if (dp[t].correlationResultIsGood)
-            {
-                unsigned long start = t + 1;
-                for (unsigned long i = start; i < resultSize; i++)
-                {
-                    if (dp[i].correlationResultIsGood &&
-                        dp[t].chip.midCoordinate == dp[i].chip.midCoordinate)
-                    {
-                        dp[i].correlationResultIsGood = false;
-                        counter++;
-                    }
-                }
-            }
-        }
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CGcpDuplicateFilter::RemoveDuplicates()");
+        return 1;
     }
 
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Removed '" + toString(counter) + "' duplicate GCPs");
@@ -536,24 +532,38 @@ int CTiledGaussianPyramidTiePointGenerator::GenerateTiePoints(CVector<SChipCorre
         return 1;
     }
 
+    CImagePrefetcher prefetcher;
     CVector<CVector<SChipCorrelationResult> > gcps(m_tilePaths.size());
     for (unsigned long t = 0; t < m_tilePaths.size(); t++)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "<<----------------------------------------------------------->>");
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, " <----TILE LOOP (" + toString(t + 1) + "/" + toString(m_tilePaths.size()) + ")----------------->");
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "<<----------------------------------------------------------->>");
+        // the current tile is only requested here for the first iteration, the
+        // following tile is read while the current tile is being processed
+        for (unsigned long n = t; n < m_tilePaths.size() && n <= t + 1; n++)
+        {
+            if (prefetcher.Request(m_tilePaths[n][INPUT_INDEX], CImagePrefetcher::ALL_BANDS) != 0 ||
+                prefetcher.Request(m_tilePaths[n][REF_INDEX], CImagePrefetcher::ALL_BANDS) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CImagePrefetcher::Request()");
+                return 1;
+            }
+        }
+
         if (CleanSubItems(pyramidPath.getPath()) != 0)
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CleanSubItems()");
             return 1;
         }
 
-        if (ProcessTile(m_tilePaths[t], pyramidPath.getPath(), gcps[t]) != 0)
+        if (ProcessTile(m_tilePaths[t], pyramidPath.getPath(), &prefetcher, gcps[t]) != 0)
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ProcessTile()");
             return 1;
         }
     }
+    prefetcher.LogStatistics();
 
     if (MergeAndCleanOutput(gcps, result) != 0)
     {
@@ -128,7 +128,7 @@ int CPaddImage::InnerPadd(
     outputImage.resize(inputImage.size());
 
     int per = 0;
-    CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing 0%     \r");
+    ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Processing 0%     \r");
     for (unsigned long t = 0; t < inputImage.size(); t++)
     {
         newImageSize = inputImage[t].getSize() + paddSizeBoth;
@@ -146,7 +146,7 @@ int CPaddImage::InnerPadd(
         if (per != (100 * (t + 1)) / inputImage.size())
         {
             per = (100 * (t + 1)) / inputImage.size();
-            CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing " + toString(per) + "%     \r");
+            ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Processing " + toString(per) + "%     \r");
         }
     }
     CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing 100%     ");
@@ -18,6 +18,7 @@
 
 #include <ul_Logger.h>
 #include <ul_Pair.h>
+#include <algorithm>
 
 namespace ultra
 {
@@ -34,97 +35,15 @@ CConvexHull::~CConvexHull()
 
 bool CConvexHull::sortFunction(const SKeyValue<unsigned long, SSize> &l, const SKeyValue<unsigned long, SSize> &r)
 {
-    long temp = (long(l.v.col))-(long(r.v.col));
-    if (temp != 0)
-    {
-        if (temp < 0)
-            return true;
-        return false;
-    }
-
-    if ((long(l.v.row))-(long(r.v.row)) < 0)
-        return true;
-
-    return false;
+    if (l.v.col != r.v.col)
+        return l.v.col < r.v.col;
+    return l.v.row < r.v.row;
 }
 
-int CConvexHull::sortFunctionVoid(const void *ll, const void *rr)
+long CConvexHull::cross(const SSize &o, const SSize &a, const SSize &b)
 {
-    const SKeyValue<unsigned long, SSize> *l = (const SKeyValue<unsigned long, SSize> *)ll;
-    const SKeyValue<unsigned long, SSize> *r = (const SKeyValue<unsigned long, SSize> *)rr;
-
-    long temp = (long(l->v.col))-(long(r->v.col));
-    if (temp < 0) return -1;
-    if (temp > 0) return 1;
-
-
-    temp = (long(l->v.row))-(long(r->v.row));
-    if (temp < 0) return -1;
-    if (temp > 0) return 1;
-
-    return 0;
-}
-
-bool CConvexHull::hullFuncCompFuncTop(float a1, float a2)
-{
-
-    return a2 <= a1;
-}
-
-bool CConvexHull::hullFuncCompFuncBot(float a1, float a2)
-{
-
-    return a2 >= a1;
-}
-
-void CConvexHull::hullFunc(
-                           const CVector<SKeyValue<unsigned long, SSize> > &pts,
-                           std::vector<SKeyValue<unsigned long, SSize> > &topBot,
-                           bool (*func)(float, float)
-                           ) const
-{
-    long size = pts.size();
-    SPair<float> A, B, C;
-    long aIndex = 0;
-    long bIndex = 1;
-    float a1, a2;
-    long x, y;
-    bool canUse;
-    topBot.push_back(pts[0]);
-    int per = 0;
-    for (x = 0; x < size - 2; x++)
-    {
-        canUse = true;
-        A = pts[aIndex].v;
-        B = pts[bIndex].v;
-        a1 = (B.y - A.y) / (B.x - A.x);
-
-        for (y = bIndex + 1; y < size; y++)
-        {
-            C = pts[y].v;
-            a2 = (C.y - B.y) / (C.x - B.x);
-            if (func(a2, a1))
-            {
-                canUse = false;
-                break;
-            }
-        }
-        if (canUse)
-        {
-            aIndex = bIndex;
-            topBot.push_back(pts[bIndex]);
-        }
-        bIndex++;
-
-        if (per != (int) ((x * 100) / size))
-        {
-
-            per = (int) ((x * 100) / size);
-            CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "CConvexHull " + toString(per) + "%     \r");
-        }
-    }
-
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "CConvexHull 100%      ");
+    return ((long) a.col - (long) o.col) * ((long) b.row - (long) o.row) -
+        ((long) a.row - (long) o.row) * ((long) b.col - (long) o.col);
 }
 
 int CConvexHull::GenerateHullPoint(const CVector<SSize> &points, CVector<unsigned long> &hullSequence) const
@@ -135,46 +54,49 @@ int CConvexHull::GenerateHullPoint(const CVector<SSize> &points, CVector<unsigne
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Hull point vector must contain at least 3 points");
         return 1;
     }
-    CVector<SKeyValue<unsigned long, SSize> > pts;
-    std::vector<SKeyValue<unsigned long, SSize> > ptsToSort;
-    ptsToSort.resize(size);
-    pts.resize(size);
 
-    for (unsigned long t = 0; t < size; t++)
+    std::vector<SKeyValue<unsigned long, SSize> > pts;
+    pts.resize(size);
+    for (unsigned long t = 0; t < (unsigned long) size; t++)
     {
-        ptsToSort[t].k = pts[t].k = t;
-        ptsToSort[t].v = pts[t].v = points[t];
-
+        pts[t].k = t;
+        pts[t].v = points[t];
     }
 
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Sorting '" + toString(size) + "' data points");
-    qsort(&ptsToSort[0], size, sizeof (SKeyValue<unsigned long, SSize>), CConvexHull::sortFunctionVoid);
-
-    pts = ptsToSort;
-    ptsToSort.clear();
-
-    std::vector<SKeyValue<unsigned long, SSize> > top;
-    std::vector<SKeyValue<unsigned long, SSize> > bot;
-
-    hullFunc(pts, top, CConvexHull::hullFuncCompFuncBot);
-
-    top.push_back(pts[size - 1]);
-
-    hullFunc(pts, bot, CConvexHull::hullFuncCompFuncTop);
+    ULTRA_LOG(CLogger::LOG_DEBUG, "Sorting '" + toString(size) + "' data points");
+    std::sort(pts.begin(), pts.end(), CConvexHull::sortFunction);
+    pts.erase(std::unique(pts.begin(), pts.end(), [](const SKeyValue<unsigned long, SSize> &l, const SKeyValue<unsigned long, SSize> &r)
+    {
+        return l.v == r.v;
+    }), pts.end());
+    size = pts.size();
+    if (size < 2)
+    {
+        hullSequence.resize(size);
+        for (long t = 0; t < size; t++)
+            hullSequence[t] = pts[t].k;
+        return 0;
+    }
 
-    size = top.size();
-    if (bot.size() >= 2)
+    // lower chain left to right then upper chain right to left, each point is pushed and popped at most once
+    std::vector<unsigned long> chain(2 * size);
+    long k = 0;
+    for (long t = 0; t < size; t++)
+    {
+        while (k >= 2 && cross(pts[chain[k - 2]].v, pts[chain[k - 1]].v, pts[t].v) <= 0)
+            k--;
+        chain[k++] = t;
+    }
+    for (long t = size - 2, lower = k + 1; t >= 0; t--)
     {
-        size += bot.size();
+        while (k >= lower && cross(pts[chain[k - 2]].v, pts[chain[k - 1]].v, pts[t].v) <= 0)
+            k--;
+        chain[k++] = t;
     }
-    hullSequence.resize(size);
-    unsigned long t;
-    for (t = 0; t < top.size(); t++)
-        hullSequence[t] = top[t].k;
-
-    unsigned long s2 = bot.size() - 1;
-    for (unsigned long a = s2; t < size; t++, a--)
-        hullSequence[t] = bot[a].k;
+
+    hullSequence.resize(k);
+    for (long t = 0; t < k; t++)
+        hullSequence[t] = pts[chain[t]].k;
 
     return 0;
 }
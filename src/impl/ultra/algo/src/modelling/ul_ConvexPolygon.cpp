@@ -0,0 +1,153 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ul_ConvexPolygon.h"
+
+#include <cmath>
+#include <ul_Logger.h>
+#include "ul_ConvexHull.h"
+
+namespace ultra
+{
+
+CConvexPolygon::CConvexPolygon()
+{
+
+}
+
+CConvexPolygon::~CConvexPolygon()
+{
+
+}
+
+double CConvexPolygon::cross(const SPair<double> &o, const SPair<double> &a, const SPair<double> &b)
+{
+    return (a.c - o.c) * (b.r - o.r) - (a.r - o.r) * (b.c - o.c);
+}
+
+void CConvexPolygon::ClipHalfPlane(
+                                   const std::vector<SPair<double> > &polygon,
+                                   const SPair<double> &a, const SPair<double> &b,
+                                   double distance,
+                                   std::vector<SPair<double> > &clipped
+                                   )
+{
+    // keeps the part of the polygon at least 'distance' left of the line a->b
+    double length = std::sqrt((b.r - a.r) * (b.r - a.r) + (b.c - a.c) * (b.c - a.c));
+    clipped.clear();
+    if (length == 0)
+    {
+        clipped = polygon;
+        return;
+    }
+
+    unsigned long size = polygon.size();
+    for (unsigned long t = 0; t < size; t++)
+    {
+        const SPair<double> &p = polygon[t];
+        const SPair<double> &q = polygon[(t + 1) % size];
+        double dp = cross(a, b, p) / length - distance;
+        double dq = cross(a, b, q) / length - distance;
+
+        if (dp >= 0)
+            clipped.push_back(p);
+        if ((dp >= 0) != (dq >= 0))
+        {
+            double f = dp / (dp - dq);
+            clipped.push_back(SPair<double>(p.r + f * (q.r - p.r), p.c + f * (q.c - p.c)));
+        }
+    }
+}
+
+int CConvexPolygon::Generate(const CVector<SSize> &points)
+{
+    m_vertices.clear();
+    if (points.size() < 3)
+        return 0;
+
+    CConvexHull hull;
+    CVector<unsigned long> hullSequence;
+    if (hull.GenerateHullPoint(points, hullSequence) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from GenerateHullPoint()");
+        return 1;
+    }
+
+    // the sequence is closed, the last index repeats the first
+    if (hullSequence.size() < 4)
+        return 0;
+
+    m_vertices.resize(hullSequence.size() - 1);
+    for (unsigned long t = 0; t < m_vertices.size(); t++)
+        m_vertices[t] = SPair<double>(points[hullSequence[t]]);
+
+    return 0;
+}
+
+void CConvexPolygon::Erode(double distance)
+{
+    if (isEmpty() || distance <= 0)
+        return;
+
+    // the intersection of the inwards shifted half planes of all the original edges
+    const std::vector<SPair<double> > original = m_vertices;
+    std::vector<SPair<double> > clipped;
+    unsigned long size = original.size();
+    for (unsigned long t = 0; t < size && m_vertices.size() >= 3; t++)
+    {
+        ClipHalfPlane(m_vertices, original[t], original[(t + 1) % size], distance, clipped);
+        m_vertices.swap(clipped);
+    }
+
+    if (m_vertices.size() < 3)
+        m_vertices.clear();
+}
+
+bool CConvexPolygon::contains(const SPair<double> &point) const
+{
+    if (isEmpty())
+        return false;
+
+    unsigned long size = m_vertices.size();
+    for (unsigned long t = 0; t < size; t++)
+    {
+        const SPair<double> &a = m_vertices[t];
+        const SPair<double> &b = m_vertices[(t + 1) % size];
+        double length = std::sqrt((b.r - a.r) * (b.r - a.r) + (b.c - a.c) * (b.c - a.c));
+        // tolerance for the rounding of the clipped vertices
+        if (cross(a, b, point) < -1e-9 * (length + 1))
+            return false;
+    }
+
+    return true;
+}
+
+bool CConvexPolygon::isEmpty() const
+{
+    return m_vertices.size() < 3;
+}
+
+void CConvexPolygon::clear()
+{
+    m_vertices.clear();
+}
+
+const std::vector<SPair<double> > &CConvexPolygon::getVertices() const
+{
+    return m_vertices;
+}
+
+} // namespace ultra
@@ -18,6 +18,7 @@
 
 #include <ul_Proj4Projection.h>
 #include <ul_ImageMetadataObjects.h>
+#include <ul_Profiler.h>
 
 namespace ultra
 {
@@ -126,7 +127,7 @@ int CReproject::innerGetTranslationMap(const SSize &inputImageSize,
             if (per != (r * 100) / inputImageSize.row)
             {
                 per = (r * 100) / inputImageSize.row;
-                CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Projecting " + toString(per) + "%     \r");
+                ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Projecting " + toString(per) + "%     \r");
             }
         }
     }
@@ -169,7 +170,7 @@ int CReproject::innerGetTranslationMap(const SSize &inputImageSize,
             if (per != (r * 100) / outSize.row)
             {
                 per = (r * 100) / outSize.row;
-                CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Generate translation map " + toString(per) + "%     \r");
+                ULTRA_LOG_NO_NEW_LINE(CLogger::LOG_INFO, "Generate translation map " + toString(per) + "%     \r");
             }
         }
     }
@@ -206,6 +207,7 @@ int CReproject::innerProject(const CMatrixArray<T> &inputImages,
 
     for (unsigned long t = 0; t < inputImages.size(); t++)
     {
+        ULTRA_TRACE_SCOPE(CTracer::CATEGORY_RESAMPLE, "ResampleBand");
         if (enableLogger)
         {
             if (CResampler<true>::Resample<T, float>(inputImages[t], outputImages[t], outputTranslationMap, resampleType, &srcNullValue, &trgNullValue) != 0)
@@ -16,7 +16,10 @@
 
 #include "ul_HarrisCornerTransform.h"
 
+#include <limits>
+
 #include "ul_Logger.h"
+#include "ul_UltraThreadFixedPool.h"
 #include "ul_SobelFilterTransform.h"
 
 namespace ultra
@@ -24,7 +27,12 @@ namespace ultra
 
 CHarrisCornerTransform::CHarrisCornerContext::CHarrisCornerContext()
 {
-
+    minHarrisValue = 1;
+    minCornerCount = 0;
+    thresholdStep = 0.1f;
+    maxThresholdSteps = 0;
+    nonMaximumSuppression = false;
+    selectedHarrisValue = 1;
 }
 
 CHarrisCornerTransform::CHarrisCornerContext::~CHarrisCornerContext()
@@ -35,18 +43,11 @@ CHarrisCornerTransform::CHarrisCornerContext::~CHarrisCornerContext()
 CHarrisCornerTransform::CHarrisCornerTransform() :
 CTransform<float, unsigned char>("HarrisCorner_Transform")
 {
-    m_sobelFilter = nullptr;
     m_internalContext = false;
 }
 
 CHarrisCornerTransform::~CHarrisCornerTransform()
 {
-    if (m_sobelFilter != nullptr)
-    {
-        delete m_sobelFilter;
-        m_sobelFilter = nullptr;
-    }
-
     if (m_internalContext)
     {
         if (m_context != nullptr)
@@ -119,16 +120,6 @@ int CHarrisCornerTransform::Init(CTransformContext *context)
         (*outputImages)[0].resize((*inputImages)[0].getSize());
     }
 
-    if (m_sobelFilter == nullptr)
-    {
-        m_sobelFilter = new CSobelFilterTransform<float>();
-        if (m_sobelFilter == nullptr)
-        {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to create SobelFilterTransform object");
-            return 1;
-        }
-    }
-
     return 0;
 }
 
@@ -136,53 +127,96 @@ int CHarrisCornerTransform::DoSobelTransForm()
 {
     const CVector<CMatrix<float> > *inputImages = CTransform<float, unsigned char>::getInputImages();
 
-    if (m_sobelFilter->LoadData(inputImages, &m_sobelImages) != 0)
+    m_sobelImages.resize(2);
+    if (CSobelFilterTransform<float>::ComputeGradients((*inputImages)[0], true, &m_sobelImages[0], &m_sobelImages[1], nullptr, nullptr) != 0)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from SobelFilterTransform::LoadData()");
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CSobelFilterTransform::ComputeGradients()");
         return 1;
     }
 
-    CSobelFilterTransform<float>::CContext sobelCtx;
-    sobelCtx.setGenMod(false);
-    sobelCtx.setGenPhase(false);
-    if (m_sobelFilter->Transform(&sobelCtx) != 0)
-    {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from SobelFilterTransform::Transform()");
-        return 1;
-    }
+    return 0;
+}
 
-    if (m_sobelImages.size() != 2)
+int CHarrisCornerTransform::ComputeResponse()
+{
+    SSize size = m_sobelImages[0].getSize();
+    m_response.resize(size);
+
+    std::function<void(unsigned long, unsigned long) > band = [&](unsigned long rowStart, unsigned long rowEnd)
+    {
+        for (unsigned long r = rowStart; r < rowEnd; r++)
+        {
+            const float *gx = m_sobelImages[0][r].getDataPointer();
+            const float *gy = m_sobelImages[1][r].getDataPointer();
+            float *response = m_response[r].getDataPointer();
+            for (unsigned long c = 0; c < size.col; c++)
+            {
+                float xx = gx[c] * gx[c];
+                float xy = gx[c] * gy[c];
+                float yy = gy[c] * gy[c];
+                float D = xx * yy - xy * xy;
+                float T = xx + yy;
+                float root = T * T - 4.0f * D;
+                if (root < 0)
+                {
+                    response[c] = -std::numeric_limits<float>::infinity();
+                    continue;
+                }
+
+                root = std::sqrt(root);
+                response[c] = (T - root) / 2.0f;
+            }
+        }
+    };
+    unsigned long bandCount = size.getProduct() >= 512 * 512 ? AUltraThreadPool::getDefaultPoolSize() : 1;
+    if (CUltraThreadFixedPool::RunBands(size.row, bandCount, band) != 0)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Sobel filter returned incorrect amount of images");
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunBands()");
         return 1;
     }
 
+    m_sobelImages.clear();
     return 0;
 }
 
-int CHarrisCornerTransform::ConstructHarrisMatrix()
+int CHarrisCornerTransform::SelectThreshold(float &threshold) const
 {
-    m_harrisMat.resize(m_sobelImages[0].getSize());
-    SSize size = m_harrisMat.getSize();
-    int per = 0;
-
+    threshold = m_context->minHarrisValue;
+    if (m_context->minCornerCount == 0 || m_context->maxThresholdSteps == 0)
+        return 0;
+
+    // descending candidate thresholds, lowered the same way the threshold used to be lowered between runs
+    unsigned long candidateCount = m_context->maxThresholdSteps + 1;
+    std::vector<float> candidates(candidateCount);
+    candidates[0] = m_context->minHarrisValue;
+    for (unsigned long k = 1; k < candidateCount; k++)
+        candidates[k] = candidates[k - 1] - m_context->thresholdStep;
+
+    // histogram of the first candidate each pixel passes, a pixel passing candidate k passes all later ones
+    std::vector<unsigned long> counts(candidateCount, 0);
+    SSize size = m_response.getSize();
     for (unsigned long r = 0; r < size.row; r++)
     {
+        const float *response = m_response[r].getDataPointer();
         for (unsigned long c = 0; c < size.col; c++)
         {
-            m_harrisMat[r][c].resize(SSize(2, 2));
-            m_harrisMat[r][c][0][0] = m_sobelImages[0][r][c] * m_sobelImages[0][r][c];
-            m_harrisMat[r][c][0][1] = m_sobelImages[0][r][c] * m_sobelImages[1][r][c];
-            m_harrisMat[r][c][1][0] = m_sobelImages[0][r][c] * m_sobelImages[1][r][c];
-            m_harrisMat[r][c][1][1] = m_sobelImages[1][r][c] * m_sobelImages[1][r][c];
-        }
-        if (per != (int) ((r * 100) / size.row))
-        {
-            per = (int) ((r * 100) / size.row);
-            CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing " + toString(per) + "%      \r");
+            if (!(response[c] > candidates[candidateCount - 1]))
+                continue;
+            unsigned long k = 0;
+            while (!(response[c] > candidates[k]))
+                k++;
+            counts[k]++;
         }
     }
-    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Processing 100%      ");
+
+    unsigned long passing = 0;
+    for (unsigned long k = 0; k < candidateCount; k++)
+    {
+        passing += counts[k];
+        threshold = candidates[k];
+        if (passing > m_context->minCornerCount)
+            break;
+    }
 
     return 0;
 }
@@ -191,39 +225,64 @@ int CHarrisCornerTransform::DetectHarrisCorners()
 {
     CVector<CMatrix<unsigned char> > *outputImages = CTransform<float, unsigned char>::getOutputImages();
 
+    float threshold;
+    if (SelectThreshold(threshold) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from SelectThreshold()");
+        return 1;
+    }
+    m_context->selectedHarrisValue = threshold;
+
     outputImages->resize(1);
-    (*outputImages)[0].resize(m_harrisMat.getSize());
+    (*outputImages)[0].resize(m_response.getSize());
 
-    SSize size = m_harrisMat.getSize();
+    SSize size = m_response.getSize();
+    long rows = (long) size.row;
+    long cols = (long) size.col;
     (*outputImages)[0].initMatMemset(0);
-    for (unsigned long r = 0; r < size.row; r++)
+    for (long r = 0; r < rows; r++)
     {
-        for (unsigned long c = 0; c < size.col; c++)
+        const float *response = m_response[r].getDataPointer();
+        unsigned char *corners = (*outputImages)[0][r].getDataPointer();
+        for (long c = 0; c < cols; c++)
         {
-            float D = m_harrisMat[r][c][0][0] * m_harrisMat[r][c][1][1] - m_harrisMat[r][c][0][1] * m_harrisMat[r][c][1][0];
-            float T = m_harrisMat[r][c][0][0] + m_harrisMat[r][c][1][1];
-            float root = T * T - 4.0f * D;
-            if (root < 0)
-            {
+            float value = response[c];
+            if (!(value > threshold))
                 continue;
-            }
-
-            root = std::sqrt(root);
 
-            float l1 = (T - root) / 2.0f;
-            float l2 = (T + root) / 2.0f;
-
-            if (l1 > m_context->minHarrisValue &&
-                l2 > m_context->minHarrisValue)
+            if (m_context->nonMaximumSuppression)
             {
-                (*outputImages)[0][r][c] = 255;
+                // ties go to the first pixel in raster order
+                bool isMaximum = true;
+                for (long rr = getMAX(0L, r - 1); rr <= getMIN(rows - 1, r + 1) && isMaximum; rr++)
+                {
+                    const float *neighbours = m_response[rr].getDataPointer();
+                    for (long cc = getMAX(0L, c - 1); cc <= getMIN(cols - 1, c + 1); cc++)
+                    {
+                        bool before = rr < r || (rr == r && cc < c);
+                        if ((before && neighbours[cc] >= value) || (!before && neighbours[cc] > value))
+                        {
+                            isMaximum = false;
+                            break;
+                        }
+                    }
+                }
+                if (!isMaximum)
+                    continue;
             }
+
+            corners[c] = 255;
         }
     }
 
     return 0;
 }
 
+const CMatrix<float> &CHarrisCornerTransform::getResponse() const
+{
+    return m_response;
+}
+
 int CHarrisCornerTransform::InnerTransform()
 {
     if (DoSobelTransForm() != 0)
@@ -232,9 +291,9 @@ int CHarrisCornerTransform::InnerTransform()
         return 1;
     }
 
-    if (ConstructHarrisMatrix() != 0)
+    if (ComputeResponse() != 0)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ConstructHarrisMatrix()");
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ComputeResponse()");
         return 1;
     }
 
@@ -0,0 +1,108 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ultra
+{
+
+/**
+ * Times kernels for gverify-bench.
+ * <br>
+ * An operation is first run once to warm up, the amount of iterations is then
+ * grown until one measurement takes at least the minimum time. The measurement
+ * is repeated and the fastest one is reported, which keeps the numbers stable
+ * from run to run. Each result is printed as ns/op and, for kernels that work on
+ * pixels, millions of pixels per second.
+ */
+class CBenchmark
+{
+public:
+
+    struct SOptions
+    {
+        std::string filter;
+        double minSeconds;
+        unsigned long repetitions;
+        unsigned int seed;
+        bool quick;
+
+        SOptions();
+        ~SOptions();
+    };
+
+    struct SResult
+    {
+        std::string name;
+        std::string params;
+        unsigned long long iterations;
+        double nsPerOp;
+        double pixelsPerSecond;
+
+        SResult();
+        ~SResult();
+    };
+
+private:
+    SOptions m_options;
+    std::vector<SResult> m_results;
+
+    double Measure(const std::function<int() > &op, unsigned long long iterations, bool &failed) const;
+
+public:
+    CBenchmark(const SOptions &options);
+    virtual ~CBenchmark();
+
+    const SOptions &getOptions() const;
+    const std::vector<SResult> &getResults() const;
+
+    /**
+     * @return true if the benchmark name contains the filter
+     */
+    bool isSelected(const std::string &name) const;
+
+    /**
+     * Times an operation, nothing is run if the name is not selected
+     * @param name the kernel
+     * @param params the sweep parameters, printed next to the name
+     * @param pixelsPerOp pixels processed by one operation, 0 to print no throughput
+     * @param op returns 0 on success
+     * @return 0 on success
+     */
+    int Run(const std::string &name, const std::string &params, double pixelsPerOp, const std::function<int() > &op);
+
+    static void PrintHeader();
+    static void PrintResult(const SResult &result);
+};
+
+/**
+ * CCoefNormCorrelatorImpl (with and without no-data), CPhaseCorrelatorImpl,
+ * CEigenFft2d and CSubPixelCorrelator over a sweep of chip sizes and search windows,
+ * and CParallelChipCorrelatorThread with and without local shift priors
+ */
+int RunCorrelationBenchmarks(CBenchmark &bench);
+
+/**
+ * CResampler, CConvKernelToImage and CIntegralMatrix over a sweep of image and kernel sizes
+ */
+int RunImageBenchmarks(CBenchmark &bench);
+
+} // namespace ultra
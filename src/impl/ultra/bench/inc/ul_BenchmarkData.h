@@ -0,0 +1,71 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include <ul_Matrix.h>
+#include <ul_Pair.h>
+
+namespace ultra
+{
+
+/**
+ * Synthetic inputs for gverify-bench, the same seed always gives the same data
+ */
+class CBenchmarkData
+{
+public:
+    CBenchmarkData() = delete;
+    ~CBenchmarkData() = delete;
+
+    /**
+     * Smoothed noise, textured enough for correlation peaks to be well defined
+     * @param size
+     * @param seed
+     * @return 
+     */
+    static CMatrix<float> CreateTexture(const SSize &size, unsigned int seed);
+
+    /**
+     * Replaces a fraction of the pixels with the no-data value
+     * @param image
+     * @param fraction 0 to 1
+     * @param noDataValue
+     * @param seed
+     */
+    static void AddNoData(CMatrix<float> &image, double fraction, float noDataValue, unsigned int seed);
+
+    /**
+     * Output to input map of a small rotation and scale about the centre of the input image
+     * @param outputSize
+     * @param inputSize
+     * @return 
+     */
+    static CMatrix<SPair<float> > CreateAffineMap(const SSize &outputSize, const SSize &inputSize);
+
+    /**
+     * Bilinearly resamples the image at a shift that varies smoothly over the image, pixels
+     * sampled outside of the image are zero
+     * @param image
+     * @param shift the mean shift (in pixels) of the output pixels into the image
+     * @param amplitude the shift varies this many pixels around the mean, a sine over the rows and columns
+     * @return 
+     */
+    static CMatrix<float> CreateShiftedImage(const CMatrix<float> &image, const SPair<double> &shift, double amplitude);
+};
+
+} // namespace ultra
@@ -0,0 +1,156 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ul_Pair.h>
+
+namespace ultra
+{
+
+/**
+ * A synthetic reference/input GeoTIFF pair.
+ * <br>
+ * Both images sample the same continuous texture (value noise over several
+ * octaves), the input is the reference texture displaced by <code>shift</code>
+ * pixels, a pure sub-pixel translation with no rotation. Both have the same
+ * georeferencing, so every correct tie point measures the same displacement.
+ * A border of no-data pixels surrounds each image, the input border is the wider one.
+ */
+struct SSyntheticScene
+{
+    unsigned long size;
+    /**
+     * Displacement of the input content in pixels, x along the columns and y along the rows
+     */
+    SPair<double> shift;
+    unsigned long border;
+    unsigned int seed;
+    double gsd;
+
+    SSyntheticScene();
+    ~SSyntheticScene();
+
+    std::string getName() const;
+
+    /**
+     * The residual every tie point should report, in map units.
+     * Residuals are the input position minus the reference position of a matched
+     * feature, the rows run south so a positive row shift is a negative map y.
+     */
+    SPair<double> getExpectedResidual() const;
+
+    /**
+     * Writes the pair into the directory, an existing pair with the same name is reused
+     * @param directory
+     * @param referencePath
+     * @param inputPath
+     * @return 0 on success
+     */
+    int Generate(const std::string &directory, std::string &referencePath, std::string &inputPath) const;
+
+    /**
+     * The texture at a (sub-pixel) location, between 0 and 1
+     */
+    static double Sample(double row, double col, unsigned int seed);
+};
+
+/**
+ * Runs image-gverify end-to-end (ReprojectImages, GenerateGcps, GenerateResults)
+ * on synthetic scenes over a matrix of settings.
+ * <br>
+ * Every run is a separate image-gverify process so that its wall time and peak
+ * resident set size are its own. The CSV results of a run are compared with the
+ * known displacement of the scene, the report has a row per run with the GCP count,
+ * the mean residual and the RMS and maximum error against the truth.
+ */
+class CSceneBenchmark
+{
+public:
+
+    struct SOptions
+    {
+        std::string gverifyPath;
+        std::string workingDirectory;
+        std::string reportPath;
+        std::vector<unsigned long> sizes;
+        std::vector<unsigned long> threadCounts;
+        std::vector<unsigned long> pyramidLevels;
+        std::vector<unsigned long> chipSizes;
+        std::vector<std::string> chipTypes;
+        std::vector<bool> usePhaseCorrelation;
+        std::vector<unsigned long> coarseToFineStrides;
+        SPair<double> shift;
+        unsigned long border;
+        unsigned int seed;
+
+        SOptions();
+        ~SOptions();
+    };
+
+    struct SRunResult
+    {
+        unsigned long size;
+        unsigned long threadCount;
+        unsigned long pyramidLevels;
+        unsigned long chipSize;
+        std::string chipType;
+        bool usePhaseCorrelation;
+        unsigned long coarseToFineStride;
+
+        SPair<double> expectedResidual;
+        int exitCode;
+        double wallSeconds;
+        unsigned long long peakRssBytes;
+        unsigned long gcpCount;
+        SPair<double> meanResidual;
+        double rmsError;
+        double maxError;
+
+        SRunResult();
+        ~SRunResult();
+    };
+
+private:
+    SOptions m_options;
+    std::vector<SRunResult> m_results;
+
+    int Execute(const std::vector<std::string> &args, const std::string &logPath,
+                int &exitCode, double &wallSeconds, unsigned long long &peakRssBytes) const;
+    int RunOne(const SSyntheticScene &scene, const std::string &referencePath, const std::string &inputPath, SRunResult &result) const;
+
+    static int ReadResults(const std::string &csvPath, const SSyntheticScene &scene, SRunResult &result);
+    static void PrintHeader();
+    static void PrintResult(const SRunResult &result);
+
+public:
+    CSceneBenchmark(const SOptions &options);
+    virtual ~CSceneBenchmark();
+
+    /**
+     * Runs every combination of the settings, a failed image-gverify run is
+     * reported with its exit code and does not stop the benchmark
+     * @return 0 on success
+     */
+    int Run();
+    int SaveReport(const std::string &path) const;
+    const std::vector<SRunResult> &getResults() const;
+};
+
+} // namespace ultra
@@ -0,0 +1,98 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <iostream>
+#include <stdlib.h>
+#include <ul_Logger.h>
+#include <ul_Utility.h>
+#include "ul_Benchmark.h"
+
+static void showHelp(int argc, char **argv)
+{
+    std::cout << "Usage: " << ((argc > 0) ? (argv[0]) : ("gverify-bench")) << " [options]" << std::endl;
+    std::cout << "\t" << "-filter [only run the benchmarks whose name contains this text]" << std::endl;
+    std::cout << "\t" << "-minTime [minimum seconds of a single measurement, default 0.2]" << std::endl;
+    std::cout << "\t" << "-repeat [measurements per benchmark, the fastest is reported, default 3]" << std::endl;
+    std::cout << "\t" << "-seed [seed of the synthetic data, default 1]" << std::endl;
+    std::cout << "\t" << "-quick [true/false, sweep fewer sizes]" << std::endl;
+}
+
+static int ParseInput(int argc, char **argv, ultra::CBenchmark::SOptions &options)
+{
+    if (argc % 2 != 1)
+        return 1;
+
+    for (int t = 1; t < argc; t += 2)
+    {
+        std::string first = argv[t];
+        std::string second = argv[t + 1];
+        if (first == "-filter")
+            options.filter = second;
+        else if (first == "-minTime")
+            options.minSeconds = atof(second.c_str());
+        else if (first == "-repeat")
+        {
+            if (atoi(second.c_str()) < 1)
+            {
+                std::cout << "The repetitions must be at least 1" << std::endl;
+                return 1;
+            }
+            options.repetitions = atoi(second.c_str());
+        }
+        else if (first == "-seed")
+            options.seed = (unsigned int) strtoul(second.c_str(), nullptr, 10);
+        else if (first == "-quick")
+            options.quick = ultra::strToBool(second);
+        else
+        {
+            std::cout << "Unknown argument '" << first << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    if (options.minSeconds <= 0)
+    {
+        std::cout << "The minimum time must be positive" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    ultra::CLogger::getInstance()->setLogLevel(ultra::CLogger::LOG_WARN);
+    ultra::CBenchmark::SOptions options;
+    if (ParseInput(argc, argv, options) != 0)
+    {
+        showHelp(argc, argv);
+        return 1;
+    }
+
+    ultra::CBenchmark bench(options);
+    ultra::CBenchmark::PrintHeader();
+    if (ultra::RunCorrelationBenchmarks(bench) != 0)
+    {
+        ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned from RunCorrelationBenchmarks()");
+        return 1;
+    }
+    if (ultra::RunImageBenchmarks(bench) != 0)
+    {
+        ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned from RunImageBenchmarks()");
+        return 1;
+    }
+    return 0;
+}
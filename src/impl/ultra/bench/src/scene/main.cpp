@@ -0,0 +1,155 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include <iostream>
+#include <stdlib.h>
+#include <ul_Logger.h>
+#include <ul_Utility.h>
+#include "ul_SceneBenchmark.h"
+
+static void showHelp(int argc, char **argv)
+{
+    std::cout << "Usage: " << ((argc > 0) ? (argv[0]) : ("gverify-scene-bench")) << " -w <working directory> [options]" << std::endl;
+    std::cout << "Lists are comma separated, every combination of the lists is run" << std::endl;
+    std::cout << "\t" << "-w <working directory, synthetic scenes are kept and reused here>" << std::endl;
+    std::cout << "\t" << "-gverify [path to image-gverify (./image-gverify)]" << std::endl;
+    std::cout << "\t" << "-report [path to a CSV report of all the runs]" << std::endl;
+    std::cout << "\t" << "-sizes [scene sizes in pixels (1000)]" << std::endl;
+    std::cout << "\t" << "-n [thread counts (1)]" << std::endl;
+    std::cout << "\t" << "-p [pyramid levels (1)]" << std::endl;
+    std::cout << "\t" << "-cs [chip sizes (33)]" << std::endl;
+    std::cout << "\t" << "-t [chip gen types (EVEN)]" << std::endl;
+    std::cout << "\t" << "-usePhaseCorrelation [true/false values (false)]" << std::endl;
+    std::cout << "\t" << "-coarseToFine [CCOEFF_NORM coarse to fine search strides, 1 is exhaustive (1)]" << std::endl;
+    std::cout << "\t" << "-shift [displacement of the input in pixels as x,y (0.3,-0.45)]" << std::endl;
+    std::cout << "\t" << "-border [no-data border of the input in pixels, half of it on the reference (32)]" << std::endl;
+    std::cout << "\t" << "-seed [seed of the synthetic texture (1)]" << std::endl;
+}
+
+static int ParseUnsignedList(const std::string &str, std::vector<unsigned long> &values)
+{
+    values.clear();
+    std::vector<std::string> items = ultra::split(str, ',');
+    for (unsigned long t = 0; t < items.size(); t++)
+    {
+        if (!ultra::isInt(items[t]) || atol(items[t].c_str()) <= 0)
+            return 1;
+        values.push_back(atol(items[t].c_str()));
+    }
+    return values.empty() ? 1 : 0;
+}
+
+static int ParseInput(int argc, char **argv, ultra::CSceneBenchmark::SOptions &options)
+{
+    if (argc % 2 != 1)
+        return 1;
+
+    for (int t = 1; t < argc; t += 2)
+    {
+        std::string first = argv[t];
+        std::string second = argv[t + 1];
+        int ret = 0;
+        if (first == "-w")
+            options.workingDirectory = second;
+        else if (first == "-gverify")
+            options.gverifyPath = second;
+        else if (first == "-report")
+            options.reportPath = second;
+        else if (first == "-sizes")
+            ret = ParseUnsignedList(second, options.sizes);
+        else if (first == "-n")
+            ret = ParseUnsignedList(second, options.threadCounts);
+        else if (first == "-p")
+            ret = ParseUnsignedList(second, options.pyramidLevels);
+        else if (first == "-cs")
+            ret = ParseUnsignedList(second, options.chipSizes);
+        else if (first == "-t")
+        {
+            options.chipTypes = ultra::split(second, ',');
+            ret = options.chipTypes.empty() ? 1 : 0;
+        }
+        else if (first == "-usePhaseCorrelation")
+        {
+            options.usePhaseCorrelation.clear();
+            std::vector<std::string> items = ultra::split(second, ',');
+            for (unsigned long i = 0; i < items.size(); i++)
+                options.usePhaseCorrelation.push_back(ultra::strToBool(items[i]));
+            ret = options.usePhaseCorrelation.empty() ? 1 : 0;
+        }
+        else if (first == "-coarseToFine")
+            ret = ParseUnsignedList(second, options.coarseToFineStrides);
+        else if (first == "-shift")
+        {
+            std::vector<std::string> items = ultra::split(second, ',');
+            if (items.size() == 2)
+                options.shift = ultra::SPair<double>(atof(items[1].c_str()), atof(items[0].c_str()));
+            else
+                ret = 1;
+        }
+        else if (first == "-border")
+            options.border = atol(second.c_str());
+        else if (first == "-seed")
+            options.seed = (unsigned int) strtoul(second.c_str(), nullptr, 10);
+        else
+        {
+            std::cout << "Unknown argument '" << first << "'" << std::endl;
+            return 1;
+        }
+
+        if (ret != 0)
+        {
+            std::cout << "Invalid value '" << second << "' for '" << first << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    if (options.workingDirectory == "")
+    {
+        std::cout << "A working directory is required" << std::endl;
+        return 1;
+    }
+    if (!ultra::pathExists(options.gverifyPath))
+    {
+        std::cout << "image-gverify not found at '" << options.gverifyPath << "'" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    ultra::CLogger::getInstance()->setLogLevel(ultra::CLogger::LOG_INFO);
+    ultra::CSceneBenchmark::SOptions options;
+    if (ParseInput(argc, argv, options) != 0)
+    {
+        showHelp(argc, argv);
+        return 1;
+    }
+
+    ultra::CSceneBenchmark bench(options);
+    int ret = bench.Run();
+    if (ret != 0)
+        ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned from CSceneBenchmark::Run()");
+
+    // the runs that did complete are reported on failures too
+    if (options.reportPath != "" && bench.SaveReport(options.reportPath) != 0)
+    {
+        ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, ultra::CLogger::LOG_ERROR, "Failure returned from CSceneBenchmark::SaveReport()");
+        ret = 1;
+    }
+    return ret;
+}
@@ -0,0 +1,372 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "ul_SceneBenchmark.h"
+
+#include <cmath>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <ul_Logger.h>
+#include <ul_Utility.h>
+#include <ul_Profiler.h>
+
+namespace ultra
+{
+
+CSceneBenchmark::SOptions::SOptions()
+{
+    gverifyPath = "./image-gverify";
+    reportPath = "";
+    sizes.push_back(1000);
+    threadCounts.push_back(1);
+    pyramidLevels.push_back(1);
+    chipSizes.push_back(33);
+    chipTypes.push_back("EVEN");
+    usePhaseCorrelation.push_back(false);
+    coarseToFineStrides.push_back(1);
+    shift = SSyntheticScene().shift;
+    border = SSyntheticScene().border;
+    seed = 1;
+}
+
+CSceneBenchmark::SOptions::~SOptions()
+{
+}
+
+CSceneBenchmark::SRunResult::SRunResult()
+{
+    size = 0;
+    threadCount = 0;
+    pyramidLevels = 0;
+    chipSize = 0;
+    usePhaseCorrelation = false;
+    coarseToFineStride = 1;
+    expectedResidual = SPair<double>(0, 0);
+    exitCode = -1;
+    wallSeconds = 0;
+    peakRssBytes = 0;
+    gcpCount = 0;
+    meanResidual = SPair<double>(0, 0);
+    rmsError = 0;
+    maxError = 0;
+}
+
+CSceneBenchmark::SRunResult::~SRunResult()
+{
+}
+
+CSceneBenchmark::CSceneBenchmark(const SOptions &options) :
+m_options(options)
+{
+}
+
+CSceneBenchmark::~CSceneBenchmark()
+{
+}
+
+const std::vector<CSceneBenchmark::SRunResult> &CSceneBenchmark::getResults() const
+{
+    return m_results;
+}
+
+static int MakeDirectory(const std::string &path)
+{
+    if (pathExists(path))
+        return 0;
+    if (MkPath(path, 0755) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to create the directory '" + path + "'");
+        return 1;
+    }
+    return 0;
+}
+
+int CSceneBenchmark::Execute(const std::vector<std::string> &args, const std::string &logPath,
+                             int &exitCode, double &wallSeconds, unsigned long long &peakRssBytes) const
+{
+    std::vector<char*> argv;
+    for (unsigned long t = 0; t < args.size(); t++)
+        argv.push_back(const_cast<char*> (args[t].c_str()));
+    argv.push_back(nullptr);
+
+    double start = CProfiler::getWallSeconds();
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to fork");
+        return 1;
+    }
+    if (pid == 0)
+    {
+        int fd = open(logPath.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to wait for '" + args[0] + "'");
+        return 1;
+    }
+    wallSeconds = CProfiler::getWallSeconds() - start;
+    // kilobytes on Linux
+    peakRssBytes = (unsigned long long) usage.ru_maxrss * 1024ULL;
+    if (WIFEXITED(status))
+        exitCode = WEXITSTATUS(status);
+    else
+        exitCode = 128 + (WIFSIGNALED(status) ? WTERMSIG(status) : 0);
+    return 0;
+}
+
+int CSceneBenchmark::ReadResults(const std::string &csvPath, const SSyntheticScene &scene, SRunResult &result)
+{
+    std::vector<std::string> lines;
+    if (ReadAllLinesFromFile(csvPath, lines) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to read '" + csvPath + "'");
+        return 1;
+    }
+
+    // point_id,chip_type,line,sample,map_x,map_y,correlation_coefficient,residual_y,residual_x,outlier_flag
+    SPair<double> expected = scene.getExpectedResidual();
+    SPair<double> sum(0, 0);
+    double sumSquaredError = 0;
+    result.gcpCount = 0;
+    result.maxError = 0;
+    for (unsigned long t = 1; t < lines.size(); t++)
+    {
+        std::vector<std::string> fields = split(lines[t], ',');
+        if (fields.size() != 10)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid line '" + lines[t] + "' in '" + csvPath + "'");
+            return 1;
+        }
+        if (atoi(fields[9].c_str()) == 0)
+            continue;
+
+        SPair<double> residual(atof(fields[7].c_str()), atof(fields[8].c_str()));
+        double error = (residual - expected).modSize() / scene.gsd;
+        sum += residual;
+        sumSquaredError += error * error;
+        result.maxError = getMAX(result.maxError, error);
+        result.gcpCount++;
+    }
+
+    if (result.gcpCount > 0)
+    {
+        result.meanResidual = sum / (double) result.gcpCount;
+        result.rmsError = std::sqrt(sumSquaredError / result.gcpCount);
+    }
+    return 0;
+}
+
+int CSceneBenchmark::RunOne(const SSyntheticScene &scene, const std::string &referencePath, const std::string &inputPath, SRunResult &result) const
+{
+    std::string runName = scene.getName() + "_n" + toString(result.threadCount) + "_p" + toString(result.pyramidLevels) +
+        "_cs" + toString(result.chipSize) + "_" + result.chipType + (result.usePhaseCorrelation ? "_phase" : "_coef") +
+        (result.coarseToFineStride > 1 ? "_s" + toString(result.coarseToFineStride) : "");
+    std::string runDirectory = m_options.workingDirectory + "/runs/" + runName;
+    std::string workDirectory = runDirectory + "/work";
+    std::string outputDirectory = runDirectory + "/output";
+    if (MakeDirectory(workDirectory) != 0 || MakeDirectory(outputDirectory) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from MakeDirectory()");
+        return 1;
+    }
+
+    std::vector<std::string> args;
+    args.push_back(m_options.gverifyPath);
+    args.push_back("-b");
+    args.push_back(referencePath);
+    args.push_back("-m");
+    args.push_back(inputPath);
+    args.push_back("-w");
+    args.push_back(workDirectory);
+    args.push_back("-o");
+    args.push_back(outputDirectory);
+    args.push_back("-nv");
+    args.push_back("0");
+    args.push_back("-n");
+    args.push_back(toString(result.threadCount));
+    args.push_back("-p");
+    args.push_back(toString(result.pyramidLevels));
+    args.push_back("-cs");
+    args.push_back(toString(result.chipSize));
+    args.push_back("-t");
+    args.push_back(result.chipType);
+    args.push_back("-usePhaseCorrelation");
+    args.push_back(boolToStr(result.usePhaseCorrelation));
+    args.push_back("-coarseToFine");
+    args.push_back(toString(result.coarseToFineStride));
+    args.push_back("-of");
+    args.push_back("csv");
+    args.push_back("-timing");
+    args.push_back(runDirectory + "/timing.json");
+
+    if (Execute(args, runDirectory + "/image-gverify.out", result.exitCode, result.wallSeconds, result.peakRssBytes) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Execute()");
+        return 1;
+    }
+    if (result.exitCode != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "Run '" + runName + "' failed with exit code '" + toString(result.exitCode) + "', see '" + runDirectory + "'");
+        return 0;
+    }
+
+    if (ReadResults(outputDirectory + "/image-gverify.csv", scene, result) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from ReadResults()");
+        return 1;
+    }
+    return 0;
+}
+
+int CSceneBenchmark::Run()
+{
+    std::string sceneDirectory = m_options.workingDirectory + "/scenes";
+    if (MakeDirectory(sceneDirectory) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from MakeDirectory()");
+        return 1;
+    }
+
+    m_results.clear();
+    bool headerPrinted = false;
+    for (unsigned long size : m_options.sizes)
+    {
+        SSyntheticScene scene;
+        scene.size = size;
+        scene.shift = m_options.shift;
+        scene.border = m_options.border;
+        scene.seed = m_options.seed;
+        std::string referencePath;
+        std::string inputPath;
+        if (scene.Generate(sceneDirectory, referencePath, inputPath) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from SSyntheticScene::Generate()");
+            return 1;
+        }
+
+        if (!headerPrinted)
+        {
+            PrintHeader();
+            headerPrinted = true;
+        }
+        for (unsigned long threadCount : m_options.threadCounts)
+        {
+            for (unsigned long pyramidLevels : m_options.pyramidLevels)
+            {
+                for (unsigned long chipSize : m_options.chipSizes)
+                {
+                    for (const std::string &chipType : m_options.chipTypes)
+                    {
+                        for (bool usePhaseCorrelation : m_options.usePhaseCorrelation)
+                        {
+                            for (unsigned long coarseToFineStride : m_options.coarseToFineStrides)
+                            {
+                                // phase correlation always evaluates every offset
+                                if (usePhaseCorrelation && coarseToFineStride > 1)
+                                    continue;
+                                SRunResult result;
+                                result.size = size;
+                                result.threadCount = threadCount;
+                                result.pyramidLevels = pyramidLevels;
+                                result.chipSize = chipSize;
+                                result.chipType = chipType;
+                                result.usePhaseCorrelation = usePhaseCorrelation;
+                                result.coarseToFineStride = coarseToFineStride;
+                                result.expectedResidual = scene.getExpectedResidual();
+                                if (RunOne(scene, referencePath, inputPath, result) != 0)
+                                {
+                                    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunOne()");
+                                    return 1;
+                                }
+                                PrintResult(result);
+                                m_results.push_back(result);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+void CSceneBenchmark::PrintHeader()
+{
+    printf("%7s %3s %3s %4s %-14s %-5s %3s %5s %10s %10s %7s %12s %12s %9s %9s\n",
+           "size", "n", "p", "cs", "chipType", "phase", "c2f", "exit", "wall(s)", "peakMB", "gcps",
+           "meanResX", "meanResY", "rmsErrPx", "maxErrPx");
+    fflush(stdout);
+}
+
+void CSceneBenchmark::PrintResult(const SRunResult &result)
+{
+    printf("%7lu %3lu %3lu %4lu %-14s %-5s %3lu %5d %10.2f %10.1f %7lu %12.4f %12.4f %9.4f %9.4f\n",
+           result.size, result.threadCount, result.pyramidLevels, result.chipSize,
+           result.chipType.c_str(), boolToStr(result.usePhaseCorrelation).c_str(), result.coarseToFineStride, result.exitCode,
+           result.wallSeconds, result.peakRssBytes / (1024.0 * 1024.0), result.gcpCount,
+           result.meanResidual.x, result.meanResidual.y, result.rmsError, result.maxError);
+    fflush(stdout);
+}
+
+int CSceneBenchmark::SaveReport(const std::string &path) const
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (fp == NULL)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to create '" + path + "'");
+        return 1;
+    }
+
+    fprintf(fp, "size,thread_count,pyramid_levels,chip_size,chip_type,phase_correlation,coarse_to_fine_stride,exit_code,wall_seconds,"
+            "peak_rss_bytes,gcp_count,expected_residual_x,expected_residual_y,mean_residual_x,mean_residual_y,"
+            "rms_error_pixels,max_error_pixels\n");
+    for (unsigned long t = 0; t < m_results.size(); t++)
+    {
+        const SRunResult &result = m_results[t];
+        fprintf(fp, "%lu,%lu,%lu,%lu,%s,%s,%lu,%d,%.6f,%llu,%lu,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+                result.size, result.threadCount, result.pyramidLevels, result.chipSize,
+                result.chipType.c_str(), boolToStr(result.usePhaseCorrelation).c_str(), result.coarseToFineStride, result.exitCode,
+                result.wallSeconds, result.peakRssBytes, result.gcpCount,
+                result.expectedResidual.x, result.expectedResidual.y,
+                result.meanResidual.x, result.meanResidual.y, result.rmsError, result.maxError);
+    }
+
+    bool ok = ferror(fp) == 0;
+    if (fclose(fp) != 0 || !ok)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to write '" + path + "'");
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace ultra
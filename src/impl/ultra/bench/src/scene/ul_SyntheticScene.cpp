@@ -0,0 +1,168 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "ul_SceneBenchmark.h"
+
+#include <cmath>
+#include <ul_Logger.h>
+#include <ul_Utility.h>
+#include <ul_UltraThreadPool.h>
+#include <ul_UltraThreadFixedPool.h>
+#include <ul_ImageSaver.h>
+
+namespace ultra
+{
+
+namespace
+{
+
+const char *SCENE_PROJ4 = "+proj=utm +zone=35 +south +ellps=WGS84 +datum=WGS84 +units=m +no_defs";
+const double SCENE_ORIGIN_X = 500000;
+const double SCENE_ORIGIN_Y = 7000000;
+const unsigned char SCENE_NO_DATA = 0;
+
+double hashToUnit(long long col, long long row, unsigned int octave, unsigned int seed)
+{
+    unsigned long long h = (unsigned long long) col * 0x9E3779B97F4A7C15ULL;
+    h ^= (unsigned long long) row * 0xC2B2AE3D27D4EB4FULL;
+    h ^= ((unsigned long long) seed << 32) | octave;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return (double) (h >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double fade(double t)
+{
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+int SaveScene(const SSyntheticScene &scene, const std::string &path, const SPair<double> &shift, unsigned long border)
+{
+    SSize size = SSize(scene.size);
+    CMatrix<unsigned char> image(size);
+    auto band = [&](unsigned long startRow, unsigned long endRow)->void
+    {
+        for (unsigned long r = startRow; r < endRow; r++)
+        {
+            unsigned char *dp = image[r].getDataPointer();
+            bool borderRow = r < border || r + border >= size.row;
+            for (unsigned long c = 0; c < size.col; c++)
+            {
+                if (borderRow || c < border || c + border >= size.col)
+                    dp[c] = SCENE_NO_DATA;
+                else
+                    dp[c] = (unsigned char) (1.5 + 254.0 * SSyntheticScene::Sample(r - shift.y, c - shift.x, scene.seed));
+            }
+        }
+    };
+    if (CUltraThreadFixedPool::RunBands(size.row, AUltraThreadPool::getCoreThreadCount(), band) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunBands()");
+        return 1;
+    }
+
+    SImageMetadata metadata;
+    metadata.setDimensions(size);
+    metadata.setOrigin(SCENE_ORIGIN_X, SCENE_ORIGIN_Y);
+    metadata.setGsd(scene.gsd, -scene.gsd);
+    metadata.setProj4String(SCENE_PROJ4);
+    if (CImageSaver::getInstance()->SaveImage(path, image, EImage::IMAGE_TYPE_GEOTIFF, &metadata) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to save '" + path + "'");
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+SSyntheticScene::SSyntheticScene()
+{
+    size = 1000;
+    shift = SPair<double>(-0.45, 0.3);
+    border = 32;
+    seed = 1;
+    gsd = 10;
+}
+
+SSyntheticScene::~SSyntheticScene()
+{
+}
+
+std::string SSyntheticScene::getName() const
+{
+    return "scene_" + toString(size) + "_seed" + toString(seed) +
+        "_dx" + toString(shift.x, 3) + "_dy" + toString(shift.y, 3) + "_border" + toString(border);
+}
+
+SPair<double> SSyntheticScene::getExpectedResidual() const
+{
+    return SPair<double>(-shift.y * gsd, shift.x * gsd);
+}
+
+double SSyntheticScene::Sample(double row, double col, unsigned int seed)
+{
+    static const double periods[] = {32, 16, 8, 4};
+    static const double weights[] = {0.4, 0.3, 0.2, 0.1};
+    double value = 0;
+    for (unsigned int octave = 0; octave < 4; octave++)
+    {
+        double y = row / periods[octave];
+        double x = col / periods[octave];
+        double fy = std::floor(y);
+        double fx = std::floor(x);
+        long long iy = (long long) fy;
+        long long ix = (long long) fx;
+        double ty = fade(y - fy);
+        double tx = fade(x - fx);
+        double top = hashToUnit(ix, iy, octave, seed) * (1 - tx) + hashToUnit(ix + 1, iy, octave, seed) * tx;
+        double bottom = hashToUnit(ix, iy + 1, octave, seed) * (1 - tx) + hashToUnit(ix + 1, iy + 1, octave, seed) * tx;
+        value += weights[octave] * (top * (1 - ty) + bottom * ty);
+    }
+    return value;
+}
+
+int SSyntheticScene::Generate(const std::string &directory, std::string &referencePath, std::string &inputPath) const
+{
+    if (size <= 2 * border)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "The scene size must be larger than its no-data borders");
+        return 1;
+    }
+
+    referencePath = directory + "/" + getName() + "_reference.tif";
+    inputPath = directory + "/" + getName() + "_input.tif";
+    if (pathExists(referencePath) && pathExists(inputPath))
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Reusing scene '" + getName() + "'");
+        return 0;
+    }
+
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Generating scene '" + getName() + "'");
+    if (SaveScene(*this, referencePath, SPair<double>(0, 0), border / 2) != 0 ||
+        SaveScene(*this, inputPath, shift, border) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from SaveScene()");
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace ultra
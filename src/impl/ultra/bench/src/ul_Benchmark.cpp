@@ -0,0 +1,161 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "ul_Benchmark.h"
+
+#include <stdio.h>
+#include <ul_Logger.h>
+#include <ul_Profiler.h>
+#include <ul_Utility.h>
+
+namespace ultra
+{
+
+CBenchmark::SOptions::SOptions()
+{
+    minSeconds = 0.2;
+    repetitions = 3;
+    seed = 1;
+    quick = false;
+}
+
+CBenchmark::SOptions::~SOptions()
+{
+}
+
+CBenchmark::SResult::SResult()
+{
+    iterations = 0;
+    nsPerOp = 0;
+    pixelsPerSecond = 0;
+}
+
+CBenchmark::SResult::~SResult()
+{
+}
+
+CBenchmark::CBenchmark(const SOptions &options) :
+m_options(options)
+{
+}
+
+CBenchmark::~CBenchmark()
+{
+}
+
+const CBenchmark::SOptions &CBenchmark::getOptions() const
+{
+    return m_options;
+}
+
+const std::vector<CBenchmark::SResult> &CBenchmark::getResults() const
+{
+    return m_results;
+}
+
+bool CBenchmark::isSelected(const std::string &name) const
+{
+    return m_options.filter == "" || name.find(m_options.filter) != std::string::npos;
+}
+
+double CBenchmark::Measure(const std::function<int() > &op, unsigned long long iterations, bool &failed) const
+{
+    failed = false;
+    double start = CProfiler::getWallSeconds();
+    for (unsigned long long t = 0; t < iterations; t++)
+    {
+        if (op() != 0)
+        {
+            failed = true;
+            break;
+        }
+    }
+    return CProfiler::getWallSeconds() - start;
+}
+
+int CBenchmark::Run(const std::string &name, const std::string &params, double pixelsPerOp, const std::function<int() > &op)
+{
+    if (!isSelected(name))
+        return 0;
+
+    bool failed = false;
+    double seconds = Measure(op, 1, failed);
+    if (failed)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Benchmark '" + name + " " + params + "' failed");
+        return 1;
+    }
+
+    // grow the iterations until a single measurement is long enough to be timed reliably
+    unsigned long long iterations = 1;
+    while (seconds < m_options.minSeconds)
+    {
+        double scale = (seconds > 0) ? (1.5 * m_options.minSeconds / seconds) : (100);
+        iterations = (unsigned long long) (iterations * getMIN(getMAX(scale, 2.0), 100.0));
+        seconds = Measure(op, iterations, failed);
+        if (failed)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Benchmark '" + name + " " + params + "' failed");
+            return 1;
+        }
+    }
+
+    double best = seconds;
+    for (unsigned long t = 1; t < m_options.repetitions; t++)
+    {
+        seconds = Measure(op, iterations, failed);
+        if (failed)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Benchmark '" + name + " " + params + "' failed");
+            return 1;
+        }
+        best = getMIN(best, seconds);
+    }
+
+    SResult result;
+    result.name = name;
+    result.params = params;
+    result.iterations = iterations;
+    result.nsPerOp = best * 1e9 / (double) iterations;
+    result.pixelsPerSecond = (pixelsPerOp > 0) ? (pixelsPerOp * (double) iterations / best) : (0);
+    m_results.push_back(result);
+    PrintResult(result);
+    return 0;
+}
+
+void CBenchmark::PrintHeader()
+{
+    printf("%-34s %-26s %12s %16s %12s\n", "benchmark", "params", "iterations", "ns/op", "Mpixels/s");
+    fflush(stdout);
+}
+
+void CBenchmark::PrintResult(const SResult &result)
+{
+    if (result.pixelsPerSecond > 0)
+    {
+        printf("%-34s %-26s %12llu %16.1f %12.2f\n", result.name.c_str(), result.params.c_str(),
+               result.iterations, result.nsPerOp, result.pixelsPerSecond * 1e-6);
+    }
+    else
+    {
+        printf("%-34s %-26s %12llu %16.1f %12s\n", result.name.c_str(), result.params.c_str(),
+               result.iterations, result.nsPerOp, "-");
+    }
+    fflush(stdout);
+}
+
+} // namespace ultra
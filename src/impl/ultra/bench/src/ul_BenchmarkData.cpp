@@ -0,0 +1,132 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "ul_BenchmarkData.h"
+
+#include <cmath>
+#include <random>
+
+namespace ultra
+{
+
+CMatrix<float> CBenchmarkData::CreateTexture(const SSize &size, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(0.0f, 255.0f);
+
+    CMatrix<float> noise(size);
+    for (unsigned long r = 0; r < size.row; r++)
+    {
+        for (unsigned long c = 0; c < size.col; c++)
+            noise[r][c] = distribution(generator);
+    }
+
+    // a 3x3 box filter gives the texture some spatial correlation
+    CMatrix<float> image(size);
+    for (long r = 0; r < (long) size.row; r++)
+    {
+        for (long c = 0; c < (long) size.col; c++)
+        {
+            float sum = 0;
+            float count = 0;
+            for (long dr = -1; dr <= 1; dr++)
+            {
+                for (long dc = -1; dc <= 1; dc++)
+                {
+                    long rr = r + dr;
+                    long cc = c + dc;
+                    if (rr >= 0 && cc >= 0 && rr < (long) size.row && cc < (long) size.col)
+                    {
+                        sum += noise[rr][cc];
+                        count++;
+                    }
+                }
+            }
+            image[r][c] = sum / count;
+        }
+    }
+    return image;
+}
+
+void CBenchmarkData::AddNoData(CMatrix<float> &image, double fraction, float noDataValue, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    SSize size = image.getSize();
+    for (unsigned long r = 0; r < size.row; r++)
+    {
+        for (unsigned long c = 0; c < size.col; c++)
+        {
+            if (distribution(generator) < fraction)
+                image[r][c] = noDataValue;
+        }
+    }
+}
+
+CMatrix<SPair<float> > CBenchmarkData::CreateAffineMap(const SSize &outputSize, const SSize &inputSize)
+{
+    const double angle = 5.0 * M_PI / 180.0;
+    const double scale = 0.9;
+    double cosA = std::cos(angle) * scale;
+    double sinA = std::sin(angle) * scale;
+    double outMidRow = outputSize.row / 2.0;
+    double outMidCol = outputSize.col / 2.0;
+    double inMidRow = inputSize.row / 2.0;
+    double inMidCol = inputSize.col / 2.0;
+
+    CMatrix<SPair<float> > map(outputSize);
+    for (unsigned long r = 0; r < outputSize.row; r++)
+    {
+        for (unsigned long c = 0; c < outputSize.col; c++)
+        {
+            double dr = r - outMidRow;
+            double dc = c - outMidCol;
+            map[r][c].y = (float) (inMidRow + cosA * dr - sinA * dc);
+            map[r][c].x = (float) (inMidCol + sinA * dr + cosA * dc);
+        }
+    }
+    return map;
+}
+
+CMatrix<float> CBenchmarkData::CreateShiftedImage(const CMatrix<float> &image, const SPair<double> &shift, double amplitude)
+{
+    SSize size = image.getSize();
+    CMatrix<float> shifted(size);
+    for (unsigned long r = 0; r < size.row; r++)
+    {
+        for (unsigned long c = 0; c < size.col; c++)
+        {
+            double rr = r + shift.r + amplitude * std::sin(2.0 * M_PI * c / size.col);
+            double cc = c + shift.c + amplitude * std::sin(2.0 * M_PI * r / size.row);
+            long r0 = (long) std::floor(rr);
+            long c0 = (long) std::floor(cc);
+            if (r0 < 0 || c0 < 0 || r0 + 1 >= (long) size.row || c0 + 1 >= (long) size.col)
+            {
+                shifted[r][c] = 0;
+                continue;
+            }
+
+            double fr = rr - r0;
+            double fc = cc - c0;
+            shifted[r][c] = (float) ((1 - fr) * ((1 - fc) * image[r0][c0] + fc * image[r0][c0 + 1]) +
+                fr * ((1 - fc) * image[r0 + 1][c0] + fc * image[r0 + 1][c0 + 1]));
+        }
+    }
+    return shifted;
+}
+
+} // namespace ultra
@@ -0,0 +1,461 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "ul_Benchmark.h"
+#include "ul_BenchmarkData.h"
+
+#include <ul_Logger.h>
+#include <ul_Utility.h>
+#include <ul_DigitalImageCorrelator.h>
+#include <ul_SubPixelCorrelator.h>
+#include <ul_EigenFft.h>
+#include <ul_GcpShiftPriors.h>
+#include <ul_ParallelChipCorrelatorThread.h>
+
+namespace ultra
+{
+
+namespace
+{
+
+const float NO_DATA_VALUE = -9999;
+const double NO_DATA_FRACTION = 0.02;
+// the image-gverify default
+const double CORRELATION_THRESHOLD = 0.75;
+// pixels, the coarse to fine offsets must match the exhaustive ones up to rounding
+const double OFFSET_TOLERANCE = 1e-6;
+// the shifted scene the local shift priors are checked on, about the pixels a finer pyramid level is off by
+const SPair<double> SCENE_SHIFT = SPair<double>(7.3, -6.6);
+const double SCENE_SHIFT_AMPLITUDE = 2.0;
+const unsigned long SHIFT_PRIOR_CHIP_SIZE = 31;
+const unsigned long SHIFT_PRIOR_GRID_SIZE = 16;
+const unsigned long SHIFT_PRIOR_SEARCH_WINDOW = 32;
+// CGaussianPyramidTiePointGenerator::SHIFT_PRIOR_RADIUS_IN_GRID_CELLS
+const double SHIFT_PRIOR_RADIUS_IN_GRID_CELLS = 2.5;
+
+std::vector<unsigned long> getChipSizes(const CBenchmark &bench)
+{
+    if (bench.getOptions().quick)
+        return std::vector<unsigned long>{15, 63};
+    return std::vector<unsigned long>{15, 31, 63, 129};
+}
+
+std::vector<unsigned long> getPhaseSizes(const CBenchmark &bench)
+{
+    // phase correlation needs even sizes
+    if (bench.getOptions().quick)
+        return std::vector<unsigned long>{16, 64};
+    return std::vector<unsigned long>{16, 32, 64, 128};
+}
+
+std::vector<unsigned long> getSearchWindows(const CBenchmark &bench)
+{
+    if (bench.getOptions().quick)
+        return std::vector<unsigned long>{16};
+    return std::vector<unsigned long>{8, 16, 32};
+}
+
+/**
+ * The search image the chip correlator extracts, see CParallelChipCorrelatorThread::populateSubImage()
+ */
+SSize getSearchSize(unsigned long chipSize, unsigned long searchWindow)
+{
+    SSize size = SSize(chipSize + searchWindow);
+    if (size.col % 2 != 1)
+        size.col++;
+    if (size.row % 2 != 1)
+        size.row++;
+    return size;
+}
+
+std::vector<ECorrelationPrecision> getPrecisions(const CBenchmark &bench)
+{
+    if (bench.getOptions().quick)
+        return std::vector<ECorrelationPrecision>{ECorrelationPrecision::HIGH, ECorrelationPrecision::FLOAT};
+    return std::vector<ECorrelationPrecision>{ECorrelationPrecision::HIGH, ECorrelationPrecision::DOUBLE, ECorrelationPrecision::FLOAT};
+}
+
+std::vector<unsigned long> getCoarseToFineStrides(const CBenchmark &bench)
+{
+    if (bench.getOptions().quick)
+        return std::vector<unsigned long>{1, 4};
+    return std::vector<unsigned long>{1, 2, 4};
+}
+
+std::string getParams(unsigned long chipSize, unsigned long searchWindow, ECorrelationPrecision precision)
+{
+    return "chip=" + toString(chipSize) + " search=" + toString(searchWindow) + " precision=" + CCorrelationHelper::typeToStr(precision);
+}
+
+int RunCoefNormBenchmarks(CBenchmark &bench, bool useNoData)
+{
+    std::string name = useNoData ? "CCoefNormCorrelatorImpl.noData" : "CCoefNormCorrelatorImpl";
+    if (!bench.isSelected(name))
+        return 0;
+
+    std::vector<unsigned long> chipSizes = getChipSizes(bench);
+    std::vector<unsigned long> searchWindows = getSearchWindows(bench);
+    unsigned int seed = bench.getOptions().seed;
+    for (unsigned long chipSize : chipSizes)
+    {
+        for (unsigned long searchWindow : searchWindows)
+        {
+            SSize searchSize = getSearchSize(chipSize, searchWindow);
+            CMatrix<float> reference = CBenchmarkData::CreateTexture(searchSize, seed);
+            CMatrix<float> chip = reference.getSubMatrix(SSize(searchWindow / 2 - 1, searchWindow / 2 + 1), SSize(chipSize));
+            const float *noData = nullptr;
+            if (useNoData)
+            {
+                CBenchmarkData::AddNoData(reference, NO_DATA_FRACTION, NO_DATA_VALUE, seed + 1);
+                CBenchmarkData::AddNoData(chip, NO_DATA_FRACTION, NO_DATA_VALUE, seed + 2);
+                noData = &NO_DATA_VALUE;
+            }
+
+            for (ECorrelationPrecision precision : getPrecisions(bench))
+            {
+                __ultra_internal::correlate_coef_norm::CCoefNormCorrelatorImpl correlator(precision);
+                CMatrix<double> output;
+                if (bench.Run(name, getParams(chipSize, searchWindow, precision), (double) searchSize.getProduct(), [&]()->int
+                    {
+                        correlator.correlateNormal<float>(reference, chip, output, noData, noData);
+                        return 0;
+                    }) != 0)
+                {
+                    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int RunPhaseBenchmarks(CBenchmark &bench)
+{
+    std::string name = "CPhaseCorrelatorImpl";
+    if (!bench.isSelected(name))
+        return 0;
+
+    unsigned int seed = bench.getOptions().seed;
+    for (unsigned long size : getPhaseSizes(bench))
+    {
+        CMatrix<float> scene = CBenchmarkData::CreateTexture(SSize(size + 8), seed);
+        CMatrix<float> reference = scene.getSubMatrix(SSize(0, 0), SSize(size));
+        CMatrix<float> chip = scene.getSubMatrix(SSize(3, 2), SSize(size));
+
+        std::shared_ptr<CDft2d> fft = std::make_shared<CDft2d>(SSize(size));
+        for (ECorrelationPrecision precision : getPrecisions(bench))
+        {
+            __ultra_internal::correlate_phase::CPhaseCorrelatorImpl correlator(precision);
+            CMatrix<double> output;
+            if (bench.Run(name, "chip=" + toString(size) + " precision=" + CCorrelationHelper::typeToStr(precision), (double) (size * size), [&]()->int
+                {
+                    correlator.correlateNormal<float>(fft.get(), reference, chip, output, nullptr, nullptr);
+                    return 0;
+                }) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int RunFftBenchmarks(CBenchmark &bench)
+{
+    if (!bench.isSelected("CEigenFft2d.forward") && !bench.isSelected("CEigenFft2d.inverse"))
+        return 0;
+
+    // odd sizes are included, the chip sizes that are not a power of two are the slow ones
+    std::vector<unsigned long> sizes;
+    for (unsigned long size : getPhaseSizes(bench))
+    {
+        sizes.push_back(size - 1);
+        sizes.push_back(size);
+    }
+    unsigned int seed = bench.getOptions().seed;
+    for (unsigned long size : sizes)
+    {
+        CMatrix<float> texture = CBenchmarkData::CreateTexture(SSize(size), seed);
+        CMatrix<SComplex<double> > input = texture.map<SComplex<double> >([](const float &v)->SComplex<double>
+        {
+            return SComplex<double>(v, 0);
+        });
+        CMatrix<SComplex<double> > output;
+        __ultra_internal_fft::CEigenFft2d fft = __ultra_internal_fft::CEigenFft2d(SSize(size));
+
+        if (bench.Run("CEigenFft2d.forward", "size=" + toString(size), (double) (size * size), [&]()->int
+            {
+                fft.forward<double>(input, output);
+                return 0;
+            }) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+            return 1;
+        }
+
+        CMatrix<SComplex<double> > spectrum;
+        fft.forward<double>(input, spectrum);
+        if (bench.Run("CEigenFft2d.inverse", "size=" + toString(size), (double) (size * size), [&]()->int
+            {
+                fft.inverse<double>(spectrum, output);
+                return 0;
+            }) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int RunSubPixelBenchmarks(CBenchmark &bench)
+{
+    unsigned int seed = bench.getOptions().seed;
+    std::string name = "CSubPixelCorrelator.coefNorm";
+    if (bench.isSelected(name))
+    {
+        for (unsigned long chipSize : getChipSizes(bench))
+        {
+            for (unsigned long searchWindow : getSearchWindows(bench))
+            {
+                SSize searchSize = getSearchSize(chipSize, searchWindow);
+                CMatrix<float> reference = CBenchmarkData::CreateTexture(searchSize, seed);
+                CMatrix<float> chip = reference.getSubMatrix(SSize(searchWindow / 2 - 1, searchWindow / 2 + 1), SSize(chipSize));
+
+                // the exhaustive search, every stride must find the same peak
+                CSubPixelCorrelator<float> exhaustive(SSize(chipSize), ECorrelationType::CCOEFF_NORM, ESubPixelCorrelationType::LEAST_SQUARE_SUB_PIXEL,
+                                                      ECorrelationPrecision::HIGH, false, 1);
+                bool exhaustiveSuccess = false;
+                SPair<double> exhaustiveOffset;
+                double exhaustiveCoefficient = 0;
+                if (exhaustive.Correlate(reference, chip, CORRELATION_THRESHOLD, exhaustiveSuccess, exhaustiveOffset, exhaustiveCoefficient) != 0)
+                {
+                    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Correlate()");
+                    return 1;
+                }
+
+                for (unsigned long stride : getCoarseToFineStrides(bench))
+                {
+                    std::string params = getParams(chipSize, searchWindow, ECorrelationPrecision::HIGH) + " stride=" + toString(stride);
+                    CSubPixelCorrelator<float> correlator(SSize(chipSize), ECorrelationType::CCOEFF_NORM, ESubPixelCorrelationType::LEAST_SQUARE_SUB_PIXEL,
+                                                          ECorrelationPrecision::HIGH, false, stride);
+                    bool success = false;
+                    SPair<double> offset;
+                    double coefficient = 0;
+                    if (bench.Run(name, params, (double) searchSize.getProduct(), [&]()->int
+                        {
+                            return correlator.Correlate(reference, chip, CORRELATION_THRESHOLD, success, offset, coefficient);
+                        }) != 0)
+                    {
+                        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+                        return 1;
+                    }
+
+                    if (success != exhaustiveSuccess || (success && getAbs(offset.r - exhaustiveOffset.r) + getAbs(offset.c - exhaustiveOffset.c) > OFFSET_TOLERANCE))
+                    {
+                        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "'" + name + " " + params + "' found " +
+                                                    (success ? toString(offset) : "no peak") + " but the exhaustive search found " +
+                                                    (exhaustiveSuccess ? toString(exhaustiveOffset) : "no peak"));
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    name = "CSubPixelCorrelator.phase";
+    if (bench.isSelected(name))
+    {
+        for (unsigned long size : getPhaseSizes(bench))
+        {
+            CMatrix<float> scene = CBenchmarkData::CreateTexture(SSize(size + 8), seed);
+            CMatrix<float> reference = scene.getSubMatrix(SSize(0, 0), SSize(size));
+            CMatrix<float> chip = scene.getSubMatrix(SSize(3, 2), SSize(size));
+
+            CSubPixelCorrelator<float> correlator(SSize(size), ECorrelationType::PHASE, ESubPixelCorrelationType::PHASE_SUB_PIXEL);
+            if (bench.Run(name, "chip=" + toString(size), (double) (size * size), [&]()->int
+                {
+                    bool success = false;
+                    SPair<double> offset;
+                    double coefficient = 0;
+                    return correlator.Correlate(reference, chip, 0.0, success, offset, coefficient);
+                }) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Correlates the chips of a shifted scene with the full search window, builds the local shift
+ * priors from those GCPs and correlates the chips again around their priors, every GCP must be
+ * the one the full window found
+ */
+int RunShiftPriorBenchmarks(CBenchmark &bench)
+{
+    std::string name = "CParallelChipCorrelatorThread.shiftPriors";
+    if (!bench.isSelected(name))
+        return 0;
+
+    SSize sceneSize = bench.getOptions().quick ? SSize(256) : SSize(512);
+    CMatrix<float> scene = CBenchmarkData::CreateTexture(sceneSize, bench.getOptions().seed);
+    CMatrix<float> reference = CBenchmarkData::CreateShiftedImage(scene, SCENE_SHIFT, SCENE_SHIFT_AMPLITUDE);
+    CMatrix<SPair<double> > worldMatrix(sceneSize);
+    for (unsigned long r = 0; r < sceneSize.row; r++)
+    {
+        for (unsigned long c = 0; c < sceneSize.col; c++)
+            worldMatrix[r][c] = SPair<double>(r, c);
+    }
+
+    // the chips and their full search windows lie inside of the scene
+    CVector<CChip<float> > chips;
+    unsigned long margin = SHIFT_PRIOR_CHIP_SIZE + SHIFT_PRIOR_SEARCH_WINDOW;
+    for (unsigned long r = margin; r + margin < sceneSize.row; r += SHIFT_PRIOR_GRID_SIZE)
+    {
+        for (unsigned long c = margin; c + margin < sceneSize.col; c += SHIFT_PRIOR_GRID_SIZE)
+        {
+            CChip<float> chip;
+            chip.chipData = reference.getSubMatrix(SSize(r, c), SSize(SHIFT_PRIOR_CHIP_SIZE));
+            chip.chipId = chips.size();
+            chip.midCoordinate = SPair<double>(r + SHIFT_PRIOR_CHIP_SIZE / 2, c + SHIFT_PRIOR_CHIP_SIZE / 2);
+            chips.pushBack(chip);
+        }
+    }
+
+    std::function<int(const CVector<CChip<float> > &, CVector<SChipCorrelationResult> &) > correlate = [&](const CVector<CChip<float> > &input, CVector<SChipCorrelationResult> &results)->int
+    {
+        __ultra_internal::CParallelChipCorrelatorThread correlator(nullptr);
+        if (correlator.LoadData(&scene, &input, &results, &worldMatrix, SPair<double>(1, 1), SHIFT_PRIOR_SEARCH_WINDOW,
+                                (float) CORRELATION_THRESHOLD, ECorrelationType::CCOEFF_NORM, false, 0, false) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadData()");
+            return 1;
+        }
+        correlator.run();
+        return correlator.hasFailed() ? 1 : 0;
+    };
+
+    std::string params = "chip=" + toString(SHIFT_PRIOR_CHIP_SIZE) + " search=" + toString(SHIFT_PRIOR_SEARCH_WINDOW) + " chips=" + toString(chips.size());
+    CVector<SChipCorrelationResult> fullResults;
+    if (bench.Run(name, params + " priors=false", 0, [&]()->int
+        {
+            return correlate(chips, fullResults);
+        }) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+        return 1;
+    }
+
+    // the pyramid builds the priors on the coarser level, the same level keeps every GCP comparable
+    CGcpShiftPriors priors;
+    if (priors.Build(fullResults, SPair<double>(1, 1), SPair<double>(0, 0), SHIFT_PRIOR_RADIUS_IN_GRID_CELLS * SHIFT_PRIOR_GRID_SIZE, 1.0) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CGcpShiftPriors::Build()");
+        return 1;
+    }
+
+    CVector<CChip<float> > priorChips = chips;
+    unsigned long priorCount = 0;
+    for (unsigned long t = 0; t < priorChips.size(); t++)
+    {
+        if (priors.Apply(priorChips[t], SHIFT_PRIOR_SEARCH_WINDOW))
+            priorCount++;
+    }
+    if (priorCount == 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "'" + name + "' gave none of the '" + toString(chips.size()) + "' chips a prior");
+        return 1;
+    }
+
+    CVector<SChipCorrelationResult> priorResults;
+    if (bench.Run(name, params + " priors=true", 0, [&]()->int
+        {
+            return correlate(priorChips, priorResults);
+        }) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+        return 1;
+    }
+
+    if (priorResults.size() != fullResults.size())
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "'" + name + "' correlated '" + toString(priorResults.size()) + "' chips around their priors "
+                                    "and '" + toString(fullResults.size()) + "' with the full window");
+        return 1;
+    }
+
+    for (unsigned long t = 0; t < fullResults.size(); t++)
+    {
+        const SChipCorrelationResult &full = fullResults[t];
+        const SChipCorrelationResult &prior = priorResults[t];
+        SPair<double> difference = prior.newMidCoordinate - full.newMidCoordinate;
+        if (full.isGoodResult() != prior.isGoodResult() ||
+            (full.isGoodResult() && getAbs(difference.r) + getAbs(difference.c) > OFFSET_TOLERANCE))
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "'" + name + " " + params + "' chip '" + toString(t) + "' found " +
+                                        (prior.isGoodResult() ? toString(prior.newMidCoordinate) : "no GCP") + " around its prior but the full window found " +
+                                        (full.isGoodResult() ? toString(full.newMidCoordinate) : "no GCP"));
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace
+
+int RunCorrelationBenchmarks(CBenchmark &bench)
+{
+    if (RunCoefNormBenchmarks(bench, false) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunCoefNormBenchmarks()");
+        return 1;
+    }
+    if (RunCoefNormBenchmarks(bench, true) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunCoefNormBenchmarks()");
+        return 1;
+    }
+    if (RunPhaseBenchmarks(bench) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunPhaseBenchmarks()");
+        return 1;
+    }
+    if (RunFftBenchmarks(bench) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunFftBenchmarks()");
+        return 1;
+    }
+    if (RunSubPixelBenchmarks(bench) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunSubPixelBenchmarks()");
+        return 1;
+    }
+    if (RunShiftPriorBenchmarks(bench) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunShiftPriorBenchmarks()");
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace ultra
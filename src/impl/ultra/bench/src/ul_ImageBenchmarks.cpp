@@ -0,0 +1,162 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "ul_Benchmark.h"
+#include "ul_BenchmarkData.h"
+
+#include <ul_Logger.h>
+#include <ul_Utility.h>
+#include <ul_Resampler.h>
+#include <ul_ConvKernelToImage.h>
+#include <ul_CreateConvKernel.h>
+#include <ul_IntegralMatrix.h>
+
+namespace ultra
+{
+
+namespace
+{
+
+const float NO_DATA_VALUE = -9999;
+const double NO_DATA_FRACTION = 0.02;
+
+std::vector<unsigned long> getImageSizes(const CBenchmark &bench)
+{
+    if (bench.getOptions().quick)
+        return std::vector<unsigned long>{256};
+    return std::vector<unsigned long>{256, 1024};
+}
+
+int RunResamplerBenchmarks(CBenchmark &bench)
+{
+    struct SResampler
+    {
+        const char *name;
+        EResamplerEnum::EResampleType type;
+    };
+    const SResampler resamplers[] = {
+        {"CResampler.NN", EResamplerEnum::RESAMPLE_TYPE_NN},
+        {"CResampler.BI", EResamplerEnum::RESAMPLE_TYPE_BI},
+        {"CResampler.CI", EResamplerEnum::RESAMPLE_TYPE_CI}
+    };
+
+    unsigned int seed = bench.getOptions().seed;
+    for (const SResampler &resampler : resamplers)
+    {
+        if (!bench.isSelected(resampler.name))
+            continue;
+        for (unsigned long size : getImageSizes(bench))
+        {
+            CMatrix<float> input = CBenchmarkData::CreateTexture(SSize(size), seed);
+            CMatrix<SPair<float> > map = CBenchmarkData::CreateAffineMap(SSize(size), SSize(size));
+            CMatrix<float> output;
+            EResamplerEnum::EResampleType type = resampler.type;
+            if (bench.Run(resampler.name, "size=" + toString(size), (double) (size * size), [&]()->int
+                {
+                    return CResampler<false>::Resample<float, float>(input, output, map, type, &NO_DATA_VALUE, &NO_DATA_VALUE);
+                }) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int RunConvolveBenchmarks(CBenchmark &bench)
+{
+    std::string name = "CConvKernelToImage::Convolve";
+    if (!bench.isSelected(name))
+        return 0;
+
+    std::vector<unsigned long> kernelSizes = bench.getOptions().quick ? std::vector<unsigned long>{7} : std::vector<unsigned long>{3, 7, 15};
+    unsigned int seed = bench.getOptions().seed;
+    for (unsigned long size : getImageSizes(bench))
+    {
+        CMatrix<float> input = CBenchmarkData::CreateTexture(SSize(size), seed);
+        CMatrix<float> output;
+        for (unsigned long kernelSize : kernelSizes)
+        {
+            CConvKernel<float> kernel = CCreateConvKernel::getKernel<float>(EKernelTypes::GAUSSIAN, SSize(kernelSize), kernelSize / 4.0f);
+            if (bench.Run(name, "size=" + toString(size) + " kernel=" + toString(kernelSize), (double) (size * size), [&]()->int
+                {
+                    return CConvKernelToImage::Convolve<float>(input, kernel, output);
+                }) != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int RunIntegralMatrixBenchmarks(CBenchmark &bench)
+{
+    unsigned int seed = bench.getOptions().seed;
+    for (unsigned long size : getImageSizes(bench))
+    {
+        CMatrix<float> input = CBenchmarkData::CreateTexture(SSize(size), seed);
+        if (bench.Run("CIntegralMatrix", "size=" + toString(size), (double) (size * size), [&]()->int
+            {
+                CIntegralMatrix integral = CIntegralMatrix::createIntegralMatrix<float>(input);
+                return 0;
+            }) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+            return 1;
+        }
+
+        CMatrix<float> inputNoData = input;
+        CBenchmarkData::AddNoData(inputNoData, NO_DATA_FRACTION, NO_DATA_VALUE, seed + 1);
+        if (bench.Run("CIntegralMatrix.noData", "size=" + toString(size), (double) (size * size), [&]()->int
+            {
+                CIntegralMatrix integral = CIntegralMatrix::createIntegralMatrix<float>(inputNoData, NO_DATA_VALUE);
+                return 0;
+            }) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CBenchmark::Run()");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int RunImageBenchmarks(CBenchmark &bench)
+{
+    if (RunResamplerBenchmarks(bench) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunResamplerBenchmarks()");
+        return 1;
+    }
+    if (RunConvolveBenchmarks(bench) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunConvolveBenchmarks()");
+        return 1;
+    }
+    if (RunIntegralMatrixBenchmarks(bench) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RunIntegralMatrixBenchmarks()");
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace ultra
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include "ul_Int_AtomicType.h"
 
 namespace ultra
@@ -24,13 +25,16 @@ namespace ultra
 class CAtomicBool : public IAtomicType
 {
 private:
-    bool m_val;
+    std::atomic<bool> m_val;
 public:
 
     CAtomicBool(bool val);
     CAtomicBool();
+    CAtomicBool(const CAtomicBool &r);
     virtual ~CAtomicBool();
 
+    CAtomicBool &operator=(const CAtomicBool &r);
+
     void set(bool val);
     bool get() const;
     bool getAndSet(bool val);
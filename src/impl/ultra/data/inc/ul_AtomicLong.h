@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include "ul_Int_AtomicType.h"
 
 namespace ultra
@@ -24,13 +25,16 @@ namespace ultra
 class CAtomicLong : public IAtomicType
 {
 private:
-    long m_val;
+    std::atomic<long> m_val;
 public:
 
     CAtomicLong(long val);
     CAtomicLong();
+    CAtomicLong(const CAtomicLong &r);
     virtual ~CAtomicLong();
 
+    CAtomicLong &operator=(const CAtomicLong &r);
+
     void set(long val);
     void inc();
     void dec();
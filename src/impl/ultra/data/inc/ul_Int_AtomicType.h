@@ -16,19 +16,19 @@
 
 #pragma once
 
-#include <memory>
-
 namespace ultra
 {
 
+/**
+ * Base of the lock-free atomic types, implementations are backed by std::atomic
+ * <br>
+ * Stores use release and loads use acquire ordering, read-modify-write operations
+ * use acquire-release ordering, so a value published through an atomic type makes
+ * the writes done before it visible to the thread that reads it.
+ */
 class IAtomicType
 {
-private:
-
-    std::shared_ptr<void> m_lock;
-
 protected:
-    std::shared_ptr<void> getLock() const;
     IAtomicType();
 public:
     virtual ~IAtomicType();
@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <vector>
+#include <functional>
+#include <type_traits>
+
 #include "ul_SmartVector.h"
 #include "ul_KeyValue.h"
 #include "ul_Exception.h"
@@ -23,11 +27,126 @@
 namespace ultra
 {
 
+namespace __ultra_internal
+{
+
+/**
+ * std::hash for enumerations is only guaranteed from C++14, hash their underlying type
+ */
+template<class K, bool isEnum = std::is_enum<K>::value>
+struct SMapHash
+{
+
+    size_t operator()(const K &k) const
+    {
+        return std::hash<K>()(k);
+    }
+};
+
+template<class K>
+struct SMapHash<K, true>
+{
+
+    size_t operator()(const K &k) const
+    {
+        typedef typename std::underlying_type<K>::type U;
+        return std::hash<U>()(static_cast<U> (k));
+    }
+};
+
+} // namespace __ultra_internal
+
+/**
+ * Key/value pairs kept in insertion order, with an open addressing (linear probing)
+ * hash index on the keys for constant time lookups.
+ * <br>
+ * Keys must not be modified through the iterators, the index would go stale.
+ */
 template<class K, class V>
 class CMap
 {
 private:
+    static const long EMPTY_SLOT = -1;
+
     CSmartVector<SKeyValue<K, V> > m_map;
+    // slot -> position in m_map, the amount of slots is a power of two and at least twice the size
+    std::vector<long> m_index;
+
+    static size_t hashKey(const K &k)
+    {
+        return __ultra_internal::SMapHash<K>()(k);
+    }
+
+    /**
+     * @return the slot holding <code>k</code> or the empty slot where it would be inserted
+     */
+    unsigned long findSlot(const K &k) const
+    {
+        unsigned long mask = m_index.size() - 1;
+        unsigned long slot = hashKey(k) & mask;
+        while (m_index[slot] != EMPTY_SLOT && !(m_map[m_index[slot]].k == k))
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    long findPosition(const K &k) const
+    {
+        if (m_index.size() == 0)
+            return EMPTY_SLOT;
+        return m_index[findSlot(k)];
+    }
+
+    /**
+     * Rebuilds the index from scratch, if a key is present more than once
+     * only its first occurrence is indexed
+     */
+    void rebuildIndex()
+    {
+        unsigned long s = size();
+        unsigned long slots = 0;
+        if (s > 0)
+        {
+            slots = 8;
+            while (slots < s * 2)
+                slots *= 2;
+        }
+        m_index.assign(slots, EMPTY_SLOT);
+        for (unsigned long t = 0; t < s; t++)
+        {
+            unsigned long slot = findSlot(m_map[t].k);
+            if (m_index[slot] == EMPTY_SLOT)
+                m_index[slot] = (long) t;
+        }
+    }
+
+    /**
+     * Grows the index if another key would push it past half full
+     */
+    void reserveSlot()
+    {
+        if (m_index.size() == 0 || (size() + 1) * 2 > m_index.size())
+        {
+            unsigned long slots = m_index.size() == 0 ? 8 : m_index.size() * 2;
+            m_index.assign(slots, EMPTY_SLOT);
+            unsigned long s = size();
+            for (unsigned long t = 0; t < s; t++)
+                m_index[findSlot(m_map[t].k)] = (long) t;
+        }
+    }
+
+    template<class KK, class VV>
+    void innerPut(KK &&k, VV &&v)
+    {
+        reserveSlot();
+        unsigned long slot = findSlot(k);
+        if (m_index[slot] != EMPTY_SLOT)
+        {
+            m_map[m_index[slot]].v = std::forward<VV>(v);
+            return;
+        }
+        m_index[slot] = (long) size();
+        m_map.pushBack(SKeyValue<K, V>(std::forward<KK>(k), std::forward<VV>(v)));
+    }
 
 public:
 
@@ -37,28 +156,34 @@ public:
     }
 
     CMap(const CMap<K, V> &r) :
-    m_map(r.m_map)
+    m_map(r.m_map),
+    m_index(r.m_index)
     {
     }
 
     CMap(CMap<K, V> &&r) :
-    m_map(std::move(r.m_map))
+    m_map(std::move(r.m_map)),
+    m_index(std::move(r.m_index))
     {
+        r.m_index.clear();
     }
 
     CMap(const CVector<SKeyValue<K, V> > &r) :
     m_map(r)
     {
+        rebuildIndex();
     }
 
     CMap(const std::initializer_list<SKeyValue<K, V> > &l) :
     m_map(l)
     {
+        rebuildIndex();
     }
 
     CMap(CSmartVector<SKeyValue<K, V> > &&r) :
     m_map(std::move(r))
     {
+        rebuildIndex();
     }
 
     bool operator==(const CMap<K, V> &r) const
@@ -67,9 +192,10 @@ public:
             return false;
         for (const auto &kv : * this)
         {
-            if (!r.contains(kv.k))
+            const V *rv = r.getPtr(kv.k);
+            if (rv == nullptr)
                 return false;
-            if (kv.v != r.get(kv.k))
+            if (kv.v != *rv)
                 return false;
         }
         return true;
@@ -85,6 +211,7 @@ public:
         if (this == &r)
             return *this;
         m_map = r.m_map;
+        m_index = r.m_index;
         return *this;
     }
 
@@ -93,14 +220,15 @@ public:
         if (this == &r)
             return *this;
         m_map = std::move(r.m_map);
+        m_index = std::move(r.m_index);
+        r.m_index.clear();
         return *this;
     }
 
     CMap<K, V> &operator=(const CVector<SKeyValue<K, V> > &r)
     {
-        if (&m_map == &r)
-            return *this;
         m_map = r;
+        rebuildIndex();
         return *this;
     }
 
@@ -109,6 +237,7 @@ public:
         if (&m_map == &r)
             return *this;
         m_map = r;
+        rebuildIndex();
         return *this;
     }
 
@@ -117,6 +246,7 @@ public:
         if (&m_map == &r)
             return *this;
         m_map = std::move(r);
+        rebuildIndex();
         return *this;
     }
 
@@ -128,6 +258,7 @@ public:
     void clear()
     {
         m_map.clear();
+        m_index.clear();
     }
 
     /**
@@ -137,6 +268,7 @@ public:
     void reset()
     {
         m_map.reset();
+        m_index.assign(m_index.size(), EMPTY_SLOT);
     }
 
     void putAll(const CMap<K, V> &map)
@@ -149,7 +281,7 @@ public:
 
     void putAll(CMap<K, V> &&map)
     {
-        for (const auto &kv : map)
+        for (auto &kv : map)
         {
             put(std::move(kv.k), std::move(kv.v));
         }
@@ -158,61 +290,38 @@ public:
 
     void put(const K &k, const V &v)
     {
-        if (contains(k))
-            get(k) = v;
-        else
-            m_map.pushBack(SKeyValue<K, V>(k, v));
+        innerPut(k, v);
     }
 
     void put(const K &k, V &&v)
     {
-        if (contains(k))
-            get(k) = std::move(v);
-        else
-            m_map.pushBack(SKeyValue<K, V>(k, std::move(v)));
+        innerPut(k, std::move(v));
     }
 
     void put(K &&k, const V &v)
     {
-        if (contains(k))
-            get(k) = v;
-        else
-            m_map.pushBack(SKeyValue<K, V>(std::move(k), v));
+        innerPut(std::move(k), v);
     }
 
     void put(K &&k, V &&v)
     {
-        if (contains(k))
-            get(k) = std::move(v);
-        else
-            m_map.pushBack(std::move(SKeyValue<K, V>(std::move(k), std::move(v))));
+        innerPut(std::move(k), std::move(v));
     }
 
     void remove(const K &k)
     {
-        if (!contains(k))
+        long position = findPosition(k);
+        if (position == EMPTY_SLOT)
             return;
 
-        unsigned long s = size();
-        for (unsigned long t = 0; t < s; t++)
-        {
-            if (m_map[t].k == k)
-            {
-                m_map.remove(t);
-                break;
-            }
-        }
+        // keeps the insertion order, so the positions after the removed item shift down
+        m_map.remove(position);
+        rebuildIndex();
     }
 
     bool contains(const K &k) const
     {
-        unsigned long s = size();
-        for (unsigned long t = 0; t < s; t++)
-        {
-            if (m_map[t].k == k)
-                return true;
-        }
-        return false;
+        return findPosition(k) != EMPTY_SLOT;
     }
 
     unsigned long size() const
@@ -245,57 +354,39 @@ public:
     const V& getOrDefault(const K &k, const V &defaultValue) const
     {
         const V *p = getPtr(k);
-        return 0 == nullptr ? defaultValue : *p;
-    }
-
-    V &getOrDefault(const K &k, const V &defaultValue)
-    {
-        V *p = getPtr(k);
-        return 0 == nullptr ? defaultValue : *p;
+        return p == nullptr ? defaultValue : *p;
     }
 
     const V* getPtr(const K &k) const
     {
-        unsigned long s = size();
-        for (unsigned long t = 0; t < s; t++)
-        {
-            if (m_map[t].k == k)
-                return &m_map[t].v;
-        }
-        return nullptr;
+        long position = findPosition(k);
+        if (position == EMPTY_SLOT)
+            return nullptr;
+        return &m_map[position].v;
     }
 
     V* getPtr(const K &k)
     {
-        unsigned long s = size();
-        for (unsigned long t = 0; t < s; t++)
-        {
-            if (m_map[t].k == k)
-                return &m_map[t].v;
-        }
-        return nullptr;
+        long position = findPosition(k);
+        if (position == EMPTY_SLOT)
+            return nullptr;
+        return &m_map[position].v;
     }
 
     V& get(const K &k)
     {
-        unsigned long s = size();
-        for (unsigned long t = 0; t < s; t++)
-        {
-            if (m_map[t].k == k)
-                return m_map[t].v;
-        }
-        throw CException(__FILE__, __LINE__, "Key '" + toString(k) + "' does not exist in the map");
+        V *p = getPtr(k);
+        if (p == nullptr)
+            throw CException(__FILE__, __LINE__, "Key '" + toString(k) + "' does not exist in the map");
+        return *p;
     }
 
     const V& get(const K &k) const
     {
-        unsigned long s = size();
-        for (unsigned long t = 0; t < s; t++)
-        {
-            if (m_map[t].k == k)
-                return m_map[t].v;
-        }
-        throw CException(__FILE__, __LINE__, "Key '" + toString(k) + "' does not exist in the map");
+        const V *p = getPtr(k);
+        if (p == nullptr)
+            throw CException(__FILE__, __LINE__, "Key '" + toString(k) + "' does not exist in the map");
+        return *p;
     }
 
     const SKeyValue<K, V> *begin() const
@@ -330,6 +421,7 @@ public:
     {
         CMap<K, V> result(*this);
         result.m_map = result.m_map.sort(func);
+        result.rebuildIndex();
         return result;
     }
 
@@ -345,4 +437,7 @@ public:
     }
 };
 
+template<class K, class V>
+const long CMap<K, V>::EMPTY_SLOT;
+
 } // namespace ultra
@@ -276,6 +276,14 @@ public:
         return *this;
     }
 
+    CMatrix<T> &operator=(CMatrix<T> &&r)
+    {
+        if (this == &r)
+            return *this;
+        m_mat = std::move(r.m_mat);
+        return *this;
+    }
+
     virtual CMatrix<T> &operator=(const std::initializer_list<std::initializer_list<T> > &l)
     {
         if (m_mat.size() != l.size())
@@ -551,6 +559,32 @@ public:
         return ret;
     }
 
+    /**
+     * Copies a sub matrix into output, output is only reallocated if its size differs
+     * @return 0 on success, 1 if the sub matrix is out of bounds
+     */
+    int getSubMatrix(const SSize &ulPoint, const SSize &size, CMatrix<T> &output) const
+    {
+        SSize s = getSize();
+        SSize p = SSize(ulPoint.row + size.row, ulPoint.col + size.col);
+        if (ulPoint.col > s.col ||
+                ulPoint.row > s.row ||
+                p.col > s.col ||
+                p.row > s.row ||
+                &output == this)
+            return 1;
+
+        output.resize(size);
+        unsigned long counter = 0;
+        for (unsigned long r = ulPoint.row; r < p.row; r++, counter++)
+        {
+            if (memcpy(&output[counter][0], &m_mat[r][ulPoint.col], sizeof (T) * size.col) != &output[counter][0])
+                return 1;
+        }
+
+        return 0;
+    }
+
     CMatrix<T> getSubMatrixEqualsCopy(const SSize &ULPoint, const SSize &size) const
     {
         CMatrix<T> ret;
@@ -1187,7 +1221,7 @@ public:
 
                 if (!swapped)
                 {
-                    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Upper triangular matrix has a Zero at row '" + toString(c) + "'");
+                    ULTRA_LOG(CLogger::LOG_DEBUG, "Upper triangular matrix has a Zero at row '" + toString(c) + "'");
                     continue;
                 }
             }
@@ -0,0 +1,137 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include <new>
+#include <vector>
+
+namespace ultra
+{
+
+/**
+ * Bump allocator for short lived scratch buffers.
+ * <br>
+ * Allocations are carved out of large blocks and are never freed individually, the
+ * arena is rewound to a marker (or reset) once the buffers are no longer needed.
+ * When the arena is reset after having spilled into more than one block, the blocks
+ * are replaced by a single block that holds the high water mark, so a workload that
+ * repeats the same allocations stops calling into the heap after its first iteration.
+ * <br>
+ * Objects are default constructed but never destructed, only use types whose
+ * destructor does nothing. An arena must only be used by a single thread, use
+ * <code>getThreadInstance()</code> for the arena of the calling thread.
+ */
+class CScratchArena
+{
+public:
+    static const unsigned long DEFAULT_BLOCK_SIZE;
+    static const unsigned long ALIGNMENT;
+
+    struct SMarker
+    {
+        unsigned long block;
+        unsigned long offset;
+        unsigned long used;
+    };
+
+private:
+
+    struct SBlock
+    {
+        char *memory;
+        char *data;
+        unsigned long size;
+    };
+
+    const unsigned long m_blockSize;
+    std::vector<SBlock> m_blocks;
+    unsigned long m_block;
+    unsigned long m_offset;
+    unsigned long m_used;
+    unsigned long m_highWaterMark;
+    unsigned long m_blockAllocations;
+
+    void addBlock(unsigned long minSize);
+    void releaseBlocks();
+    void *allocateBytes(unsigned long bytes);
+
+public:
+    CScratchArena(unsigned long blockSize = CScratchArena::DEFAULT_BLOCK_SIZE);
+    ~CScratchArena();
+    CScratchArena(const CScratchArena &) = delete;
+    CScratchArena &operator=(const CScratchArena &) = delete;
+
+    /**
+     * @return the arena of the calling thread, it lives until the thread exits
+     */
+    static CScratchArena *getThreadInstance();
+
+    /**
+     * @param count
+     * @return <code>count</code> default constructed objects, aligned to <code>ALIGNMENT</code>
+     */
+    template<class T>
+    T *allocate(unsigned long count)
+    {
+        T *ret = static_cast<T *> (allocateBytes(count * sizeof (T)));
+        for (unsigned long t = 0; t < count; t++)
+            new (ret + t) T;
+        return ret;
+    }
+
+    SMarker getMarker() const;
+
+    /**
+     * Releases everything allocated after the marker was taken, rewinding to an
+     * empty arena is a <code>reset()</code>
+     */
+    void rewind(const SMarker &marker);
+    void reset();
+
+    /**
+     * @return the bytes currently held in blocks
+     */
+    unsigned long getCapacity() const;
+    /**
+     * @return the most bytes that were in use at once
+     */
+    unsigned long getHighWaterMark() const;
+    /**
+     * @return the amount of blocks that were allocated from the heap
+     */
+    unsigned long getBlockAllocations() const;
+};
+
+/**
+ * Rewinds an arena to where it was when the scope was entered
+ */
+class CScratchArenaScope
+{
+private:
+    CScratchArena *m_arena;
+    CScratchArena::SMarker m_marker;
+public:
+    CScratchArenaScope(CScratchArena *arena = CScratchArena::getThreadInstance());
+    ~CScratchArenaScope();
+    CScratchArenaScope(const CScratchArenaScope &) = delete;
+    CScratchArenaScope &operator=(const CScratchArenaScope &) = delete;
+
+    CScratchArena *getArena() const;
+};
+
+} // namespace ultra
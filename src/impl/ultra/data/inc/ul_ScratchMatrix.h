@@ -0,0 +1,131 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#pragma once
+
+#include "ul_Matrix.h"
+#include "ul_ScratchArena.h"
+
+namespace ultra
+{
+
+/**
+ * A row major matrix that lives in a <code>CScratchArena</code>.
+ * <br>
+ * The matrix does not own its memory, it is only valid until the arena is rewound
+ * past the point where it was allocated. Copying a scratch matrix copies the view,
+ * not the data. <code>getView()</code> returns a window of a matrix that shares its rows.
+ */
+template<class T>
+class CScratchMatrix
+{
+private:
+    T *m_data;
+    SSize m_size;
+    unsigned long m_stride;
+public:
+
+    CScratchMatrix() :
+    m_data(nullptr),
+    m_size(0, 0),
+    m_stride(0)
+    {
+    }
+
+    CScratchMatrix(CScratchArena *arena, const SSize &size) :
+    m_data(arena->allocate<T>(size.getProduct())),
+    m_size(size),
+    m_stride(size.col)
+    {
+    }
+
+    /**
+     * @param ul
+     * @param size
+     * @return a view of the window at ul, writes through the view change this matrix
+     */
+    CScratchMatrix<T> getView(const SSize &ul, const SSize &size) const
+    {
+        if (ul.row + size.row > m_size.row || ul.col + size.col > m_size.col)
+            throw CException(__FILE__, __LINE__, "View of size " + toString(size) + " at " + toString(ul) + " is outside of a scratch matrix of size " + toString(m_size));
+        CScratchMatrix<T> ret;
+        ret.m_data = m_data + ul.row * m_stride + ul.col;
+        ret.m_size = size;
+        ret.m_stride = m_stride;
+        return ret;
+    }
+
+    SSize getSize() const
+    {
+        return m_size;
+    }
+
+    T *getDataPointer()
+    {
+        return m_data;
+    }
+
+    const T *getDataPointer() const
+    {
+        return m_data;
+    }
+
+    T *operator[](unsigned long row)
+    {
+        return m_data + row * m_stride;
+    }
+
+    const T *operator[](unsigned long row) const
+    {
+        return m_data + row * m_stride;
+    }
+
+    /**
+     * Converts a matrix of the same size into this one
+     * @param r
+     * @param fp the conversion applied to every element
+     */
+    template<class N, class FP>
+    void assign(const CMatrix<N> &r, const FP &fp)
+    {
+        if (r.getSize() != m_size)
+            throw CException(__FILE__, __LINE__, "Cannot assign a matrix of size " + toString(r.getSize()) + " to a scratch matrix of size " + toString(m_size));
+        for (unsigned long row = 0; row < m_size.row; row++)
+        {
+            const N *src = r[row].getDataPointer();
+            T *des = (*this)[row];
+            for (unsigned long col = 0; col < m_size.col; col++)
+                des[col] = fp(src[col]);
+        }
+    }
+
+    bool contains(const T &val) const
+    {
+        for (unsigned long row = 0; row < m_size.row; row++)
+        {
+            const T *dp = (*this)[row];
+            for (unsigned long col = 0; col < m_size.col; col++)
+            {
+                if (dp[col] == val)
+                    return true;
+            }
+        }
+        return false;
+    }
+};
+
+} // namespace ultra
@@ -360,6 +360,18 @@ public:
         m_vec.growTo(cap);
     }
 
+    CSmartVector<T> &remove(unsigned long index)
+    {
+        if (index >= m_size)
+        {
+            throw CException(__FILE__, __LINE__, "Index is out of bounds");
+        }
+        for (unsigned long t = index + 1; t < m_size; t++)
+            m_vec[t - 1] = std::move(m_vec[t]);
+        m_size--;
+        return *this;
+    }
+
     CSmartVector<T> &pop(unsigned long index, T &val)
     {
         if (index >= m_size)
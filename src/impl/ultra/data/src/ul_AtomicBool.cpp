@@ -15,43 +15,50 @@
 */
 
 #include "ul_AtomicBool.h"
-#include <ul_UltraThread.h>
 
 namespace ultra
 {
 
-CAtomicBool::CAtomicBool(bool val) : IAtomicType()
+CAtomicBool::CAtomicBool(bool val) : IAtomicType(),
+m_val(val)
 {
-    m_val = val;
 }
 
-CAtomicBool::CAtomicBool() : IAtomicType()
+CAtomicBool::CAtomicBool() : IAtomicType(),
+m_val(true)
+{
+}
+
+CAtomicBool::CAtomicBool(const CAtomicBool &r) : IAtomicType(),
+m_val(r.get())
 {
-    m_val = true;
 }
 
 CAtomicBool::~CAtomicBool()
 {
 }
 
+CAtomicBool &CAtomicBool::operator=(const CAtomicBool &r)
+{
+    if (this == &r)
+        return *this;
+    set(r.get());
+    return *this;
+}
+
 void CAtomicBool::set(bool val)
 {
-    AUTO_LOCK(getLock());
-    m_val = val;
+    m_val.store(val, std::memory_order_release);
 }
 
 bool CAtomicBool::get() const
 {
-    AUTO_LOCK(getLock());
-    return m_val;
+    return m_val.load(std::memory_order_acquire);
 }
 
 bool CAtomicBool::getAndSet(bool val)
 {
-    AUTO_LOCK(getLock());
-    bool ret = m_val;
-    m_val = val;
-    return ret;
+    return m_val.exchange(val, std::memory_order_acq_rel);
 }
 
 } // namespace ultra
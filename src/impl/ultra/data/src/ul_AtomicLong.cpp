@@ -15,122 +15,117 @@
 */
 
 #include "ul_AtomicLong.h"
-#include <ul_UltraThread.h>
 
 namespace ultra
 {
 
-CAtomicLong::CAtomicLong(long val) : IAtomicType()
+CAtomicLong::CAtomicLong(long val) : IAtomicType(),
+m_val(val)
 {
-    m_val = val;
 }
 
-CAtomicLong::CAtomicLong() : IAtomicType()
+CAtomicLong::CAtomicLong() : IAtomicType(),
+m_val(0)
+{
+}
+
+CAtomicLong::CAtomicLong(const CAtomicLong &r) : IAtomicType(),
+m_val(r.get())
 {
-    m_val = 0;
 }
 
 CAtomicLong::~CAtomicLong()
 {
 }
 
+CAtomicLong &CAtomicLong::operator=(const CAtomicLong &r)
+{
+    if (this == &r)
+        return *this;
+    set(r.get());
+    return *this;
+}
+
 void CAtomicLong::set(long val)
 {
-    AUTO_LOCK(getLock());
-    m_val = val;
+    m_val.store(val, std::memory_order_release);
 }
 
 void CAtomicLong::inc()
 {
-    AUTO_LOCK(getLock());
-    m_val++;
+    m_val.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void CAtomicLong::mul(long val)
 {
-    AUTO_LOCK(getLock());
-    m_val *= val;
+    // there is no atomic multiply, retry until no other thread changed the value in between
+    long expected = m_val.load(std::memory_order_relaxed);
+    while (!m_val.compare_exchange_weak(expected, expected * val, std::memory_order_acq_rel, std::memory_order_relaxed))
+    {
+    }
 }
 
 void CAtomicLong::div(long val)
 {
-    AUTO_LOCK(getLock());
-    m_val /= val;
+    long expected = m_val.load(std::memory_order_relaxed);
+    while (!m_val.compare_exchange_weak(expected, expected / val, std::memory_order_acq_rel, std::memory_order_relaxed))
+    {
+    }
 }
 
 void CAtomicLong::add(long val)
 {
-    AUTO_LOCK(getLock());
-    m_val += val;
+    m_val.fetch_add(val, std::memory_order_acq_rel);
 }
 
 void CAtomicLong::sub(long val)
 {
-    AUTO_LOCK(getLock());
-    m_val -= val;
+    m_val.fetch_sub(val, std::memory_order_acq_rel);
 }
 
 void CAtomicLong::dec()
 {
-    AUTO_LOCK(getLock());
-    m_val--;
+    m_val.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 long CAtomicLong::get() const
 {
-    AUTO_LOCK(getLock());
-    return m_val;
+    return m_val.load(std::memory_order_acquire);
 }
 
 long CAtomicLong::getAndSet(long val)
 {
-    AUTO_LOCK(getLock());
-    long ret = m_val;
-    m_val = val;
-    return ret;
+    return m_val.exchange(val, std::memory_order_acq_rel);
 }
 
 long CAtomicLong::getAndInc()
 {
-    AUTO_LOCK(getLock());
-    long ret = m_val;
-    m_val++;
-    return ret;
+    return m_val.fetch_add(1, std::memory_order_acq_rel);
 }
 
 long CAtomicLong::getAndDec()
 {
-    AUTO_LOCK(getLock());
-    long ret = m_val;
-    m_val--;
-    return ret;
+    return m_val.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 long CAtomicLong::incAndGet()
 {
-    AUTO_LOCK(getLock());
-    return (++m_val);
+    return m_val.fetch_add(1, std::memory_order_acq_rel) + 1;
 }
 
 long CAtomicLong::decAndGet()
 {
-    AUTO_LOCK(getLock());
-    return (--m_val);
+    return m_val.fetch_sub(1, std::memory_order_acq_rel) - 1;
 }
 
 long CAtomicLong::addAndGet(long val)
 {
-    AUTO_LOCK(getLock());
-    m_val += val;
-    return m_val;
+    return m_val.fetch_add(val, std::memory_order_acq_rel) + val;
 }
 
 long CAtomicLong::getAndAdd(long val)
 {
-    AUTO_LOCK(getLock());
-    long ret = m_val;
-    m_val += val;
-    return ret;
+    return m_val.fetch_add(val, std::memory_order_acq_rel);
 }
 
 } // namespace ultra
@@ -16,14 +16,10 @@
 
 #include "ul_Int_AtomicType.h"
 
-#include "ul_Logger.h"
-#include "ul_UltraThread.h"
-
 namespace ultra
 {
 
-IAtomicType::IAtomicType() :
-m_lock(new CThreadLock(), std::default_delete<CThreadLock>())
+IAtomicType::IAtomicType()
 {
 }
 
@@ -31,9 +27,4 @@ IAtomicType::~IAtomicType()
 {
 }
 
-std::shared_ptr<void> IAtomicType::getLock() const
-{
-    return m_lock;
-}
-
 } // namespace ultra
@@ -0,0 +1,169 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "ul_ScratchArena.h"
+
+#include <stdlib.h>
+
+#include <ul_Utility.h>
+#include <ul_Exception.h>
+
+namespace ultra
+{
+
+const unsigned long CScratchArena::DEFAULT_BLOCK_SIZE = 1024 * 1024;
+const unsigned long CScratchArena::ALIGNMENT = 64;
+
+CScratchArena::CScratchArena(unsigned long blockSize) :
+m_blockSize(blockSize > 0 ? blockSize : CScratchArena::DEFAULT_BLOCK_SIZE)
+{
+    m_block = 0;
+    m_offset = 0;
+    m_used = 0;
+    m_highWaterMark = 0;
+    m_blockAllocations = 0;
+}
+
+CScratchArena::~CScratchArena()
+{
+    releaseBlocks();
+}
+
+CScratchArena *CScratchArena::getThreadInstance()
+{
+    static thread_local CScratchArena arena;
+    return &arena;
+}
+
+void CScratchArena::addBlock(unsigned long minSize)
+{
+    SBlock block;
+    block.size = minSize > m_blockSize ? minSize : m_blockSize;
+    block.memory = static_cast<char *> (malloc(block.size + ALIGNMENT));
+    if (block.memory == nullptr)
+        throw CException(__FILE__, __LINE__, "Failed to allocate a scratch arena block of '" + toString(block.size) + "' bytes");
+    unsigned long misalignment = reinterpret_cast<unsigned long> (block.memory) % ALIGNMENT;
+    block.data = block.memory + (misalignment == 0 ? 0 : ALIGNMENT - misalignment);
+    m_blocks.push_back(block);
+    m_blockAllocations++;
+}
+
+void CScratchArena::releaseBlocks()
+{
+    for (unsigned long t = 0; t < m_blocks.size(); t++)
+        free(m_blocks[t].memory);
+    m_blocks.clear();
+    m_block = 0;
+    m_offset = 0;
+    m_used = 0;
+}
+
+void *CScratchArena::allocateBytes(unsigned long bytes)
+{
+    // rounding every allocation keeps all offsets aligned
+    bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    if (bytes == 0)
+        bytes = ALIGNMENT;
+
+    while (m_block < m_blocks.size() && m_offset + bytes > m_blocks[m_block].size)
+    {
+        m_block++;
+        m_offset = 0;
+    }
+    if (m_block == m_blocks.size())
+    {
+        addBlock(bytes);
+        m_offset = 0;
+    }
+
+    void *ret = m_blocks[m_block].data + m_offset;
+    m_offset += bytes;
+    m_used += bytes;
+    if (m_used > m_highWaterMark)
+        m_highWaterMark = m_used;
+    return ret;
+}
+
+CScratchArena::SMarker CScratchArena::getMarker() const
+{
+    SMarker marker;
+    marker.block = m_block;
+    marker.offset = m_offset;
+    marker.used = m_used;
+    return marker;
+}
+
+void CScratchArena::rewind(const SMarker &marker)
+{
+    if (marker.used == 0)
+    {
+        reset();
+        return;
+    }
+    m_block = marker.block;
+    m_offset = marker.offset;
+    m_used = marker.used;
+}
+
+void CScratchArena::reset()
+{
+    if (m_blocks.size() > 1)
+    {
+        // the tail of every block but the last may be unused, the high water mark is what one block needs
+        releaseBlocks();
+        addBlock(m_highWaterMark);
+    }
+    m_block = 0;
+    m_offset = 0;
+    m_used = 0;
+}
+
+unsigned long CScratchArena::getCapacity() const
+{
+    unsigned long capacity = 0;
+    for (unsigned long t = 0; t < m_blocks.size(); t++)
+        capacity += m_blocks[t].size;
+    return capacity;
+}
+
+unsigned long CScratchArena::getHighWaterMark() const
+{
+    return m_highWaterMark;
+}
+
+unsigned long CScratchArena::getBlockAllocations() const
+{
+    return m_blockAllocations;
+}
+
+CScratchArenaScope::CScratchArenaScope(CScratchArena *arena) :
+m_arena(arena),
+m_marker(arena->getMarker())
+{
+}
+
+CScratchArenaScope::~CScratchArenaScope()
+{
+    m_arena->rewind(m_marker);
+}
+
+CScratchArena *CScratchArenaScope::getArena() const
+{
+    return m_arena;
+}
+
+} // namespace ultra
@@ -26,6 +26,7 @@
 #include <ul_ImageMetadataObjects.h>
 #include <ul_Int_ImageLoader.h>
 #include <ul_KeyValue.h>
+#include <ul_Profiler.h>
 
 namespace ultra
 {
@@ -40,6 +41,23 @@ private:
     CImageLoader();
 
     int CheckIfPathExists(const std::string &pathToImageFile) const;
+
+    // decoded bytes handed out, counted as CProfiler::COUNTER_IMAGE_BYTES_READ
+    template<class T>
+    static int CountBytesRead(int result, const CMatrix<T> &image)
+    {
+        if (result == 0)
+            CProfiler::getInstance()->AddCounter(CProfiler::COUNTER_IMAGE_BYTES_READ, (long long) image.getSize().getProduct() * sizeof (T));
+        return result;
+    }
+
+    template<class T>
+    static int CountBytesRead(int result, const CMatrixArray<T> &images)
+    {
+        for (unsigned long t = 0; result == 0 && t < images.size(); t++)
+            CountBytesRead(result, images[t]);
+        return result;
+    }
 public:
     virtual ~CImageLoader();
     static CImageLoader *getInstance();
@@ -52,7 +70,7 @@ public:
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CheckIfPathExists()");
             return 1;
         }
-        return getLoaderInstance()->LoadImage(pathToImageFile, imageVec, ul, size);
+        return CountBytesRead(getLoaderInstance()->LoadImage(pathToImageFile, imageVec, ul, size), imageVec);
     }
 
     template<class T>
@@ -63,7 +81,7 @@ public:
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CheckIfPathExists()");
             return 1;
         }
-        return getLoaderInstance()->LoadImage(pathToImageFile, image, ul, size, bandNumber);
+        return CountBytesRead(getLoaderInstance()->LoadImage(pathToImageFile, image, ul, size, bandNumber), image);
     }
 
     template<class T>
@@ -74,7 +92,7 @@ public:
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CheckIfPathExists()");
             return 1;
         }
-        return getLoaderInstance()->LoadImage(pathToImageFile, imageVec);
+        return CountBytesRead(getLoaderInstance()->LoadImage(pathToImageFile, imageVec), imageVec);
     }
 
     template<class T>
@@ -85,7 +103,7 @@ public:
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CheckIfPathExists()");
             return 1;
         }
-        return getLoaderInstance()->LoadImage(pathToImageFile, image, bandNumber);
+        return CountBytesRead(getLoaderInstance()->LoadImage(pathToImageFile, image, bandNumber), image);
     }
 
     template<class T>
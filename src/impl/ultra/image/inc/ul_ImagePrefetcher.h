@@ -0,0 +1,128 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include <deque>
+#include <memory>
+
+#include <ul_UltraThread.h>
+#include <ul_MatrixArray.h>
+
+namespace ultra
+{
+
+/**
+ * Reads images on a background I/O thread ahead of the point where they are needed.
+ * <br>
+ * Producers call <code>Request()</code> for images that will be needed later,
+ * consumers call <code>LoadImage()</code> which hands over a prefetched image,
+ * waits for a read in flight, or falls back to a synchronous read through
+ * <code>CImageLoader</code> if the image was never requested.
+ * <br>
+ * The amount of outstanding requests is bounded, requests past the bound are
+ * dropped (the image is then read synchronously when needed). Prefetched images that
+ * have not been handed over count against the memory budget, the I/O thread waits
+ * for memory to be released before reading further.
+ * <br>
+ * The time consumers spent waiting on I/O is accumulated and can be logged with
+ * <code>LogStatistics()</code>.
+ */
+class CImagePrefetcher : public IRunnable
+{
+public:
+    static const unsigned long DEFAULT_MAX_QUEUED_REQUESTS;
+    static const unsigned long long DEFAULT_MEMORY_BUDGET;
+    /**
+     * Band number that loads all the bands of an image
+     */
+    static const int ALL_BANDS;
+
+private:
+
+    enum EState
+    {
+        STATE_QUEUED = 0,
+        STATE_LOADING,
+        STATE_DONE
+    };
+
+    struct SEntry
+    {
+        std::string pathToImageFile;
+        int bandNumber;
+        EState state;
+        bool wanted;
+        int loadResult;
+        unsigned long long bytes;
+        CMatrixArray<float> image;
+
+        SEntry();
+        ~SEntry();
+    };
+
+    std::shared_ptr<CThreadLock> m_lock;
+    std::deque<std::shared_ptr<SEntry> > m_queue;
+    std::vector<std::shared_ptr<SEntry> > m_entries;
+    bool m_running;
+    unsigned long m_maxQueuedRequests;
+    unsigned long long m_memoryBudget;
+    unsigned long long m_memoryInUse;
+
+    double m_waitSeconds;
+    unsigned long m_hits;
+    unsigned long m_misses;
+    unsigned long m_dropped;
+
+    long findEntry(const std::string &pathToImageFile, int bandNumber) const;
+    int EstimateSize(const std::string &pathToImageFile, int bandNumber, unsigned long long &bytes) const;
+    int ReadImage(const std::string &pathToImageFile, int bandNumber, CMatrixArray<float> &image) const;
+    void Stop();
+
+public:
+    CImagePrefetcher(unsigned long maxQueuedRequests = CImagePrefetcher::DEFAULT_MAX_QUEUED_REQUESTS,
+                     unsigned long long memoryBudget = CImagePrefetcher::DEFAULT_MEMORY_BUDGET);
+    virtual ~CImagePrefetcher();
+
+    /**
+     * Queues an image to be read on the I/O thread, requesting an image that is
+     * already queued, in flight or prefetched does nothing
+     * @param pathToImageFile
+     * @param bandNumber a band number or ALL_BANDS
+     * @return 0 on success
+     */
+    int Request(const std::string &pathToImageFile, int bandNumber = 1);
+
+    /**
+     * Hands over a prefetched image, reading it on the calling thread if it was not prefetched
+     * @param pathToImageFile
+     * @param image
+     * @param bandNumber a band number or ALL_BANDS
+     * @return 0 on success
+     */
+    int LoadImage(const std::string &pathToImageFile, CMatrixArray<float> &image, int bandNumber = CImagePrefetcher::ALL_BANDS);
+    int LoadImage(const std::string &pathToImageFile, CMatrix<float> &image, int bandNumber = 1);
+
+    /**
+     * @return the total seconds consumers waited on image reads
+     */
+    double getWaitSeconds() const;
+    void LogStatistics() const;
+
+    virtual void run(void *context = nullptr) override;
+};
+
+} // namespace ultra
@@ -0,0 +1,115 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include <iostream>
+#include <ul_Size.h>
+
+namespace ultra
+{
+
+/**
+ * Creation profile used when writing GeoTIFF images.
+ * <br>
+ * A default constructed object reproduces the original behaviour of
+ * a striped, uncompressed and non BigTIFF file.
+ * <br>
+ * Profiles can be parsed from a comma separated list of KEY=VALUE pairs
+ * <code>
+ * COMPRESS=ZSTD,PREDICTOR=AUTO,TILED=YES,BLOCKSIZE=512,BIGTIFF=IF_SAFER,NUM_THREADS=ALL_CPUS
+ * </code>
+ */
+struct SImageSaveOptions
+{
+public:
+
+    enum ECompression
+    {
+        COMPRESSION_NONE = 0,
+        COMPRESSION_DEFLATE,
+        COMPRESSION_ZSTD,
+        COMPRESSION_LZW,
+        COMPRESSION_ENUM_COUNT
+    };
+
+    enum EPredictor
+    {
+        PREDICTOR_NONE = 0,
+        PREDICTOR_HORIZONTAL,
+        PREDICTOR_FLOATING_POINT,
+        /**
+         * Floating point predictor for float data and horizontal
+         * differencing for integer data
+         */
+        PREDICTOR_AUTO,
+        PREDICTOR_ENUM_COUNT
+    };
+
+    enum EBigTiff
+    {
+        BIGTIFF_NO = 0,
+        BIGTIFF_YES,
+        BIGTIFF_IF_NEEDED,
+        BIGTIFF_IF_SAFER,
+        BIGTIFF_ENUM_COUNT
+    };
+
+    /**
+     * Value of <code>threadCount</code> that uses all the available cores
+     */
+    static const int ALL_CPUS;
+
+    bool tiled;
+    SSize blockSize;
+    ECompression compression;
+    EPredictor predictor;
+    /**
+     * Compression level, -1 leaves the driver default
+     */
+    int compressionLevel;
+    EBigTiff bigTiff;
+    /**
+     * Amount of threads used to compress blocks, 0 or 1 compresses on the writing thread
+     */
+    int threadCount;
+
+    SImageSaveOptions();
+    SImageSaveOptions(const SImageSaveOptions &r);
+    ~SImageSaveOptions();
+    SImageSaveOptions &operator=(const SImageSaveOptions &r);
+
+    bool isCompressed() const;
+
+    static std::string compressionToStr(SImageSaveOptions::ECompression compression);
+    static SImageSaveOptions::ECompression strToCompression(const std::string &compressionStr);
+    static std::string predictorToStr(SImageSaveOptions::EPredictor predictor);
+    static SImageSaveOptions::EPredictor strToPredictor(const std::string &predictorStr);
+    static std::string bigTiffToStr(SImageSaveOptions::EBigTiff bigTiff);
+    static SImageSaveOptions::EBigTiff strToBigTiff(const std::string &bigTiffStr);
+
+    /**
+     * Parses a comma separated KEY=VALUE profile, keys not present keep their current values
+     * @param profile
+     * @param options
+     * @return 0 on success
+     */
+    static int Parse(const std::string &profile, SImageSaveOptions &options);
+
+    friend std::ostream &operator<<(std::ostream &stream, const SImageSaveOptions &o);
+};
+
+} // namespace ultra
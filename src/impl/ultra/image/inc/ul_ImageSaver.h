@@ -22,7 +22,9 @@
 #include <ul_Image.h>
 #include "ul_ImageMetadataObjects.h"
 #include <ul_Int_ImageSaver.h>
+#include <ul_ImageSaveOptions.h>
 #include <ul_File.h>
+#include <ul_Profiler.h>
 
 namespace ultra
 {
@@ -30,14 +32,40 @@ namespace ultra
 class CImageSaver
 {
 private:
+    SImageSaveOptions m_defaultSaveOptions;
     __ultra_internal::IImageSaver* getSaverInstance();
     CImageSaver();
+
+    // bytes handed in, counted as CProfiler::COUNTER_IMAGE_BYTES_WRITTEN
+    template<class T>
+    static int CountBytesWritten(int result, const CMatrix<T> &image)
+    {
+        if (result == 0)
+            CProfiler::getInstance()->AddCounter(CProfiler::COUNTER_IMAGE_BYTES_WRITTEN, (long long) image.getSize().getProduct() * sizeof (T));
+        return result;
+    }
+
+    template<class T>
+    static int CountBytesWritten(int result, const CMatrixArray<T> &images)
+    {
+        for (unsigned long t = 0; result == 0 && t < images.size(); t++)
+            CountBytesWritten(result, images[t]);
+        return result;
+    }
 public:
     virtual ~CImageSaver();
     static CImageSaver *getInstance();
 
+    /**
+     * Sets the profile used by saves that do not pass their own <code>SImageSaveOptions</code>,
+     * this is not thread safe and should be called before any image is saved
+     * @param options
+     */
+    void setDefaultSaveOptions(const SImageSaveOptions &options);
+    const SImageSaveOptions &getDefaultSaveOptions() const;
+
     template<class T>
-    int SaveImage(std::string pathToImageFile, const CMatrix<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr)
+    int SaveImage(std::string pathToImageFile, const CMatrix<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr)
     {
         CFile fPath = pathToImageFile;
         if (!fPath.getParentFolderFile().isDirectoryWritable())
@@ -49,11 +77,11 @@ public:
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "Going to overwrite a file at '" + pathToImageFile + "'");
         }
-        return getSaverInstance()->SaveImage(pathToImageFile, image, imageType, metadata);
+        return CountBytesWritten(getSaverInstance()->SaveImage(pathToImageFile, image, imageType, metadata, (options != nullptr) ? (options) : (&m_defaultSaveOptions)), image);
     }
 
     template<class T>
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr)
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr)
     {
         if (image.size() == 0)
         {
@@ -70,12 +98,12 @@ public:
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "Going to overwrite a file at '" + pathToImageFile + "'");
         }
-        return getSaverInstance()->SaveImage(pathToImageFile, image, imageType, metadata);
+        return CountBytesWritten(getSaverInstance()->SaveImage(pathToImageFile, image, imageType, metadata, (options != nullptr) ? (options) : (&m_defaultSaveOptions)), image);
     }
 
     int SetNoDataValue(std::string pathToImageFile, double noDataValue, int bandNumber = 1);
     int RemoveNoDataValue(std::string pathToImageFile, int bandNumber = 1);
-    int SaveImage(std::string pathToImageFile, const CImage &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
+    int SaveImage(std::string pathToImageFile, const CImage &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
 };
 
 } //namespace ultra
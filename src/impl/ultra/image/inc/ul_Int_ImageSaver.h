@@ -19,6 +19,7 @@
 #include <ul_Complex.h>
 #include <ul_MatrixArray.h>
 #include <ul_ImageMetadataObjects.h>
+#include <ul_ImageSaveOptions.h>
 #include <ul_Color.h>
 
 namespace ultra
@@ -36,31 +37,31 @@ private:
 
 protected:
 
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) = 0;
 
     virtual int innerSetNoDataValue(std::string pathToImageFile, double noDataValue, int bandNumber) = 0;
     virtual int innerRemoveNoDataValue(std::string pathToImageFile, int bandNumber) = 0;
@@ -70,42 +71,42 @@ protected:
     IImageSaver(bool isThreadSave, int lockKey);
 private:
     template<class T>
-    int SaveImageLocked_T(std::string pathToImageFile, const CMatrix<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata);
+    int SaveImageLocked_T(std::string pathToImageFile, const CMatrix<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options);
     template<class T>
-    int SaveImageLocked_T(std::string pathToImageFile, const CMatrixArray<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata);
+    int SaveImageLocked_T(std::string pathToImageFile, const CMatrixArray<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options);
 
     template<class T>
-    int SaveImage_T(std::string pathToImageFile, const CMatrix<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata);
+    int SaveImage_T(std::string pathToImageFile, const CMatrix<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options);
     template<class T>
-    int SaveImage_T(std::string pathToImageFile, const CMatrixArray<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata);
+    int SaveImage_T(std::string pathToImageFile, const CMatrixArray<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options);
 public:
     virtual ~IImageSaver();
 
-    int SaveImage(std::string pathToImageFile, const CMatrix<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrix<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
-    int SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrix<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
+    int SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata = nullptr, const SImageSaveOptions *options = nullptr);
 
     int SetNoDataValue(std::string pathToImageFile, double noDataValue, int bandNumber = 1);
     int RemoveNoDataValue(std::string pathToImageFile, int bandNumber = 1);
@@ -20,6 +20,7 @@
 #include <ul_Logger.h>
 #include <ul_Utility.h>
 #include <gdal_priv.h>
+#include <cpl_string.h>
 #include <ogrsf_frmts.h>
 #include <ogr_srs_api.h>
 #include <ul_UltraThread.h>
@@ -37,7 +38,7 @@ m_defaultBlockSize(), m_defaultPapszOptions()
     GDALDriver *driver = GetGDALDriverManager()->GetDriverByName("JP2ECW");
     if (driver != nullptr)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Removing JP2ECW driver from the GDALDriverManager");
+        ULTRA_LOG(CLogger::LOG_DEBUG, "Removing JP2ECW driver from the GDALDriverManager");
         GetGDALDriverManager()->DeregisterDriver(driver);
         GDALDestroyDriver(driver);
     }
@@ -695,5 +696,65 @@ char** CGdalWrapper::getGdalDefaultPapszOptions(EImage::EImageFormat imageType)
     return nullptr;
 }
 
+std::shared_ptr<char*> CGdalWrapper::genGdalCreationOptions(EImage::EImageFormat imageType, const SImageSaveOptions &options, bool isFloatingPoint, bool isComplex) const
+{
+    if (imageType != EImage::IMAGE_TYPE_GEOTIFF && imageType != EImage::IMAGE_TYPE_BIG_GEOTIFF)
+        return std::shared_ptr<char*>();
+
+    char **papszOptions = nullptr;
+    if (options.tiled)
+    {
+        SSize blockSize = options.blockSize;
+        if (blockSize.containsZero())
+        {
+            const SSize *defaultBlockSize = getDefaultBlockSize(imageType);
+            blockSize = (defaultBlockSize != nullptr) ? (*defaultBlockSize) : (SSize(256, 256));
+        }
+        papszOptions = CSLSetNameValue(papszOptions, "TILED", "YES");
+        papszOptions = CSLSetNameValue(papszOptions, "BLOCKXSIZE", toString(blockSize.col).c_str());
+        papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", toString(blockSize.row).c_str());
+    }
+
+    if (options.isCompressed())
+    {
+        papszOptions = CSLSetNameValue(papszOptions, "COMPRESS", SImageSaveOptions::compressionToStr(options.compression).c_str());
+
+        SImageSaveOptions::EPredictor predictor = options.predictor;
+        if (predictor == SImageSaveOptions::PREDICTOR_AUTO)
+            predictor = (isFloatingPoint) ? (SImageSaveOptions::PREDICTOR_FLOATING_POINT) : (SImageSaveOptions::PREDICTOR_HORIZONTAL);
+        // GTiff predictors are not defined for complex samples
+        if (!isComplex)
+        {
+            if (predictor == SImageSaveOptions::PREDICTOR_HORIZONTAL)
+                papszOptions = CSLSetNameValue(papszOptions, "PREDICTOR", "2");
+            else if (predictor == SImageSaveOptions::PREDICTOR_FLOATING_POINT && isFloatingPoint)
+                papszOptions = CSLSetNameValue(papszOptions, "PREDICTOR", "3");
+        }
+
+        if (options.compressionLevel >= 0)
+        {
+            if (options.compression == SImageSaveOptions::COMPRESSION_DEFLATE)
+                papszOptions = CSLSetNameValue(papszOptions, "ZLEVEL", toString(options.compressionLevel).c_str());
+            else if (options.compression == SImageSaveOptions::COMPRESSION_ZSTD)
+                papszOptions = CSLSetNameValue(papszOptions, "ZSTD_LEVEL", toString(options.compressionLevel).c_str());
+        }
+
+        if (options.threadCount == SImageSaveOptions::ALL_CPUS)
+            papszOptions = CSLSetNameValue(papszOptions, "NUM_THREADS", "ALL_CPUS");
+        else if (options.threadCount > 1)
+            papszOptions = CSLSetNameValue(papszOptions, "NUM_THREADS", toString(options.threadCount).c_str());
+    }
+
+    if (imageType == EImage::IMAGE_TYPE_BIG_GEOTIFF)
+        papszOptions = CSLSetNameValue(papszOptions, "BIGTIFF", "YES");
+    else if (options.bigTiff != SImageSaveOptions::BIGTIFF_NO)
+        papszOptions = CSLSetNameValue(papszOptions, "BIGTIFF", SImageSaveOptions::bigTiffToStr(options.bigTiff).c_str());
+
+    return std::shared_ptr<char*>(papszOptions, [](char **p)
+    {
+        CSLDestroy(p);
+    });
+}
+
 } // namespace __ultra_internal
 } // namespace ultra
@@ -17,6 +17,7 @@
 
 #include "ul_ImageEnums.h"
 #include "ul_ImageMetadataObjects.h"
+#include "ul_ImageSaveOptions.h"
 #include <ul_Odl.h>
 #include <ul_AtomicBool.h>
 #include <ul_Matrix.h>
@@ -63,6 +64,11 @@ public:
 
     const SSize *getDefaultBlockSize(EImage::EImageFormat imageType) const;
     char** getGdalDefaultPapszOptions(EImage::EImageFormat imageType) const;
+    /**
+     * Generates the GDAL creation options for a save profile, the returned
+     * pointer owns the option list and is nullptr for formats without creation options
+     */
+    std::shared_ptr<char*> genGdalCreationOptions(EImage::EImageFormat imageType, const SImageSaveOptions &options, bool isFloatingPoint, bool isComplex) const;
 };
 
 } // namespace __ultra_internal
@@ -17,6 +17,7 @@
 #include "ul_ImageLoaderGDAL.h"
 
 #include "ul_Logger.h"
+#include "ul_Profiler.h"
 #include "ul_GdalWrapper.h"
 #include "ul_GDALState.h"
 #include <gdal_priv.h>
@@ -553,6 +554,7 @@ template<class T>
 int CImageLoaderGDAL::GetImageRasterLines(std::string pathToInputFile, CMatrix<T> &img, int bandNumber,
                                           const SSize &ul, const SSize& size)
 {
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_IO, "GdalRead");
     int ret = 0;
     if (CGdalState::getInstance()->WaitForReader() != 0)
     {
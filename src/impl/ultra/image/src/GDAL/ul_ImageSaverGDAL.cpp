@@ -19,6 +19,7 @@
 #include "ul_GDALState.h"
 
 #include <ul_File.h>
+#include <ul_Profiler.h>
 
 #include <gdal_priv.h>
 #include <ogrsf_frmts.h>
@@ -258,12 +259,12 @@ int CImageSaverGDAL::DetermineType(int &gdalImageType)
 }
 
 template<class T>
-int CImageSaverGDAL::inner_saveImageVecLineForLine(void *PoDriver, const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::inner_saveImageVecLineForLine(void *PoDriver, const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_IO, "GdalWrite");
     GDALDriver *poDriver = (GDALDriver*) (PoDriver);
     SSize imgSize = imgVec[0]->getSize();
     GDALDataset *poDstDS = nullptr;
-    char **papszOptions = nullptr;
     int noBands = imgVec.size();
     int gdalImageType;
     if (DetermineType<T>(gdalImageType) != 0)
@@ -271,8 +272,14 @@ int CImageSaverGDAL::inner_saveImageVecLineForLine(void *PoDriver, const std::st
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from DetermineType()");
         return 1;
     }
+    SImageSaveOptions saveOptions;
+    if (options != nullptr)
+        saveOptions = *options;
+    std::shared_ptr<char*> papszOptions = CGdalWrapper::getInstance()->genGdalCreationOptions(imageType, saveOptions,
+                                                                                              GDALDataTypeIsFloating((GDALDataType) gdalImageType) != 0,
+                                                                                              GDALDataTypeIsComplex((GDALDataType) gdalImageType) != 0);
     poDstDS = poDriver->Create(pathToImageFile.c_str(), imgSize.col, imgSize.row, noBands, (GDALDataType) gdalImageType,
-                               papszOptions);
+                               papszOptions.get());
 
     if (poDstDS == nullptr)
     {
@@ -310,6 +317,20 @@ int CImageSaverGDAL::inner_saveImageVecLineForLine(void *PoDriver, const std::st
     CPLFree(pszSRS_WKT);
 
 
+    // tiled files are written one row of blocks at a time so that every
+    // block is complete (and compressed) exactly once
+    unsigned long rowsPerWrite = 1;
+    if (saveOptions.tiled)
+    {
+        int blockCols = 0;
+        int blockRows = 0;
+        poDstDS->GetRasterBand(1)->GetBlockSize(&blockCols, &blockRows);
+        rowsPerWrite = getMAX(blockRows, 1);
+    }
+    CVector<T> stripBuffer;
+    if (rowsPerWrite > 1)
+        stripBuffer.resize(rowsPerWrite * imgSize.col);
+
     for (unsigned long t = 1; t <= noBands; t++)
     {
         poBand = poDstDS->GetRasterBand(t);
@@ -320,9 +341,21 @@ int CImageSaverGDAL::inner_saveImageVecLineForLine(void *PoDriver, const std::st
             return 1;
         }
 
-        for (unsigned long r = 0; r < imgSize.row; r++)
+        const CMatrix<T> &img = *imgVec[t - 1];
+        for (unsigned long r = 0; r < imgSize.row; r += rowsPerWrite)
         {
-            if (poBand->RasterIO(GF_Write, 0, r, imgSize.col, 1, &(*imgVec[t - 1])[r][0], imgSize.col, 1, (GDALDataType) gdalImageType, 0, 0) != 0)
+            unsigned long rows = getMIN(rowsPerWrite, imgSize.row - r);
+            const T *dp = &img[r][0];
+            if (rowsPerWrite > 1)
+            {
+                T *sp = stripBuffer.getDataPointer();
+                for (unsigned long sr = 0; sr < rows; sr++)
+                {
+                    memcpy(sp + sr * imgSize.col, &img[r + sr][0], imgSize.col * sizeof (T));
+                }
+                dp = sp;
+            }
+            if (poBand->RasterIO(GF_Write, 0, r, imgSize.col, rows, const_cast<T*> (dp), imgSize.col, rows, (GDALDataType) gdalImageType, 0, 0) != 0)
             {
                 GDALClose(poDstDS);
                 CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from RasterIO()");
@@ -337,8 +370,10 @@ int CImageSaverGDAL::inner_saveImageVecLineForLine(void *PoDriver, const std::st
 }
 
 template<class T>
-int CImageSaverGDAL::inner_saveImageVecFromMemory(void *PoDriver, const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::inner_saveImageVecFromMemory(void *PoDriver, const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
+    ULTRA_TRACE_SCOPE(CTracer::CATEGORY_IO, "GdalWrite");
+    // drivers without Create() support (JPEG, PNG, ...) have no GTiff creation options
     GDALDriver *poDriver = (GDALDriver*) (PoDriver);
     SSize imgSize = imgVec[0]->getSize();
     char **papszOptions = nullptr;
@@ -421,7 +456,7 @@ int CImageSaverGDAL::inner_saveImageVecFromMemory(void *PoDriver, const std::str
 }
 
 template<class T>
-int CImageSaverGDAL::inner_saveImageVec(const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::inner_saveImageVec(const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
     if (!EImage::canWriteImage(imageType))
     {
@@ -434,7 +469,7 @@ int CImageSaverGDAL::inner_saveImageVec(const std::string &pathToImageFile, cons
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CGdalState::WaitForWriter()");
         return 1;
     }
-    ret = inner_wrappedSaveImageVec(pathToImageFile, imgVec, imageType, metadata);
+    ret = inner_wrappedSaveImageVec(pathToImageFile, imgVec, imageType, metadata, options);
     if (CGdalState::getInstance()->RemoveWriter() != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CGdalState::RemoveWriter()");
@@ -444,7 +479,7 @@ int CImageSaverGDAL::inner_saveImageVec(const std::string &pathToImageFile, cons
 }
 
 template<class T>
-int CImageSaverGDAL::inner_wrappedSaveImageVec(const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata * metadata)
+int CImageSaverGDAL::inner_wrappedSaveImageVec(const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
     std::string format = EImage::imageFormatToGdalStr(imageType);
     GDALDriver *poDriver;
@@ -468,7 +503,7 @@ int CImageSaverGDAL::inner_wrappedSaveImageVec(const std::string &pathToImageFil
 
     if (GDALGetMetadataItem(poDriver, GDAL_DCAP_CREATE, nullptr) != nullptr)
     {
-        if (inner_saveImageVecLineForLine<T>((void*) poDriver, pathToImageFile, imgVec, imageType, metadata) != 0)
+        if (inner_saveImageVecLineForLine<T>((void*) poDriver, pathToImageFile, imgVec, imageType, metadata, options) != 0)
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from inner_saveImageVecLineForLine()");
             return 1;
@@ -476,7 +511,7 @@ int CImageSaverGDAL::inner_wrappedSaveImageVec(const std::string &pathToImageFil
     }
     else
     {
-        if (inner_saveImageVecFromMemory<T>((void*) poDriver, pathToImageFile, imgVec, imageType, metadata) != 0)
+        if (inner_saveImageVecFromMemory<T>((void*) poDriver, pathToImageFile, imgVec, imageType, metadata, options) != 0)
         {
             CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from inner_saveImageVecFromMemory()");
             return 1;
@@ -493,16 +528,16 @@ int CImageSaverGDAL::inner_wrappedSaveImageVec(const std::string &pathToImageFil
 }
 
 template<class T>
-int CImageSaverGDAL::inner_saveImage(const std::string &pathToImageFile, const CMatrix<T> &img, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::inner_saveImage(const std::string &pathToImageFile, const CMatrix<T> &img, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
     CVector<CMatrix<T>*> imgVec;
     imgVec.resize(1);
     imgVec[0] = const_cast<CMatrix<T> *> (&img);
-    return inner_saveImageVec<T>(pathToImageFile, imgVec, imageType, metadata);
+    return inner_saveImageVec<T>(pathToImageFile, imgVec, imageType, metadata, options);
 }
 
 template<class T>
-int CImageSaverGDAL::inner_saveImage(const std::string &pathToImageFile, const CMatrixArray<T> &img, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::inner_saveImage(const std::string &pathToImageFile, const CMatrixArray<T> &img, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
     CVector<CMatrix<T>*> imgVec;
     imgVec.resize(img.size());
@@ -510,127 +545,127 @@ int CImageSaverGDAL::inner_saveImage(const std::string &pathToImageFile, const C
     {
         imgVec[t] = const_cast<CMatrix<T> *> (&img[t]);
     }
-    return inner_saveImageVec<T>(pathToImageFile, imgVec, imageType, metadata);
+    return inner_saveImageVec<T>(pathToImageFile, imgVec, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
-int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaverGDAL::innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return inner_saveImage(pathToImageFile, image, imageType, metadata);
+    return inner_saveImage(pathToImageFile, image, imageType, metadata, options);
 }
 
 int CImageSaverGDAL::innerSetNoDataValue(std::string pathToImageFile, double noDataValue, int bandNumber)
@@ -33,10 +33,10 @@ private:
     void genGeoTransform(const SPair<double> &origin, const SPair<double> &gsd, double output[6], const SImageMetadata *metadata);
 
     template<class T>
-    int inner_saveImage(const std::string &pathToImageFile, const CMatrix<T> &img, EImage::EImageFormat imageType, const SImageMetadata *metadata);
+    int inner_saveImage(const std::string &pathToImageFile, const CMatrix<T> &img, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options);
 
     template<class T>
-    int inner_saveImage(const std::string &pathToImageFile, const CMatrixArray<T> &img, EImage::EImageFormat imageType, const SImageMetadata *metadata);
+    int inner_saveImage(const std::string &pathToImageFile, const CMatrixArray<T> &img, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options);
 
     int PopulateOSrs(const SImageMetadata *metadata, void *osrs, void *dataset);
 
@@ -44,46 +44,46 @@ private:
     int DetermineType(int &gdalImageType);
 
     template<class T>
-    int inner_saveImageVecLineForLine(void *PoDriver, const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata);
+    int inner_saveImageVecLineForLine(void *PoDriver, const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options);
 
     template<class T>
-    int inner_saveImageVecFromMemory(void *PoDriver, const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata);
+    int inner_saveImageVecFromMemory(void *PoDriver, const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options);
 
     // wrapped calls
     template<class T>
-    int inner_saveImageVec(const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata);
+    int inner_saveImageVec(const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options);
 
 private:
     //where calls are wrapped
     template<class T>
-    int inner_wrappedSaveImageVec(const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata);
+    int inner_wrappedSaveImageVec(const std::string &pathToImageFile, const CVector<CMatrix<T>*> &imgVec, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options);
 protected:
 
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
-    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrix<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
+    virtual int innerSaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options) override;
 
     virtual int innerSetNoDataValue(std::string pathToImageFile, double noDataValue, int bandNumber) override;
     virtual int innerRemoveNoDataValue(std::string pathToImageFile, int bandNumber) override;
@@ -39,43 +39,35 @@ CImageLoadSaveLocks *CImageLoadSaveLocks::getInstance()
     return &instance;
 }
 
-int CImageLoadSaveLocks::AddLockIfNotExists(int key)
+/**
+ * Must be called with <code>m_lock</code> held
+ */
+int CImageLoadSaveLocks::getOrAddLock(int key, std::shared_ptr<void> &lock)
 {
-    if (key < 0)
+    std::shared_ptr<void> *existing = m_locks.getPtr(key);
+    if (existing != nullptr)
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Cannot insert a key with a negative value");
+        lock = *existing;
         return 0;
     }
-    AUTO_LOCK(m_lock);
-    bool found = false;
-    for (unsigned long t = 0; t < m_locks.size(); t++)
-    {
-        if (m_locks[t].k == key)
-        {
-            found = true;
-            break;
-        }
-    }
 
     int ret = 0;
-    if (!found)
+    try
+    {
+        std::shared_ptr<void> newLock(new CThreadLock(), std::default_delete<CThreadLock>());
+        m_locks.put(key, newLock);
+        lock = newLock;
+    }
+    catch (const std::exception &e)
     {
-        try
-        {
-            std::shared_ptr<void> lock(new CThreadLock(), std::default_delete<CThreadLock>());
-            m_locks.pushBack(SKeyValue<int, std::shared_ptr<void> >(key, lock));
-        }
-        catch (const std::exception &e)
-        {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, e);
-            ret = 1;
-        }
-        catch (const std::exception *e)
-        {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, *e);
-            delete e;
-            ret = 1;
-        }
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, e);
+        ret = 1;
+    }
+    catch (const std::exception *e)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, *e);
+        delete e;
+        ret = 1;
     }
 
     return ret;
@@ -86,21 +78,12 @@ std::shared_ptr<void> CImageLoadSaveLocks::getLock(int key, std::shared_ptr<void
     if (key < 0)
         return defaultLock;
 
-    std::shared_ptr<void> returnLock = defaultLock;
+    std::shared_ptr<void> returnLock;
     AUTO_LOCK(m_lock);
-    if (AddLockIfNotExists(key) != 0)
-    {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from AddLockIfNotExists()");
-        return returnLock;
-    }
-
-    for (unsigned long t = 0; t < m_locks.size(); t++)
+    if (getOrAddLock(key, returnLock) != 0)
     {
-        if (m_locks[t].k == key)
-        {
-            returnLock = m_locks[t].v;
-            break;
-        }
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from getOrAddLock()");
+        return defaultLock;
     }
 
     return returnLock;
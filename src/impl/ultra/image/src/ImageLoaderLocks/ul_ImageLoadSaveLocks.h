@@ -17,7 +17,7 @@
 #pragma once
 
 #include <ul_KeyValue.h>
-#include <ul_Vector.h>
+#include <ul_Map.h>
 #include <ul_UltraThread.h>
 
 namespace ultra
@@ -31,10 +31,10 @@ class CImageLoadSaveLocks
 private:
     std::shared_ptr<CThreadLock> m_lock;
 
-    CVector<SKeyValue<int, std::shared_ptr<void> > > m_locks;
+    CMap<int, std::shared_ptr<void> > m_locks;
 
     CImageLoadSaveLocks();
-    int AddLockIfNotExists(int key);
+    int getOrAddLock(int key, std::shared_ptr<void> &lock);
 public:
     virtual ~CImageLoadSaveLocks();
     static CImageLoadSaveLocks *getInstance();
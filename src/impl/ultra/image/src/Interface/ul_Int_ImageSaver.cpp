@@ -47,9 +47,9 @@ bool IImageSaver::isThreadSafe() const
 }
 
 template<class T>
-int IImageSaver::SaveImageLocked_T(std::string pathToImageFile, const CMatrix<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImageLocked_T(std::string pathToImageFile, const CMatrix<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    if (innerSaveImage(pathToImageFile, image, imageType, metadata) != 0)
+    if (innerSaveImage(pathToImageFile, image, imageType, metadata, options) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from innerSaveImage()");
         return 1;
@@ -58,9 +58,9 @@ int IImageSaver::SaveImageLocked_T(std::string pathToImageFile, const CMatrix<T>
 }
 
 template<class T>
-int IImageSaver::SaveImageLocked_T(std::string pathToImageFile, const CMatrixArray<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImageLocked_T(std::string pathToImageFile, const CMatrixArray<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    if (innerSaveImage(pathToImageFile, image, imageType, metadata) != 0)
+    if (innerSaveImage(pathToImageFile, image, imageType, metadata, options) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from innerSaveImage()");
         return 1;
@@ -69,145 +69,145 @@ int IImageSaver::SaveImageLocked_T(std::string pathToImageFile, const CMatrixArr
 }
 
 template<class T>
-int IImageSaver::SaveImage_T(std::string pathToImageFile, const CMatrix<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage_T(std::string pathToImageFile, const CMatrix<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
     if (!isThreadSafe())
     {
         AUTO_LOCK(getLock());
-        return SaveImageLocked_T(pathToImageFile, image, imageType, metadata);
+        return SaveImageLocked_T(pathToImageFile, image, imageType, metadata, options);
     }
-    return SaveImageLocked_T(pathToImageFile, image, imageType, metadata);
+    return SaveImageLocked_T(pathToImageFile, image, imageType, metadata, options);
 }
 
 template<class T>
-int IImageSaver::SaveImage_T(std::string pathToImageFile, const CMatrixArray<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage_T(std::string pathToImageFile, const CMatrixArray<T> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
     if (!isThreadSafe())
     {
         AUTO_LOCK(getLock());
-        return SaveImageLocked_T(pathToImageFile, image, imageType, metadata);
+        return SaveImageLocked_T(pathToImageFile, image, imageType, metadata, options);
     }
-    return SaveImageLocked_T(pathToImageFile, image, imageType, metadata);
+    return SaveImageLocked_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrix<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<char> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<short> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<unsigned int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<int> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<float> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<double> &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<short> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<int> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<float> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
-int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int IImageSaver::SaveImage(std::string pathToImageFile, const CMatrixArray<SComplex<double> > &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
-    return SaveImage_T(pathToImageFile, image, imageType, metadata);
+    return SaveImage_T(pathToImageFile, image, imageType, metadata, options);
 }
 
 int IImageSaver::SetNoDataValue(std::string pathToImageFile, double noDataValue, int bandNumber)
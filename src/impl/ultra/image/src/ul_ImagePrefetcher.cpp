@@ -0,0 +1,329 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ul_ImagePrefetcher.h"
+
+#include <chrono>
+
+#include <ul_Logger.h>
+#include <ul_Utility.h>
+#include <ul_Exception.h>
+#include <ul_Profiler.h>
+#include "ul_ImageLoader.h"
+
+namespace ultra
+{
+
+const unsigned long CImagePrefetcher::DEFAULT_MAX_QUEUED_REQUESTS = 4;
+const unsigned long long CImagePrefetcher::DEFAULT_MEMORY_BUDGET = 1024ULL * 1024ULL * 1024ULL;
+const int CImagePrefetcher::ALL_BANDS = 0;
+
+CImagePrefetcher::SEntry::SEntry()
+{
+    bandNumber = 1;
+    state = STATE_QUEUED;
+    wanted = false;
+    loadResult = 0;
+    bytes = 0;
+}
+
+CImagePrefetcher::SEntry::~SEntry()
+{
+}
+
+CImagePrefetcher::CImagePrefetcher(unsigned long maxQueuedRequests, unsigned long long memoryBudget) :
+m_lock(std::make_shared<CThreadLock>())
+{
+    m_running = true;
+    m_maxQueuedRequests = maxQueuedRequests;
+    m_memoryBudget = memoryBudget;
+    m_memoryInUse = 0;
+    m_waitSeconds = 0;
+    m_hits = 0;
+    m_misses = 0;
+    m_dropped = 0;
+
+    if (CUltraThread::getInstance()->start(this, nullptr) != 0)
+    {
+        throw CException(__FILE__, __LINE__, "Failure returned from CUltraThread::start()");
+    }
+}
+
+CImagePrefetcher::~CImagePrefetcher()
+{
+    Stop();
+}
+
+void CImagePrefetcher::Stop()
+{
+    {
+        AUTO_LOCK(m_lock);
+        if (!m_running)
+            return;
+        m_running = false;
+        m_lock->broadcast(__FILE__, __LINE__);
+    }
+
+    if (CUltraThread::getInstance()->join(this) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "Failed to join the image prefetch thread");
+    }
+
+    AUTO_LOCK(m_lock);
+    m_queue.clear();
+    m_entries.clear();
+    m_memoryInUse = 0;
+}
+
+long CImagePrefetcher::findEntry(const std::string &pathToImageFile, int bandNumber) const
+{
+    for (unsigned long t = 0; t < m_entries.size(); t++)
+    {
+        if (m_entries[t]->bandNumber == bandNumber &&
+            m_entries[t]->pathToImageFile == pathToImageFile)
+            return (long) t;
+    }
+    return -1;
+}
+
+int CImagePrefetcher::EstimateSize(const std::string &pathToImageFile, int bandNumber, unsigned long long &bytes) const
+{
+    SImageMetadata metadata;
+    if (CImageLoader::getInstance()->LoadImageMetadata(pathToImageFile, metadata) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadImageMetadata()");
+        return 1;
+    }
+    unsigned long long bands = bandNumber == ALL_BANDS ? getMAX(metadata.bandCount, 1) : 1;
+    bytes = (unsigned long long) metadata.getDimensions().getProduct() * bands * sizeof (float);
+    return 0;
+}
+
+int CImagePrefetcher::ReadImage(const std::string &pathToImageFile, int bandNumber, CMatrixArray<float> &image) const
+{
+    if (bandNumber == ALL_BANDS)
+    {
+        if (CImageLoader::getInstance()->LoadImage(pathToImageFile, image) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadImage()");
+            return 1;
+        }
+        return 0;
+    }
+
+    image.resize(1);
+    if (CImageLoader::getInstance()->LoadImage(pathToImageFile, image[0], bandNumber) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadImage()");
+        return 1;
+    }
+    return 0;
+}
+
+int CImagePrefetcher::Request(const std::string &pathToImageFile, int bandNumber)
+{
+    AUTO_LOCK(m_lock);
+    if (!m_running)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Image prefetcher has been stopped");
+        return 1;
+    }
+
+    if (findEntry(pathToImageFile, bandNumber) >= 0)
+        return 0;
+
+    if (m_queue.size() >= m_maxQueuedRequests)
+    {
+        m_dropped++;
+        ULTRA_LOG(CLogger::LOG_DEBUG, "Prefetch queue is full, not prefetching '" + pathToImageFile + "'");
+        return 0;
+    }
+
+    std::shared_ptr<SEntry> entry = std::make_shared<SEntry>();
+    entry->pathToImageFile = pathToImageFile;
+    entry->bandNumber = bandNumber;
+    m_entries.push_back(entry);
+    m_queue.push_back(entry);
+    m_lock->broadcast(__FILE__, __LINE__);
+    return 0;
+}
+
+int CImagePrefetcher::LoadImage(const std::string &pathToImageFile, CMatrixArray<float> &image, int bandNumber)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::shared_ptr<SEntry> entry;
+    {
+        AUTO_LOCK(m_lock);
+        long index = findEntry(pathToImageFile, bandNumber);
+        if (index >= 0)
+        {
+            std::shared_ptr<SEntry> found = m_entries[index];
+            if (found->state == STATE_QUEUED)
+            {
+                // not started yet, reading it here is quicker than waiting for the queue to drain
+                for (unsigned long t = 0; t < m_queue.size(); t++)
+                {
+                    if (m_queue[t] == found)
+                    {
+                        m_queue.erase(m_queue.begin() + t);
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                found->wanted = true;
+                m_lock->broadcast(__FILE__, __LINE__);
+                while (found->state != STATE_DONE)
+                {
+                    m_lock->wait(__FILE__, __LINE__);
+                }
+                m_memoryInUse -= found->bytes;
+                m_lock->broadcast(__FILE__, __LINE__);
+                entry = found;
+            }
+
+            // other consumers may have moved the entry while waiting
+            for (unsigned long t = 0; t < m_entries.size(); t++)
+            {
+                if (m_entries[t] == found)
+                {
+                    m_entries.erase(m_entries.begin() + t);
+                    break;
+                }
+            }
+        }
+    }
+
+    int ret = 0;
+    if (entry == nullptr)
+    {
+        ret = ReadImage(pathToImageFile, bandNumber, image);
+    }
+    else
+    {
+        ret = entry->loadResult;
+        if (ret == 0)
+            image = std::move(entry->image);
+    }
+
+    std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+    {
+        AUTO_LOCK(m_lock);
+        m_waitSeconds += waited.count();
+        if (entry == nullptr)
+            m_misses++;
+        else
+            m_hits++;
+    }
+
+    if (ret != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to load image '" + pathToImageFile + "'");
+        return 1;
+    }
+    return 0;
+}
+
+int CImagePrefetcher::LoadImage(const std::string &pathToImageFile, CMatrix<float> &image, int bandNumber)
+{
+    if (bandNumber == ALL_BANDS)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "A single band must be selected when loading into a matrix");
+        return 1;
+    }
+
+    CMatrixArray<float> images;
+    if (LoadImage(pathToImageFile, images, bandNumber) != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from LoadImage()");
+        return 1;
+    }
+    image = std::move(images[0]);
+    return 0;
+}
+
+double CImagePrefetcher::getWaitSeconds() const
+{
+    AUTO_LOCK(m_lock);
+    return m_waitSeconds;
+}
+
+void CImagePrefetcher::LogStatistics() const
+{
+    AUTO_LOCK(m_lock);
+    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_INFO, "Image prefetching: '" + toString(m_hits) + "' prefetched, "
+                                "'" + toString(m_misses) + "' read on demand, '" + toString(m_dropped) + "' dropped requests, "
+                                "waited '" + toString(m_waitSeconds) + "' seconds on I/O");
+}
+
+void CImagePrefetcher::run(void *context)
+{
+    CTracer::getInstance()->SetThreadName("ImagePrefetch");
+    while (true)
+    {
+        std::shared_ptr<SEntry> entry;
+        {
+            AUTO_LOCK(m_lock);
+            while (m_running && m_queue.empty())
+            {
+                m_lock->wait(__FILE__, __LINE__);
+            }
+            if (!m_running)
+                break;
+            entry = m_queue.front();
+            m_queue.pop_front();
+            entry->state = STATE_LOADING;
+        }
+
+        unsigned long long bytes = 0;
+        int ret = EstimateSize(entry->pathToImageFile, entry->bandNumber, bytes);
+
+        {
+            AUTO_LOCK(m_lock);
+            // an image a consumer is waiting on is read even if it exceeds the budget
+            while (ret == 0 && m_running && !entry->wanted &&
+                   m_memoryInUse > 0 && m_memoryInUse + bytes > m_memoryBudget)
+            {
+                m_lock->wait(__FILE__, __LINE__);
+            }
+            if (!m_running)
+            {
+                entry->state = STATE_DONE;
+                entry->loadResult = 1;
+                m_lock->broadcast(__FILE__, __LINE__);
+                break;
+            }
+            if (ret == 0)
+            {
+                entry->bytes = bytes;
+                m_memoryInUse += bytes;
+            }
+        }
+
+        if (ret == 0)
+            ret = ReadImage(entry->pathToImageFile, entry->bandNumber, entry->image);
+
+        {
+            AUTO_LOCK(m_lock);
+            entry->loadResult = ret;
+            entry->state = STATE_DONE;
+            m_lock->broadcast(__FILE__, __LINE__);
+        }
+    }
+}
+
+} // namespace ultra
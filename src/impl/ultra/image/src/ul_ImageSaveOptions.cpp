@@ -0,0 +1,247 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ul_ImageSaveOptions.h"
+
+#include <ul_Utility.h>
+#include <ul_Logger.h>
+
+namespace ultra
+{
+
+const int SImageSaveOptions::ALL_CPUS = -1;
+
+SImageSaveOptions::SImageSaveOptions()
+{
+    tiled = false;
+    blockSize = SSize(256, 256);
+    compression = COMPRESSION_NONE;
+    predictor = PREDICTOR_NONE;
+    compressionLevel = -1;
+    bigTiff = BIGTIFF_NO;
+    threadCount = 0;
+}
+
+SImageSaveOptions::SImageSaveOptions(const SImageSaveOptions &r)
+{
+    *this = r;
+}
+
+SImageSaveOptions::~SImageSaveOptions()
+{
+}
+
+SImageSaveOptions &SImageSaveOptions::operator=(const SImageSaveOptions &r)
+{
+    if (this == &r)
+        return *this;
+    tiled = r.tiled;
+    blockSize = r.blockSize;
+    compression = r.compression;
+    predictor = r.predictor;
+    compressionLevel = r.compressionLevel;
+    bigTiff = r.bigTiff;
+    threadCount = r.threadCount;
+    return *this;
+}
+
+bool SImageSaveOptions::isCompressed() const
+{
+    return compression != COMPRESSION_NONE && compression != COMPRESSION_ENUM_COUNT;
+}
+
+std::string SImageSaveOptions::compressionToStr(SImageSaveOptions::ECompression compression)
+{
+    switch (compression)
+    {
+    case SImageSaveOptions::COMPRESSION_NONE:return "NONE";
+    case SImageSaveOptions::COMPRESSION_DEFLATE:return "DEFLATE";
+    case SImageSaveOptions::COMPRESSION_ZSTD:return "ZSTD";
+    case SImageSaveOptions::COMPRESSION_LZW:return "LZW";
+    }
+    return "";
+}
+
+SImageSaveOptions::ECompression SImageSaveOptions::strToCompression(const std::string &compressionStr)
+{
+    std::string s = toUpper(trimStr(compressionStr));
+    if (s == "NONE") return SImageSaveOptions::COMPRESSION_NONE;
+    if (s == "DEFLATE") return SImageSaveOptions::COMPRESSION_DEFLATE;
+    if (s == "ZSTD") return SImageSaveOptions::COMPRESSION_ZSTD;
+    if (s == "LZW") return SImageSaveOptions::COMPRESSION_LZW;
+    return SImageSaveOptions::COMPRESSION_ENUM_COUNT;
+}
+
+std::string SImageSaveOptions::predictorToStr(SImageSaveOptions::EPredictor predictor)
+{
+    switch (predictor)
+    {
+    case SImageSaveOptions::PREDICTOR_NONE:return "NONE";
+    case SImageSaveOptions::PREDICTOR_HORIZONTAL:return "HORIZONTAL";
+    case SImageSaveOptions::PREDICTOR_FLOATING_POINT:return "FLOATING_POINT";
+    case SImageSaveOptions::PREDICTOR_AUTO:return "AUTO";
+    }
+    return "";
+}
+
+SImageSaveOptions::EPredictor SImageSaveOptions::strToPredictor(const std::string &predictorStr)
+{
+    std::string s = toUpper(trimStr(predictorStr));
+    if (s == "NONE" || s == "NO" || s == "1") return SImageSaveOptions::PREDICTOR_NONE;
+    if (s == "HORIZONTAL" || s == "2") return SImageSaveOptions::PREDICTOR_HORIZONTAL;
+    if (s == "FLOATING_POINT" || s == "3") return SImageSaveOptions::PREDICTOR_FLOATING_POINT;
+    if (s == "AUTO" || s == "YES") return SImageSaveOptions::PREDICTOR_AUTO;
+    return SImageSaveOptions::PREDICTOR_ENUM_COUNT;
+}
+
+std::string SImageSaveOptions::bigTiffToStr(SImageSaveOptions::EBigTiff bigTiff)
+{
+    switch (bigTiff)
+    {
+    case SImageSaveOptions::BIGTIFF_NO:return "NO";
+    case SImageSaveOptions::BIGTIFF_YES:return "YES";
+    case SImageSaveOptions::BIGTIFF_IF_NEEDED:return "IF_NEEDED";
+    case SImageSaveOptions::BIGTIFF_IF_SAFER:return "IF_SAFER";
+    }
+    return "";
+}
+
+SImageSaveOptions::EBigTiff SImageSaveOptions::strToBigTiff(const std::string &bigTiffStr)
+{
+    std::string s = toUpper(trimStr(bigTiffStr));
+    if (s == "NO" || s == "FALSE") return SImageSaveOptions::BIGTIFF_NO;
+    if (s == "YES" || s == "TRUE") return SImageSaveOptions::BIGTIFF_YES;
+    if (s == "IF_NEEDED") return SImageSaveOptions::BIGTIFF_IF_NEEDED;
+    if (s == "IF_SAFER") return SImageSaveOptions::BIGTIFF_IF_SAFER;
+    return SImageSaveOptions::BIGTIFF_ENUM_COUNT;
+}
+
+int SImageSaveOptions::Parse(const std::string &profile, SImageSaveOptions &options)
+{
+    SImageSaveOptions ret = options;
+    std::vector<std::string> items = split(profile, ',');
+    for (unsigned long t = 0; t < items.size(); t++)
+    {
+        std::string item = trimStr(items[t]);
+        if (item == "")
+            continue;
+        std::vector<std::string> kv = split(item, '=');
+        if (kv.size() != 2)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid save option '" + item + "' expected KEY=VALUE");
+            return 1;
+        }
+        std::string key = toUpper(trimStr(kv[0]));
+        std::string val = toUpper(trimStr(kv[1]));
+
+        if (key == "COMPRESS")
+        {
+            ret.compression = strToCompression(val);
+            if (ret.compression == COMPRESSION_ENUM_COUNT)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid compression '" + val + "' (NONE/DEFLATE/ZSTD/LZW)");
+                return 1;
+            }
+        }
+        else if (key == "PREDICTOR")
+        {
+            ret.predictor = strToPredictor(val);
+            if (ret.predictor == PREDICTOR_ENUM_COUNT)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid predictor '" + val + "' (NONE/HORIZONTAL/FLOATING_POINT/AUTO)");
+                return 1;
+            }
+        }
+        else if (key == "LEVEL" || key == "ZLEVEL" || key == "ZSTD_LEVEL")
+        {
+            if (!isInt(val))
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Compression level must be an integer");
+                return 1;
+            }
+            ret.compressionLevel = atoi(val.c_str());
+        }
+        else if (key == "TILED")
+        {
+            ret.tiled = strToBool(val);
+        }
+        else if (key == "BLOCKSIZE" || key == "BLOCKXSIZE" || key == "BLOCKYSIZE")
+        {
+            if (!isInt(val) || atoi(val.c_str()) <= 0 || atoi(val.c_str()) % 16 != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Block size must be a positive multiple of 16");
+                return 1;
+            }
+            unsigned long size = atol(val.c_str());
+            if (key != "BLOCKYSIZE")
+                ret.blockSize.col = size;
+            if (key != "BLOCKXSIZE")
+                ret.blockSize.row = size;
+            ret.tiled = true;
+        }
+        else if (key == "BIGTIFF")
+        {
+            ret.bigTiff = strToBigTiff(val);
+            if (ret.bigTiff == BIGTIFF_ENUM_COUNT)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Invalid BigTIFF option '" + val + "' (NO/YES/IF_NEEDED/IF_SAFER)");
+                return 1;
+            }
+        }
+        else if (key == "NUM_THREADS")
+        {
+            if (val == "ALL_CPUS")
+            {
+                ret.threadCount = ALL_CPUS;
+            }
+            else if (isInt(val) && atoi(val.c_str()) >= 0)
+            {
+                ret.threadCount = atoi(val.c_str());
+            }
+            else
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "NUM_THREADS must be a positive integer or ALL_CPUS");
+                return 1;
+            }
+        }
+        else
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Unknown save option '" + key + "'");
+            return 1;
+        }
+    }
+    options = ret;
+    return 0;
+}
+
+std::ostream &operator<<(std::ostream &stream, const SImageSaveOptions &o)
+{
+    stream << "COMPRESS=" << SImageSaveOptions::compressionToStr(o.compression);
+    stream << ",PREDICTOR=" << SImageSaveOptions::predictorToStr(o.predictor);
+    if (o.compressionLevel >= 0)
+        stream << ",LEVEL=" << o.compressionLevel;
+    stream << ",TILED=" << (o.tiled ? "YES" : "NO");
+    if (o.tiled)
+        stream << ",BLOCKXSIZE=" << o.blockSize.col << ",BLOCKYSIZE=" << o.blockSize.row;
+    stream << ",BIGTIFF=" << SImageSaveOptions::bigTiffToStr(o.bigTiff);
+    if (o.threadCount == SImageSaveOptions::ALL_CPUS)
+        stream << ",NUM_THREADS=ALL_CPUS";
+    else
+        stream << ",NUM_THREADS=" << o.threadCount;
+    return stream;
+}
+
+} // namespace ultra
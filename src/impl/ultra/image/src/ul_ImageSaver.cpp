@@ -24,7 +24,8 @@
 namespace ultra
 {
 
-CImageSaver::CImageSaver()
+CImageSaver::CImageSaver() :
+m_defaultSaveOptions()
 {
 }
 
@@ -38,13 +39,23 @@ CImageSaver *CImageSaver::getInstance()
     return &instance;
 }
 
+void CImageSaver::setDefaultSaveOptions(const SImageSaveOptions &options)
+{
+    m_defaultSaveOptions = options;
+}
+
+const SImageSaveOptions &CImageSaver::getDefaultSaveOptions() const
+{
+    return m_defaultSaveOptions;
+}
+
 __ultra_internal::IImageSaver* CImageSaver::getSaverInstance()
 {
     __ultra_internal::IImageSaver *defaultInstance = __ultra_internal::CImageSaverGDAL::getInstance();
     return defaultInstance;
 }
 
-int CImageSaver::SaveImage(std::string pathToImageFile, const CImage &image, EImage::EImageFormat imageType, const SImageMetadata *metadata)
+int CImageSaver::SaveImage(std::string pathToImageFile, const CImage &image, EImage::EImageFormat imageType, const SImageMetadata *metadata, const SImageSaveOptions *options)
 {
     CMatrixArray<unsigned char> imgVec;
     imgVec.resize(3);
@@ -52,7 +63,7 @@ int CImageSaver::SaveImage(std::string pathToImageFile, const CImage &image, EIm
     imgVec[1] = image.getGreen();
     imgVec[2] = image.getBlue();
 
-    if (SaveImage(pathToImageFile, imgVec, imageType, metadata) != 0)
+    if (SaveImage(pathToImageFile, imgVec, imageType, metadata, options) != 0)
     {
         CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from SaveImage()");
         return 1;
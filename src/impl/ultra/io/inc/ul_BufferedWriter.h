@@ -0,0 +1,82 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace ultra
+{
+
+/**
+ * Writes a file through a large in-memory buffer, the file is only touched when
+ * the buffer fills up or on <code>Flush()</code>/<code>Close()</code>.
+ * <br>
+ * <code>Printf()</code> formats straight into the buffer, so writing many short
+ * records does not cost a stdio call per record.
+ */
+class CBufferedWriter
+{
+public:
+    static const unsigned long DEFAULT_BUFFER_SIZE;
+
+private:
+    FILE *m_file;
+    std::string m_path;
+    std::vector<char> m_buffer;
+    unsigned long m_used;
+    unsigned long long m_flushedBytes;
+
+    CBufferedWriter(const CBufferedWriter &r) = delete;
+    CBufferedWriter &operator=(const CBufferedWriter &r) = delete;
+
+public:
+    CBufferedWriter(unsigned long bufferSize = CBufferedWriter::DEFAULT_BUFFER_SIZE);
+    virtual ~CBufferedWriter();
+
+    /**
+     * Creates (truncates) the file at path
+     * @param path
+     * @return 0 on success
+     */
+    int Open(const std::string &path);
+    int Write(const void *data, unsigned long size);
+    int Write(const std::string &str);
+    int Printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+    /**
+     * Overwrites bytes that have already been written, used to fill in
+     * headers whose values are only known once all the records are out
+     * @param offset byte offset from the start of the file
+     * @param data
+     * @param size
+     * @return 0 on success
+     */
+    int Patch(unsigned long long offset, const void *data, unsigned long size);
+    int Flush();
+    int Close();
+
+    bool isOpen() const;
+    /**
+     * @return the amount of bytes written so far, including the ones still buffered
+     */
+    unsigned long long getPosition() const;
+    std::string getPath() const;
+};
+
+} // namespace ultra
@@ -0,0 +1,226 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ul_BufferedWriter.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "ul_Logger.h"
+
+namespace ultra
+{
+
+const unsigned long CBufferedWriter::DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+CBufferedWriter::CBufferedWriter(unsigned long bufferSize) :
+m_buffer(bufferSize > 0 ? bufferSize : 1)
+{
+    m_file = NULL;
+    m_used = 0;
+    m_flushedBytes = 0;
+}
+
+CBufferedWriter::~CBufferedWriter()
+{
+    if (isOpen() && Close() != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "Failed to close '" + m_path + "'");
+    }
+}
+
+int CBufferedWriter::Open(const std::string &path)
+{
+    if (isOpen() && Close() != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Close()");
+        return 1;
+    }
+
+    m_file = fopen(path.c_str(), "wb");
+    if (m_file == NULL)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to create '" + path + "'");
+        return 1;
+    }
+    // all the buffering is done here
+    setvbuf(m_file, NULL, _IONBF, 0);
+    m_path = path;
+    m_used = 0;
+    m_flushedBytes = 0;
+    return 0;
+}
+
+int CBufferedWriter::Write(const void *data, unsigned long size)
+{
+    if (!isOpen())
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Writer is not open");
+        return 1;
+    }
+
+    const char *src = (const char *) data;
+    while (size > 0)
+    {
+        if (m_used == m_buffer.size() && Flush() != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Flush()");
+            return 1;
+        }
+        unsigned long amount = m_buffer.size() - m_used;
+        if (amount > size)
+            amount = size;
+        memcpy(m_buffer.data() + m_used, src, amount);
+        m_used += amount;
+        src += amount;
+        size -= amount;
+    }
+    return 0;
+}
+
+int CBufferedWriter::Write(const std::string &str)
+{
+    return Write(str.data(), str.size());
+}
+
+int CBufferedWriter::Printf(const char *format, ...)
+{
+    if (!isOpen())
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Writer is not open");
+        return 1;
+    }
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        unsigned long available = m_buffer.size() - m_used;
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(m_buffer.data() + m_used, available, format, args);
+        va_end(args);
+        if (length < 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to format '" + std::string(format) + "'");
+            return 1;
+        }
+        if ((unsigned long) length < available)
+        {
+            m_used += length;
+            return 0;
+        }
+        if (attempt == 0 && m_used > 0 && (unsigned long) length < m_buffer.size())
+        {
+            if (Flush() != 0)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from Flush()");
+                return 1;
+            }
+            continue;
+        }
+
+        // longer than the whole buffer, format it on the side
+        std::vector<char> temp(length + 1);
+        va_start(args, format);
+        vsnprintf(temp.data(), temp.size(), format, args);
+        va_end(args);
+        return Write(temp.data(), length);
+    }
+    return 0;
+}
+
+int CBufferedWriter::Patch(unsigned long long offset, const void *data, unsigned long size)
+{
+    if (offset + size > getPosition())
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Can only patch bytes that have already been written");
+        return 1;
+    }
+
+    const char *src = (const char *) data;
+    if (offset < m_flushedBytes)
+    {
+        unsigned long onDisk = size;
+        if (offset + onDisk > m_flushedBytes)
+            onDisk = (unsigned long) (m_flushedBytes - offset);
+        if (fseeko(m_file, (off_t) offset, SEEK_SET) != 0 ||
+            fwrite(src, 1, onDisk, m_file) != onDisk ||
+            fseeko(m_file, 0, SEEK_END) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to patch '" + m_path + "'");
+            return 1;
+        }
+        src += onDisk;
+        offset += onDisk;
+        size -= onDisk;
+    }
+    if (size > 0)
+        memcpy(m_buffer.data() + (offset - m_flushedBytes), src, size);
+    return 0;
+}
+
+int CBufferedWriter::Flush()
+{
+    if (!isOpen())
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Writer is not open");
+        return 1;
+    }
+    if (m_used == 0)
+        return 0;
+
+    if (fwrite(m_buffer.data(), 1, m_used, m_file) != m_used)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to write to '" + m_path + "'");
+        return 1;
+    }
+    m_flushedBytes += m_used;
+    m_used = 0;
+    return 0;
+}
+
+int CBufferedWriter::Close()
+{
+    if (!isOpen())
+        return 0;
+
+    int ret = Flush();
+    if (fclose(m_file) != 0)
+        ret = 1;
+    m_file = NULL;
+    if (ret != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to close '" + m_path + "'");
+        return 1;
+    }
+    return 0;
+}
+
+bool CBufferedWriter::isOpen() const
+{
+    return m_file != NULL;
+}
+
+unsigned long long CBufferedWriter::getPosition() const
+{
+    return m_flushedBytes + m_used;
+}
+
+std::string CBufferedWriter::getPath() const
+{
+    return m_path;
+}
+
+} // namespace ultra
@@ -196,7 +196,7 @@ int COdl::add(const std::string &key, const std::string &value)
     {
         if (value != getItemStr(key))
         {
-            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Item '" + key + "' already exists, going to overwrite the value");
+            ULTRA_LOG(CLogger::LOG_DEBUG, "Item '" + key + "' already exists, going to overwrite the value");
             remove(key);
             std::vector<SOdlItem> vec;
             vec.push_back(SOdlItem(value));
@@ -238,7 +238,7 @@ int COdl::add(const std::string &key, const std::vector<std::string> &value)
     }
     if (isItemPresentExactMatch(key))
     {
-        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_DEBUG, "Item '" + key + "' already exists, going to overwrite the value");
+        ULTRA_LOG(CLogger::LOG_DEBUG, "Item '" + key + "' already exists, going to overwrite the value");
         remove(key);
     }
 
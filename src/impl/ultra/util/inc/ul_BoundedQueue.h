@@ -0,0 +1,157 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include "ul_UltraThread.h"
+
+namespace ultra
+{
+
+/**
+ * A first-in first-out queue shared between producer and consumer threads
+ * <br>
+ * <code>Push()</code> blocks while the queue holds <code>capacity</code> items,
+ * <code>Pop()</code> blocks while it is empty. Once the producers are done
+ * <code>Close()</code> is called, consumers then drain the remaining items and
+ * <code>Pop()</code> returns false.
+ * <br><br>
+ * <code>
+ * CBoundedQueue&lt;CChip&lt;float&gt; &gt; queue(64);<br>
+ * // producers: queue.Push(std::move(chip));<br>
+ * // consumers: while (queue.Pop(chip)) { ... }<br>
+ * queue.Close(); // after the last producer finished, also when it failed<br>
+ * </code>
+ */
+template<class T>
+class CBoundedQueue
+{
+private:
+    std::shared_ptr<CThreadLock> m_lock;
+    std::deque<T> m_items;
+    unsigned long m_capacity;
+    bool m_closed;
+
+    CBoundedQueue(const CBoundedQueue &r);
+    CBoundedQueue &operator=(const CBoundedQueue &r);
+public:
+
+    explicit CBoundedQueue(unsigned long capacity) :
+    m_lock(std::make_shared<CThreadLock>())
+    {
+        m_capacity = capacity < 1 ? 1 : capacity;
+        m_closed = false;
+    }
+
+    virtual ~CBoundedQueue()
+    {
+    }
+
+    /**
+     * Blocks until there is space in the queue
+     * @param item
+     * @return 0 on success, 1 if the queue was closed
+     */
+    int Push(T item)
+    {
+        AUTO_LOCK(m_lock);
+        while (!m_closed && m_items.size() >= m_capacity)
+        {
+            m_lock->wait(__FILE__, __LINE__);
+        }
+        if (m_closed)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Cannot push onto a closed queue");
+            return 1;
+        }
+        m_items.push_back(std::move(item));
+        m_lock->broadcast(__FILE__, __LINE__);
+        return 0;
+    }
+
+    /**
+     * Blocks until an item is available or the queue is closed and drained
+     * @param item
+     * @return false when no more items will arrive
+     */
+    bool Pop(T &item)
+    {
+        AUTO_LOCK(m_lock);
+        while (!m_closed && m_items.empty())
+        {
+            m_lock->wait(__FILE__, __LINE__);
+        }
+        if (m_items.empty())
+            return false;
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_lock->broadcast(__FILE__, __LINE__);
+        return true;
+    }
+
+    /**
+     * Blocks like Pop() for the first item, then takes up to <code>maxItems</code> items
+     * that are already queued without waiting for more
+     * @param items replaced with the popped items
+     * @param maxItems
+     * @return false when no more items will arrive
+     */
+    bool PopBatch(std::vector<T> &items, unsigned long maxItems)
+    {
+        items.clear();
+        AUTO_LOCK(m_lock);
+        while (!m_closed && m_items.empty())
+        {
+            m_lock->wait(__FILE__, __LINE__);
+        }
+        if (m_items.empty())
+            return false;
+        while (!m_items.empty() && items.size() < (maxItems < 1 ? 1 : maxItems))
+        {
+            items.push_back(std::move(m_items.front()));
+            m_items.pop_front();
+        }
+        m_lock->broadcast(__FILE__, __LINE__);
+        return true;
+    }
+
+    /**
+     * No more items will be pushed, wakes all waiting consumers
+     */
+    void Close()
+    {
+        AUTO_LOCK(m_lock);
+        m_closed = true;
+        m_lock->broadcast(__FILE__, __LINE__);
+    }
+
+    bool isClosed() const
+    {
+        AUTO_LOCK(m_lock);
+        return m_closed;
+    }
+
+    unsigned long size() const
+    {
+        AUTO_LOCK(m_lock);
+        return m_items.size();
+    }
+};
+
+} //namespace ultra
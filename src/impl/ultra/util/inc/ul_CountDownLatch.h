@@ -0,0 +1,64 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include <memory>
+#include "ul_UltraThread.h"
+
+namespace ultra
+{
+
+/**
+ * Blocks waiting threads until a number of tasks signalled completion
+ * <br><br>
+ * <code>
+ * CCountDownLatch latch(threadCount);<br>
+ * // every task calls latch.countDown() once it is done, also when it fails<br>
+ * latch.await(); // returns the moment the last task counted down<br>
+ * </code>
+ */
+class CCountDownLatch
+{
+private:
+    std::shared_ptr<CThreadLock> m_lock;
+    unsigned long m_count;
+
+    CCountDownLatch(const CCountDownLatch &r);
+    CCountDownLatch &operator=(const CCountDownLatch &r);
+public:
+    explicit CCountDownLatch(unsigned long count = 0);
+    virtual ~CCountDownLatch();
+
+    /**
+     * Decrements the count, waking all waiting threads when it reaches zero
+     * @return the count remaining after this call
+     */
+    unsigned long countDown();
+    unsigned long getCount() const;
+    /**
+     * Blocks until the count reaches zero
+     * @return 0 on success
+     */
+    int await() const;
+    /**
+     * Must only be called when no thread is waiting on the latch
+     * @param count
+     */
+    void reset(unsigned long count);
+};
+
+} //namespace ultra
@@ -21,6 +21,7 @@
 
 #include <ul_Exception.h>
 #include <memory>
+#include <atomic>
 
 namespace ultra
 {
@@ -40,8 +41,44 @@ struct SLoggerMaxLog
     SLoggerMaxLog(std::string &file, int line);
 };
 
+struct SLogEntry
+{
+
+    enum EEntryType
+    {
+        ENTRY_LINE = 0,
+        ENTRY_NO_NEW_LINE,
+        ENTRY_FILE_ONLY
+    };
+
+    EEntryType type;
+    long long timeSeconds;
+    int timeMilliseconds;
+    std::string file;
+    int line;
+    std::string msg;
+
+    SLogEntry();
+    ~SLogEntry();
+};
+
 } // namespace ultra_InternalLoggingStructs
 
+/**
+ * Logs only if the level is enabled, the message expression is not evaluated otherwise
+ */
+#define ULTRA_LOG(level, msg) do { if (ultra::CLogger::getInstance()->canLog(level)) ultra::CLogger::getInstance()->Log(__FILE__, __LINE__, level, msg); } while (0)
+#define ULTRA_LOG_NO_NEW_LINE(level, msg) do { if (ultra::CLogger::getInstance()->canLog(level)) ultra::CLogger::getInstance()->LogNoNewLine(__FILE__, __LINE__, level, msg); } while (0)
+
+/**
+ * Process wide logger writing to stdout (tee) and an optional log file.
+ * <br>
+ * Messages are timestamped by the caller and handed to a background writer
+ * thread through a bounded ring buffer, the writer formats them and writes
+ * them in batches to a log file descriptor that stays open. Errors are
+ * written before <code>Log()</code> returns, everything else may still be
+ * queued, use <code>Flush()</code> where the output has to be on disk.
+ */
 class CLogger
 {
 public:
@@ -55,22 +92,46 @@ public:
         LOG_NONE,
         LOG_ENUM_COUNT
     };
+    /**
+     * Amount of messages that can be queued for the writer thread before callers block
+     */
+    static const unsigned long RING_SIZE;
+
 private:
     std::shared_ptr<void> m_lock;
+    std::shared_ptr<void> m_writeLock;
     std::string m_logPath;
-    bool m_loggerIsuseTee;
-    bool m_getLocalTime;
-    bool m_details;
+    mutable int m_logFd;
+    std::atomic<bool> m_loggerIsuseTee;
+    std::atomic<bool> m_getLocalTime;
+    std::atomic<bool> m_details;
+    std::atomic<int> m_logLevel;
     mutable std::vector<std::shared_ptr<ultra_InternalLoggingStructs::SLoggerMaxLog> > m_limitedLogItems;
-    std::string getTimeStr() const;
-    ELogLevel m_logLevel;
-    int innerLog(std::string file, int line, std::string msg, std::string msgColor, bool isTitle) const;
-    int innerLogLimited(std::string file, int line, std::string msg, std::string msgColor, int maxAmountOfLogsAllowed = 5) const;
-    int innerLogNoNewLine(std::string file, int line, std::string msgColor) const;
+
+    // ring buffer drained by the writer thread, guarded by m_lock
+    mutable std::vector<ultra_InternalLoggingStructs::SLogEntry> m_ring;
+    mutable unsigned long m_ringHead;
+    mutable unsigned long m_ringCount;
+    mutable unsigned long long m_enqueued;
+    mutable unsigned long long m_written;
+    mutable bool m_writerStarted;
+    mutable bool m_writerRunning;
+    mutable bool m_writerStopping;
+    mutable std::shared_ptr<void> m_writerThread;
+
+    std::string getTimeStr(long long seconds, int milliseconds) const;
     std::string getFileName(const std::string name) const;
-    std::string buildMessage(ELogLevel level, std::string msg, std::string &colorMsg) const;
+    std::string buildMessage(ELogLevel level, std::string msg) const;
+    int Enqueue(ultra_InternalLoggingStructs::SLogEntry &entry, bool waitUntilWritten) const;
+    bool StartWriter() const;
+    void StopWriter();
+    void WriterLoop() const;
+    static void *writerThreadRunner(void *context);
+    void WriteEntries(std::vector<ultra_InternalLoggingStructs::SLogEntry> &entries) const;
     int lock() const;
     int unlock() const;
+    int wait() const;
+    int broadcast() const;
     CLogger();
 public:
     virtual ~CLogger();
@@ -89,7 +150,14 @@ public:
     void setUseLocalTime(bool useLocalTime);
     void disableLogDetails();
     void enableLogDetails();
+    /**
+     * Lock free, use ULTRA_LOG() to skip building messages that would not be logged
+     */
     bool canLog(ELogLevel level) const;
+    /**
+     * Blocks until every message logged so far has been written
+     */
+    void Flush() const;
 };
 
 } //namespace ultra
@@ -0,0 +1,205 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ul_UltraThread.h>
+
+namespace ultra
+{
+
+/**
+ * Process wide registry of stage timings and counters.
+ * <br>
+ * Stages are timed with <code>ULTRA_SCOPED_TIMER(name)</code>, timing the same
+ * name more than once (per tile, per pyramid level) accumulates into one entry.
+ * CPU time is the CPU time of the whole process while the stage ran, so for a
+ * multi-threaded stage it is larger than the wall time, stages that overlap
+ * (chip generation runs alongside correlation) each count the shared CPU time.
+ * <br>
+ * <code>SaveJson()</code> writes every stage and counter together with the total
+ * wall/CPU time and the peak resident set size.
+ */
+class CProfiler
+{
+public:
+    static const std::string COUNTER_IMAGE_BYTES_READ;
+    static const std::string COUNTER_IMAGE_BYTES_WRITTEN;
+    static const std::string COUNTER_CHIPS_ATTEMPTED;
+    static const std::string COUNTER_CHIPS_ACCEPTED;
+
+    struct SStageStats
+    {
+        unsigned long long count;
+        double wallSeconds;
+        double minWallSeconds;
+        double maxWallSeconds;
+        double cpuSeconds;
+
+        SStageStats();
+        ~SStageStats();
+    };
+
+private:
+    std::shared_ptr<CThreadLock> m_lock;
+    std::map<std::string, SStageStats> m_stages;
+    std::map<std::string, long long> m_counters;
+    double m_startWallSeconds;
+    double m_startCpuSeconds;
+
+    CProfiler();
+
+public:
+    virtual ~CProfiler();
+    static CProfiler *getInstance();
+
+    /**
+     * @return seconds on a monotonic clock
+     */
+    static double getWallSeconds();
+    /**
+     * @return CPU seconds used by all the threads of the process
+     */
+    static double getCpuSeconds();
+    /**
+     * @return the peak resident set size of the process in bytes
+     */
+    static unsigned long long getPeakRssBytes();
+
+    void AddStage(const std::string &name, double wallSeconds, double cpuSeconds);
+    void AddCounter(const std::string &name, long long amount);
+    long long getCounter(const std::string &name) const;
+    bool getStage(const std::string &name, SStageStats &stats) const;
+    void Clear();
+
+    std::string ToJson() const;
+    int SaveJson(const std::string &path) const;
+};
+
+/**
+ * Adds the wall and CPU time between its construction and destruction to a
+ * <code>CProfiler</code> stage, and a trace event if tracing is enabled
+ */
+class CScopedTimer
+{
+private:
+    std::string m_name;
+    double m_startWallSeconds;
+    double m_startCpuSeconds;
+
+    CScopedTimer(const CScopedTimer &r) = delete;
+    CScopedTimer &operator=(const CScopedTimer &r) = delete;
+
+public:
+    explicit CScopedTimer(const std::string &name);
+    virtual ~CScopedTimer();
+};
+
+#define ULTRA_SCOPED_TIMER(name) ultra::CScopedTimer __AUTO_LOCK_UNIQUE_NAME(ULTRA_SCOPED_TIMER_)(name)
+
+/**
+ * Records what every thread is doing as a timeline, written in the Chrome trace
+ * event format (chrome://tracing, ui.perfetto.dev).
+ * <br>
+ * Tracing is off until <code>Enable()</code> is called, a disabled trace scope
+ * costs one atomic load. Every thread appends its events to a buffer of its own
+ * without locking, the buffers are owned by the tracer so that the events of
+ * threads that have exited are kept. <code>SaveJson()</code> must only be called
+ * once the traced threads are done.
+ * <br>
+ * Every <code>ULTRA_SCOPED_TIMER</code> stage is also traced.
+ */
+class CTracer
+{
+private:
+    struct SEvent
+    {
+        std::string name;
+        const char *category;
+        double startSeconds;
+        double endSeconds;
+    };
+
+    struct SThreadBuffer
+    {
+        unsigned long threadId;
+        std::string threadName;
+        std::vector<SEvent> events;
+    };
+
+    std::shared_ptr<CThreadLock> m_lock;
+    std::vector<std::shared_ptr<SThreadBuffer> > m_buffers;
+    std::atomic<bool> m_enabled;
+    double m_startWallSeconds;
+
+    CTracer();
+    SThreadBuffer *getThreadBuffer();
+
+public:
+    static const char *CATEGORY_STAGE;
+    static const char *CATEGORY_CORRELATION;
+    static const char *CATEGORY_FFT;
+    static const char *CATEGORY_IO;
+    static const char *CATEGORY_RESAMPLE;
+
+    virtual ~CTracer();
+    static CTracer *getInstance();
+
+    void Enable();
+    void Disable();
+
+    bool isEnabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Names the calling thread in the timeline
+     * @param name
+     */
+    void SetThreadName(const std::string &name);
+    void AddEvent(const char *category, const std::string &name, double startSeconds, double endSeconds);
+    int SaveJson(const std::string &path) const;
+};
+
+/**
+ * Adds a trace event spanning its construction and destruction, nothing is
+ * recorded if tracing was disabled at construction
+ */
+class CTraceScope
+{
+private:
+    const char *m_category;
+    const char *m_name;
+    double m_startSeconds;
+    bool m_active;
+
+    CTraceScope(const CTraceScope &r) = delete;
+    CTraceScope &operator=(const CTraceScope &r) = delete;
+
+public:
+    CTraceScope(const char *category, const char *name);
+    virtual ~CTraceScope();
+};
+
+#define ULTRA_TRACE_SCOPE(category, name) ultra::CTraceScope __AUTO_LOCK_UNIQUE_NAME(ULTRA_TRACE_SCOPE_)(category, name)
+
+} // namespace ultra
@@ -89,6 +89,16 @@ public:
     unsigned long getPoolSize() const override;
     unsigned long getActiveTaskSize() const override;
     unsigned long getWaitingTaskSize() const override;
+
+    /**
+     * Splits [0, count) into at most <code>bandCount</code> contiguous bands and runs
+     * <code>fp(start, end)</code> for every band on a shared pool of the default pool size,
+     * a single band is run on the calling thread. Calls made from within a band run on the
+     * thread of that band, so nested calls never start more threads than the shared pool has.
+     * Band boundaries only depend on the arguments.
+     * @return 0 on success, 1 if a band threw
+     */
+    static int RunBands(unsigned long count, unsigned long bandCount, std::function<void(unsigned long, unsigned long) > fp);
 };
 
 } // namespace ultra
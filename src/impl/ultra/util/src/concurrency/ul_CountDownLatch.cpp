@@ -0,0 +1,69 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ul_CountDownLatch.h"
+
+namespace ultra
+{
+
+CCountDownLatch::CCountDownLatch(unsigned long count) :
+m_lock(std::make_shared<CThreadLock>())
+{
+    m_count = count;
+}
+
+CCountDownLatch::~CCountDownLatch()
+{
+}
+
+unsigned long CCountDownLatch::countDown()
+{
+    AUTO_LOCK(m_lock);
+    if (m_count == 0)
+        return 0;
+    m_count--;
+    if (m_count == 0)
+        m_lock->broadcast(__FILE__, __LINE__);
+    return m_count;
+}
+
+unsigned long CCountDownLatch::getCount() const
+{
+    AUTO_LOCK(m_lock);
+    return m_count;
+}
+
+int CCountDownLatch::await() const
+{
+    AUTO_LOCK(m_lock);
+    while (m_count > 0)
+    {
+        if (m_lock->wait(__FILE__, __LINE__) != 0)
+        {
+            CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to wait on a mutex");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void CCountDownLatch::reset(unsigned long count)
+{
+    AUTO_LOCK(m_lock);
+    m_count = count;
+}
+
+} //namespace ultra
@@ -16,9 +16,12 @@
 
 #include "ul_UltraThreadFixedPool.h"
 #include "ul_Exception.h"
+#include "ul_CountDownLatch.h"
 #include <ul_Logger.h>
 #include <ul_Utility.h>
 
+#include <atomic>
+
 namespace ultra
 {
 
@@ -249,16 +252,10 @@ int CUltraThreadPool::CBackGroundThreadSpawner::StartANewThread()
     {
         if ((*m_threadsBusy)[t]->isDone())
         {
-            int counter = 0;
-            while (!CUltraThread::getInstance()->hasFinished((*m_threadsBusy)[t].get()))
+            // the runner is done, its thread only has to return and blocks on nothing of the pool
+            if (CUltraThread::getInstance()->join((*m_threadsBusy)[t].get()) != 0)
             {
-                counter++;
-                if (counter > 60 * 10000)
-                {
-                    CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "POSSIBLE DEADLOCK DETECTED");
-                    break;
-                }
-                usleep(1000);
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "Failed to join a finished pool thread");
             }
             m_threadsBusy->erase(m_threadsBusy->begin() + t);
             m_lock->broadcast(__FILE__, __LINE__);
@@ -346,12 +343,11 @@ CUltraThreadPool::~CUltraThreadPool()
     JoinAllThreads();
     m_backGroundThreadSpawner->stop();
 
-    while (!CUltraThread::getInstance()->hasFinished(m_backGroundThreadSpawner.get()))
+    if (CUltraThread::getInstance()->join(m_backGroundThreadSpawner.get()) != 0)
     {
-        usleep(10000);
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_WARN, "Failed to join the thread pool spawner");
     }
 
-
     AUTO_LOCK(m_lock);
     m_threadsToRun.clear();
     m_threadsBusy.clear();
@@ -725,4 +721,72 @@ void CUltraThreadFixedPool::start(std::function<void(unsigned long) > fp)
     addJob(job);
 }
 
+namespace
+{
+
+// set while a thread runs a band, nested RunBands() calls then run on that thread
+thread_local bool runningBand = false;
+
+CUltraThreadFixedPool *getBandPool()
+{
+    // never destroyed, its idle workers wait for bands until the process exits
+    static CUltraThreadFixedPool *pool = new CUltraThreadFixedPool(AUltraThreadPool::getDefaultPoolSize());
+    return pool;
+}
+
+} // namespace
+
+int CUltraThreadFixedPool::RunBands(unsigned long count, unsigned long bandCount, std::function<void(unsigned long, unsigned long) > fp)
+{
+    bandCount = getMAX(1UL, getMIN(bandCount, count));
+    if (bandCount == 1 || runningBand)
+    {
+        fp(0, count);
+        return 0;
+    }
+
+    unsigned long bandSize = (count + bandCount - 1) / bandCount;
+    unsigned long jobCount = (count + bandSize - 1) / bandSize;
+    CCountDownLatch latch(jobCount);
+    std::atomic<bool> failed(false);
+    CUltraThreadFixedPool *pool = getBandPool();
+    for (unsigned long start = 0; start < count; start += bandSize)
+    {
+        unsigned long end = getMIN(count, start + bandSize);
+        std::function<void() > job = [&fp, &latch, &failed, start, end]()
+        {
+            runningBand = true;
+            try
+            {
+                fp(start, end);
+            }
+            catch (const std::exception &e)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, e);
+                failed = true;
+            }
+            catch (...)
+            {
+                CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Caught an unknown exception");
+                failed = true;
+            }
+            runningBand = false;
+            latch.countDown();
+        };
+        pool->start(job);
+    }
+
+    if (latch.await() != 0)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failure returned from CCountDownLatch::await()");
+        return 1;
+    }
+    if (failed)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "A band failed");
+        return 1;
+    }
+    return 0;
+}
+
 } // namespace ultra
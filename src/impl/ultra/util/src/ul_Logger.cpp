@@ -18,6 +18,8 @@
 
 #include <stdlib.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "ul_Utility.h"
 #include <sys/time.h>
 
@@ -56,21 +58,79 @@ SLoggerMaxLog::SLoggerMaxLog(std::string &file, int line)
     counter = 0;
 }
 
+SLogEntry::SLogEntry()
+{
+    type = ENTRY_LINE;
+    timeSeconds = 0;
+    timeMilliseconds = 0;
+    line = 0;
+}
+
+SLogEntry::~SLogEntry()
+{
+}
+
 } // namespace ultra_InternalLoggingStructs
 
+using ultra_InternalLoggingStructs::SLogEntry;
+
+const unsigned long CLogger::RING_SIZE = 4096;
+
+static void captureTime(SLogEntry &entry)
+{
+    struct timeval curTime;
+    gettimeofday(&curTime, NULL);
+    entry.timeSeconds = curTime.tv_sec;
+    entry.timeMilliseconds = curTime.tv_usec / 1000;
+}
+
+static void appendNewLine(std::string &out, const std::string &msg)
+{
+    if (msg.length() == 0 || msg[msg.length() - 1] != '\n')
+        out += '\n';
+}
+
+static void writeAll(int fd, const std::string &data)
+{
+    const char *dp = data.c_str();
+    size_t left = data.length();
+    while (left > 0)
+    {
+        ssize_t done = write(fd, dp, left);
+        if (done <= 0)
+            return;
+        dp += done;
+        left -= done;
+    }
+}
+
 CLogger::CLogger() :
-m_lock(new WRAPPER_LOCK_CLASS_TO_CREATE(), std::default_delete<WRAPPER_LOCK_CLASS_TO_CREATE>())
+m_lock(new WRAPPER_LOCK_CLASS_TO_CREATE(), std::default_delete<WRAPPER_LOCK_CLASS_TO_CREATE>()),
+m_writeLock(new WRAPPER_LOCK_CLASS_TO_CREATE(), std::default_delete<WRAPPER_LOCK_CLASS_TO_CREATE>()),
+m_ring(CLogger::RING_SIZE)
 {
     m_loggerIsuseTee = true;
     m_details = true;
     m_getLocalTime = false;
     m_logPath = "";
+    m_logFd = -1;
     m_limitedLogItems.clear();
     m_logLevel = CLogger::LOG_INFO;
+    m_ringHead = 0;
+    m_ringCount = 0;
+    m_enqueued = 0;
+    m_written = 0;
+    m_writerStarted = false;
+    m_writerRunning = false;
+    m_writerStopping = false;
 }
 
 CLogger::~CLogger()
 {
+    StopWriter();
+    if (m_logFd >= 0)
+        close(m_logFd);
+    m_logFd = -1;
     m_logPath = "";
     m_limitedLogItems.clear();
 }
@@ -91,208 +151,242 @@ int CLogger::unlock() const
     return ((WRAPPER_LOCK_CLASS_TO_CREATE*) m_lock.get())->unlock();
 }
 
-std::string CLogger::getTimeStr() const
+int CLogger::wait() const
 {
-    std::string ret;
-    struct timeval curTime;
-    gettimeofday(&curTime, NULL);
-    int milli = curTime.tv_usec / 1000;
-    time_t now = curTime.tv_sec;
-    tm *ltm = m_getLocalTime ? localtime(&now) : gmtime(&now);
-    char temp[2048];
-    snprintf(temp, 2047, "%04d-%02d-%02dT%02d:%02d:%02d:%03d", ltm->tm_year + 1900,
-             ltm->tm_mon + 1,
-             ltm->tm_mday,
-             ltm->tm_hour,
-             ltm->tm_min,
-             ltm->tm_sec,
-             milli);
-    ret = temp;
-
-    return ret;
+    return ((WRAPPER_LOCK_CLASS_TO_CREATE*) m_lock.get())->wait();
+}
+
+int CLogger::broadcast() const
+{
+    return ((WRAPPER_LOCK_CLASS_TO_CREATE*) m_lock.get())->broadcast();
+}
+
+std::string CLogger::getTimeStr(long long seconds, int milliseconds) const
+{
+    time_t now = (time_t) seconds;
+    tm ltm;
+    if (m_getLocalTime)
+        localtime_r(&now, &ltm);
+    else
+        gmtime_r(&now, &ltm);
+    char temp[64];
+    snprintf(temp, sizeof (temp), "%04d-%02d-%02dT%02d:%02d:%02d:%03d", ltm.tm_year + 1900,
+             ltm.tm_mon + 1,
+             ltm.tm_mday,
+             ltm.tm_hour,
+             ltm.tm_min,
+             ltm.tm_sec,
+             milliseconds);
+    return temp;
 }
 
 void CLogger::setUseTEE(bool useTeeCommand)
 {
-    lock();
     m_loggerIsuseTee = useTeeCommand;
-    unlock();
 }
 
 void CLogger::setUseLocalTime(bool useLocalTime)
 {
-    lock();
     m_getLocalTime = useLocalTime;
-    unlock();
 }
 
 int CLogger::setLogFilePath(std::string path)
 {
-    lock();
     if (path == "")
-    {
-        unlock();
         return 0;
-    }
-    int fd = open(path.c_str(), O_TRUNC | O_CLOEXEC | O_RDWR | O_CREAT, 0666);
+
+    int fd = open(path.c_str(), O_TRUNC | O_CLOEXEC | O_WRONLY | O_CREAT | O_APPEND, 0666);
     if (fd < 0)
-    {
-        unlock();
         return 1;
-    }
-    close(fd);
+
+    // messages queued so far belong to the previous file
+    Flush();
+    WRAPPER_LOCK_CLASS_TO_CREATE *writeLock = (WRAPPER_LOCK_CLASS_TO_CREATE*) m_writeLock.get();
+    writeLock->lock();
+    if (m_logFd >= 0)
+        close(m_logFd);
+    m_logFd = fd;
     m_logPath = path;
-    unlock();
+    writeLock->unlock();
     return 0;
 }
 
-int CLogger::innerLogLimited(std::string file, int line, std::string msg, std::string msgColor, int maxAmountOfLogsAllowed) const
+bool CLogger::StartWriter() const
 {
-    int ret = 0;
-    bool found = false;
-    int index = 0;
-    for (unsigned int p = 0; p < m_limitedLogItems.size(); p++)
+    // called with m_lock held
+    if (!m_writerStarted)
     {
-        if (line == m_limitedLogItems[p]->line && file == m_limitedLogItems[p]->file)
+        m_writerStarted = true;
+        std::shared_ptr<pthread_t> thread = std::make_shared<pthread_t>();
+        if (pthread_create(thread.get(), NULL, &CLogger::writerThreadRunner, (void *) this) == 0)
         {
-            found = true;
-            index = p;
-            break;
+            m_writerThread = thread;
+            m_writerRunning = true;
         }
     }
+    return m_writerRunning;
+}
 
-    if (!found)
-    {
-        std::shared_ptr<ultra_InternalLoggingStructs::SLoggerMaxLog> item = std::make_shared<ultra_InternalLoggingStructs::SLoggerMaxLog>(file, line);
-        item->counter++;
-        std::string head = "Limited log (" + toString(item->counter) + "/" + toString(maxAmountOfLogsAllowed) + "): ";
-        msg = head + msg;
-        msgColor = head + msgColor;
-        innerLog(getFileName(item->file), item->line, msg, msgColor, false);
-        m_limitedLogItems.push_back(item);
-    }
-    else
-    {
-        if (m_limitedLogItems[index]->counter < maxAmountOfLogsAllowed)
-        {
-            m_limitedLogItems[index]->counter++;
-            std::string head = "Limited log (" + toString(m_limitedLogItems[index]->counter) + "/" + toString(maxAmountOfLogsAllowed) + "): ";
-            msg = head + msg;
-            msgColor = head + msgColor;
-            innerLog(getFileName(m_limitedLogItems[index]->file), m_limitedLogItems[index]->line, msg, msgColor, false);
-        }
-    }
+void CLogger::StopWriter()
+{
+    lock();
+    m_writerStopping = true;
+    broadcast();
+    std::shared_ptr<void> thread = m_writerThread;
+    m_writerThread.reset();
+    unlock();
+
+    if (thread != nullptr)
+        pthread_join(*((pthread_t *) thread.get()), NULL);
+}
 
-    return ret;
+void *CLogger::writerThreadRunner(void *context)
+{
+    ((const CLogger *) context)->WriterLoop();
+    return NULL;
 }
 
-int CLogger::innerLog(std::string file, int line, std::string msg, std::string msgColor, bool isTitle) const
+void CLogger::WriterLoop() const
 {
-    if (!m_logPath.empty())
+    std::vector<SLogEntry> batch;
+    batch.reserve(RING_SIZE);
+
+    lock();
+    while (true)
     {
-        int fd = open(m_logPath.c_str(), O_CLOEXEC | O_RDWR | O_APPEND, 0666);
-        if (fd < 0)
-        {
-            std::cout << "Failed to write to logFile at " << m_logPath.c_str() << std::endl;
-            return 1;
-        }
-        std::string message;
-        if (isTitle)
-            message = msg;
-        else
-            message = getTimeStr() + " " + file + " " + toString(line) + ": " + msg;
-        write(fd, message.c_str(), message.length());
-        if (msg.length() > 0)
+        while (m_ringCount == 0 && !m_writerStopping)
         {
-            if (msg[msg.length() - 1] != '\n')
-            {
-                message = "\n";
-                write(fd, message.c_str(), message.length());
-            }
+            wait();
         }
-        else
+        if (m_ringCount == 0)
+            break;
+
+        batch.clear();
+        for (unsigned long t = 0; t < m_ringCount; t++)
         {
-            message = "\n";
-            write(fd, message.c_str(), message.length());
+            batch.push_back(std::move(m_ring[(m_ringHead + t) % RING_SIZE]));
         }
-        close(fd);
+        m_ringHead = (m_ringHead + m_ringCount) % RING_SIZE;
+        m_ringCount = 0;
+        broadcast();
+        unlock();
+
+        WriteEntries(batch);
+
+        lock();
+        m_written += batch.size();
+        broadcast();
     }
+    m_writerRunning = false;
+    broadcast();
+    unlock();
+}
 
-    if (m_loggerIsuseTee)
+void CLogger::WriteEntries(std::vector<SLogEntry> &entries) const
+{
+    WRAPPER_LOCK_CLASS_TO_CREATE *writeLock = (WRAPPER_LOCK_CLASS_TO_CREATE*) m_writeLock.get();
+    writeLock->lock();
+
+    bool tee = m_loggerIsuseTee;
+    bool details = m_details;
+    std::string fileOut;
+    std::string teeOut;
+    bool flushTee = false;
+    for (unsigned long t = 0; t < entries.size(); t++)
     {
-        if (m_details)
-        {
-            if (isTitle)
-                std::cout << msgColor;
-            else
-                std::cout << getTimeStr() << " " << file << " " << line << ": " << msgColor;
-        }
-        else
+        const SLogEntry &entry = entries[t];
+        std::string prefix;
+        if (entry.type != SLogEntry::ENTRY_FILE_ONLY)
+            prefix = getTimeStr(entry.timeSeconds, entry.timeMilliseconds) + " " + getFileName(entry.file) + " " + toString(entry.line) + ": ";
+
+        if (entry.type != SLogEntry::ENTRY_NO_NEW_LINE && m_logFd >= 0)
         {
-            std::cout << msgColor;
+            fileOut += prefix;
+            fileOut += entry.msg;
+            appendNewLine(fileOut, entry.msg);
         }
 
-        if (msg.length() > 0)
+        if (entry.type != SLogEntry::ENTRY_FILE_ONLY && tee)
         {
-            if (msg[msg.length() - 1] != '\n')
-            {
-                std::cout << std::endl;
-            }
+            if (details)
+                teeOut += prefix;
+            teeOut += entry.msg;
+            if (entry.type == SLogEntry::ENTRY_LINE)
+                appendNewLine(teeOut, entry.msg);
+            flushTee = true;
         }
-        else
+    }
+
+    if (!fileOut.empty())
+        writeAll(m_logFd, fileOut);
+    if (flushTee)
+        std::cout << teeOut << std::flush;
+
+    writeLock->unlock();
+}
+
+int CLogger::Enqueue(SLogEntry &entry, bool waitUntilWritten) const
+{
+    lock();
+    while (StartWriter() && !m_writerStopping && m_ringCount == RING_SIZE)
+    {
+        wait();
+    }
+
+    if (!m_writerRunning || m_writerStopping)
+    {
+        // no writer thread (failed to start or the logger is being destroyed), write in place
+        unlock();
+        std::vector<SLogEntry> entries(1);
+        entries[0] = std::move(entry);
+        WriteEntries(entries);
+        return 0;
+    }
+
+    m_ring[(m_ringHead + m_ringCount) % RING_SIZE] = std::move(entry);
+    m_ringCount++;
+    unsigned long long sequence = ++m_enqueued;
+    broadcast();
+
+    if (waitUntilWritten)
+    {
+        while (m_written < sequence && m_writerRunning)
         {
-            std::cout << std::endl;
+            wait();
         }
     }
-
+    unlock();
     return 0;
 }
 
-std::string CLogger::buildMessage(ELogLevel level, std::string msg, std::string &colorMsg) const
+void CLogger::Flush() const
 {
-    std::string ret;
+    lock();
+    unsigned long long target = m_enqueued;
+    while (m_written < target && m_writerRunning)
+    {
+        wait();
+    }
+    unlock();
+}
+
+std::string CLogger::buildMessage(ELogLevel level, std::string msg) const
+{
+    if (!m_details)
+        return msg;
+
     switch (level)
     {
     case LOG_DEBUG:
-        if (m_details)
-        {
-            ret = "DEBUG: " + msg;
-            colorMsg = ret;
-        }
-        else
-            colorMsg = ret = msg;
-
-        break;
+        return "DEBUG: " + msg;
     case LOG_INFO:
-        if (m_details)
-        {
-            ret = "INFO: " + msg;
-            colorMsg = ret;
-        }
-        else
-            colorMsg = ret = msg;
-        break;
+        return "INFO: " + msg;
     case LOG_WARN:
-        if (m_details)
-        {
-            ret = "WARN: " + msg;
-            colorMsg = ret;
-        }
-        else
-            colorMsg = ret = msg;
-        break;
+        return "WARN: " + msg;
     case LOG_ERROR:
-        if (m_details)
-        {
-            ret = "ERROR: " + msg;
-            colorMsg = ret;
-        }
-        else
-            colorMsg = ret = msg;
-
-        break;
+        return "ERROR: " + msg;
     }
-    return ret;
+    return msg;
 }
 
 int CLogger::LogLimited(std::string file, int line, ELogLevel level, std::string msg, int maxAmountOfLogsAllowed) const
@@ -301,37 +395,35 @@ int CLogger::LogLimited(std::string file, int line, ELogLevel level, std::string
         return 0;
 
     lock();
-    bool found = false;
-    int index = 0;
+    std::shared_ptr<ultra_InternalLoggingStructs::SLoggerMaxLog> item;
     for (unsigned int p = 0; p < m_limitedLogItems.size(); p++)
     {
         if (line == m_limitedLogItems[p]->line && file == m_limitedLogItems[p]->file)
         {
-            found = true;
-            index = p;
+            item = m_limitedLogItems[p];
             break;
         }
     }
-    if (found)
+    if (item == nullptr)
     {
-        if (m_limitedLogItems[index]->counter >= maxAmountOfLogsAllowed)
-        {
-            unlock();
-            return 0;
-        }
+        item = std::make_shared<ultra_InternalLoggingStructs::SLoggerMaxLog>(file, line);
+        m_limitedLogItems.push_back(item);
     }
-
-    std::string colorMsg;
-    msg = buildMessage(level, msg, colorMsg);
-
-    if (innerLogLimited(file, line, msg, colorMsg, maxAmountOfLogsAllowed) != 0)
+    if (item->counter >= maxAmountOfLogsAllowed)
     {
         unlock();
-        return 1;
+        return 0;
     }
-
+    item->counter++;
+    std::string head = "Limited log (" + toString(item->counter) + "/" + toString(maxAmountOfLogsAllowed) + "): ";
     unlock();
-    return 0;
+
+    SLogEntry entry;
+    captureTime(entry);
+    entry.file = file;
+    entry.line = line;
+    entry.msg = head + buildMessage(level, msg);
+    return Enqueue(entry, level == LOG_ERROR);
 }
 
 int CLogger::Log(ELogLevel level, const CException &ex) const
@@ -359,47 +451,17 @@ int CLogger::LogToFile(ELogLevel level, std::string msg) const
     if (!canLog(level))
         return 0;
 
-    lock();
-    if (!m_logPath.empty())
-    {
-        int fd = open(m_logPath.c_str(), O_CLOEXEC | O_RDWR | O_APPEND, 0666);
-        if (fd < 0)
-        {
-            std::cout << "Failed to write to logFile at " << m_logPath.c_str() << std::endl;
-            unlock();
-            return 1;
-        }
-
-        if (msg.length() > 0)
-            write(fd, msg.c_str(), msg.length());
-        if (msg.length() > 0)
-        {
-            if (msg[msg.length() - 1] != '\n')
-            {
-                msg = "\n";
-                write(fd, msg.c_str(), msg.length());
-            }
-        }
-        else
-        {
-            msg = "\n";
-            write(fd, msg.c_str(), msg.length());
-        }
-        close(fd);
-    }
-    unlock();
-    return 0;
+    SLogEntry entry;
+    entry.type = SLogEntry::ENTRY_FILE_ONLY;
+    entry.msg = std::move(msg);
+    return Enqueue(entry, level == LOG_ERROR);
 }
 
 bool CLogger::canLog(ELogLevel level) const
 {
     if (level == LOG_NONE)
         return false;
-    lock();
-    int LoggerLogLevel = static_cast<int> (m_logLevel);
-    bool result = LoggerLogLevel <= static_cast<int> (level);
-    unlock();
-    return result;
+    return m_logLevel.load(std::memory_order_relaxed) <= static_cast<int> (level);
 }
 
 int CLogger::Log(std::string file, int line, ELogLevel level, std::string msg) const
@@ -407,17 +469,12 @@ int CLogger::Log(std::string file, int line, ELogLevel level, std::string msg) c
     if (!canLog(level))
         return 0;
 
-    file = getFileName(file);
-    lock();
-    std::string colorMsg;
-    msg = buildMessage(level, msg, colorMsg);
-    if (innerLog(file, line, msg, colorMsg, false) != 0)
-    {
-        unlock();
-        return 1;
-    }
-    unlock();
-    return 0;
+    SLogEntry entry;
+    captureTime(entry);
+    entry.file = std::move(file);
+    entry.line = line;
+    entry.msg = buildMessage(level, msg);
+    return Enqueue(entry, level == LOG_ERROR);
 }
 
 int CLogger::LogNoNewLine(std::string file, int line, ELogLevel level, std::string msg) const
@@ -425,31 +482,13 @@ int CLogger::LogNoNewLine(std::string file, int line, ELogLevel level, std::stri
     if (!canLog(level))
         return 0;
 
-    file = getFileName(file);
-
-    lock();
-    std::string colorMsg;
-    msg = buildMessage(level, msg, colorMsg);
-    if (innerLogNoNewLine(file, line, colorMsg) != 0)
-    {
-        unlock();
-        return 1;
-    }
-    unlock();
-    return 0;
-}
-
-int CLogger::innerLogNoNewLine(std::string file, int line, std::string msgColor) const
-{
-    if (m_loggerIsuseTee)
-    {
-        if (m_details)
-            std::cout << getTimeStr() << " " << file << " " << line << ": " << msgColor << std::flush;
-        else
-            std::cout << msgColor << std::flush;
-    }
-
-    return 0;
+    SLogEntry entry;
+    entry.type = SLogEntry::ENTRY_NO_NEW_LINE;
+    captureTime(entry);
+    entry.file = std::move(file);
+    entry.line = line;
+    entry.msg = buildMessage(level, msg);
+    return Enqueue(entry, level == LOG_ERROR);
 }
 
 void CLogger::setLogLevel(ELogLevel logLevel)
@@ -458,46 +497,41 @@ void CLogger::setLogLevel(ELogLevel logLevel)
     {
         return;
     }
-    lock();
     m_logLevel = logLevel;
-    unlock();
 }
 
 CLogger::ELogLevel CLogger::getLogLevel() const
 {
-    ELogLevel ret;
-
-    lock();
-    ret = m_logLevel;
-    unlock();
-
-    return ret;
+    return static_cast<ELogLevel> (m_logLevel.load());
 }
 
 void CLogger::LogLogLevels() const
 {
-    lock();
     std::string msg;
-    switch (m_logLevel)
+    switch (getLogLevel())
     {
     case CLogger::LOG_DEBUG:
         msg = "LOGGER: Log level is: DEBUG";
-        innerLog(getFileName(__FILE__), __LINE__, msg, msg, false);
         break;
     case CLogger::LOG_ERROR:
         msg = "LOGGER: Log level is: ERROR";
-        innerLog(getFileName(__FILE__), __LINE__, msg, msg, false);
         break;
     case CLogger::LOG_INFO:
         msg = "LOGGER: Log level is: INFO";
-        innerLog(getFileName(__FILE__), __LINE__, msg, msg, false);
         break;
     case CLogger::LOG_WARN:
         msg = "LOGGER: Log level is: WARN";
-        innerLog(getFileName(__FILE__), __LINE__, msg, msg, false);
         break;
+    default:
+        return;
     }
-    unlock();
+
+    SLogEntry entry;
+    captureTime(entry);
+    entry.file = __FILE__;
+    entry.line = __LINE__;
+    entry.msg = msg;
+    Enqueue(entry, false);
 }
 
 std::string CLogger::getFileName(const std::string name) const
@@ -529,16 +563,12 @@ std::string CLogger::getFileName(const std::string name) const
 
 void CLogger::disableLogDetails()
 {
-    lock();
     m_details = false;
-    unlock();
 }
 
 void CLogger::enableLogDetails()
 {
-    lock();
     m_details = true;
-    unlock();
 }
 
 } //namespace ultra
@@ -0,0 +1,372 @@
+/*
+* Copyright 2018 Pinkmatter Solutions
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ul_Profiler.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "ul_Logger.h"
+#include "ul_Utility.h"
+
+namespace ultra
+{
+
+const std::string CProfiler::COUNTER_IMAGE_BYTES_READ = "imageBytesRead";
+const std::string CProfiler::COUNTER_IMAGE_BYTES_WRITTEN = "imageBytesWritten";
+const std::string CProfiler::COUNTER_CHIPS_ATTEMPTED = "chipsAttempted";
+const std::string CProfiler::COUNTER_CHIPS_ACCEPTED = "chipsAccepted";
+
+CProfiler::SStageStats::SStageStats()
+{
+    count = 0;
+    wallSeconds = 0;
+    minWallSeconds = 0;
+    maxWallSeconds = 0;
+    cpuSeconds = 0;
+}
+
+CProfiler::SStageStats::~SStageStats()
+{
+}
+
+CProfiler::CProfiler() :
+m_lock(std::make_shared<CThreadLock>())
+{
+    m_startWallSeconds = getWallSeconds();
+    m_startCpuSeconds = getCpuSeconds();
+}
+
+CProfiler::~CProfiler()
+{
+}
+
+CProfiler *CProfiler::getInstance()
+{
+    static CProfiler instance;
+    return &instance;
+}
+
+static double toSeconds(const timespec &ts)
+{
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+double CProfiler::getWallSeconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return toSeconds(ts);
+}
+
+double CProfiler::getCpuSeconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return toSeconds(ts);
+}
+
+unsigned long long CProfiler::getPeakRssBytes()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    // kilobytes on Linux
+    return (unsigned long long) usage.ru_maxrss * 1024ULL;
+}
+
+void CProfiler::AddStage(const std::string &name, double wallSeconds, double cpuSeconds)
+{
+    AUTO_LOCK(m_lock);
+    SStageStats &stats = m_stages[name];
+    if (stats.count == 0 || wallSeconds < stats.minWallSeconds)
+        stats.minWallSeconds = wallSeconds;
+    if (stats.count == 0 || wallSeconds > stats.maxWallSeconds)
+        stats.maxWallSeconds = wallSeconds;
+    stats.count++;
+    stats.wallSeconds += wallSeconds;
+    stats.cpuSeconds += cpuSeconds;
+}
+
+void CProfiler::AddCounter(const std::string &name, long long amount)
+{
+    AUTO_LOCK(m_lock);
+    m_counters[name] += amount;
+}
+
+long long CProfiler::getCounter(const std::string &name) const
+{
+    AUTO_LOCK(m_lock);
+    std::map<std::string, long long>::const_iterator it = m_counters.find(name);
+    return (it == m_counters.end()) ? (0) : (it->second);
+}
+
+bool CProfiler::getStage(const std::string &name, SStageStats &stats) const
+{
+    AUTO_LOCK(m_lock);
+    std::map<std::string, SStageStats>::const_iterator it = m_stages.find(name);
+    if (it == m_stages.end())
+        return false;
+    stats = it->second;
+    return true;
+}
+
+void CProfiler::Clear()
+{
+    AUTO_LOCK(m_lock);
+    m_stages.clear();
+    m_counters.clear();
+    m_startWallSeconds = getWallSeconds();
+    m_startCpuSeconds = getCpuSeconds();
+}
+
+static std::string jsonString(const std::string &str)
+{
+    std::string ret = "\"";
+    for (unsigned long t = 0; t < str.length(); t++)
+    {
+        char c = str[t];
+        if (c == '"' || c == '\\')
+        {
+            ret += '\\';
+            ret += c;
+        }
+        else if ((unsigned char) c < 0x20)
+        {
+            char temp[8];
+            snprintf(temp, sizeof (temp), "\\u%04x", (unsigned int) (unsigned char) c);
+            ret += temp;
+        }
+        else
+            ret += c;
+    }
+    return ret + "\"";
+}
+
+static std::string jsonDouble(double value)
+{
+    char temp[64];
+    snprintf(temp, sizeof (temp), "%.6f", value);
+    return temp;
+}
+
+std::string CProfiler::ToJson() const
+{
+    AUTO_LOCK(m_lock);
+    std::string json = "{\n";
+    json += "  \"wallSeconds\": " + jsonDouble(getWallSeconds() - m_startWallSeconds) + ",\n";
+    json += "  \"cpuSeconds\": " + jsonDouble(getCpuSeconds() - m_startCpuSeconds) + ",\n";
+    json += "  \"peakRssBytes\": " + toString(getPeakRssBytes()) + ",\n";
+
+    json += "  \"stages\": {";
+    bool first = true;
+    for (std::map<std::string, SStageStats>::const_iterator it = m_stages.begin(); it != m_stages.end(); ++it)
+    {
+        const SStageStats &stats = it->second;
+        json += (first ? "\n" : ",\n");
+        json += "    " + jsonString(it->first) + ": {" +
+            "\"count\": " + toString(stats.count) +
+            ", \"wallSeconds\": " + jsonDouble(stats.wallSeconds) +
+            ", \"minWallSeconds\": " + jsonDouble(stats.minWallSeconds) +
+            ", \"maxWallSeconds\": " + jsonDouble(stats.maxWallSeconds) +
+            ", \"cpuSeconds\": " + jsonDouble(stats.cpuSeconds) + "}";
+        first = false;
+    }
+    json += (first ? "},\n" : "\n  },\n");
+
+    json += "  \"counters\": {";
+    first = true;
+    for (std::map<std::string, long long>::const_iterator it = m_counters.begin(); it != m_counters.end(); ++it)
+    {
+        json += (first ? "\n" : ",\n");
+        json += "    " + jsonString(it->first) + ": " + toString(it->second);
+        first = false;
+    }
+    json += (first ? "}\n" : "\n  }\n");
+    json += "}\n";
+    return json;
+}
+
+int CProfiler::SaveJson(const std::string &path) const
+{
+    std::string json = ToJson();
+    FILE *fp = fopen(path.c_str(), "w");
+    if (fp == NULL)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to create '" + path + "'");
+        return 1;
+    }
+    bool ok = fwrite(json.c_str(), 1, json.length(), fp) == json.length();
+    if (fclose(fp) != 0 || !ok)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to write '" + path + "'");
+        return 1;
+    }
+    return 0;
+}
+
+CScopedTimer::CScopedTimer(const std::string &name)
+{
+    // the totals are measured from the creation of the profiler, which must not be after the first stage started
+    CProfiler::getInstance();
+    m_name = name;
+    m_startWallSeconds = CProfiler::getWallSeconds();
+    m_startCpuSeconds = CProfiler::getCpuSeconds();
+}
+
+CScopedTimer::~CScopedTimer()
+{
+    double endWallSeconds = CProfiler::getWallSeconds();
+    CProfiler::getInstance()->AddStage(m_name,
+                                       endWallSeconds - m_startWallSeconds,
+                                       CProfiler::getCpuSeconds() - m_startCpuSeconds);
+    CTracer *tracer = CTracer::getInstance();
+    if (tracer->isEnabled())
+        tracer->AddEvent(CTracer::CATEGORY_STAGE, m_name, m_startWallSeconds, endWallSeconds);
+}
+
+const char *CTracer::CATEGORY_STAGE = "stage";
+const char *CTracer::CATEGORY_CORRELATION = "correlation";
+const char *CTracer::CATEGORY_FFT = "fft";
+const char *CTracer::CATEGORY_IO = "io";
+const char *CTracer::CATEGORY_RESAMPLE = "resample";
+
+CTracer::CTracer() :
+m_lock(std::make_shared<CThreadLock>()),
+m_enabled(false)
+{
+    m_startWallSeconds = CProfiler::getWallSeconds();
+}
+
+CTracer::~CTracer()
+{
+}
+
+CTracer *CTracer::getInstance()
+{
+    static CTracer instance;
+    return &instance;
+}
+
+void CTracer::Enable()
+{
+    AUTO_LOCK(m_lock);
+    m_startWallSeconds = CProfiler::getWallSeconds();
+    m_enabled.store(true);
+}
+
+void CTracer::Disable()
+{
+    m_enabled.store(false);
+}
+
+CTracer::SThreadBuffer *CTracer::getThreadBuffer()
+{
+    // the tracer is a singleton, the buffer of a thread is never released before the process exits
+    static thread_local SThreadBuffer *buffer = nullptr;
+    if (buffer == nullptr)
+    {
+        std::shared_ptr<SThreadBuffer> newBuffer = std::make_shared<SThreadBuffer>();
+        newBuffer->events.reserve(1024);
+        AUTO_LOCK(m_lock);
+        newBuffer->threadId = m_buffers.size() + 1;
+        m_buffers.push_back(newBuffer);
+        buffer = newBuffer.get();
+    }
+    return buffer;
+}
+
+void CTracer::SetThreadName(const std::string &name)
+{
+    if (!isEnabled())
+        return;
+    SThreadBuffer *buffer = getThreadBuffer();
+    AUTO_LOCK(m_lock);
+    buffer->threadName = name;
+}
+
+void CTracer::AddEvent(const char *category, const std::string &name, double startSeconds, double endSeconds)
+{
+    SThreadBuffer *buffer = getThreadBuffer();
+    buffer->events.push_back(SEvent());
+    SEvent &event = buffer->events.back();
+    event.name = name;
+    event.category = category;
+    event.startSeconds = startSeconds;
+    event.endSeconds = endSeconds;
+}
+
+int CTracer::SaveJson(const std::string &path) const
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (fp == NULL)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to create '" + path + "'");
+        return 1;
+    }
+
+    AUTO_LOCK(m_lock);
+    long pid = (long) getpid();
+    bool first = true;
+    fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+    for (unsigned long t = 0; t < m_buffers.size(); t++)
+    {
+        const SThreadBuffer &buffer = *m_buffers[t];
+        std::string threadName = buffer.threadName;
+        if (threadName == "")
+            threadName = "thread " + toString(buffer.threadId);
+        fprintf(fp, "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %ld, \"tid\": %lu, \"args\": {\"name\": %s}}",
+                first ? "" : ",", pid, buffer.threadId, jsonString(threadName).c_str());
+        first = false;
+
+        for (unsigned long e = 0; e < buffer.events.size(); e++)
+        {
+            const SEvent &event = buffer.events[e];
+            // timestamps are in microseconds
+            fprintf(fp, ",\n{\"name\": %s, \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %ld, \"tid\": %lu}",
+                    jsonString(event.name).c_str(), event.category,
+                    (event.startSeconds - m_startWallSeconds) * 1e6,
+                    (event.endSeconds - event.startSeconds) * 1e6,
+                    pid, buffer.threadId);
+        }
+    }
+    fprintf(fp, "\n]}\n");
+
+    bool ok = ferror(fp) == 0;
+    if (fclose(fp) != 0 || !ok)
+    {
+        CLogger::getInstance()->Log(__FILE__, __LINE__, CLogger::LOG_ERROR, "Failed to write '" + path + "'");
+        return 1;
+    }
+    return 0;
+}
+
+CTraceScope::CTraceScope(const char *category, const char *name)
+{
+    m_category = category;
+    m_name = name;
+    m_active = CTracer::getInstance()->isEnabled();
+    m_startSeconds = m_active ? CProfiler::getWallSeconds() : 0;
+}
+
+CTraceScope::~CTraceScope()
+{
+    if (m_active)
+        CTracer::getInstance()->AddEvent(m_category, m_name, m_startSeconds, CProfiler::getWallSeconds());
+}
+
+} // namespace ultra